@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      accumulates the integral matrix sum_events A_i A_j^* as a
+//      sequence of blocked Hermitian rank-k updates
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "reportingUtils.hpp"
+#include "ampIntegralAccumulator.h"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+ampIntegralAccumulator::ampIntegralAccumulator(const unsigned int nmbWaves,
+                                               const unsigned int blockSize,
+                                               const unsigned int nmbThreads)
+	: _nmbWaves             (0),
+	  _blockSize            (max(1u, (blockSize + nmbRowsPerLane - 1) / nmbRowsPerLane) * nmbRowsPerLane),
+	  _nmbThreads           (1),
+	  _nmbRowsInBlock       (0),
+	  _nmbEvents            (0),
+	  _weightSum            (0),
+	  _weightSumCompensation(0)
+{
+	setNmbThreads(nmbThreads);
+	reset(nmbWaves);
+}
+
+
+void
+ampIntegralAccumulator::reset(const unsigned int nmbWaves)
+{
+	_nmbWaves              = nmbWaves;
+	_nmbRowsInBlock        = 0;
+	_nmbEvents             = 0;
+	_weightSum             = 0;
+	_weightSumCompensation = 0;
+	_blockRe.assign((size_t)_nmbWaves * _blockSize, 0);
+	_blockIm.assign((size_t)_nmbWaves * _blockSize, 0);
+	_sums.assign((size_t)_nmbWaves * (_nmbWaves + 1) / 2 * 4, 0);
+}
+
+
+void
+ampIntegralAccumulator::setNmbThreads(const unsigned int nmbThreads)
+{
+#ifdef _OPENMP
+	_nmbThreads = (nmbThreads == 0) ? omp_get_max_threads() : nmbThreads;
+#else
+	if (nmbThreads > 1)
+		printWarn << "ROOTPWA was compiled without OpenMP support. "
+		          << "ignoring request to use " << nmbThreads << " threads." << endl;
+	_nmbThreads = 1;
+#endif
+}
+
+
+void
+ampIntegralAccumulator::addEvent(const complex<double>* amps,
+                                 const unsigned int     nmbSubAmps,
+                                 const double           weight)
+{
+	// the products of two rows carry the weight once
+	const double rowFactor = sqrt(weight);
+	for (unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex) {
+		if (_nmbRowsInBlock == _blockSize)
+			flush();
+		const complex<double>* rowAmps = amps + subAmpIndex * _nmbWaves;
+		for (unsigned int waveIndex = 0; waveIndex < _nmbWaves; ++waveIndex) {
+			_blockRe[(size_t)waveIndex * _blockSize + _nmbRowsInBlock] = rowFactor * rowAmps[waveIndex].real();
+			_blockIm[(size_t)waveIndex * _blockSize + _nmbRowsInBlock] = rowFactor * rowAmps[waveIndex].imag();
+		}
+		++_nmbRowsInBlock;
+	}
+	++_nmbEvents;
+	addCompensated(_weightSum, _weightSumCompensation, weight);
+}
+
+
+void
+ampIntegralAccumulator::flush()
+{
+	if (_nmbRowsInBlock == 0)
+		return;
+	// padding rows of the last lane do not contribute
+	const unsigned int nmbLanes = (_nmbRowsInBlock + nmbRowsPerLane - 1) / nmbRowsPerLane;
+	for (unsigned int waveIndex = 0; waveIndex < _nmbWaves; ++waveIndex)
+		for (unsigned int row = _nmbRowsInBlock; row < nmbLanes * nmbRowsPerLane; ++row) {
+			_blockRe[(size_t)waveIndex * _blockSize + row] = 0;
+			_blockIm[(size_t)waveIndex * _blockSize + row] = 0;
+		}
+
+	// the rows of the matrix have different lengths
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long waveIndexI = 0; waveIndexI < (long)_nmbWaves; ++waveIndexI) {
+		const double* reI = &_blockRe[(size_t)waveIndexI * _blockSize];
+		const double* imI = &_blockIm[(size_t)waveIndexI * _blockSize];
+		for (unsigned int waveIndexJ = waveIndexI; waveIndexJ < _nmbWaves; ++waveIndexJ) {
+			const double* reJ = &_blockRe[(size_t)waveIndexJ * _blockSize];
+			const double* imJ = &_blockIm[(size_t)waveIndexJ * _blockSize];
+			double sumRe[nmbRowsPerLane] = {};
+			double sumIm[nmbRowsPerLane] = {};
+			for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+				const unsigned int offset = iLane * nmbRowsPerLane;
+				for (unsigned int iRow = 0; iRow < nmbRowsPerLane; ++iRow) {
+					// A_i A_j^*
+					sumRe[iRow] += reI[offset + iRow] * reJ[offset + iRow] + imI[offset + iRow] * imJ[offset + iRow];
+					sumIm[iRow] += imI[offset + iRow] * reJ[offset + iRow] - reI[offset + iRow] * imJ[offset + iRow];
+				}
+			}
+			double blockSumRe = 0;
+			double blockSumIm = 0;
+			for (unsigned int iRow = 0; iRow < nmbRowsPerLane; ++iRow) {
+				blockSumRe += sumRe[iRow];
+				blockSumIm += sumIm[iRow];
+			}
+			double* elementSums = &_sums[packedIndex(waveIndexI, waveIndexJ)];
+			addCompensated(elementSums[0], elementSums[1], blockSumRe);
+			addCompensated(elementSums[2], elementSums[3], blockSumIm);
+		}
+	}
+	_nmbRowsInBlock = 0;
+}
+
+
+bool
+ampIntegralAccumulator::merge(const ampIntegralAccumulator& other)
+{
+	if (other._nmbWaves != _nmbWaves) {
+		printWarn << "cannot merge integral accumulators with different numbers of waves "
+		          << "(" << _nmbWaves << " != " << other._nmbWaves << ")." << endl;
+		return false;
+	}
+	if (other._nmbRowsInBlock > 0) {
+		printWarn << "cannot merge integral accumulator with unflushed events." << endl;
+		return false;
+	}
+	flush();
+	for (size_t i = 0; i < _sums.size(); i += 2) {
+		// the compensation of the other sum is subtracted as well
+		addCompensated(_sums[i], _sums[i + 1], other._sums[i]);
+		addCompensated(_sums[i], _sums[i + 1], -other._sums[i + 1]);
+	}
+	_nmbEvents += other._nmbEvents;
+	addCompensated(_weightSum, _weightSumCompensation, other._weightSum);
+	addCompensated(_weightSum, _weightSumCompensation, -other._weightSumCompensation);
+	return true;
+}
+
+
+complex<double>
+ampIntegralAccumulator::element(const unsigned int waveIndexI,
+                                const unsigned int waveIndexJ) const
+{
+	if (waveIndexJ < waveIndexI)
+		return conj(element(waveIndexJ, waveIndexI));
+	const double* elementSums = &_sums[packedIndex(waveIndexI, waveIndexJ)];
+	return complex<double>(elementSums[0], elementSums[2]);
+}
+
+
+bool
+ampIntegralAccumulator::setPackedSums(const vector<double>& sums,
+                                      const unsigned long   nmbEvents,
+                                      const double          weightSum,
+                                      const double          weightSumCompensation)
+{
+	if (sums.size() != _sums.size()) {
+		printWarn << "size of packed sums (" << sums.size() << ") does not match "
+		          << "number of waves " << _nmbWaves << "." << endl;
+		return false;
+	}
+	_sums                  = sums;
+	_nmbRowsInBlock        = 0;
+	_nmbEvents             = nmbEvents;
+	_weightSum             = weightSum;
+	_weightSumCompensation = weightSumCompensation;
+	return true;
+}
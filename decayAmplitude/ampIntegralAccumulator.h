@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      accumulates the integral matrix sum_events A_i A_j^* as a
+//      sequence of blocked Hermitian rank-k updates
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef AMPINTEGRALACCUMULATOR_H
+#define AMPINTEGRALACCUMULATOR_H
+
+
+#include <complex>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
+
+namespace rpwa {
+
+
+	// the amplitudes of the events are buffered in a block of rows,
+	// where every incoherent sub-amplitude of an event is an extra row
+	// scaled by the square root of the event weight. once the block is
+	// full, the upper triangle of the integral matrix is updated with the
+	// products of all rows of the block. the columns of the block are
+	// stored wave by wave with separate real and imaginary parts, so that
+	// the sums over rows run over contiguous memory in lanes of
+	// nmbRowsPerLane rows. the update is parallelized over the rows of
+	// the matrix, the block sums are added to the matrix elements with
+	// compensated summation.
+	class ampIntegralAccumulator {
+
+	public:
+
+		enum {
+			nmbRowsPerLane   = 8,    // number of rows summed in parallel
+			defaultBlockSize = 512,  // number of rows per block
+			alignment        = 64    // alignment of the columns in bytes
+		};
+
+		ampIntegralAccumulator(const unsigned int nmbWaves   = 0,
+		                       const unsigned int blockSize  = defaultBlockSize,  // rounded up to a multiple of nmbRowsPerLane
+		                       const unsigned int nmbThreads = 0);                // 0 = number of threads given by the OpenMP runtime
+		~ampIntegralAccumulator() { }
+
+		void reset(const unsigned int nmbWaves);  ///< removes all events and sets the number of waves
+
+		/// adds an event; amps[sub-amplitude index * nmbWaves() + wave index]
+		void addEvent(const std::complex<double>* amps,
+		              const unsigned int          nmbSubAmps = 1,
+		              const double                weight     = 1);
+
+		void flush();  ///< adds the buffered rows to the integral matrix
+
+		/// adds the matrix elements, events and weights of another accumulator with the same number of waves
+		bool merge(const ampIntegralAccumulator& other);
+
+		unsigned int  nmbWaves  () const { return _nmbWaves;   }
+		unsigned long nmbEvents () const { return _nmbEvents;  }  ///< returns number of added events
+		double        weightSum () const { return _weightSum;  }  ///< returns sum of the weights of the added events
+		double        weightSumCompensation() const { return _weightSumCompensation; }  ///< returns compensation of the compensated sum of the weights
+		unsigned int  nmbThreads() const { return _nmbThreads; }
+		void          setNmbThreads(const unsigned int nmbThreads = 0);
+
+		/// returns the integral matrix element (i, j); flush() has to be called first to include all events
+		std::complex<double> element(const unsigned int waveIndexI,
+		                             const unsigned int waveIndexJ) const;
+
+		/// fills both triangles of a matrix with operator[][]; flush() has to be called first to include all events
+		template<typename matrixT>
+		void fillMatrix(matrixT& matrix, const double factor = 1) const
+		{
+			for (unsigned int i = 0; i < _nmbWaves; ++i)
+				for (unsigned int j = i; j < _nmbWaves; ++j) {
+					const std::complex<double> val = factor * element(i, j);
+					matrix[i][j] = val;
+					if (j != i)
+						matrix[j][i] = std::conj(val);
+				}
+		}
+
+		/// packed storage of the upper triangle (real and imaginary part of sum and compensation per element)
+		const std::vector<double>& packedSums() const { return _sums; }
+		bool setPackedSums(const std::vector<double>& sums,
+		                   const unsigned long        nmbEvents,
+		                   const double               weightSum,
+		                   const double               weightSumCompensation = 0);
+
+	private:
+
+		std::size_t packedIndex(const unsigned int i,
+		                        const unsigned int j) const  ///< index of element (i, j) with j >= i in packed upper triangle
+		{ return ((std::size_t)i * (2 * _nmbWaves - i + 1) / 2 + (j - i)) * 4; }
+
+		static void addCompensated(double& sum, double& compensation, const double value)
+		{
+			const double y = value - compensation;
+			const double t = sum + y;
+			compensation = (t - sum) - y;
+			sum = t;
+		}
+
+		unsigned int  _nmbWaves;
+		unsigned int  _blockSize;
+		unsigned int  _nmbThreads;
+		unsigned int  _nmbRowsInBlock;
+		unsigned long _nmbEvents;
+		double        _weightSum;
+		double        _weightSumCompensation;
+
+		std::vector<double, boost::alignment::aligned_allocator<double, alignment> > _blockRe;  // [wave index][row]
+		std::vector<double, boost::alignment::aligned_allocator<double, alignment> > _blockIm;  // [wave index][row]
+		std::vector<double> _sums;  // [packed index + 0..3] = real sum, real compensation, imaginary sum, imaginary compensation
+
+	};
+
+
+}  // namespace rpwa
+
+
+#endif  // AMPINTEGRALACCUMULATOR_H
@@ -45,9 +45,12 @@
 #include "fileUtils.hpp"
 #include "sumAccumulators.hpp"
 #include "amplitudeTreeLeaf.h"
+#include "ampIntegralAccumulator.h"
 #include "ampIntegralMatrix.h"
 #include "amplitudeMetadata.h"
+#include "eventBinIndex.h"
 #include "eventMetadata.h"
+#include "eventWeights.h"
 
 
 using namespace std;
@@ -301,7 +304,9 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>&   ampMetada
                              const long                                maxNmbEvents,
                              const string&                             weightFileName,
                              const eventMetadata*                      eventMeta,
-                             const map<string, pair<double, double> >& otfBin)
+                             const map<string, pair<double, double> >& otfBin,
+                             const string&                             binIndexDirectory,
+                             const unsigned int                        nmbThreads)
 {
 	if (ampMetadata.empty()) {
 		printWarn << "did not receive any amplitude trees. cannot calculate integral." << endl;
@@ -327,13 +332,13 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>&   ampMetada
 		printErr << "integral matrix was already initialized, but with a different number of waves. Aborting..." << endl;
 		return false;
 	}
-	const long nmbEvents = ampMetadata[0]->amplitudeTree()->GetEntries();
+	const long nmbEvents = ampMetadata[0]->nmbAmplitudes();
 	if (nmbEvents == 0) {
 		printWarn << "amplitude trees contain no amplitudes values. cannot calculate integral." << endl;
 		return false;
 	}
 	for (size_t i = 1; i < ampMetadata.size(); i++) {
-		if (nmbEvents != ampMetadata[i]->amplitudeTree()->GetEntries()) {
+		if (nmbEvents != ampMetadata[i]->nmbAmplitudes()) {
 			printErr << "amplitude trees do not all have the same entry count." << endl;
 			return false;
 		}
@@ -342,11 +347,17 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>&   ampMetada
 		_nmbEvents = nmbEvents;
 	else
 		_nmbEvents = min(nmbEvents, maxNmbEvents);
-	// set amplitude tree leafs
+	// set amplitude tree leafs; amplitudes in columnar files are
+	// read in blocks instead
+	const unsigned long ampBlockSize = amplitudeMetadata::defaultChunkSize;
 	vector<amplitudeTreeLeaf*> ampTreeLeafs(_nmbWaves);
+	vector<vector<complex<double> > > ampBlocks(_nmbWaves);
 	for(size_t waveIndex = 0; waveIndex < _nmbWaves; waveIndex++) {
 		ampTreeLeafs[waveIndex] = NULL;
-		ampMetadata[waveIndex]->amplitudeTree()->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeafs[waveIndex]);
+		if (ampMetadata[waveIndex]->columnar())
+			ampBlocks[waveIndex].resize(ampBlockSize);
+		else
+			ampMetadata[waveIndex]->amplitudeTree()->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeafs[waveIndex]);
 	}
 
 	// make sure that either all or none of the waves have description (needed?)
@@ -357,20 +368,35 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>&   ampMetada
 	//_integrals.clear();
 	_integrals.resize(extents[_nmbWaves][_nmbWaves]);
 
-	// open importance sampling weight file
-	//!!! this should be provided as a friend tree for the amplitudes
-	ifstream weightFile;
-	bool     useWeight = false;
-	if (weightFileName != "") {
+	// read importance sampling weights; weights from a column of the
+	// event file or from a binary weight file are indexed by the event
+	// number, the weights in a text file belong to the integrated events
+	// in the order in which they are visited
+	const bool     useWeight       = (weightFileName != "");
+	bool           weightsPerEvent = false;
+	vector<double> weights;
+	if (useWeight) {
 		if (_debug)
-			printDebug << "opening importance sampling weight file '" << weightFileName << "'" << endl;
-		weightFile.open(weightFileName.c_str());
-		if (not weightFile) {
-			printWarn << "cannot open importance sampling weight file '" << weightFileName << "' "
+			printDebug << "reading importance sampling weights from '" << weightFileName << "'" << endl;
+		const eventMetadata* weightEventMeta = eventMeta;
+		if (not weightEventMeta and ampMetadata[0]->eventMetadata().size() == 1)
+			weightEventMeta = &(ampMetadata[0]->eventMetadata()[0]);
+		bool weightsRead = false;
+		if (weightEventMeta) {
+			weightsPerEvent = (eventWeights::sourceType(weightFileName, *weightEventMeta) != eventWeights::TEXT_FILE);
+			weightsRead     = eventWeights::readWeights(weightFileName, *weightEventMeta, weights);
+		} else
+			weightsRead = eventWeights::readTextFile(weightFileName, weights);
+		if (not weightsRead) {
+			printWarn << "cannot read importance sampling weights from '" << weightFileName << "'. "
 			          << "cannot calculate integral." << endl;
 			return false;
 		}
-		useWeight = true;
+		if (weightsPerEvent and (long)weights.size() != nmbEvents) {
+			printWarn << "number of importance sampling weights does not match number of amplitudes ("
+			          << weights.size() << " != " << nmbEvents << "). cannot calculate integral." << endl;
+			return false;
+		}
 	}
 
 	TTree* eventTree = 0;
@@ -403,17 +429,56 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>&   ampMetada
 		}
 	}
 
-	// loop over events and calculate integral matrix
-	accumulator_set<double, stats<tag::sum(compensated)> > weightAcc;
-	typedef accumulator_set<complex<double>, stats<tag::sum(compensated)> > complexAcc;
-	vector<vector<complexAcc> > ampProdAcc(_nmbWaves, vector<complexAcc>(_nmbWaves));
+	// with a bin index only the events in the bin are visited and no
+	// veto is needed
+	const bool useBinIndex = eventMeta and not binIndexDirectory.empty();
+	vector<size_t> binEntries;
+	if (useBinIndex) {
+		vector<string> variables;
+		for (map<string, pair<double, double> >::const_iterator elem = otfBin.begin(); elem != otfBin.end(); ++elem)
+			variables.push_back(elem->first);
+		const eventBinIndex* binIndex = eventBinIndex::getBinIndex(*eventMeta, binIndexDirectory, variables);
+		if (not binIndex or binIndex->nmbEvents() != nmbEvents or not binIndex->entriesInBin(otfBin, binEntries)) {
+			printErr << "could not select events with bin index." << endl;
+			return false;
+		}
+		binEntries.erase(lower_bound(binEntries.begin(), binEntries.end(), _nmbEvents), binEntries.end());
+		eventTree->ResetBranchAddresses();
+		eventTree = 0;
+	}
+	const unsigned long nmbEventsToVisit = useBinIndex ? binEntries.size() : _nmbEvents;
+
+	// loop over events and calculate integral matrix; the amplitudes of
+	// each event are buffered and the upper triangle of the matrix is
+	// updated block-wise
+	ampIntegralAccumulator accumulator(_nmbWaves, ampIntegralAccumulator::defaultBlockSize, nmbThreads);
 	// process weight file and amplitudes
-	vector<vector<complex<double> > > amps(_nmbWaves);
-	progress_display progressIndicator(_nmbEvents, cout, "");
+	vector<complex<double> > eventAmps;  // [sub-amplitude index * _nmbWaves + wave index]
+	progress_display progressIndicator(nmbEventsToVisit, cout, "");
 	bool             success      = true;
-	unsigned long    eventCounter = 0;
-	for (unsigned long iEvent = 0; iEvent < _nmbEvents; ++iEvent) {
+	vector<size_t>   blockEntries;
+	for (unsigned long iVisit = 0; iVisit < nmbEventsToVisit; ++iVisit) {
 		++progressIndicator;
+		const unsigned long iEvent = useBinIndex ? binEntries[iVisit] : iVisit;
+
+		// the blocks have to be read before the on-the-fly binning veto
+		const unsigned long indexInBlock = iVisit % ampBlockSize;
+		if (indexInBlock == 0) {
+			const unsigned long nmbInBlock = min(ampBlockSize, nmbEventsToVisit - iVisit);
+			if (useBinIndex)
+				blockEntries.assign(binEntries.begin() + iVisit, binEntries.begin() + iVisit + nmbInBlock);
+			for (unsigned int waveIndex = 0; waveIndex < _nmbWaves; ++waveIndex)
+				if (ampMetadata[waveIndex]->columnar()
+				    and not (useBinIndex ? ampMetadata[waveIndex]->readAmplitudes(blockEntries, 0, ampBlocks[waveIndex].data())
+				                         : ampMetadata[waveIndex]->readAmplitudes(iEvent, nmbInBlock, ampBlocks[waveIndex].data()))) {
+					success = false;
+					printWarn << "error reading amplitudes for wave '" << _waveNames[waveIndex] << "'. stopping integration "
+					          << "at event " << iEvent << " of total " << _nmbEvents << "." << endl;
+					break;
+				}
+			if (not success)
+				break;
+		}
 
 		if(eventTree) {
 			eventTree->GetEntry(iEvent);
@@ -428,70 +493,66 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>&   ampMetada
 				continue;
 			}
 		}
-		++eventCounter;
 
-		// sum up importance sampling weight
+		// get importance sampling weight
 		double w = 1;
-		if (useWeight)
-			if (not(weightFile >> w)) {
+		if (useWeight) {
+			const unsigned long weightIndex = weightsPerEvent ? iEvent : accumulator.nmbEvents();
+			if (weightIndex >= weights.size()) {
 				success = false;
-				printWarn << "error reading weight file. stopping integration "
+				printWarn << "too few importance sampling weights. stopping integration "
 				          << "at event " << iEvent << " of total " << _nmbEvents << "." << endl;
 				break;
 			}
+			w = weights[weightIndex];
+		}
 		const double weight = 1 / w; // we have to undo the weighting of the events!
-		weightAcc(weight);
 
 		// read amplitude values for this event from root trees
+		unsigned int nmbSubAmps = 0;
 		for (unsigned int waveIndex = 0; waveIndex < _nmbWaves; ++waveIndex) {
-			ampMetadata[waveIndex]->amplitudeTree()->GetEntry(iEvent);
-			const unsigned int nmbSubAmps = ampTreeLeafs[waveIndex]->nmbIncohSubAmps();
-			if (nmbSubAmps < 1) {
-				printErr << "amplitude object for wave '" << _waveNames[waveIndex] << "' "
-				         << "does not contain any amplitude values "
-				         << "at event " << iEvent << " of total " << _nmbEvents << ". Aborting..." << endl;
+			unsigned int nmbWaveSubAmps = 1;
+			if (not ampMetadata[waveIndex]->columnar()) {
+				ampMetadata[waveIndex]->amplitudeTree()->GetEntry(iEvent);
+				nmbWaveSubAmps = ampTreeLeafs[waveIndex]->nmbIncohSubAmps();
+				if (nmbWaveSubAmps < 1) {
+					printErr << "amplitude object for wave '" << _waveNames[waveIndex] << "' "
+					         << "does not contain any amplitude values "
+					         << "at event " << iEvent << " of total " << _nmbEvents << ". Aborting..." << endl;
+					throw;
+				}
+			}
+			if (waveIndex == 0) {
+				nmbSubAmps = nmbWaveSubAmps;
+				eventAmps.resize(nmbSubAmps * _nmbWaves);
+			} else if (nmbWaveSubAmps != nmbSubAmps) {
+				printErr << "number of incoherent sub-amplitudes for wave '"
+				         << _waveNames[0] << "' = " << nmbSubAmps
+				         << " differs from that of wave '" << _waveNames[waveIndex] << "' = "
+				         << nmbWaveSubAmps
+				         << " at event " << iEvent << " of total " << _nmbEvents << ". Aborting... "
+				         << "be sure to use only .root amplitude files, "
+				         << "if your channel has sub-amplitudes." << endl;
 				throw;
 			}
 			// get all incoherent subamps
-			amps[waveIndex].resize(nmbSubAmps);
-			for (unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex)
-				amps[waveIndex][subAmpIndex] = ampTreeLeafs[waveIndex]->incohSubAmp(subAmpIndex);
+			if (ampMetadata[waveIndex]->columnar())
+				eventAmps[waveIndex] = ampBlocks[waveIndex][indexInBlock];
+			else
+				for (unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex)
+					eventAmps[subAmpIndex * _nmbWaves + waveIndex] = ampTreeLeafs[waveIndex]->incohSubAmp(subAmpIndex);
 		}
 
 		// sum up integral matrix elements
-		for (unsigned int waveIndexI = 0; waveIndexI < _nmbWaves; ++waveIndexI)
-			for (unsigned int waveIndexJ = 0; waveIndexJ < _nmbWaves; ++waveIndexJ) {
-				// sum over incoherent subamps
-				const unsigned int nmbSubAmps = amps[waveIndexI].size();
-				if (nmbSubAmps != amps[waveIndexJ].size()) {
-					printErr << "number of incoherent sub-amplitudes for wave '"
-					         << _waveNames[waveIndexI] << "' = " << nmbSubAmps
-					         << " differs from that of wave '" << _waveNames[waveIndexJ] << "' = "
-					         << amps[waveIndexJ].size()
-					         << " at event " << iEvent << " of total " << _nmbEvents << ". Aborting... "
-					         << "be sure to use only .root amplitude files, "
-					         << "if your channel has sub-amplitudes." << endl;
-					throw;
-				}
-				complex<double> val = 0;
-				for (unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex)
-					val += amps[waveIndexI][subAmpIndex] * conj(amps[waveIndexJ][subAmpIndex]);
-				if (useWeight)
-					val *= weight;
-				ampProdAcc[waveIndexI][waveIndexJ](val);
-			}
+		accumulator.addEvent(eventAmps.data(), nmbSubAmps, useWeight ? weight : 1);
 	}  // event loop
-	_nmbEvents = eventCounter;
+	accumulator.flush();
+	_nmbEvents = accumulator.nmbEvents();
 
-	// copy values from accumulators and (if necessary) renormalize to
+	// copy values from accumulator and (if necessary) renormalize to
 	// integral of importance sampling weights
-	const double weightNorm = sum(weightAcc) / (double)_nmbEvents;
-	for (unsigned int waveIndexI = 0; waveIndexI < _nmbWaves; ++waveIndexI)
-		for (unsigned int waveIndexJ = 0; waveIndexJ < _nmbWaves; ++waveIndexJ) {
-			_integrals[waveIndexI][waveIndexJ] = sum(ampProdAcc[waveIndexI][waveIndexJ]);
-			if (useWeight)
-				_integrals[waveIndexI][waveIndexJ] *= 1 / weightNorm;
-		}
+	const double weightNorm = accumulator.weightSum() / (double)_nmbEvents;
+	accumulator.fillMatrix(_integrals, useWeight ? 1 / weightNorm : 1);
 
 	printSucc << "calculated integrals of " << _nmbWaves << " amplitude(s) "
 	          << "for " << _nmbEvents << " events" << endl;
@@ -499,6 +560,180 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>&   ampMetada
 }
 
 
+bool
+ampIntegralMatrix::integrateBins(vector<ampIntegralMatrix>&                          integrals,
+                                 const vector<const amplitudeMetadata*>&             ampMetadata,
+                                 const eventMetadata&                                eventMeta,
+                                 const vector<map<string, pair<double, double> > >& bins,
+                                 const long                                          maxNmbEvents,
+                                 const string&                                       weightFileName,
+                                 const unsigned int                                  nmbThreads)
+{
+	if (ampMetadata.empty()) {
+		printWarn << "did not receive any amplitude trees. cannot calculate integrals." << endl;
+		return false;
+	}
+	if (bins.empty()) {
+		printWarn << "did not receive any bins. cannot calculate integrals." << endl;
+		return false;
+	}
+	const unsigned int nmbWaves = ampMetadata.size();
+	vector<string> waveNames(nmbWaves);
+	for (unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex)
+		waveNames[waveIndex] = ampMetadata[waveIndex]->objectBaseName();
+	const long nmbEventsInFile = ampMetadata[0]->nmbAmplitudes();
+	for (unsigned int waveIndex = 1; waveIndex < nmbWaves; ++waveIndex)
+		if (ampMetadata[waveIndex]->nmbAmplitudes() != nmbEventsInFile) {
+			printErr << "amplitude trees do not all have the same entry count." << endl;
+			return false;
+		}
+	TTree* eventTree = eventMeta.eventTree();
+	if (not eventTree or eventTree->GetEntries() != nmbEventsInFile) {
+		printErr << "event number mismatch between amplitudes and data file." << endl;
+		return false;
+	}
+	const unsigned long nmbEvents = (maxNmbEvents <= 0) ? nmbEventsInFile : min(nmbEventsInFile, maxNmbEvents);
+
+	// each binning variable is read only once, even if it is used by several bins
+	vector<string> variables;
+	for (size_t iBin = 0; iBin < bins.size(); ++iBin)
+		for (map<string, pair<double, double> >::const_iterator elem = bins[iBin].begin(); elem != bins[iBin].end(); ++elem)
+			if (find(variables.begin(), variables.end(), elem->first) == variables.end())
+				variables.push_back(elem->first);
+	vector<double> variableValues(variables.size());
+	for (size_t iVar = 0; iVar < variables.size(); ++iVar) {
+		const int err = eventTree->SetBranchAddress(variables[iVar].c_str(), &variableValues[iVar]);
+		if (err < 0) {
+			printErr << "could not set branch address for branch '" << variables[iVar] << "' (error code " << err << ")." << endl;
+			return false;
+		}
+	}
+	// bounds of each bin as (variable index, (lower, upper))
+	vector<vector<pair<size_t, pair<double, double> > > > binBounds(bins.size());
+	for (size_t iBin = 0; iBin < bins.size(); ++iBin)
+		for (map<string, pair<double, double> >::const_iterator elem = bins[iBin].begin(); elem != bins[iBin].end(); ++elem)
+			binBounds[iBin].push_back(make_pair(find(variables.begin(), variables.end(), elem->first) - variables.begin(), elem->second));
+
+	// the weights of all events are read at once
+	const bool     useWeight = (weightFileName != "");
+	vector<double> weights;
+	if (useWeight) {
+		if (not eventWeights::readWeights(weightFileName, eventMeta, weights)) {
+			printWarn << "cannot read importance sampling weights from '" << weightFileName << "'. "
+			          << "cannot calculate integrals." << endl;
+			return false;
+		}
+		if (weights.size() < nmbEvents) {
+			printErr << "too few importance sampling weights (" << weights.size() << " < " << nmbEvents << "). Aborting..." << endl;
+			return false;
+		}
+	}
+
+	vector<amplitudeTreeLeaf*> ampTreeLeafs(nmbWaves, NULL);
+	const unsigned long ampBlockSize = amplitudeMetadata::defaultChunkSize;
+	vector<vector<complex<double> > > ampBlocks(nmbWaves);
+	for (unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+		if (ampMetadata[waveIndex]->columnar())
+			ampBlocks[waveIndex].resize(ampBlockSize);
+		else
+			ampMetadata[waveIndex]->amplitudeTree()->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeafs[waveIndex]);
+	}
+
+	// every bin has its own accumulator, so that the integral of a bin
+	// is summed in the same way as by integrate(); the accumulators of
+	// bins without events are not allocated
+	vector<ampIntegralAccumulator> accumulators(bins.size(), ampIntegralAccumulator(0, ampIntegralAccumulator::defaultBlockSize, nmbThreads));
+	vector<complex<double> >       eventAmps;  // [sub-amplitude index * nmbWaves + wave index]
+	progress_display progressIndicator(nmbEvents, cout, "");
+	for (unsigned long iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		++progressIndicator;
+		const unsigned long indexInBlock = iEvent % ampBlockSize;
+		if (indexInBlock == 0) {
+			const unsigned long nmbInBlock = min(ampBlockSize, nmbEvents - iEvent);
+			for (unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex)
+				if (ampMetadata[waveIndex]->columnar()
+				    and not ampMetadata[waveIndex]->readAmplitudes(iEvent, nmbInBlock, ampBlocks[waveIndex].data())) {
+					printErr << "error reading amplitudes for wave '" << waveNames[waveIndex] << "' "
+					         << "at event " << iEvent << " of total " << nmbEvents << ". Aborting..." << endl;
+					return false;
+				}
+		}
+
+		// sort the event into the bins
+		eventTree->GetEntry(iEvent);
+		vector<size_t> eventBins;
+		for (size_t iBin = 0; iBin < bins.size(); ++iBin) {
+			bool inBin = true;
+			for (size_t iBound = 0; iBound < binBounds[iBin].size(); ++iBound) {
+				const double value = variableValues[binBounds[iBin][iBound].first];
+				if (value < binBounds[iBin][iBound].second.first or value >= binBounds[iBin][iBound].second.second) {
+					inBin = false;
+					break;
+				}
+			}
+			if (inBin)
+				eventBins.push_back(iBin);
+		}
+		if (eventBins.empty())
+			continue;
+
+		// read amplitudes
+		unsigned int nmbSubAmps = 1;
+		for (unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex)
+			if (not ampMetadata[waveIndex]->columnar()) {
+				ampMetadata[waveIndex]->amplitudeTree()->GetEntry(iEvent);
+				nmbSubAmps = ampTreeLeafs[waveIndex]->nmbIncohSubAmps();
+			}
+		eventAmps.resize(nmbSubAmps * nmbWaves);
+		for (unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+			if (ampMetadata[waveIndex]->columnar()) {
+				if (nmbSubAmps != 1) {
+					printErr << "wave '" << waveNames[waveIndex] << "' has no sub-amplitudes, but other waves have "
+					         << nmbSubAmps << " at event " << iEvent << ". Aborting..." << endl;
+					return false;
+				}
+				eventAmps[waveIndex] = ampBlocks[waveIndex][indexInBlock];
+				continue;
+			}
+			if (ampTreeLeafs[waveIndex]->nmbIncohSubAmps() != nmbSubAmps or nmbSubAmps < 1) {
+				printErr << "number of incoherent sub-amplitudes for wave '" << waveNames[waveIndex] << "' "
+				         << "differs from that of the other waves at event " << iEvent << ". Aborting..." << endl;
+				return false;
+			}
+			for (unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex)
+				eventAmps[subAmpIndex * nmbWaves + waveIndex] = ampTreeLeafs[waveIndex]->incohSubAmp(subAmpIndex);
+		}
+
+		const double weight = useWeight ? 1 / weights[iEvent] : 1;  // we have to undo the weighting of the events!
+		for (size_t i = 0; i < eventBins.size(); ++i) {
+			ampIntegralAccumulator& accumulator = accumulators[eventBins[i]];
+			if (accumulator.nmbWaves() == 0)
+				accumulator.reset(nmbWaves);
+			accumulator.addEvent(eventAmps.data(), nmbSubAmps, weight);
+		}
+	}
+	eventTree->ResetBranchAddresses();
+
+	// copy values from accumulators and (if necessary) renormalize to
+	// integral of importance sampling weights
+	integrals.assign(bins.size(), ampIntegralMatrix());
+	for (size_t iBin = 0; iBin < bins.size(); ++iBin) {
+		ampIntegralMatrix&      integral    = integrals[iBin];
+		ampIntegralAccumulator& accumulator = accumulators[iBin];
+		integral.setWaveNames(waveNames);
+		accumulator.flush();
+		integral._nmbEvents = accumulator.nmbEvents();
+		if (accumulator.nmbEvents() == 0)
+			continue;
+		const double weightNorm = accumulator.weightSum() / (double)accumulator.nmbEvents();
+		accumulator.fillMatrix(integral._integrals, useWeight ? 1 / weightNorm : 1);
+	}
+
+	printSucc << "calculated integrals of " << nmbWaves << " amplitude(s) "
+	          << "for " << bins.size() << " bins from " << nmbEvents << " events" << endl;
+	return true;
+}
+
 void
 ampIntegralMatrix::renormalize(const unsigned long nmbEventsRenorm)
 {
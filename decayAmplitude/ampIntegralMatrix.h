@@ -125,9 +125,27 @@ namespace rpwa {
 		bool addEvent(std::map<std::string, std::complex<double> > &amplitudes);
 		bool integrate(const std::vector<const rpwa::amplitudeMetadata*>&       ampMetadata,
 		               const long                                               maxNmbEvents   = 0,
-		               const std::string&                                       weightFileName = "",
+		               const std::string&                                       weightFileName = "",  ///< label of the weight column of the event file or name of a weight file (see eventWeights)
 		               const rpwa::eventMetadata*                               eventMeta      = 0,
-		               const std::map<std::string, std::pair<double, double> >& otfBin         = std::map<std::string, std::pair<double, double> >());
+		               const std::map<std::string, std::pair<double, double> >& otfBin         = std::map<std::string, std::pair<double, double> >(),
+		               const std::string&                                       binIndexDirectory = "",   ///< if binIndexDirectory is not empty, the events in otfBin are selected with the bin index of the event file instead of a scan
+		               const unsigned int                                       nmbThreads     = 0);  ///< number of threads for the update of the matrix elements (0 = number of threads given by the OpenMP runtime)
+
+		// calculates the integral matrices of many kinematic bins with a
+		// single pass over the events; integrals[i] is set to the
+		// integral of the events in bins[i]. an event can contribute to
+		// several bins. in contrast to integrate() a weight text file has
+		// to contain the weight of every event of the event file. each bin
+		// is summed by its own ampIntegralAccumulator as in integrate(),
+		// which updates the matrix elements with nmbThreads threads
+		// (0 = number of threads given by the OpenMP runtime).
+		static bool integrateBins(std::vector<rpwa::ampIntegralMatrix>&                                 integrals,
+		                          const std::vector<const rpwa::amplitudeMetadata*>&                     ampMetadata,
+		                          const rpwa::eventMetadata&                                             eventMeta,
+		                          const std::vector<std::map<std::string, std::pair<double, double> > >& bins,
+		                          const long                                                             maxNmbEvents   = 0,
+		                          const std::string&                                                     weightFileName = "",
+		                          const unsigned int                                                     nmbThreads     = 0);
 
 		void renormalize(const unsigned long nmbEventsRenorm);
 
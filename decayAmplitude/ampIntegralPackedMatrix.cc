@@ -0,0 +1,375 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      read-only, memory-mapped integral matrix that stores only the
+//      upper triangle of the Hermitian matrix
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TFile.h"
+
+#include "reportingUtils.hpp"
+#include "fileUtils.hpp"
+#include "ampIntegralMatrix.h"
+#include "ampIntegralMatrixMetadata.h"
+#include "ampIntegralPackedMatrix.h"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+namespace {
+
+	// layout of the beginning of the header; the wave names follow the
+	// header as null-terminated strings, the matrix elements start at
+	// elementsOffset
+	struct packedFileHeader {
+		char     magic[8];
+		uint32_t version;
+		uint32_t elementSize;
+		uint32_t nmbWaves;
+		uint32_t padding;
+		uint64_t nmbEvents;
+		uint64_t waveNamesSize;
+		uint64_t elementsOffset;
+		char     integralContentHash[33];  // content hash of the integral file the packed file was written from
+	};
+
+	const char     packedFileMagic[8] = {'R', 'P', 'W', 'A', 'I', 'N', 'T', 'P'};
+	const uint32_t packedFileVersion  = 2;
+
+
+	bool
+	readPackedFileHeader(const string&     fileName,
+	                     packedFileHeader& header)
+	{
+		FILE* inFile = fopen(fileName.c_str(), "rb");
+		if (not inFile)
+			return false;
+		const bool success = (fread(&header, 1, sizeof(header), inFile) == sizeof(header));
+		fclose(inFile);
+		return success and memcmp(header.magic, packedFileMagic, sizeof(packedFileMagic)) == 0;
+	}
+
+
+	// returns the content hash of the integral in an integral file; only
+	// the metadata object is read, the integral matrix is not
+	string
+	integralFileContentHash(const string& integralFileName)
+	{
+		TFile* integralFile = TFile::Open(integralFileName.c_str(), "READ");
+		if (not integralFile or integralFile->IsZombie()) {
+			delete integralFile;
+			return "";
+		}
+		string contentHash = "";
+		const ampIntegralMatrixMetadata* integralMeta
+			= (const ampIntegralMatrixMetadata*)integralFile->Get(ampIntegralMatrixMetadata::objectNameInFile.c_str());
+		if (integralMeta) {
+			contentHash = integralMeta->contentHash();
+			delete integralMeta;
+		}
+		integralFile->Close();
+		delete integralFile;
+		return contentHash;
+	}
+
+}
+
+
+// multiple of the page size on all relevant platforms, so that the
+// matrix elements are page-aligned in the mapped file
+const size_t ampIntegralPackedMatrix::pageSize = 4096;
+
+
+ampIntegralPackedMatrix::ampIntegralPackedMatrix()
+	: _mappedData(0),
+	  _mappedSize(0),
+	  _elements  (0),
+	  _nmbWaves  (0),
+	  _nmbEvents (0)
+{ }
+
+
+ampIntegralPackedMatrix::~ampIntegralPackedMatrix()
+{
+	close();
+}
+
+
+bool
+ampIntegralPackedMatrix::open(const string& fileName)
+{
+	close();
+	const int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		printWarn << "could not open packed integral file '" << fileName << "': " << strerror(errno) << endl;
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 or (size_t)fileStat.st_size < sizeof(packedFileHeader)) {
+		printWarn << "packed integral file '" << fileName << "' is too small." << endl;
+		::close(fd);
+		return false;
+	}
+	const size_t mappedSize = fileStat.st_size;
+	void* mappedData = mmap(0, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+	// the mapping stays valid after the file descriptor is closed
+	::close(fd);
+	if (mappedData == MAP_FAILED) {
+		printWarn << "could not map packed integral file '" << fileName << "': " << strerror(errno) << endl;
+		return false;
+	}
+
+	const packedFileHeader* header = (const packedFileHeader*)mappedData;
+	const size_t nmbElements = (size_t)header->nmbWaves * (header->nmbWaves + 1) / 2;
+	string errorMessage = "";
+	if (memcmp(header->magic, packedFileMagic, sizeof(packedFileMagic)) != 0)
+		errorMessage = "is not a packed integral file";
+	else if (header->version != packedFileVersion or header->elementSize != sizeof(complex<double>))
+		errorMessage = "has an unsupported format";
+	else if (header->elementsOffset % pageSize != 0
+	         or header->elementsOffset < sizeof(packedFileHeader) + header->waveNamesSize
+	         or mappedSize != header->elementsOffset + nmbElements * sizeof(complex<double>))
+		errorMessage = "has an inconsistent size";
+	if (errorMessage == "") {
+		// wave names are separated by null characters
+		const char* waveName    = (const char*)mappedData + sizeof(packedFileHeader);
+		const char* waveNameEnd = waveName + header->waveNamesSize;
+		while (waveName < waveNameEnd and _waveNames.size() < header->nmbWaves) {
+			const size_t length = strnlen(waveName, waveNameEnd - waveName);
+			_waveNames.push_back(string(waveName, length));
+			waveName += length + 1;
+		}
+		if (_waveNames.size() != header->nmbWaves)
+			errorMessage = "contains the wrong number of wave names";
+	}
+	if (errorMessage != "") {
+		printWarn << "packed integral file '" << fileName << "' " << errorMessage << "." << endl;
+		munmap(mappedData, mappedSize);
+		_waveNames.clear();
+		return false;
+	}
+
+	for (unsigned int i = 0; i < _waveNames.size(); ++i)
+		_waveNameToIndexMap[_waveNames[i]] = i;
+	_mappedData = mappedData;
+	_mappedSize = mappedSize;
+	_elements   = (const complex<double>*)((const char*)mappedData + header->elementsOffset);
+	_nmbWaves   = header->nmbWaves;
+	_nmbEvents  = header->nmbEvents;
+	_integralContentHash = string(header->integralContentHash, strnlen(header->integralContentHash, sizeof(header->integralContentHash)));
+	return true;
+}
+
+
+void
+ampIntegralPackedMatrix::close()
+{
+	if (_mappedData)
+		munmap(_mappedData, _mappedSize);
+	_mappedData = 0;
+	_mappedSize = 0;
+	_elements   = 0;
+	_nmbWaves   = 0;
+	_nmbEvents  = 0;
+	_integralContentHash = "";
+	_waveNames.clear();
+	_waveNameToIndexMap.clear();
+}
+
+
+bool
+ampIntegralPackedMatrix::containsWave(const string& waveName) const
+{
+	return _waveNameToIndexMap.find(waveName) != _waveNameToIndexMap.end();
+}
+
+
+unsigned int
+ampIntegralPackedMatrix::waveIndex(const string& waveName) const
+{
+	map<string, unsigned int>::const_iterator entry = _waveNameToIndexMap.find(waveName);
+	if (entry == _waveNameToIndexMap.end()) {
+		printErr << "cannot find wave '" << waveName << "' in packed integral matrix. Aborting..." << endl;
+		throw;
+	}
+	return entry->second;
+}
+
+
+complex<double>
+ampIntegralPackedMatrix::element(const unsigned int waveIndexI,
+                                 const unsigned int waveIndexJ) const
+{
+	if (waveIndexI >= _nmbWaves or waveIndexJ >= _nmbWaves) {
+		printErr << "wave index pair (" << waveIndexI << ", " << waveIndexJ << ") out of range. "
+		         << "number of waves = " << _nmbWaves << endl;
+		throw;
+	}
+	if (waveIndexJ < waveIndexI)
+		return conj(upperElement(waveIndexJ, waveIndexI)) / ((double)_nmbEvents);
+	return upperElement(waveIndexI, waveIndexJ) / ((double)_nmbEvents);
+}
+
+
+bool
+ampIntegralPackedMatrix::getIntegralMatrix(ampIntegralMatrix& integral) const
+{
+	if (not isOpen()) {
+		printWarn << "packed integral matrix is not open." << endl;
+		return false;
+	}
+	integral.clear();
+	if (not integral.setWaveNames(_waveNames))
+		return false;
+	ampIntegralMatrix::integralMatrixType& matrix = integral.matrix();
+	for (unsigned int i = 0; i < _nmbWaves; ++i)
+		for (unsigned int j = i; j < _nmbWaves; ++j) {
+			matrix[i][j] = upperElement(i, j);
+			if (j != i)
+				matrix[j][i] = conj(matrix[i][j]);
+		}
+	integral.setNmbEvents(_nmbEvents);
+	return true;
+}
+
+
+bool
+ampIntegralPackedMatrix::write(const string&                    fileName,
+                               const ampIntegralMatrixMetadata& integralMeta)
+{
+	const ampIntegralMatrix* integral = integralMeta.getAmpIntegralMatrix();
+	if (not integral) {
+		printWarn << "integral metadata does not contain an integral matrix." << endl;
+		return false;
+	}
+	if (integralMeta.contentHash().size() >= sizeof(packedFileHeader().integralContentHash)) {
+		printWarn << "content hash '" << integralMeta.contentHash() << "' of integral is too long." << endl;
+		return false;
+	}
+	const unsigned int nmbWaves = integral->nmbWaves();
+	string waveNames = "";
+	for (unsigned int i = 0; i < nmbWaves; ++i) {
+		waveNames += integral->waveName(i);
+		waveNames += '\0';
+	}
+	const size_t elementsOffset = (sizeof(packedFileHeader) + waveNames.size() + pageSize - 1) / pageSize * pageSize;
+
+	const string tmpName = temporaryFileName(fileName);
+	FILE* outFile = fopen(tmpName.c_str(), "wb");
+	if (not outFile) {
+		printWarn << "could not open '" << tmpName << "' for writing: " << strerror(errno) << endl;
+		return false;
+	}
+
+	vector<char> headerBuffer(elementsOffset, 0);
+	packedFileHeader* header = (packedFileHeader*)headerBuffer.data();
+	memcpy(header->magic, packedFileMagic, sizeof(packedFileMagic));
+	header->version        = packedFileVersion;
+	header->elementSize    = sizeof(complex<double>);
+	header->nmbWaves       = nmbWaves;
+	header->nmbEvents      = integral->nmbEvents();
+	header->waveNamesSize  = waveNames.size();
+	header->elementsOffset = elementsOffset;
+	strncpy(header->integralContentHash, integralMeta.contentHash().c_str(), sizeof(header->integralContentHash) - 1);
+	memcpy(headerBuffer.data() + sizeof(packedFileHeader), waveNames.data(), waveNames.size());
+	bool success = (fwrite(headerBuffer.data(), 1, elementsOffset, outFile) == elementsOffset);
+
+	// the rows of the upper triangle are written one by one
+	const ampIntegralMatrix::integralMatrixType& matrix = integral->matrix();
+	for (unsigned int i = 0; success and i < nmbWaves; ++i)
+		success = (fwrite(&matrix[i][i], sizeof(complex<double>), nmbWaves - i, outFile) == nmbWaves - i);
+	if (fclose(outFile) != 0)
+		success = false;
+	if (not success) {
+		printWarn << "could not write packed integral file '" << tmpName << "'." << endl;
+		remove(tmpName.c_str());
+		return false;
+	}
+	if (rename(tmpName.c_str(), fileName.c_str()) != 0) {
+		printWarn << "could not rename '" << tmpName << "' to '" << fileName << "': " << strerror(errno) << endl;
+		remove(tmpName.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+bool
+ampIntegralPackedMatrix::isPackedFile(const string& fileName)
+{
+	FILE* inFile = fopen(fileName.c_str(), "rb");
+	if (not inFile)
+		return false;
+	char magic[sizeof(packedFileMagic)];
+	const bool isPacked = (fread(magic, 1, sizeof(magic), inFile) == sizeof(magic)
+	                       and memcmp(magic, packedFileMagic, sizeof(packedFileMagic)) == 0);
+	fclose(inFile);
+	return isPacked;
+}
+
+
+string
+ampIntegralPackedMatrix::packedFileName(const string& integralFileName)
+{
+	return changeFileExtension(integralFileName, ".packed");
+}
+
+
+string
+ampIntegralPackedMatrix::findPackedFile(const string& integralFileName)
+{
+	if (isPackedFile(integralFileName))
+		return integralFileName;
+	const string packedName = packedFileName(integralFileName);
+	packedFileHeader header;
+	if (access(packedName.c_str(), R_OK) != 0 or not readPackedFileHeader(packedName, header))
+		return "";
+	// modification times are not reliable enough to decide whether the
+	// packed file still belongs to the integral file, e.g. after files
+	// were copied, so the content hashes are compared
+	const string packedHash   = (header.version == packedFileVersion)
+	                            ? string(header.integralContentHash, strnlen(header.integralContentHash, sizeof(header.integralContentHash)))
+	                            : "";
+	const string integralHash = integralFileContentHash(integralFileName);
+	if (packedHash == "" or packedHash != integralHash) {
+		printWarn << "packed integral file '" << packedName << "' does not belong to the content of "
+		          << "integral file '" << integralFileName << "'. ignoring it." << endl;
+		return "";
+	}
+	return packedName;
+}
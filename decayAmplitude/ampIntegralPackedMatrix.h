@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      read-only, memory-mapped integral matrix that stores only the
+//      upper triangle of the Hermitian matrix
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef AMPINTEGRALPACKEDMATRIX_H
+#define AMPINTEGRALPACKEDMATRIX_H
+
+
+#include <complex>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace rpwa {
+
+
+	class ampIntegralMatrix;
+	class ampIntegralMatrixMetadata;
+
+
+	// the packed integral file consists of a header, the wave names and
+	// the upper triangle of the integral matrix as plain
+	// complex<double> in row-major order, i.e. the elements (i, j) with
+	// j >= i. the matrix elements start at a page boundary, so that they
+	// are used directly from the mapped file without a copy; the file
+	// is mapped read-only and shared, so concurrent processes on one
+	// node use the same pages of the page cache. like
+	// ampIntegralMatrix the file holds the unnormalized sums, element()
+	// divides them by the number of events. wave descriptions are not
+	// stored. the header contains the content hash of the integral file
+	// the packed file was written from, which is used to decide whether
+	// the packed file still belongs to the integral file.
+	class ampIntegralPackedMatrix {
+
+	public:
+
+		ampIntegralPackedMatrix();
+		~ampIntegralPackedMatrix();
+
+		bool open(const std::string& fileName);  ///< maps the packed integral file
+		void close();
+
+		bool          isOpen   () const { return _elements != 0;  }
+		unsigned int  nmbWaves () const { return _nmbWaves;       }  ///< returns number of waves in integral
+		unsigned long nmbEvents() const { return _nmbEvents;      }  ///< returns number of events in integral
+
+		const std::string& integralContentHash() const { return _integralContentHash; }  ///< returns content hash of the integral file the packed file was written from
+
+		const std::vector<std::string>& waveNames() const { return _waveNames; }
+		bool         containsWave(const std::string& waveName) const;  ///< returns whether wave is in integral matrix
+		unsigned int waveIndex   (const std::string& waveName) const;  ///< returns wave index for a wave name
+
+		/// returns the unnormalized sum of element (i, j) with j >= i
+		const std::complex<double>& upperElement(const unsigned int waveIndexI,
+		                                         const unsigned int waveIndexJ) const
+		{ return _elements[packedIndex(waveIndexI, waveIndexJ, _nmbWaves)]; }
+
+		/// returns integral matrix element divided by number of events defined by index pair
+		std::complex<double> element(const unsigned int waveIndexI,
+		                             const unsigned int waveIndexJ) const;
+		/// returns integral matrix element divided by number of events defined by pair of wave names
+		std::complex<double> element(const std::string& waveNameI,
+		                             const std::string& waveNameJ) const
+		{ return element(waveIndex(waveNameI), waveIndex(waveNameJ)); }
+
+		const std::complex<double>* elements() const { return _elements; }  ///< returns the packed upper triangle
+
+		bool getIntegralMatrix(rpwa::ampIntegralMatrix& integral) const;  ///< fills both triangles of a full integral matrix
+
+		// writes the upper triangle of the integral matrix of an integral
+		// file together with its content hash to a packed integral file;
+		// the file is written under a temporary name first and then
+		// renamed
+		static bool write(const std::string&                     fileName,
+		                  const rpwa::ampIntegralMatrixMetadata& integralMeta);
+
+		static bool isPackedFile(const std::string& fileName);  ///< checks the magic number of the file
+
+		/// name of the packed file that belongs to an integral file (same path with extension '.packed')
+		static std::string packedFileName(const std::string& integralFileName);
+		/// returns integralFileName if it is a packed file, its packed file if that was written from the same content as the integral file, or "" otherwise; only the metadata of the integral file is read for the check
+		static std::string findPackedFile(const std::string& integralFileName);
+
+		/// index of element (i, j) with j >= i in the packed upper triangle
+		static std::size_t packedIndex(const unsigned int waveIndexI,
+		                               const unsigned int waveIndexJ,
+		                               const unsigned int nmbWaves)
+		{ return (std::size_t)waveIndexI * (2 * nmbWaves - waveIndexI + 1) / 2 + (waveIndexJ - waveIndexI); }
+
+		static const std::size_t pageSize;
+
+	private:
+
+		ampIntegralPackedMatrix(const ampIntegralPackedMatrix&);
+		ampIntegralPackedMatrix& operator =(const ampIntegralPackedMatrix&);
+
+		void*                               _mappedData;
+		std::size_t                         _mappedSize;
+		const std::complex<double>*         _elements;
+		unsigned int                        _nmbWaves;
+		unsigned long                       _nmbEvents;
+		std::string                         _integralContentHash;
+		std::vector<std::string>            _waveNames;
+		std::map<std::string, unsigned int> _waveNameToIndexMap;
+
+	};
+
+
+}  // namespace rpwa
+
+
+#endif  // AMPINTEGRALPACKEDMATRIX_H
@@ -0,0 +1,505 @@
+
+#include "ampIntegralShard.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <unistd.h>
+
+#include <boost/progress.hpp>
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include "ampIntegralAccumulator.h"
+#include "ampIntegralMatrix.h"
+#include "ampIntegralMatrixMetadata.h"
+#include "amplitudeMetadata.h"
+#include "amplitudeTreeLeaf.h"
+#include "eventWeights.h"
+#include "fileUtils.hpp"
+#include "reportingUtils.hpp"
+
+using namespace rpwa;
+using namespace std;
+
+
+const std::string rpwa::ampIntegralShard::objectNameInFile = "integralShard";
+
+
+rpwa::ampIntegralShard::ampIntegralShard()
+	: _waveNames(),
+	  _keyFileContents(),
+	  _amplitudeHashes(),
+	  _binningMap(),
+	  _evtMetas(),
+	  _rangeContentHashes(),
+	  _rangeFirstEvents(),
+	  _rangeLastEvents(),
+	  _useWeights(false),
+	  _nmbEvents(0),
+	  _weightSum(0),
+	  _weightSumCompensation(0),
+	  _packedSums() { }
+
+
+rpwa::ampIntegralShard::~ampIntegralShard() { }
+
+
+Long64_t rpwa::ampIntegralShard::nmbEventsVisited() const
+{
+	Long64_t nmbEventsVisited = 0;
+	for(size_t i = 0; i < _rangeFirstEvents.size(); ++i) {
+		nmbEventsVisited += _rangeLastEvents[i] - _rangeFirstEvents[i];
+	}
+	return nmbEventsVisited;
+}
+
+
+bool rpwa::ampIntegralShard::integrate(const vector<const amplitudeMetadata*>&   ampMetadata,
+                                       const eventMetadata&                      eventMeta,
+                                       const long                                firstEvent,
+                                       const long                                lastEvent,
+                                       const string&                             weightFileName,
+                                       const map<string, pair<double, double> >& otfBin,
+                                       const string&                             checkpointFileName,
+                                       const long                                checkpointInterval,
+                                       const unsigned int                        nmbThreads)
+{
+	if(ampMetadata.empty()) {
+		printWarn << "did not receive any amplitudes. cannot calculate integral." << endl;
+		return false;
+	}
+	TTree* eventTree = eventMeta.eventTree();
+	if(not eventTree) {
+		printErr << "event tree not found in metadata." << endl;
+		return false;
+	}
+	const long nmbEventsInFile = eventTree->GetEntries();
+	for(size_t waveIndex = 0; waveIndex < ampMetadata.size(); ++waveIndex) {
+		if(ampMetadata[waveIndex]->nmbAmplitudes() != nmbEventsInFile) {
+			printErr << "event number mismatch between amplitudes of wave '" << ampMetadata[waveIndex]->objectBaseName() << "' "
+			         << "and data file (" << ampMetadata[waveIndex]->nmbAmplitudes() << " != " << nmbEventsInFile << ")." << endl;
+			return false;
+		}
+	}
+	const long endEvent = (lastEvent < 0) ? nmbEventsInFile : min(lastEvent, nmbEventsInFile);
+	if(firstEvent < 0 or firstEvent > endEvent) {
+		printErr << "invalid event range [" << firstEvent << ", " << endEvent << ")." << endl;
+		return false;
+	}
+
+	// set up an empty shard and replace it by the checkpoint if it
+	// belongs to the same integration
+	ampIntegralShard shard;
+	for(size_t waveIndex = 0; waveIndex < ampMetadata.size(); ++waveIndex) {
+		shard._waveNames.push_back(ampMetadata[waveIndex]->objectBaseName());
+		shard._keyFileContents.push_back(ampMetadata[waveIndex]->keyfileContent());
+		shard._amplitudeHashes.push_back(ampMetadata[waveIndex]->contentHash());
+	}
+	shard._binningMap = otfBin;
+	shard._evtMetas.push_back(eventMeta);
+	shard._rangeContentHashes.push_back(eventMeta.contentHash());
+	shard._rangeFirstEvents.push_back(firstEvent);
+	shard._rangeLastEvents.push_back(firstEvent);
+	shard._useWeights = (weightFileName != "");
+	*this = shard;
+	if(checkpointFileName != "" and access(checkpointFileName.c_str(), R_OK) == 0) {
+		const ampIntegralShard* checkpoint = readShardFile(checkpointFileName, true);
+		if(checkpoint and checkpoint->isCheckpointOf(shard) and checkpoint->_rangeLastEvents[0] <= endEvent) {
+			*this = *checkpoint;
+			printInfo << "continuing integration from checkpoint in '" << checkpointFileName << "' "
+			          << "at event " << _rangeLastEvents[0] << "." << endl;
+		} else {
+			printWarn << "ignoring checkpoint file '" << checkpointFileName << "', "
+			          << "which does not belong to this integration." << endl;
+		}
+		delete checkpoint;
+	}
+	const long startEvent = _rangeLastEvents[0];
+
+	const unsigned int nmbWaves = _waveNames.size();
+	ampIntegralAccumulator accumulator(nmbWaves, ampIntegralAccumulator::defaultBlockSize, nmbThreads);
+	if(not _packedSums.empty() and not accumulator.setPackedSums(_packedSums, _nmbEvents, _weightSum, _weightSumCompensation)) {
+		printErr << "sums of checkpoint do not match number of waves." << endl;
+		return false;
+	}
+
+	// the weights of all events are read at once
+	vector<double> weights;
+	if(_useWeights) {
+		if(not eventWeights::readWeights(weightFileName, eventMeta, weights)) {
+			printErr << "cannot read importance sampling weights from '" << weightFileName << "'." << endl;
+			return false;
+		}
+		if((long)weights.size() < endEvent) {
+			printErr << "too few importance sampling weights (" << weights.size() << " < " << endEvent << ")." << endl;
+			return false;
+		}
+	}
+
+	// only the binning variables are read from the event tree
+	vector<double>                binningVariables(otfBin.size());
+	vector<TBranch*>              binningBranches (otfBin.size(), 0);
+	vector<pair<double, double> > bounds;
+	for(map<string, pair<double, double> >::const_iterator elem = otfBin.begin(); elem != otfBin.end(); ++elem) {
+		const size_t binVarIndex = bounds.size();
+		const int err = eventTree->SetBranchAddress(elem->first.c_str(), &binningVariables[binVarIndex], &binningBranches[binVarIndex]);
+		if(err < 0 or not binningBranches[binVarIndex]) {
+			printErr << "could not set branch address for branch '" << elem->first << "' (error code " << err << ")." << endl;
+			eventTree->ResetBranchAddresses();
+			return false;
+		}
+		bounds.push_back(elem->second);
+	}
+
+	const unsigned long ampBlockSize = amplitudeMetadata::defaultChunkSize;
+	vector<amplitudeTreeLeaf*> ampTreeLeafs(nmbWaves, NULL);
+	vector<vector<complex<double> > > ampBlocks(nmbWaves);
+	for(unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+		if(ampMetadata[waveIndex]->columnar()) {
+			ampBlocks[waveIndex].resize(ampBlockSize);
+		} else {
+			ampMetadata[waveIndex]->amplitudeTree()->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeafs[waveIndex]);
+		}
+	}
+
+	printInfo << "calculating partial integral of " << nmbWaves << " amplitude(s) "
+	          << "for events [" << startEvent << ", " << endEvent << ")." << endl;
+	vector<complex<double> > eventAmps;  // [sub-amplitude index * nmbWaves + wave index]
+	boost::progress_display progressIndicator(endEvent - startEvent, cout, "");
+	bool success        = true;
+	long lastCheckpoint = startEvent;
+	for(long iEvent = startEvent; iEvent < endEvent; ++iEvent) {
+		++progressIndicator;
+		const unsigned long indexInBlock = (iEvent - startEvent) % ampBlockSize;
+		if(indexInBlock == 0) {
+			const unsigned long nmbInBlock = min(ampBlockSize, (unsigned long)(endEvent - iEvent));
+			for(unsigned int waveIndex = 0; waveIndex < nmbWaves and success; ++waveIndex) {
+				if(ampMetadata[waveIndex]->columnar() and not ampMetadata[waveIndex]->readAmplitudes(iEvent, nmbInBlock, ampBlocks[waveIndex].data())) {
+					printErr << "error reading amplitudes for wave '" << _waveNames[waveIndex] << "' at event " << iEvent << "." << endl;
+					success = false;
+				}
+			}
+			if(not success) {
+				break;
+			}
+		}
+
+		bool veto = false;
+		if(not bounds.empty()) {
+			const Long64_t treeEntry = eventTree->LoadTree(iEvent);
+			for(size_t binVarIndex = 0; binVarIndex < bounds.size(); ++binVarIndex) {
+				binningBranches[binVarIndex]->GetEntry(treeEntry);
+				if(binningVariables[binVarIndex] < bounds[binVarIndex].first or binningVariables[binVarIndex] >= bounds[binVarIndex].second) {
+					veto = true;
+					break;
+				}
+			}
+		}
+
+		if(not veto) {
+			unsigned int nmbSubAmps = 0;
+			for(unsigned int waveIndex = 0; waveIndex < nmbWaves and success; ++waveIndex) {
+				unsigned int nmbWaveSubAmps = 1;
+				if(not ampMetadata[waveIndex]->columnar()) {
+					ampMetadata[waveIndex]->amplitudeTree()->GetEntry(iEvent);
+					nmbWaveSubAmps = ampTreeLeafs[waveIndex]->nmbIncohSubAmps();
+				}
+				if(waveIndex == 0) {
+					nmbSubAmps = nmbWaveSubAmps;
+					eventAmps.resize(nmbSubAmps * nmbWaves);
+				}
+				if(nmbWaveSubAmps < 1 or nmbWaveSubAmps != nmbSubAmps) {
+					printErr << "number of incoherent sub-amplitudes for wave '" << _waveNames[waveIndex] << "' "
+					         << "is zero or differs from that of the other waves at event " << iEvent << "." << endl;
+					success = false;
+					break;
+				}
+				if(ampMetadata[waveIndex]->columnar()) {
+					eventAmps[waveIndex] = ampBlocks[waveIndex][indexInBlock];
+				} else {
+					for(unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex) {
+						eventAmps[subAmpIndex * nmbWaves + waveIndex] = ampTreeLeafs[waveIndex]->incohSubAmp(subAmpIndex);
+					}
+				}
+			}
+			if(not success) {
+				break;
+			}
+			accumulator.addEvent(eventAmps.data(), nmbSubAmps, _useWeights ? 1 / weights[iEvent] : 1);  // we have to undo the weighting of the events!
+		}
+
+		if(checkpointFileName != "" and checkpointInterval > 0 and iEvent + 1 - lastCheckpoint >= checkpointInterval and iEvent + 1 < endEvent) {
+			accumulator.flush();
+			_packedSums            = accumulator.packedSums();
+			_nmbEvents             = accumulator.nmbEvents();
+			_weightSum             = accumulator.weightSum();
+			_weightSumCompensation = accumulator.weightSumCompensation();
+			_rangeLastEvents[0]    = iEvent + 1;
+			if(not writeToFile(checkpointFileName)) {
+				printWarn << "could not write checkpoint to '" << checkpointFileName << "'." << endl;
+			}
+			lastCheckpoint = iEvent + 1;
+		}
+	}
+	eventTree->ResetBranchAddresses();
+	for(unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+		if(not ampMetadata[waveIndex]->columnar()) {
+			ampMetadata[waveIndex]->amplitudeTree()->ResetBranchAddresses();
+		}
+	}
+	if(not success) {
+		return false;
+	}
+
+	accumulator.flush();
+	_packedSums            = accumulator.packedSums();
+	_nmbEvents             = accumulator.nmbEvents();
+	_weightSum             = accumulator.weightSum();
+	_weightSumCompensation = accumulator.weightSumCompensation();
+	_rangeLastEvents[0]    = endEvent;
+	printSucc << "calculated partial integral of " << nmbWaves << " amplitude(s) "
+	          << "for " << _nmbEvents << " events." << endl;
+	return true;
+}
+
+
+bool rpwa::ampIntegralShard::merge(const ampIntegralShard& shard)
+{
+	if(shard._waveNames != _waveNames) {
+		printErr << "cannot merge shards with different waves." << endl;
+		return false;
+	}
+	if(shard._binningMap != _binningMap) {
+		printErr << "cannot merge shards of different bins." << endl;
+		return false;
+	}
+	if(shard._useWeights != _useWeights) {
+		printErr << "cannot merge weighted and unweighted shards." << endl;
+		return false;
+	}
+	for(size_t i = 0; i < shard._keyFileContents.size(); ++i) {
+		if(find(_keyFileContents.begin(), _keyFileContents.end(), shard._keyFileContents[i]) == _keyFileContents.end()) {
+			printErr << "mismatch in keyfiles." << endl;
+			return false;
+		}
+	}
+	if(rangesOverlap(shard)) {
+		printErr << "cannot merge shards with overlapping event ranges." << endl;
+		return false;
+	}
+
+	const unsigned int nmbWaves = _waveNames.size();
+	ampIntegralAccumulator accumulator     (nmbWaves);
+	ampIntegralAccumulator shardAccumulator(nmbWaves);
+	if(not accumulator.setPackedSums(_packedSums, _nmbEvents, _weightSum, _weightSumCompensation)
+	   or not shardAccumulator.setPackedSums(shard._packedSums, shard._nmbEvents, shard._weightSum, shard._weightSumCompensation)
+	   or not accumulator.merge(shardAccumulator))
+	{
+		printErr << "could not merge sums of shards." << endl;
+		return false;
+	}
+	_packedSums            = accumulator.packedSums();
+	_nmbEvents             = accumulator.nmbEvents();
+	_weightSum             = accumulator.weightSum();
+	_weightSumCompensation = accumulator.weightSumCompensation();
+
+	for(size_t i = 0; i < shard._amplitudeHashes.size(); ++i) {
+		if(find(_amplitudeHashes.begin(), _amplitudeHashes.end(), shard._amplitudeHashes[i]) == _amplitudeHashes.end()) {
+			_amplitudeHashes.push_back(shard._amplitudeHashes[i]);
+		}
+	}
+	for(size_t i = 0; i < shard._evtMetas.size(); ++i) {
+		if(find(_evtMetas.begin(), _evtMetas.end(), shard._evtMetas[i]) == _evtMetas.end()) {
+			_evtMetas.push_back(shard._evtMetas[i]);
+		}
+	}
+	_rangeContentHashes.insert(_rangeContentHashes.end(), shard._rangeContentHashes.begin(), shard._rangeContentHashes.end());
+	_rangeFirstEvents.insert  (_rangeFirstEvents.end(),   shard._rangeFirstEvents.begin(),   shard._rangeFirstEvents.end()  );
+	_rangeLastEvents.insert   (_rangeLastEvents.end(),    shard._rangeLastEvents.begin(),    shard._rangeLastEvents.end()   );
+	return true;
+}
+
+
+bool rpwa::ampIntegralShard::getIntegralMatrix(ampIntegralMatrix& integral) const
+{
+	if(_nmbEvents == 0) {
+		printWarn << "shard does not contain any events." << endl;
+		return false;
+	}
+	ampIntegralAccumulator accumulator(_waveNames.size());
+	if(not accumulator.setPackedSums(_packedSums, _nmbEvents, _weightSum, _weightSumCompensation)) {
+		return false;
+	}
+	integral.clear();
+	if(not integral.setWaveNames(_waveNames)) {
+		return false;
+	}
+	// renormalize to integral of importance sampling weights
+	const double weightNorm = _weightSum / (double)_nmbEvents;
+	accumulator.fillMatrix(integral.matrix(), _useWeights ? 1 / weightNorm : 1);
+	integral.setNmbEvents(_nmbEvents);
+	return true;
+}
+
+
+bool rpwa::ampIntegralShard::writeIntegralFile(const string& integralFileName) const
+{
+	ampIntegralMatrix integral;
+	if(not getIntegralMatrix(integral)) {
+		printErr << "could not get integral matrix from shard." << endl;
+		return false;
+	}
+	ampIntegralMatrixMetadata integralMeta;
+	integralMeta.setBinningMap(_binningMap);
+	for(size_t i = 0; i < _evtMetas.size(); ++i) {
+		if(not integralMeta.addEventMetadata(_evtMetas[i])) {
+			printErr << "could not add event metadata to integral metadata." << endl;
+			return false;
+		}
+	}
+	for(size_t i = 0; i < _keyFileContents.size(); ++i) {
+		integralMeta.addKeyFileContent(_keyFileContents[i]);
+	}
+	if(not integralMeta.setAmpIntegralMatrix(&integral)) {
+		printErr << "could not add the integral matrix to the metadata object." << endl;
+		return false;
+	}
+	for(size_t i = 0; i < _amplitudeHashes.size(); ++i) {
+		// not fatal, the same hash can appear twice for waves with
+		// constant amplitudes
+		if(not integralMeta.addAmplitudeHash(_amplitudeHashes[i])) {
+			printWarn << "could not add the amplitude hash." << endl;
+		}
+	}
+	TFile* outputFile = TFile::Open(integralFileName.c_str(), "NEW");
+	if(not outputFile or outputFile->IsZombie()) {
+		printErr << "cannot open output file '" << integralFileName << "'." << endl;
+		delete outputFile;
+		return false;
+	}
+	const bool success = integralMeta.writeToFile(outputFile);
+	outputFile->Close();
+	delete outputFile;
+	if(not success) {
+		printErr << "could not write integral objects to file '" << integralFileName << "'." << endl;
+	}
+	return success;
+}
+
+
+ostream& rpwa::ampIntegralShard::print(ostream& out) const
+{
+	out << "ampIntegralShard:" << endl
+	    << "    number of waves ..... " << _waveNames.size()            << endl
+	    << "    number of events .... " << _nmbEvents                   << endl
+	    << "    weighted ............ " << yesNo(_useWeights)          << endl;
+	if(_useWeights) {
+		out << "    sum of weights ...... " << _weightSum               << endl;
+	}
+	out << "    binning map";
+	if(_binningMap.empty()) {
+		out << " ......... " << "<empty>" << endl;
+	} else {
+		out << ": " << endl;
+		for(map<string, pair<double, double> >::const_iterator it = _binningMap.begin(); it != _binningMap.end(); ++it) {
+			out << "        variable '" << it->first << "' range " << it->second << endl;
+		}
+	}
+	out << "    event ranges:" << endl;
+	for(size_t i = 0; i < _rangeFirstEvents.size(); ++i) {
+		out << "        [" << _rangeFirstEvents[i] << ", " << _rangeLastEvents[i] << ") "
+		    << "of event file '" << _rangeContentHashes[i] << "'" << endl;
+	}
+	return out;
+}
+
+
+const ampIntegralShard* rpwa::ampIntegralShard::readShardFile(TFile* inputFile, const bool& quiet)
+{
+	ampIntegralShard* shard = (ampIntegralShard*)inputFile->Get(objectNameInFile.c_str());
+	if(not shard) {
+		if(not quiet) {
+			printWarn << "could not find integral shard '" << objectNameInFile << "'." << endl;
+		}
+		return 0;
+	}
+	const size_t nmbWaves = shard->_waveNames.size();
+	if(shard->_packedSums.size() != nmbWaves * (nmbWaves + 1) / 2 * 4
+	   or shard->_rangeFirstEvents.size() != shard->_rangeContentHashes.size()
+	   or shard->_rangeLastEvents.size()  != shard->_rangeContentHashes.size())
+	{
+		if(not quiet) {
+			printWarn << "integral shard is inconsistent." << endl;
+		}
+		delete shard;
+		return 0;
+	}
+	return shard;
+}
+
+
+const ampIntegralShard* rpwa::ampIntegralShard::readShardFile(const string& fileName, const bool& quiet)
+{
+	TFile* inputFile = TFile::Open(fileName.c_str(), "READ");
+	if(not inputFile or inputFile->IsZombie()) {
+		if(not quiet) {
+			printWarn << "could not open integral shard file '" << fileName << "'." << endl;
+		}
+		delete inputFile;
+		return 0;
+	}
+	const ampIntegralShard* shard = readShardFile(inputFile, quiet);
+	inputFile->Close();
+	delete inputFile;
+	return shard;
+}
+
+
+bool rpwa::ampIntegralShard::writeToFile(const string& fileName) const
+{
+	// a preempted job must never leave a partially written shard
+	const string tmpName = temporaryFileName(fileName);
+	TFile* outputFile = TFile::Open(tmpName.c_str(), "RECREATE");
+	if(not outputFile or outputFile->IsZombie()) {
+		printWarn << "could not open '" << tmpName << "' for writing." << endl;
+		delete outputFile;
+		return false;
+	}
+	const bool success = (Write(objectNameInFile.c_str()) > 0);
+	outputFile->Close();
+	delete outputFile;
+	if(not success or rename(tmpName.c_str(), fileName.c_str()) != 0) {
+		remove(tmpName.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+bool rpwa::ampIntegralShard::isCheckpointOf(const ampIntegralShard& shard) const
+{
+	return _waveNames          == shard._waveNames
+	   and _amplitudeHashes    == shard._amplitudeHashes
+	   and _binningMap         == shard._binningMap
+	   and _useWeights         == shard._useWeights
+	   and _rangeContentHashes == shard._rangeContentHashes
+	   and _rangeFirstEvents   == shard._rangeFirstEvents;
+}
+
+
+bool rpwa::ampIntegralShard::rangesOverlap(const ampIntegralShard& shard) const
+{
+	for(size_t i = 0; i < _rangeContentHashes.size(); ++i) {
+		for(size_t j = 0; j < shard._rangeContentHashes.size(); ++j) {
+			if(_rangeContentHashes[i] == shard._rangeContentHashes[j]
+			   and _rangeFirstEvents[i] < shard._rangeLastEvents[j]
+			   and shard._rangeFirstEvents[j] < _rangeLastEvents[i])
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
@@ -0,0 +1,125 @@
+#ifndef AMPINTEGRALSHARD_H
+#define AMPINTEGRALSHARD_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <TObject.h>
+
+#include "eventMetadata.h"
+
+class TFile;
+
+
+namespace rpwa {
+
+	class ampIntegralMatrix;
+	class amplitudeMetadata;
+
+	// partial integral matrix of a range of events
+	//
+	// in contrast to ampIntegralMatrix the shard keeps the unnormalized
+	// sums of the amplitude products together with the number of events
+	// and the sum of the importance sampling weights, so that shards of
+	// disjoint event ranges are merged exactly and the normalization to
+	// the weights is applied only once to the merged sums. the event
+	// ranges are recorded for each event file to reject overlapping
+	// shards. a shard is also used as checkpoint of a running
+	// integration: it is written periodically to a checkpoint file, and
+	// an integration of the same event range continues from the last
+	// checkpoint.
+	class ampIntegralShard : public TObject {
+
+	  public:
+
+		ampIntegralShard();
+		~ampIntegralShard();
+
+		const std::vector<std::string>&                          waveNames      () const { return _waveNames;       }
+		const std::vector<std::string>&                          keyFileContents() const { return _keyFileContents; }
+		const std::vector<std::string>&                          amplitudeHashes() const { return _amplitudeHashes; }
+		const std::map<std::string, std::pair<double, double> >& binningMap     () const { return _binningMap;      }
+		const std::vector<rpwa::eventMetadata>&                  evtMetas       () const { return _evtMetas;        }
+		bool                                                     useWeights     () const { return _useWeights;      }
+		unsigned long                                            nmbEvents      () const { return _nmbEvents;       }  ///< returns number of events in the bin
+		double                                                   weightSum      () const { return _weightSum;       }  ///< returns sum of the weights of the events in the bin
+		Long64_t                                                 nmbEventsVisited() const;                            ///< returns number of events in the event ranges
+
+		// calculates the partial integral of the events in [firstEvent,
+		// lastEvent) of the event file that are in otfBin (an empty bin
+		// contains all events). the weights are taken from a column of the
+		// event file or from a weight file (see eventWeights); in contrast
+		// to ampIntegralMatrix::integrate() a weight text file has to
+		// contain the weight of every event. if checkpointFileName
+		// is not empty, the shard is written to it every
+		// checkpointInterval events, and if it already contains a
+		// checkpoint of the same integration, the integration continues
+		// after the last event of the checkpoint.
+		bool integrate(const std::vector<const rpwa::amplitudeMetadata*>&       ampMetadata,
+		               const rpwa::eventMetadata&                               eventMeta,
+		               const long                                               firstEvent         = 0,
+		               const long                                               lastEvent          = -1,       // -1 = last event of the event file
+		               const std::string&                                       weightFileName     = "",
+		               const std::map<std::string, std::pair<double, double> >& otfBin             = std::map<std::string, std::pair<double, double> >(),
+		               const std::string&                                       checkpointFileName = "",
+		               const long                                               checkpointInterval = 1000000,
+		               const unsigned int                                       nmbThreads         = 0);
+
+		// adds the sums of a shard of the same waves and bin with
+		// event ranges that do not overlap with the ones of this shard
+		bool merge(const ampIntegralShard& shard);
+
+		// sets the integral matrix from the sums normalized to the
+		// weights of the events
+		bool getIntegralMatrix(rpwa::ampIntegralMatrix& integral) const;
+
+		// writes the integral matrix with its metadata to a new integral
+		// file in the format of the integrals calculated in one go
+		bool writeIntegralFile(const std::string& integralFileName) const;
+
+		std::ostream& print(std::ostream& out) const;
+
+		static const ampIntegralShard* readShardFile(TFile* inputFile, const bool& quiet = false);
+		static const ampIntegralShard* readShardFile(const std::string& fileName, const bool& quiet = false);
+		bool writeToFile(const std::string& fileName) const;  ///< writes to a temporary file, which is renamed when complete
+
+		static const std::string objectNameInFile;
+
+	  private:
+
+		bool isCheckpointOf(const ampIntegralShard& shard) const;  ///< checks whether this shard is a checkpoint of an integration set up like shard
+		bool rangesOverlap (const ampIntegralShard& shard) const;
+
+		std::vector<std::string>                          _waveNames;
+		std::vector<std::string>                          _keyFileContents;
+		std::vector<std::string>                          _amplitudeHashes;
+		std::map<std::string, std::pair<double, double> > _binningMap;
+		std::vector<rpwa::eventMetadata>                  _evtMetas;
+
+		std::vector<std::string>                          _rangeContentHashes;  // [range index] content hash of the event file
+		std::vector<Long64_t>                             _rangeFirstEvents;    // [range index] first event of the range
+		std::vector<Long64_t>                             _rangeLastEvents;     // [range index] event after the last event of the range
+
+		bool                                              _useWeights;
+		ULong64_t                                         _nmbEvents;
+		double                                            _weightSum;
+		double                                            _weightSumCompensation;  // compensation of the compensated sum of the weights, needed to merge shards without loss of precision
+		std::vector<double>                               _packedSums;  // upper triangle of the matrix in the packed layout of ampIntegralAccumulator
+
+		ClassDef(ampIntegralShard, 1);
+
+	}; // class ampIntegralShard
+
+
+	inline
+	std::ostream&
+	operator <<(std::ostream&           out,
+	            const ampIntegralShard& shard)
+	{
+		return shard.print(out);
+	}
+
+} // namespace rpwa
+
+#endif
@@ -151,7 +151,6 @@ decayTopology::doClone(const bool cloneFsParticles,
 	}
 	// looping over incoming particles of respective vertices and clone them
 	// this also clones dangling particles that have no associated edge
-	//!!! what about outgoing particles in production vertex other than X?
 	for (unsigned int i = 0; i < newVerts.size(); ++i) {
 		if (not topoClone->isProductionVertex(newVerts[i]) or cloneProdKinematics)
 			for (unsigned int j = 0; j < newVerts[i]->nmbInParticles(); ++j) {
@@ -170,6 +169,21 @@ decayTopology::doClone(const bool cloneFsParticles,
 				}
 			}
 	}
+	// outgoing particles of the production vertex other than X (e.g. the
+	// recoil) are dangling particles, whose Lorentz-vectors are set when
+	// the production kinematics is read
+	if (cloneProdKinematics and topoClone->productionVertex()) {
+		const productionVertexPtr& prodVert = topoClone->productionVertex();
+		for (unsigned int i = 0; i < prodVert->nmbOutParticles(); ++i) {
+			const particlePtr part = prodVert->outParticles()[i];
+			if (not topoClone->isEdge(part)) {
+				if (_debug)
+					printDebug << "cloning dangling " << *part << endl;
+				particlePtr newPart(part->clone());
+				prodVert->outParticles()[i] = newPart;
+			}
+		}
+	}
 	topoClone->name() = "topoClone";
 	return topoClone;
 }
@@ -681,6 +695,16 @@ decayTopology::initKinematicsData(const TClonesArray& prodKinPartNames,
 }
 
 
+int
+decayTopology::fsDataPartIndex(const unsigned int fsPartIndex) const
+{
+	map<unsigned int, unsigned int>::const_iterator entry = _fsDataPartIndexMap.find(fsPartIndex);
+	if (entry == _fsDataPartIndexMap.end())
+		return -1;
+	return entry->second;
+}
+
+
 bool
 decayTopology::readKinematicsData(const vector<TVector3>& prodKinMomentaVec,
                                   const vector<TVector3>& decayKinMomentaVec)
@@ -135,6 +135,8 @@ namespace rpwa {
 		bool initKinematicsData(const TClonesArray& prodKinParticles,
 		                        const TClonesArray& decayKinParticles);  ///< initializes input data
 
+		int fsDataPartIndex(const unsigned int fsPartIndex) const;  ///< returns index in input data array of final-state particle at given index; -1 means kinematics data were not initialized
+
 		bool readKinematicsData(const std::vector<TVector3>& prodKinMomenta,
 		                        const std::vector<TVector3>& decayKinMomenta);  ///< reads production and decay kinematics data and sets respective 4-momenta
 
@@ -33,12 +33,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <sstream>
 
 #include "TLorentzRotation.h"
 #include "TMath.h"
 
 #include "conversionUtils.hpp"
 #include "factorial.hpp"
+#include "physUtils.hpp"
+#include "dFunction.hpp"
 #include "isobarAmplitude.h"
 
 
@@ -56,7 +59,15 @@ isobarAmplitude::isobarAmplitude()
 	  _boseSymmetrize      (true),
 	  _isospinSymmetrize   (true),
 	  _doSpaceInversion    (false),
-	  _doReflection        (false)
+	  _doReflection        (false),
+	  _eventGjTrans        (0),
+	  _subAmpCache         (),
+	  _subAmpCacheSlots    (),
+	  _symTermSubAmpCacheSlots(0),
+	  _useCompiledProgram  (false),
+	  _program             (),
+	  _programTableSize    (0),
+	  _daughterVertexIndices()
 { }
 
 
@@ -65,7 +76,15 @@ isobarAmplitude::isobarAmplitude(const isobarDecayTopologyPtr& decay)
 	  _boseSymmetrize      (true),
 	  _isospinSymmetrize   (true),
 	  _doSpaceInversion    (false),
-	  _doReflection        (false)
+	  _doReflection        (false),
+	  _eventGjTrans        (0),
+	  _subAmpCache         (),
+	  _subAmpCacheSlots    (),
+	  _symTermSubAmpCacheSlots(0),
+	  _useCompiledProgram  (false),
+	  _program             (),
+	  _programTableSize    (0),
+	  _daughterVertexIndices()
 {
 	setDecayTopology(decay);
 }
@@ -95,6 +114,34 @@ isobarAmplitude::setDecayTopology(const isobarDecayTopologyPtr& decay)
 }
 
 
+void
+isobarAmplitude::cloneDecayTopology()
+{
+	// the kinematics data index maps and the momentum caches are copied
+	// with the topology; the symmetrization terms refer to final-state
+	// particle indices only and stay valid
+	setDecayTopology(_decay->clone(true, true));
+	// the mass dependences are copied as well, so that the clone does not
+	// share any state with the original; mass dependences that cannot be
+	// copied are shared
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	for (unsigned int i = 0; i < vertices.size(); ++i) {
+		const massDependencePtr massDep = vertices[i]->massDependence()->clone();
+		if (massDep)
+			vertices[i]->setMassDependence(massDep);
+	}
+	_eventGjTrans            = 0;
+	_symTermSubAmpCacheSlots = 0;
+	_subAmpCache.reset();
+	_subAmpCacheSlots.clear();
+	initDaughterVertexIndices();
+	// the decay program sets the spin projections of the particles of
+	// the topology during compilation, so it is compiled for the clone
+	if (programCompiled() and not compileProgram())
+		_program.clear();
+}
+
+
 void
 isobarAmplitude::init()
 {
@@ -109,6 +156,49 @@ isobarAmplitude::init()
 		printErr << "Could not initialize amplitude symetrization maps." << endl;
 		throw;
 	}
+	// the cache slots depend on the symmetrization terms
+	_subAmpCache.reset();
+	_subAmpCacheSlots.clear();
+	initDaughterVertexIndices();
+	_program.clear();
+	if (_useCompiledProgram and not compileProgram()) {
+		printWarn << "could not compile decay program. amplitude is calculated from decay graph." << endl;
+		_program.clear();
+	}
+}
+
+
+bool
+isobarAmplitude::setSubAmplitudeCache(const isobarSubAmplitudeCachePtr& cache)
+{
+	_subAmpCache.reset();
+	_subAmpCacheSlots.clear();
+	if (not cache)
+		return true;
+	if (_symTermMaps.empty()) {
+		printWarn << "array of symmetrization terms is empty. make sure isobarAmplitude::init() "
+		          << "was called. cannot use sub-amplitude cache." << endl;
+		return false;
+	}
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	vector<vector<unsigned int> > subAmpCacheSlots(_symTermMaps.size(), vector<unsigned int>(vertices.size(), 0));
+	for (unsigned int iSymTerm = 0; iSymTerm < _symTermMaps.size(); ++iSymTerm)
+		// the X decay vertex is never shared
+		for (unsigned int iVertex = 1; iVertex < vertices.size(); ++iVertex) {
+			string signature;
+			if (not subDecaySignature(vertices[iVertex], _symTermMaps[iSymTerm].fsPartPermMap, signature)) {
+				printWarn << "cannot construct signature of sub-decay " << *vertices[iVertex] << ". "
+				          << "make sure the kinematics data were initialized. cannot use sub-amplitude cache." << endl;
+				return false;
+			}
+			if (_debug)
+				printDebug << "signature of sub-decay " << *vertices[iVertex] << " in symmetrization term "
+				           << iSymTerm << " is '" << signature << "'" << endl;
+			subAmpCacheSlots[iSymTerm][iVertex] = cache->registerSubDecay(signature, vertices[iVertex]->parent()->J() + 1);
+		}
+	_subAmpCache = cache;
+	_subAmpCacheSlots.swap(subAmpCacheSlots);
+	return true;
 }
 
 
@@ -126,12 +216,151 @@ isobarAmplitude::amplitude() const
 	}
 	// loop over all symmetrization terms; assumes that init() was called before
 	complex<double> amp = 0;
-	for (unsigned int i = 0; i < nmbSymTerms; ++i)
+	if (programCompiled()) {
+		const unsigned int nmbVertices = _decay->nmbDecayVertices();
+		if (_programKinematics.size() != nmbVertices) {
+			_programKinematics.resize(nmbVertices);
+			for (unsigned int iVertex = 0; iVertex < nmbVertices; ++iVertex) {
+				vertexKinematicsBlock& vertexKinematics = _programKinematics[iVertex];
+				vertexKinematics.phi.resize          (1);
+				vertexKinematics.theta.resize        (1);
+				vertexKinematics.barrierFactor.resize(1);
+				vertexKinematics.massDepAmp.resize   (1);
+			}
+		}
+		for (unsigned int i = 0; i < nmbSymTerms; ++i) {
+			if (not _decay->revertMomenta(_symTermMaps[i].fsPartPermMap)) {
+				printErr << "problems reverting momenta in decay topology. cannot calculate amplitude. "
+				         << "returning 0." << endl;
+				return 0;
+			}
+			transformDaughters();
+			vertexKinematics(_programKinematics, 0);
+			complex<double> symTermAmp;
+			runProgram(_programKinematics, 1, &symTermAmp);
+			amp += _symTermMaps[i].factor * symTermAmp;
+		}
+		return amp;
+	}
+	for (unsigned int i = 0; i < nmbSymTerms; ++i) {
+		_symTermSubAmpCacheSlots = (_subAmpCache) ? &_subAmpCacheSlots[i] : 0;
 		amp += _symTermMaps[i].factor * symTermAmp(_symTermMaps[i].fsPartPermMap);
+	}
+	_symTermSubAmpCacheSlots = 0;
 	return amp;
 }
 
 
+// the X Lorentz-vector is the sum of all final-state momenta and the
+// reference Lorentz-vector is given by the production kinematics, so
+// the transformation is the same for all symmetrization terms and for
+// all amplitudes with the same production vertex and final state
+complex<double>
+isobarAmplitude::amplitude(const TLorentzRotation& gjTrans) const
+{
+	_eventGjTrans = &gjTrans;
+	const complex<double> amp = amplitude();
+	_eventGjTrans = 0;
+	return amp;
+}
+
+
+// the amplitudes are calculated in two steps:
+// 1) for each event and symmetrization term the daughters are
+//    transformed into their frames and the helicity-independent
+//    quantities of each vertex (angles, barrier factor, and mass
+//    dependence) are stored in arrays over the events of the block
+// 2) for each symmetrization term the helicity sums are evaluated from
+//    the bottom of the decay tree up to the X decay vertex on these
+//    arrays; the amplitudes of the sub-decays are tabulated for all
+//    helicities of their parent isobar
+// the arithmetic of each event is the same as in amplitude()
+bool
+isobarAmplitude::amplitude(const kinematicsBlock& block,
+                           complex<double>*       amps) const
+{
+	const unsigned int nmbEvents   = block.nmbEvents();
+	const unsigned int nmbSymTerms = _symTermMaps.size();
+	for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent)
+		amps[iEvent] = 0;
+	if (nmbSymTerms < 1) {
+		printErr << "array of symmetrization terms is empty. make sure isobarAmplitude::init() "
+		         << "was called. cannot calculate amplitudes." << endl;
+		return false;
+	}
+	if (nmbEvents == 0)
+		return true;
+
+	// kinematics [symmetrization term][vertex]
+	const vector<isobarDecayVertexPtr>& vertices    = _decay->isobarDecayVertices();
+	const unsigned int                  nmbVertices = vertices.size();
+	if (_daughterVertexIndices.size() != nmbVertices) {
+		printErr << "table of daughter vertex indices does not match decay topology. make sure isobarAmplitude::init() "
+		         << "was called. cannot calculate amplitudes." << endl;
+		return false;
+	}
+	// the buffers are kept between blocks, so that resizing them
+	// reallocates memory only if a block is larger than the previous ones
+	vector<vector<vertexKinematicsBlock> >& kinematics = _blockKinematics;
+	kinematics.resize(nmbSymTerms);
+	for (unsigned int iSymTerm = 0; iSymTerm < nmbSymTerms; ++iSymTerm) {
+		kinematics[iSymTerm].resize(nmbVertices);
+		for (unsigned int iVertex = 0; iVertex < nmbVertices; ++iVertex) {
+			vertexKinematicsBlock& vertexKinematics = kinematics[iSymTerm][iVertex];
+			vertexKinematics.phi.resize          (nmbEvents);
+			vertexKinematics.theta.resize        (nmbEvents);
+			vertexKinematics.barrierFactor.resize(nmbEvents);
+			vertexKinematics.massDepAmp.resize   (nmbEvents);
+		}
+	}
+	for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		if (not _decay->readKinematicsData(block.prodKinMomenta(iEvent), block.decayKinMomenta(iEvent))) {
+			printWarn << "problems reading event [" << iEvent << "] of kinematics block. "
+			          << "cannot calculate amplitudes." << endl;
+			return false;
+		}
+		for (unsigned int iSymTerm = 0; iSymTerm < nmbSymTerms; ++iSymTerm) {
+			if (not _decay->revertMomenta(_symTermMaps[iSymTerm].fsPartPermMap)) {
+				printErr << "problems reverting momenta in decay topology. cannot calculate amplitudes." << endl;
+				return false;
+			}
+			transformDaughters();
+			vertexKinematics(kinematics[iSymTerm], iEvent);
+		}
+	}
+
+	// sub-decay amplitudes [vertex][helicity of parent][event]
+	vector<vector<vector<complex<double> > > >& subDecayAmps = _blockSubDecayAmps;
+	vector<complex<double> >&                   symTermAmps  = _blockSymTermAmps;
+	subDecayAmps.resize(nmbVertices);
+	symTermAmps.resize (nmbEvents);
+	for (unsigned int iSymTerm = 0; iSymTerm < nmbSymTerms; ++iSymTerm) {
+		if (programCompiled())
+			runProgram(kinematics[iSymTerm], nmbEvents, symTermAmps.data());
+		else {
+			// the vertices are ordered depth-first, so the daughter vertices
+			// are calculated before their parents
+			for (unsigned int iVertex = nmbVertices - 1; iVertex > 0; --iVertex) {
+				const particlePtr& parent = vertices[iVertex]->parent();
+				subDecayAmps[iVertex].resize(parent->J() + 1);
+				for (unsigned int iLambda = 0; iLambda < subDecayAmps[iVertex].size(); ++iLambda)
+					subDecayAmps[iVertex][iLambda].resize(nmbEvents);
+				for (int lambda = -parent->J(); lambda <= +parent->J(); lambda += 2) {
+					parent->setSpinProj(lambda);
+					twoBodyDecayAmplitudeSums(iVertex, false, kinematics[iSymTerm], subDecayAmps, nmbEvents,
+					                          subDecayAmps[iVertex][(lambda + parent->J()) / 2].data());
+				}
+			}
+			twoBodyDecayAmplitudeSums(0, true, kinematics[iSymTerm], subDecayAmps, nmbEvents, symTermAmps.data());
+		}
+		const complex<double>& factor = _symTermMaps[iSymTerm].factor;
+		for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent)
+			amps[iEvent] += factor * symTermAmps[iEvent];
+	}
+	return true;
+}
+
+
 TLorentzRotation
 isobarAmplitude::gjTransform(const TLorentzVector& beamLv,  // beam Lorentz-vector
                              const TLorentzVector& XLv)     // X  Lorentz-vector
@@ -179,15 +408,24 @@ isobarAmplitude::gjTransform(const TLorentzVector& beamLv,  // beam Lorentz-vect
 }
 
 
+TLorentzRotation
+isobarAmplitude::eventGjTransform() const
+{
+	if (_eventGjTrans)
+		return *_eventGjTrans;
+	const TLorentzVector& beamLv = _decay->productionVertex()->referenceLzVec();
+	const TLorentzVector& XLv    = _decay->XParticle()->lzVec();
+	return gjTransform(beamLv, XLv);
+}
+
+
 void
 isobarAmplitude::spaceInvertDecay() const
 {
 	if (_debug)
 		printDebug << "space inverting final state momenta." << endl;
 	// transform final state particles into X rest frame
-	const TLorentzVector&  beamLv  = _decay->productionVertex()->referenceLzVec();
-	const TLorentzVector&  XLv     = _decay->XParticle()->lzVec();
-	const TLorentzRotation gjTrans = gjTransform(beamLv, XLv);
+	const TLorentzRotation gjTrans = eventGjTransform();
 	_decay->transformFsParticles(gjTrans);
 	// perform parity transformation on final state particles in X rest frame
 	for (unsigned int i = 0; i < _decay->nmbFsParticles(); ++i) {
@@ -206,9 +444,7 @@ isobarAmplitude::reflectDecay() const
 	if (_debug)
 		printDebug << "reflecting final state momenta through production plane." << endl;
 	// transform final state particles into X rest frame
-	const TLorentzVector&  beamLv  = _decay->productionVertex()->referenceLzVec();
-	const TLorentzVector&  XLv     = _decay->XParticle()->lzVec();
-	const TLorentzRotation gjTrans = gjTransform(beamLv, XLv);
+	const TLorentzRotation gjTrans = eventGjTransform();
 	_decay->transformFsParticles(gjTrans);
 	// reflect final state particles through production plane
 	for (unsigned int i = 0; i < _decay->nmbFsParticles(); ++i) {
@@ -244,7 +480,7 @@ isobarAmplitude::twoBodyDecayAmplitudeSum(const isobarDecayVertexPtr& vertex,
 			dynamic_pointer_cast<isobarDecayVertex>(_decay->toVertex(daughter1));
 		complex<double> daughter1Amp = 0;
 		if (daughter1Vertex) {
-			daughter1Amp = twoBodyDecayAmplitudeSum(daughter1Vertex, false);
+			daughter1Amp = subDecayAmplitudeSum(daughter1Vertex);
 		} else
 			daughter1Amp = 1;
 		for (int lambda2 = -daughter2->J(); lambda2 <= +daughter2->J(); lambda2 += 2) {
@@ -254,7 +490,7 @@ isobarAmplitude::twoBodyDecayAmplitudeSum(const isobarDecayVertexPtr& vertex,
 				dynamic_pointer_cast<isobarDecayVertex>(_decay->toVertex(daughter2));
 			complex<double> daughter2Amp = 0;
 			if (daughter2Vertex) {
-				daughter2Amp = twoBodyDecayAmplitudeSum(daughter2Vertex, false);
+				daughter2Amp = subDecayAmplitudeSum(daughter2Vertex);
 			} else
 				daughter2Amp = 1;
 			complex<double> parentAmp = twoBodyDecayAmplitude(vertex, topVertex);
@@ -277,6 +513,325 @@ isobarAmplitude::twoBodyDecayAmplitudeSum(const isobarDecayVertexPtr& vertex,
 }
 
 
+// same sums as in twoBodyDecayAmplitudeSum(), but for all events of a
+// block; the amplitudes of the daughter vertices are taken from the
+// tabulated sub-decay amplitudes
+void
+isobarAmplitude::twoBodyDecayAmplitudeSums
+(const unsigned int                                        vertexIndex,
+ const bool                                                topVertex,
+ const vector<vertexKinematicsBlock>&                      kinematics,
+ const vector<vector<vector<complex<double> > > >&         subDecayAmps,
+ const unsigned int                                        nmbEvents,
+ complex<double>*                                          ampSums) const
+{
+	const vector<isobarDecayVertexPtr>& vertices  = _decay->isobarDecayVertices();
+	const isobarDecayVertexPtr&         vertex    = vertices[vertexIndex];
+	const particlePtr&                  daughter1 = vertex->daughter1();
+	const particlePtr&                  daughter2 = vertex->daughter2();
+	// final-state particles have no vertex and an amplitude of 1
+	const int daughterVertexIndices[2] = {_daughterVertexIndices[vertexIndex].first,
+	                                      _daughterVertexIndices[vertexIndex].second};
+	for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent)
+		ampSums[iEvent] = 0;
+	vector<complex<double> >& parentAmps = _blockParentAmps;
+	parentAmps.resize(nmbEvents);
+	for (int lambda1 = -daughter1->J(); lambda1 <= +daughter1->J(); lambda1 += 2) {
+		daughter1->setSpinProj(lambda1);
+		const complex<double>* daughter1Amps = (daughterVertexIndices[0] < 0) ? 0
+			: subDecayAmps[daughterVertexIndices[0]][(lambda1 + daughter1->J()) / 2].data();
+		for (int lambda2 = -daughter2->J(); lambda2 <= +daughter2->J(); lambda2 += 2) {
+			daughter2->setSpinProj(lambda2);
+			const complex<double>* daughter2Amps = (daughterVertexIndices[1] < 0) ? 0
+				: subDecayAmps[daughterVertexIndices[1]][(lambda2 + daughter2->J()) / 2].data();
+			if (not twoBodyDecayAmplitudes(vertex, topVertex, kinematics[vertexIndex], nmbEvents, parentAmps.data()))
+				continue;
+			for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+				const complex<double> daughter1Amp = (daughter1Amps) ? daughter1Amps[iEvent] : 1;
+				const complex<double> daughter2Amp = (daughter2Amps) ? daughter2Amps[iEvent] : 1;
+				ampSums[iEvent] += parentAmps[iEvent] * daughter1Amp * daughter2Amp;
+			}
+		}
+	}
+}
+
+
+void
+isobarAmplitude::vertexKinematics(vector<vertexKinematicsBlock>& kinematics,
+                                  const unsigned int             eventIndex) const
+{
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	for (unsigned int iVertex = 0; iVertex < vertices.size(); ++iVertex) {
+		const isobarDecayVertexPtr& vertex           = vertices[iVertex];
+		const TLorentzVector&       daughter1Lv      = vertex->daughter1()->lzVec();  // use daughter1 as analyzer
+		vertexKinematicsBlock&      vertexKinematics = kinematics[iVertex];
+		vertexKinematics.phi          [eventIndex] = daughter1Lv.Phi();
+		vertexKinematics.theta        [eventIndex] = daughter1Lv.Theta();
+		vertexKinematics.barrierFactor[eventIndex] = barrierFactor(vertex->L(), daughter1Lv.Vect().Mag(), _debug);
+		vertexKinematics.massDepAmp   [eventIndex] = vertex->massDepAmplitude();
+	}
+}
+
+
+unsigned int
+isobarAmplitude::addAngularFunction(decayProgramOp&                    op,
+                                    const decayProgramAngularFunction& function)
+{
+	for (unsigned int i = 0; i < op.angularFunctions.size(); ++i)
+		if (op.angularFunctions[i] == function)
+			return i;
+	op.angularFunctions.push_back(function);
+	return op.angularFunctions.size() - 1;
+}
+
+
+// the program contains everything that does not depend on the event:
+// the helicity combinations with non-vanishing Clebsch-Gordan
+// coefficients, the products of the coefficients and normalization
+// factors, the distinct angular functions of each vertex, and the
+// table entries that connect the vertices. the event-dependent
+// quantities of the vertices are calculated by vertexKinematics()
+void
+isobarAmplitude::initDaughterVertexIndices()
+{
+	const vector<isobarDecayVertexPtr>& vertices    = _decay->isobarDecayVertices();
+	const unsigned int                  nmbVertices = vertices.size();
+	vector<pair<int, int> > daughterVertexIndices(nmbVertices, make_pair(-1, -1));
+	// the vertices are ordered depth-first, so the daughter vertices come
+	// after their parent
+	for (unsigned int iVertex = 0; iVertex < nmbVertices; ++iVertex) {
+		const particlePtr daughters[2] = {vertices[iVertex]->daughter1(), vertices[iVertex]->daughter2()};
+		int*              indices  [2] = {&daughterVertexIndices[iVertex].first, &daughterVertexIndices[iVertex].second};
+		for (unsigned int i = 0; i < 2; ++i) {
+			const isobarDecayVertexPtr daughterVertex =
+				dynamic_pointer_cast<isobarDecayVertex>(_decay->toVertex(daughters[i]));
+			if (daughterVertex)
+				for (unsigned int j = iVertex + 1; j < nmbVertices; ++j)
+					if (vertices[j] == daughterVertex) {
+						*indices[i] = j;
+						break;
+					}
+		}
+	}
+	_daughterVertexIndices.swap(daughterVertexIndices);
+}
+
+
+bool
+isobarAmplitude::compileProgram()
+{
+	const vector<isobarDecayVertexPtr>& vertices    = _decay->isobarDecayVertices();
+	const unsigned int                  nmbVertices = vertices.size();
+	if (nmbVertices == 0) {
+		printWarn << "decay topology has no isobar decay vertices. cannot compile decay program." << endl;
+		return false;
+	}
+	if (_daughterVertexIndices.size() != nmbVertices)
+		initDaughterVertexIndices();
+	// table entry 0 holds the amplitude of the X decay for the helicity
+	// of X, the other vertices have one entry per helicity of their parent
+	vector<unsigned int> tableOffsets(nmbVertices, 0);
+	unsigned int         tableSize = 1;
+	for (unsigned int iVertex = 1; iVertex < nmbVertices; ++iVertex) {
+		tableOffsets[iVertex] = tableSize;
+		tableSize += vertices[iVertex]->parent()->J() + 1;
+	}
+
+	vector<decayProgramOp> program;
+	unsigned int           nmbTerms = 0;
+	// the vertices are ordered depth-first, so the daughter vertices come
+	// before their parents in reverse order
+	for (int iVertex = nmbVertices - 1; iVertex >= 0; --iVertex) {
+		const isobarDecayVertexPtr& vertex    = vertices[iVertex];
+		const bool                  topVertex = (iVertex == 0);
+		const particlePtr&          parent    = vertex->parent();
+		const particlePtr           daughters[2] = {vertex->daughter1(), vertex->daughter2()};
+		const int daughterVertexIndices[2] = {_daughterVertexIndices[iVertex].first,
+		                                      _daughterVertexIndices[iVertex].second};
+		decayProgramOp op;
+		op.vertexIndex = iVertex;
+		// the helicity of X is fixed by the wave
+		const int parentSpinProj = parent->spinProj();
+		const int lambdaMin      = (topVertex) ? parentSpinProj : -parent->J();
+		const int lambdaMax      = (topVertex) ? parentSpinProj : +parent->J();
+		for (int lambda = lambdaMin; lambda <= lambdaMax; lambda += 2) {
+			parent->setSpinProj(lambda);
+			for (int lambda1 = -daughters[0]->J(); lambda1 <= +daughters[0]->J(); lambda1 += 2) {
+				daughters[0]->setSpinProj(lambda1);
+				for (int lambda2 = -daughters[1]->J(); lambda2 <= +daughters[1]->J(); lambda2 += 2) {
+					daughters[1]->setSpinProj(lambda2);
+					decayProgramTerm term;
+					term.parentSlot = (topVertex) ? 0 : tableOffsets[iVertex] + (lambda + parent->J()) / 2;
+					const int daughterLambdas[2] = {lambda1, lambda2};
+					for (unsigned int i = 0; i < 2; ++i)
+						term.daughterSlots[i] = (daughterVertexIndices[i] < 0) ? -1
+							: tableOffsets[daughterVertexIndices[i]] + (daughterLambdas[i] + daughters[i]->J()) / 2;
+					if (compileTwoBodyDecay(vertex, topVertex, op, term))
+						op.terms.push_back(term);
+				}
+			}
+		}
+		parent->setSpinProj(parentSpinProj);
+		nmbTerms += op.terms.size();
+		program.push_back(op);
+	}
+	_program.swap(program);
+	_programTableSize = tableSize;
+	if (_debug)
+		printDebug << "compiled decay program with " << _program.size() << " operations, "
+		           << nmbTerms << " terms, and " << _programTableSize << " table entries" << endl;
+	return true;
+}
+
+
+// the interpreter only uses the indices of the program and the arrays
+// of vertex kinematics; for each event the operations fill the table of
+// sub-decay amplitudes from the bottom of the decay tree up to the X
+// decay vertex
+void
+isobarAmplitude::runProgram(const vector<vertexKinematicsBlock>& kinematics,
+                            const unsigned int                   nmbEvents,
+                            complex<double>*                     amps) const
+{
+	_programTable.resize(_programTableSize);
+	for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		for (unsigned int i = 0; i < _programTableSize; ++i)
+			_programTable[i] = 0;
+		for (unsigned int iOp = 0; iOp < _program.size(); ++iOp) {
+			const decayProgramOp&        op               = _program[iOp];
+			const vertexKinematicsBlock& vertexKinematics = kinematics[op.vertexIndex];
+			const double                 phi              = vertexKinematics.phi  [iEvent];
+			const double                 theta            = vertexKinematics.theta[iEvent];
+			_programAngularValues.resize(op.angularFunctions.size());
+			for (unsigned int i = 0; i < op.angularFunctions.size(); ++i) {
+				const decayProgramAngularFunction& function = op.angularFunctions[i];
+				switch (function.type) {
+				case decayProgramAngularFunction::D_FUNCTION_CONJ:
+					_programAngularValues[i] = DFunctionConj<complex<double> >(function.j, function.m, function.n, phi, theta);
+					break;
+				case decayProgramAngularFunction::D_FUNCTION_REFL_CONJ:
+					_programAngularValues[i] = DFunctionReflConj<complex<double> >(function.j, function.m, function.n,
+					                                                                function.P, function.refl, phi, theta);
+					break;
+				case decayProgramAngularFunction::SPHERICAL_HARMONIC:
+					_programAngularValues[i] = sphericalHarmonic<complex<double> >(function.j, function.m, theta, phi);
+					break;
+				}
+			}
+			const complex<double> dynamics = vertexKinematics.barrierFactor[iEvent] * vertexKinematics.massDepAmp[iEvent];
+			for (unsigned int iTerm = 0; iTerm < op.terms.size(); ++iTerm) {
+				const decayProgramTerm& term = op.terms[iTerm];
+				complex<double>         amp  = 0;
+				for (unsigned int i = 0; i < term.angularTerms.size(); ++i)
+					amp += term.angularTerms[i].second * _programAngularValues[term.angularTerms[i].first];
+				amp *= dynamics;
+				if (term.daughterSlots[0] >= 0)
+					amp *= _programTable[term.daughterSlots[0]];
+				if (term.daughterSlots[1] >= 0)
+					amp *= _programTable[term.daughterSlots[1]];
+				_programTable[term.parentSlot] += amp;
+			}
+		}
+		amps[iEvent] = _programTable[0];
+	}
+}
+
+
+// the amplitude of a sub-decay depends on the helicity of its parent
+// isobar and on the kinematics of the particles below its vertex,
+// which is fixed by the signature of the sub-decay
+complex<double>
+isobarAmplitude::subDecayAmplitudeSum(const isobarDecayVertexPtr& vertex) const
+{
+	if (not _symTermSubAmpCacheSlots)
+		return twoBodyDecayAmplitudeSum(vertex, false);
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	unsigned int iVertex = 1;
+	while (iVertex < vertices.size() and vertices[iVertex] != vertex)
+		++iVertex;
+	if (iVertex == vertices.size())
+		return twoBodyDecayAmplitudeSum(vertex, false);
+	const particlePtr& parent = vertex->parent();
+	const unsigned int slot   = (*_symTermSubAmpCacheSlots)[iVertex] + (parent->spinProj() + parent->J()) / 2;
+	complex<double>    amp;
+	if (_subAmpCache->get(slot, amp))
+		return amp;
+	amp = twoBodyDecayAmplitudeSum(vertex, false);
+	_subAmpCache->set(slot, amp);
+	return amp;
+}
+
+
+// the signature contains
+// - the formalism and everything outside of the decay tree that
+//   defines the Gottfried-Jackson frame
+// - the final-state particles below each isobar on the path from the
+//   X decay vertex to the vertex, which define the chain of frames the
+//   daughters are transformed into
+// - the sub-decay itself: isobars with mass, width, L, S and mass
+//   dependence, and the final-state particles with the index of their
+//   momenta in the input data for the given permutation
+bool
+isobarAmplitude::subDecaySignature(const isobarDecayVertexPtr& vertex,
+                                   const vector<unsigned int>& fsPartPermMap,
+                                   string&                     signature) const
+{
+	ostringstream sig;
+	sig << name() << " " << _decay->productionVertex()->name();
+	for (unsigned int i = 0; i < _decay->productionVertex()->nmbInParticles(); ++i)
+		sig << " " << _decay->productionVertex()->inParticles()[i]->name();
+	sig << " " << _doSpaceInversion << _doReflection << " ";
+
+	// isobars on the path from the X decay vertex down to the vertex
+	vector<isobarDecayVertexPtr> path(1, vertex);
+	while (true) {
+		const isobarDecayVertexPtr ancestor =
+			dynamic_pointer_cast<isobarDecayVertex>(_decay->fromVertex(path.back()->parent()));
+		if (not ancestor or ancestor == _decay->XIsobarDecayVertex())
+			break;
+		path.push_back(ancestor);
+	}
+	for (int i = path.size() - 1; i >= 0; --i) {
+		const vector<unsigned int> fsPartIndices = _decay->getFsPartIndicesConnectedToVertex(path[i]);
+		vector<int> dataIndices;
+		for (unsigned int j = 0; j < fsPartIndices.size(); ++j)
+			dataIndices.push_back(_decay->fsDataPartIndex(fsPartPermMap[fsPartIndices[j]]));
+		sort(dataIndices.begin(), dataIndices.end());
+		sig << "{";
+		for (unsigned int j = 0; j < dataIndices.size(); ++j) {
+			if (dataIndices[j] < 0)
+				return false;
+			sig << ((j == 0) ? "" : " ") << dataIndices[j];
+		}
+		sig << "}";
+	}
+
+	// sub-decay tree in depth-first order
+	vector<particlePtr> particles(1, vertex->parent());
+	while (not particles.empty()) {
+		const particlePtr part = particles.back();
+		particles.pop_back();
+		const isobarDecayVertexPtr partVertex = dynamic_pointer_cast<isobarDecayVertex>(_decay->toVertex(part));
+		if (partVertex) {
+			sig << " (" << part->name() << " " << maxPrecision(part->mass()) << " " << maxPrecision(part->width())
+			    << " L = " << partVertex->L() << " S = " << partVertex->S() << " " << *(partVertex->massDependence()) << ")";
+			particles.push_back(partVertex->daughter2());
+			particles.push_back(partVertex->daughter1());
+		} else {
+			const int fsPartIndex = _decay->fsParticlesIndex(part);
+			if (fsPartIndex < 0)
+				return false;
+			const int dataIndex = _decay->fsDataPartIndex(fsPartPermMap[fsPartIndex]);
+			if (dataIndex < 0)
+				return false;
+			sig << " " << part->name() << "[" << dataIndex << "]";
+		}
+	}
+	signature = sig.str();
+	return true;
+}
+
+
 complex<double>
 isobarAmplitude::symTermAmp(const vector<unsigned int>& fsPartPermMap) const
 {
@@ -410,7 +965,8 @@ isobarAmplitude::printParameters(ostream& out) const
 	    << "    Bose symmetrization .............. " << enDisabled(_boseSymmetrize      ) << endl
 	    << "    isospin symmetrization ........... " << enDisabled(_isospinSymmetrize   ) << endl
 	    << "    space inversion of FS momenta .... " << enDisabled(_doSpaceInversion    ) << endl
-	    << "    reflection through prod. plane ... " << enDisabled(_doReflection        ) << endl;
+	    << "    reflection through prod. plane ... " << enDisabled(_doReflection        ) << endl
+	    << "    compiled decay program ........... " << enDisabled(_useCompiledProgram  ) << endl;
 	return out;
 }
 
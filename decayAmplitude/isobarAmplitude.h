@@ -37,9 +37,12 @@
 
 #include <complex>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "isobarDecayTopology.h"
+#include "isobarSubAmplitudeCache.h"
+#include "kinematicsBlock.h"
 
 
 namespace rpwa {
@@ -57,6 +60,13 @@ namespace rpwa {
 		isobarAmplitude(const isobarDecayTopologyPtr& decay);
 		virtual ~isobarAmplitude();
 
+		// creates a deep copy of the amplitude including its decay
+		// topology, mass dependences, and production kinematics, which can
+		// be used independently of the original, e.g. in another thread;
+		// the kinematics data initialization is copied, the sub-amplitude
+		// cache is not
+		isobarAmplitudePtr clone() const { return isobarAmplitudePtr(doClone()); }
+
 		const isobarDecayTopologyPtr& decayTopology   () const { return _decay; }              ///< returns pointer to decay topology
 		void                          setDecayTopology(const isobarDecayTopologyPtr& decay);   ///< sets decay topology
 
@@ -74,11 +84,35 @@ namespace rpwa {
 		void enableSpaceInversion(const bool flag = true) { _doSpaceInversion = flag; }  ///< en/disables parity transformation of decay
 		void enableReflection    (const bool flag = true) { _doReflection     = flag; }  ///< en/disables reflection of decay through production plane
 
+		bool useCompiledProgram   () const { return _useCompiledProgram; }  ///< returns whether amplitude is evaluated by compiled decay program
+		void enableCompiledProgram(const bool flag = true) { _useCompiledProgram = flag; }  ///< en/disables evaluation by decay program compiled in init(); takes effect at next call of init()
+		bool programCompiled      () const { return not _program.empty(); }  ///< returns whether a compiled decay program is used
+
 		static TLorentzRotation gjTransform(const TLorentzVector& beamLv,
 		                                    const TLorentzVector& XLv);  ///< constructs Lorentz-transformation to X Gottfried-Jackson frame
 
+		// registers all isobar sub-decays of the amplitude in the cache, so
+		// that their amplitudes are shared with all other amplitudes that
+		// use the same cache; needs to be called after init() and after the
+		// kinematics data were initialized; the cache has to be invalidated
+		// for each new event. a null pointer switches the cache off
+		bool setSubAmplitudeCache(const isobarSubAmplitudeCachePtr& cache);
+		const isobarSubAmplitudeCachePtr& subAmplitudeCache() const { return _subAmpCache; }  ///< returns sub-amplitude cache
+
 		std::complex<double> amplitude()   const;                         ///< computes amplitude
 		std::complex<double> operator ()() const { return amplitude(); }  ///< computes amplitude
+		std::complex<double> amplitude(const TLorentzRotation& gjTrans) const;  ///< computes amplitude using the given transformation into the X Gottfried-Jackson frame of the current event
+
+		// computes the amplitudes of all events of the block and writes
+		// them to amps, which has to hold block.nmbEvents() values. the
+		// kinematics of the decay vertices are calculated event by event;
+		// the sums over the helicities are then performed for all events
+		// at once, so that the Clebsch-Gordan coefficients are calculated
+		// once per block and the amplitude of each sub-decay is
+		// calculated once per helicity of its parent isobar. the
+		// sub-amplitude cache is not used
+		bool amplitude(const kinematicsBlock& block,
+		               std::complex<double>*  amps) const;
 
 		virtual std::string   name           ()                  const { return "isobarAmplitude"; }
 		virtual std::ostream& printParameters(std::ostream& out) const;  ///< prints amplitude parameters in human-readable form
@@ -90,6 +124,11 @@ namespace rpwa {
 
 	protected:
 
+		virtual isobarAmplitude* doClone() const = 0;  ///< helper function to use covariant return types with smart pointers; needed for public clone()
+		void cloneDecayTopology();  ///< replaces decay topology by a deep copy; used by doClone() of derived classes
+
+		TLorentzRotation eventGjTransform() const;  ///< returns transformation into the X Gottfried-Jackson frame of the current event
+
 		void spaceInvertDecay() const;  ///< performs parity transformation on all decay three-momenta
 		void reflectDecay    () const;  ///< performs reflection through production plane on all decay three-momenta
 
@@ -103,6 +142,81 @@ namespace rpwa {
 		(const isobarDecayVertexPtr& vertex,
 		 const bool                  topVertex = false) const;  ///< recursive function that sums up decay amplitudes for all allowed helicitities for all vertices below the given vertex
 
+		// kinematic quantities of a decay vertex for all events of a block
+		struct vertexKinematicsBlock {
+			std::vector<double>                phi;            ///< azimuthal angle of daughter 1 in parent frame
+			std::vector<double>                theta;          ///< polar angle of daughter 1 in parent frame
+			std::vector<double>                barrierFactor;  ///< barrier factor for breakup momentum of daughter 1
+			std::vector<std::complex<double> > massDepAmp;     ///< mass-dependent amplitude of parent
+		};
+
+		virtual bool twoBodyDecayAmplitudes
+		(const isobarDecayVertexPtr&  vertex,
+		 const bool                   topVertex,
+		 const vertexKinematicsBlock& kinematics,
+		 const unsigned int           nmbEvents,
+		 std::complex<double>*        amps) const = 0;  ///< calculates two-body decay amplitude for the current helicities for all events of a block; returns false if the amplitude vanishes for all events
+
+		void twoBodyDecayAmplitudeSums
+		(const unsigned int                                                  vertexIndex,
+		 const bool                                                          topVertex,
+		 const std::vector<vertexKinematicsBlock>&                           kinematics,
+		 const std::vector<std::vector<std::vector<std::complex<double> > > >& subDecayAmps,
+		 const unsigned int                                                  nmbEvents,
+		 std::complex<double>*                                               ampSums) const;  ///< sums decay amplitudes of the vertex for all events of a block using the sub-decay amplitudes [vertex][helicity][event] of its daughters
+
+		// the decay tree compiled into a flat program: one operation per
+		// isobar decay vertex, ordered such that the daughter vertices come
+		// before their parent and the X decay vertex is the last one. each
+		// operation fills the amplitudes of its sub-decay for all
+		// helicities of the parent isobar into a table; the terms of the
+		// helicity sums refer to the angular functions of the operation
+		// and to table entries by index only
+		struct decayProgramAngularFunction {
+			enum functionTypeEnum {
+				D_FUNCTION_CONJ,       ///< D^{j *}_{m n}(phi, theta, 0)
+				D_FUNCTION_REFL_CONJ,  ///< D^{j P refl *}_{m n}(phi, theta, 0)
+				SPHERICAL_HARMONIC     ///< Y_j^m(theta, phi)
+			};
+			functionTypeEnum type;
+			int              j, m, n, P, refl;
+			bool operator ==(const decayProgramAngularFunction& other) const
+			{ return type == other.type and j == other.j and m == other.m and n == other.n and P == other.P and refl == other.refl; }
+		};
+		struct decayProgramTerm {
+			unsigned int                                  parentSlot;        ///< table entry of the parent helicity
+			int                                           daughterSlots[2];  ///< table entries of the daughter helicities; -1 for final-state particles
+			std::vector<std::pair<unsigned int, double> > angularTerms;      ///< indices of angular functions of the operation and their coefficients, which include all Clebsch-Gordan and normalization factors
+		};
+		struct decayProgramOp {
+			unsigned int                             vertexIndex;       ///< index of vertex in isobarDecayVertices()
+			std::vector<decayProgramAngularFunction> angularFunctions;  ///< distinct angular functions needed by the terms
+			std::vector<decayProgramTerm>            terms;
+		};
+
+		virtual bool compileTwoBodyDecay
+		(const isobarDecayVertexPtr& vertex,
+		 const bool                  topVertex,
+		 decayProgramOp&             op,
+		 decayProgramTerm&           term) const = 0;  ///< adds the angular terms of the two-body decay amplitude for the current helicities to the program term; returns false if the amplitude vanishes
+
+		static unsigned int addAngularFunction(decayProgramOp&                    op,
+		                                       const decayProgramAngularFunction& function);  ///< returns index of angular function in operation; adds function if it is not yet there
+
+		void initDaughterVertexIndices();  ///< fills the table of daughter vertex indices of the isobar decay vertices
+		bool compileProgram();             ///< compiles the decay tree into the decay program
+		void vertexKinematics(std::vector<vertexKinematicsBlock>& kinematics,
+		                      const unsigned int                  eventIndex) const;  ///< stores angles, barrier factors, and mass-dependent amplitudes of all vertices of the current event
+		void runProgram(const std::vector<vertexKinematicsBlock>& kinematics,
+		                const unsigned int                        nmbEvents,
+		                std::complex<double>*                     amps) const;  ///< evaluates the decay program for all events
+
+		std::complex<double> subDecayAmplitudeSum(const isobarDecayVertexPtr& vertex) const;  ///< returns twoBodyDecayAmplitudeSum() for a vertex below the X decay vertex, from the sub-amplitude cache if possible
+
+		bool subDecaySignature(const isobarDecayVertexPtr&      vertex,
+		                       const std::vector<unsigned int>& fsPartPermMap,
+		                       std::string&                     signature) const;  ///< constructs the signature of the sub-decay below the vertex for the final-state permutation
+
 		virtual std::complex<double> symTermAmp(const std::vector<unsigned int>& fsPartPermMap) const;  ///< returns decay amplitude for a certain permutation of final-state particles
 
 		virtual bool initSymTermMaps();
@@ -115,6 +229,24 @@ namespace rpwa {
 		bool                    _doReflection;          ///< is set, all three-momenta of the decay particles are reflected through production plane (for test purposes)
 		std::vector<symTermMap> _symTermMaps;           ///< array of factors and permutation maps for symmetrization terms
 
+		mutable const TLorentzRotation*          _eventGjTrans;             ///< if set, externally calculated transformation into the X Gottfried-Jackson frame of the current event
+		isobarSubAmplitudeCachePtr               _subAmpCache;              ///< cache for amplitudes of isobar sub-decays
+		std::vector<std::vector<unsigned int> >  _subAmpCacheSlots;         ///< first cache slot of each isobar decay vertex for each symmetrization term
+		mutable const std::vector<unsigned int>* _symTermSubAmpCacheSlots;  ///< cache slots of the symmetrization term that is being calculated
+
+		bool                                       _useCompiledProgram;  ///< if set, init() compiles the decay program
+		std::vector<decayProgramOp>                _program;             ///< compiled decay program; empty if not used
+		unsigned int                               _programTableSize;    ///< number of entries in the table of sub-decay amplitudes of the program
+		mutable std::vector<vertexKinematicsBlock> _programKinematics;   ///< vertex kinematics of the current event for the decay program
+		mutable std::vector<std::complex<double> > _programTable;        ///< sub-decay amplitudes of the current event for the decay program
+		mutable std::vector<std::complex<double> > _programAngularValues;  ///< values of the angular functions of the current operation
+
+		std::vector<std::pair<int, int> >                                   _daughterVertexIndices;  ///< indices of the daughter vertices of each vertex in isobarDecayVertices(); -1 for final-state particles
+		mutable std::vector<std::vector<vertexKinematicsBlock> >            _blockKinematics;        ///< vertex kinematics [symmetrization term][vertex] of the current block
+		mutable std::vector<std::vector<std::vector<std::complex<double> > > > _blockSubDecayAmps;   ///< sub-decay amplitudes [vertex][helicity of parent][event] of the current block
+		mutable std::vector<std::complex<double> >                          _blockSymTermAmps;       ///< amplitudes of the current symmetrization term of the current block
+		mutable std::vector<std::complex<double> >                          _blockParentAmps;        ///< two-body decay amplitudes of the current vertex of the current block
+
 		static bool _debug;  ///< if set to true, debug messages are printed
 
 	};
@@ -63,6 +63,15 @@ isobarCanonicalAmplitude::~isobarCanonicalAmplitude()
 { }
 
 
+isobarCanonicalAmplitude*
+isobarCanonicalAmplitude::doClone() const
+{
+	isobarCanonicalAmplitude* ampClone = new isobarCanonicalAmplitude(*this);
+	ampClone->cloneDecayTopology();
+	return ampClone;
+}
+
+
 void
 isobarCanonicalAmplitude::transformDaughters() const
 {
@@ -82,9 +91,7 @@ isobarCanonicalAmplitude::transformDaughters() const
 	// calculate Lorentz-transformations into the correct frames for the
 	// daughters in the decay vertices
 	// 1) transform daughters of all decay vertices into Gottfried-Jackson frame
-	const TLorentzVector&  beamLv  = _decay->productionVertex()->referenceLzVec();
-	const TLorentzVector&  XLv     = _decay->XParticle()->lzVec();
-	const TLorentzRotation gjTrans = gjTransform(beamLv, XLv);
+	const TLorentzRotation gjTrans = eventGjTransform();
 	for (unsigned int i = 0; i < _decay->nmbDecayVertices(); ++i) {
 		const isobarDecayVertexPtr& vertex = _decay->isobarDecayVertices()[i];
 		if (_debug)
@@ -114,6 +121,36 @@ isobarCanonicalAmplitude::transformDaughters() const
 }
 
 
+// Clebsch-Gordan coefficient for the L-S coupling of the current
+// spin projections of the vertex; in the reflectivity basis the
+// coupling term of the X decay is symmetrized
+double
+isobarCanonicalAmplitude::lsClebschCoeff(const isobarDecayVertexPtr& vertex,
+                                         const bool                  topVertex,
+                                         const int                   mL,
+                                         const int                   mS) const
+{
+	const particlePtr& parent = vertex->parent();
+	const int          L      = vertex->L();
+	const int          S      = vertex->S();
+	const int          J      = parent->J();
+	const int          M      = parent->spinProj();
+	if (_useReflectivityBasis and topVertex) {
+		// symmetrize L-S coupling term
+		const int reflFactor = reflectivityFactor(J, parent->P(), M, parent->reflectivity());
+		if (M == 0) {
+			if (reflFactor == +1)
+				return 0;
+			return clebschGordanCoeff<double>(L, mL, S, mS, J, 0, _debug);
+		}
+		return 1 / rpwa::sqrt(2)
+			* (               clebschGordanCoeff<double>(L, mL, S, mS, J, +M, _debug)
+			   - reflFactor * clebschGordanCoeff<double>(L, mL, S, mS, J, -M, _debug));
+	}
+	return clebschGordanCoeff<double>(L, mL, S, mS, J, M, _debug);
+}
+
+
 // assumes that daughters were transformed into parent RF
 complex<double>
 isobarCanonicalAmplitude::twoBodyDecayAmplitude(const isobarDecayVertexPtr& vertex,
@@ -123,7 +160,6 @@ isobarCanonicalAmplitude::twoBodyDecayAmplitude(const isobarDecayVertexPtr& vert
 		printDebug << "calculating two-body decay amplitude in canonical formalism "
 		           << "for " << *vertex << endl;
 
-	const particlePtr& parent    = vertex->parent();
 	const particlePtr& daughter1 = vertex->daughter1();
 	const particlePtr& daughter2 = vertex->daughter2();
 
@@ -151,31 +187,12 @@ isobarCanonicalAmplitude::twoBodyDecayAmplitude(const isobarDecayVertexPtr& vert
 																		 // helicity amplitude lacks a factor of 1 / sqrt(4 pi)
 
 	// sum over all possible spin projections of L
-	const int       J     = parent->J();
-	const int       M     = parent->spinProj();
-	const int       P     = parent->P();
-	const int       refl  = parent->reflectivity();
 	const double    phi   = daughter1->lzVec().Phi();  // use daughter1 as analyzer
 	const double    theta = daughter1->lzVec().Theta();
 	complex<double> amp	  = 0;
 	for (int mL = -L; mL <= L; mL += 2) {
 		// calculate Clebsch-Gordan coefficient for L-S coupling
-		double LSClebsch;
-		if (_useReflectivityBasis and topVertex) {
-			// symmetrize L-S coupling term
-			const int reflFactor = reflectivityFactor(J, P, M, refl);
-			if (M == 0) {
-				if (reflFactor == +1)
-					LSClebsch = 0;
-				else
-					LSClebsch = clebschGordanCoeff<double>(L, mL, S, mS, J, 0, _debug);
-			} else {
-				LSClebsch = 1 / rpwa::sqrt(2)
-					* (               clebschGordanCoeff<double>(L, mL, S, mS, J, +M, _debug)
-					   - reflFactor * clebschGordanCoeff<double>(L, mL, S, mS, J, -M, _debug));
-			}
-		} else
-			LSClebsch = clebschGordanCoeff<double>(L, mL, S, mS, J, M, _debug);
+		const double LSClebsch = lsClebschCoeff(vertex, topVertex, mL, mS);
 		if (LSClebsch == 0)
 			continue;
 		// multiply spherical harmonic
@@ -189,3 +206,93 @@ isobarCanonicalAmplitude::twoBodyDecayAmplitude(const isobarDecayVertexPtr& vert
 		printDebug << "two-body decay amplitude = " << maxPrecisionDouble(amp) << endl;
 	return amp;
 }
+
+
+// same as twoBodyDecayAmplitude(), but the Clebsch-Gordan coefficients
+// are calculated only once for all events of the block
+bool
+isobarCanonicalAmplitude::twoBodyDecayAmplitudes(const isobarDecayVertexPtr&  vertex,
+                                                 const bool                   topVertex,
+                                                 const vertexKinematicsBlock& kinematics,
+                                                 const unsigned int           nmbEvents,
+                                                 complex<double>*             amps) const
+{
+	const particlePtr& daughter1 = vertex->daughter1();
+	const particlePtr& daughter2 = vertex->daughter2();
+
+	// calculate Clebsch-Gordan coefficient for S-S coupling
+	const int    s1        = daughter1->J();
+	const int    m1        = daughter1->spinProj();
+	const int    s2        = daughter2->J();
+	const int    m2        = daughter2->spinProj();
+	const int    S         = vertex->S();
+	const int    mS        = m1 + m2;
+	const double ssClebsch = clebschGordanCoeff<double>(s1, m1, s2, m2, S, mS, _debug);
+	if (ssClebsch == 0)
+		return false;
+
+	// calculate Clebsch-Gordan coefficients for L-S coupling for all
+	// spin projections of L
+	const int      L = vertex->L();
+	vector<double> LSClebschs;
+	for (int mL = -L; mL <= L; mL += 2)
+		LSClebschs.push_back(lsClebschCoeff(vertex, topVertex, mL, mS));
+
+	const double norm = sqrt(fourPi);  // see twoBodyDecayAmplitude()
+	for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		const double    phi   = kinematics.phi  [iEvent];
+		const double    theta = kinematics.theta[iEvent];
+		complex<double> amp   = 0;
+		for (int mL = -L; mL <= L; mL += 2) {
+			const double LSClebsch = LSClebschs[(mL + L) / 2];
+			if (LSClebsch == 0)
+				continue;
+			amp += LSClebsch * sphericalHarmonic<complex<double> >(L, mL, theta, phi, _debug);
+		}
+		amp *= norm * ssClebsch * kinematics.barrierFactor[iEvent] * kinematics.massDepAmp[iEvent];
+		amps[iEvent] = amp;
+	}
+	return true;
+}
+
+
+// same as twoBodyDecayAmplitudes(), but instead of calculating the
+// amplitudes the spherical harmonics and their coefficients are added
+// to the decay program
+bool
+isobarCanonicalAmplitude::compileTwoBodyDecay(const isobarDecayVertexPtr& vertex,
+                                              const bool                  topVertex,
+                                              decayProgramOp&             op,
+                                              decayProgramTerm&           term) const
+{
+	const particlePtr& daughter1 = vertex->daughter1();
+	const particlePtr& daughter2 = vertex->daughter2();
+
+	// calculate Clebsch-Gordan coefficient for S-S coupling
+	const int    s1        = daughter1->J();
+	const int    m1        = daughter1->spinProj();
+	const int    s2        = daughter2->J();
+	const int    m2        = daughter2->spinProj();
+	const int    S         = vertex->S();
+	const int    mS        = m1 + m2;
+	const double ssClebsch = clebschGordanCoeff<double>(s1, m1, s2, m2, S, mS, _debug);
+	if (ssClebsch == 0)
+		return false;
+
+	const int    L    = vertex->L();
+	const double norm = sqrt(fourPi);  // see twoBodyDecayAmplitude()
+	for (int mL = -L; mL <= L; mL += 2) {
+		const double LSClebsch = lsClebschCoeff(vertex, topVertex, mL, mS);
+		if (LSClebsch == 0)
+			continue;
+		decayProgramAngularFunction function;
+		function.type = decayProgramAngularFunction::SPHERICAL_HARMONIC;
+		function.j    = L;
+		function.m    = mL;
+		function.n    = 0;
+		function.P    = 0;
+		function.refl = 0;
+		term.angularTerms.push_back(make_pair(addAngularFunction(op, function), norm * ssClebsch * LSClebsch));
+	}
+	return not term.angularTerms.empty();
+}
@@ -59,14 +59,36 @@ namespace rpwa {
 		static void setDebug(const bool debug = true) { _debug = debug; }  ///< sets debug flag
 
 
+	protected:
+
+		isobarCanonicalAmplitude* doClone() const;  ///< helper function to use covariant return types with smart pointers; needed for public clone()
+
 	private:
 
+		double lsClebschCoeff(const isobarDecayVertexPtr& vertex,
+		                      const bool                  topVertex,
+		                      const int                   mL,
+		                      const int                   mS) const;  ///< calculates Clebsch-Gordan coefficient for L-S coupling; symmetrized for X decay in reflectivity basis
+
 		void transformDaughters() const;  ///< boosts Lorentz-vectors of decay daughters into frames where angular distributions are defined
 
 		std::complex<double> twoBodyDecayAmplitude
 		(const isobarDecayVertexPtr& vertex,
 		 const bool                  topVertex) const;  ///< calculates amplitude for two-body decay a -> b + c; where b and c are stable
 
+		bool twoBodyDecayAmplitudes
+		(const isobarDecayVertexPtr&  vertex,
+		 const bool                   topVertex,
+		 const vertexKinematicsBlock& kinematics,
+		 const unsigned int           nmbEvents,
+		 std::complex<double>*        amps) const;  ///< calculates two-body decay amplitude for the current helicities for all events of a block
+
+		bool compileTwoBodyDecay
+		(const isobarDecayVertexPtr& vertex,
+		 const bool                  topVertex,
+		 decayProgramOp&             op,
+		 decayProgramTerm&           term) const;  ///< adds the angular terms of the two-body decay amplitude for the current helicities to the program term
+
 		static bool _debug;  ///< if set to true, debug messages are printed
 
 	};
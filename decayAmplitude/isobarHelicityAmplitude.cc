@@ -63,6 +63,15 @@ isobarHelicityAmplitude::~isobarHelicityAmplitude()
 { }
 
 
+isobarHelicityAmplitude*
+isobarHelicityAmplitude::doClone() const
+{
+	isobarHelicityAmplitude* ampClone = new isobarHelicityAmplitude(*this);
+	ampClone->cloneDecayTopology();
+	return ampClone;
+}
+
+
 TLorentzRotation
 isobarHelicityAmplitude::hfTransform(const TLorentzVector& daughterLv)
 {
@@ -105,9 +114,7 @@ isobarHelicityAmplitude::transformDaughters() const
 	// calculate Lorentz-transformations into the correct frames for the
 	// daughters in the decay vertices
 	// 1) transform daughters of all decay vertices into Gottfried-Jackson frame
-	const TLorentzVector&  beamLv  = _decay->productionVertex()->referenceLzVec();
-	const TLorentzVector&  XLv     = _decay->XParticle()->lzVec();
-	const TLorentzRotation gjTrans = gjTransform(beamLv, XLv);
+	const TLorentzRotation gjTrans = eventGjTransform();
 	for (unsigned int i = 0; i < _decay->nmbDecayVertices(); ++i) {
 		const isobarDecayVertexPtr& vertex = _decay->isobarDecayVertices()[i];
 		if (_debug)
@@ -196,3 +203,96 @@ isobarHelicityAmplitude::twoBodyDecayAmplitude(const isobarDecayVertexPtr& verte
 		printDebug << "two-body decay amplitude = " << maxPrecisionDouble(amp) << endl;
 	return amp;
 }
+
+
+// same as twoBodyDecayAmplitude(), but the Clebsch-Gordan coefficients
+// are calculated only once for all events of the block
+bool
+isobarHelicityAmplitude::twoBodyDecayAmplitudes(const isobarDecayVertexPtr&  vertex,
+                                                const bool                   topVertex,
+                                                const vertexKinematicsBlock& kinematics,
+                                                const unsigned int           nmbEvents,
+                                                complex<double>*             amps) const
+{
+	const particlePtr& parent    = vertex->parent();
+	const particlePtr& daughter1 = vertex->daughter1();
+	const particlePtr& daughter2 = vertex->daughter2();
+
+	// calculate Clebsch-Gordan coefficients for L-S and S-S coupling
+	const int    L         = vertex->L();
+	const int    S         = vertex->S();
+	const int    J         = parent->J();
+	const int    lambda1   = daughter1->spinProj();
+	const int    lambda2   = daughter2->spinProj();
+	const int    lambda    = lambda1 - lambda2;
+	const double lsClebsch = clebschGordanCoeff<double>(L, 0, S, lambda, J, lambda, _debug);
+	if (lsClebsch == 0)
+		return false;
+	const int    s1        = daughter1->J();
+	const int    s2        = daughter2->J();
+	const double ssClebsch = clebschGordanCoeff<double>(s1, lambda1, s2, -lambda2, S, lambda, _debug);
+	if (ssClebsch == 0)
+		return false;
+
+	const int    Lambda   = parent->spinProj();
+	const int    P        = parent->P();
+	const int    refl     = parent->reflectivity();
+	const bool   reflConj = topVertex and _useReflectivityBasis;
+	const double norm     = angMomNormFactor(L, _debug);
+	for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		const double    phi   = kinematics.phi  [iEvent];
+		const double    theta = kinematics.theta[iEvent];
+		complex<double> DFunc;
+		if (reflConj)
+			DFunc = DFunctionReflConj<complex<double> >(J, Lambda, lambda, P, refl, phi, theta, 0, _debug);
+		else
+			DFunc = DFunctionConj<complex<double> >(J, Lambda, lambda, phi, theta, 0, _debug);
+		amps[iEvent] = norm * DFunc * lsClebsch * ssClebsch * kinematics.barrierFactor[iEvent] * kinematics.massDepAmp[iEvent];
+	}
+	return true;
+}
+
+
+// same as twoBodyDecayAmplitudes(), but instead of calculating the
+// amplitudes the D-function and its coefficient are added to the decay
+// program
+bool
+isobarHelicityAmplitude::compileTwoBodyDecay(const isobarDecayVertexPtr& vertex,
+                                             const bool                  topVertex,
+                                             decayProgramOp&             op,
+                                             decayProgramTerm&           term) const
+{
+	const particlePtr& parent    = vertex->parent();
+	const particlePtr& daughter1 = vertex->daughter1();
+	const particlePtr& daughter2 = vertex->daughter2();
+
+	// calculate Clebsch-Gordan coefficients for L-S and S-S coupling
+	const int    L         = vertex->L();
+	const int    S         = vertex->S();
+	const int    J         = parent->J();
+	const int    lambda1   = daughter1->spinProj();
+	const int    lambda2   = daughter2->spinProj();
+	const int    lambda    = lambda1 - lambda2;
+	const double lsClebsch = clebschGordanCoeff<double>(L, 0, S, lambda, J, lambda, _debug);
+	if (lsClebsch == 0)
+		return false;
+	const int    s1        = daughter1->J();
+	const int    s2        = daughter2->J();
+	const double ssClebsch = clebschGordanCoeff<double>(s1, lambda1, s2, -lambda2, S, lambda, _debug);
+	if (ssClebsch == 0)
+		return false;
+
+	decayProgramAngularFunction function;
+	if (topVertex and _useReflectivityBasis)
+		function.type = decayProgramAngularFunction::D_FUNCTION_REFL_CONJ;
+	else
+		function.type = decayProgramAngularFunction::D_FUNCTION_CONJ;
+	function.j    = J;
+	function.m    = parent->spinProj();
+	function.n    = lambda;
+	function.P    = parent->P();
+	function.refl = parent->reflectivity();
+	const double norm = angMomNormFactor(L, _debug);
+	term.angularTerms.push_back(make_pair(addAngularFunction(op, function), norm * lsClebsch * ssClebsch));
+	return true;
+}
@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      per-event cache of isobar sub-decay amplitudes shared by several
+//      isobar amplitudes
+//
+//
+//-------------------------------------------------------------------------
+
+
+
+#include "isobarSubAmplitudeCache.h"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+isobarSubAmplitudeCache::isobarSubAmplitudeCache()
+	: _eventIndex      (1),
+	  _nmbRegistrations(0),
+	  _nmbLookups      (0),
+	  _nmbHits         (0)
+{ }
+
+
+unsigned int
+isobarSubAmplitudeCache::registerSubDecay(const string&      signature,
+                                          const unsigned int nmbHelicities)
+{
+	++_nmbRegistrations;
+	map<string, unsigned int>::const_iterator entry = _subDecaySlots.find(signature);
+	if (entry != _subDecaySlots.end())
+		return entry->second;
+	// slot event indices start at 0, i.e. before the first event
+	const unsigned int slot = _amps.size();
+	_amps.resize            (slot + nmbHelicities, 0);
+	_slotEventIndices.resize(slot + nmbHelicities, 0);
+	_subDecaySlots[signature] = slot;
+	return slot;
+}
+
+
+ostream&
+isobarSubAmplitudeCache::print(ostream& out) const
+{
+	out << "isobar sub-amplitude cache: " << nmbSubDecays() << " distinct sub-decays for "
+	    << _nmbRegistrations << " registered sub-decays, " << _nmbHits << " of " << _nmbLookups
+	    << " sub-amplitudes taken from cache";
+	return out;
+}
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      per-event cache of isobar sub-decay amplitudes shared by several
+//      isobar amplitudes
+//
+//
+//-------------------------------------------------------------------------
+
+
+
+#ifndef ISOBARSUBAMPLITUDECACHE_H
+#define ISOBARSUBAMPLITUDECACHE_H
+
+
+#include <complex>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+
+namespace rpwa {
+
+
+	class isobarSubAmplitudeCache;
+	typedef boost::shared_ptr<rpwa::isobarSubAmplitudeCache> isobarSubAmplitudeCachePtr;
+
+
+	// the same isobar sub-decay, e.g. rho(770) -> pi pi with the same
+	// final-state particles, appears in many waves of a wave set. every
+	// sub-decay is registered with a signature that contains everything
+	// its amplitude depends on except for the helicity of the isobar; all
+	// amplitudes that register the same signature share one slot per
+	// helicity. the stored amplitudes are valid until newEvent() is
+	// called, so a cache must only be shared by amplitudes that are
+	// evaluated for the same event
+	class isobarSubAmplitudeCache {
+
+	public:
+
+		isobarSubAmplitudeCache();
+		~isobarSubAmplitudeCache() { }
+
+		/// returns index of first slot of the sub-decay with the given signature; there is one slot for each of the nmbHelicities helicities
+		unsigned int registerSubDecay(const std::string& signature,
+		                              const unsigned int nmbHelicities);
+
+		void newEvent() { ++_eventIndex; }  ///< invalidates all stored amplitudes
+
+		bool get(const unsigned int    slot,
+		         std::complex<double>& amp)  ///< returns whether amplitude in slot was already calculated for the current event
+		{
+			++_nmbLookups;
+			if (_slotEventIndices[slot] != _eventIndex)
+				return false;
+			++_nmbHits;
+			amp = _amps[slot];
+			return true;
+		}
+
+		void set(const unsigned int          slot,
+		         const std::complex<double>& amp)  ///< stores amplitude in slot for the current event
+		{
+			_amps            [slot] = amp;
+			_slotEventIndices[slot] = _eventIndex;
+		}
+
+		unsigned int  nmbSubDecays     () const { return _subDecaySlots.size(); }  ///< returns number of distinct sub-decays
+		unsigned int  nmbRegistrations () const { return _nmbRegistrations;     }  ///< returns number of registered sub-decays including duplicates
+		unsigned long nmbLookups       () const { return _nmbLookups;           }
+		unsigned long nmbHits          () const { return _nmbHits;              }
+
+		std::ostream& print(std::ostream& out) const;
+
+	private:
+
+		std::map<std::string, unsigned int> _subDecaySlots;     ///< first slot of each sub-decay signature
+		std::vector<std::complex<double> >  _amps;              ///< stored amplitudes
+		std::vector<unsigned long>          _slotEventIndices;  ///< index of event for which amplitude in slot was calculated
+		unsigned long                       _eventIndex;        ///< index of current event
+		unsigned int                        _nmbRegistrations;
+		unsigned long                       _nmbLookups;
+		unsigned long                       _nmbHits;
+
+	};
+
+
+	inline
+	isobarSubAmplitudeCachePtr
+	createIsobarSubAmplitudeCache()
+	{
+		isobarSubAmplitudeCachePtr cache(new isobarSubAmplitudeCache());
+		return cache;
+	}
+
+
+	inline
+	std::ostream&
+	operator <<(std::ostream&                  out,
+	            const isobarSubAmplitudeCache& cache)
+	{
+		return cache.print(out);
+	}
+
+
+}  // namespace rpwa
+
+
+#endif  // ISOBARSUBAMPLITUDECACHE_H
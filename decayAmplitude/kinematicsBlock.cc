@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      momenta of a block of events for the batched calculation of
+//      isobar amplitudes
+//
+//
+//-------------------------------------------------------------------------
+
+
+
+#include <TClonesArray.h>
+#include <TVector3.h>
+
+#include "reportingUtils.hpp"
+#include "kinematicsBlock.h"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+const unsigned int kinematicsBlock::defaultCapacity = 256;
+
+
+kinematicsBlock::kinematicsBlock(const unsigned int capacity)
+	: _nmbEvents(0)
+{
+	for (unsigned int i = 0; i < capacity; ++i) {
+		_prodKinMomenta.push_back (new TClonesArray("TVector3"));
+		_decayKinMomenta.push_back(new TClonesArray("TVector3"));
+	}
+}
+
+
+kinematicsBlock::~kinematicsBlock()
+{
+	for (unsigned int i = 0; i < _prodKinMomenta.size(); ++i) {
+		delete _prodKinMomenta [i];
+		delete _decayKinMomenta[i];
+	}
+}
+
+
+bool
+kinematicsBlock::addEvent(const TClonesArray& prodKinMomenta,
+                          const TClonesArray& decayKinMomenta)
+{
+	if (full()) {
+		printWarn << "kinematics block is full (" << capacity() << " events). cannot add event." << endl;
+		return false;
+	}
+	TClonesArray& blockProdKinMomenta  = *_prodKinMomenta [_nmbEvents];
+	TClonesArray& blockDecayKinMomenta = *_decayKinMomenta[_nmbEvents];
+	blockProdKinMomenta.Clear();
+	for (int i = 0; i < prodKinMomenta.GetEntriesFast(); ++i)
+		new (blockProdKinMomenta[i]) TVector3(*static_cast<const TVector3*>(prodKinMomenta.At(i)));
+	blockDecayKinMomenta.Clear();
+	for (int i = 0; i < decayKinMomenta.GetEntriesFast(); ++i)
+		new (blockDecayKinMomenta[i]) TVector3(*static_cast<const TVector3*>(decayKinMomenta.At(i)));
+	++_nmbEvents;
+	return true;
+}
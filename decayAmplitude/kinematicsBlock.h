@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      momenta of a block of events for the batched calculation of
+//      isobar amplitudes
+//
+//
+//-------------------------------------------------------------------------
+
+
+
+#ifndef KINEMATICSBLOCK_H
+#define KINEMATICSBLOCK_H
+
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+
+class TClonesArray;
+
+
+namespace rpwa {
+
+
+	class kinematicsBlock;
+	typedef boost::shared_ptr<rpwa::kinematicsBlock> kinematicsBlockPtr;
+
+
+	// holds copies of the production and decay kinematics momenta of up to
+	// capacity() events in the form in which they are read from the event
+	// tree. isobarAmplitude::amplitude() calculates the amplitudes of all
+	// events of a block at once; blocks of a few hundred events are large
+	// enough to amortize the event-independent parts of the calculation
+	// and small enough for the intermediate arrays to stay in the cache
+	class kinematicsBlock {
+
+	public:
+
+		kinematicsBlock(const unsigned int capacity);
+		~kinematicsBlock();
+
+		unsigned int capacity () const { return _prodKinMomenta.size(); }  ///< returns maximum number of events
+		unsigned int nmbEvents() const { return _nmbEvents;             }  ///< returns number of events in block
+		bool         full     () const { return _nmbEvents == capacity(); }
+
+		void clear() { _nmbEvents = 0; }  ///< removes all events from block
+
+		bool addEvent(const TClonesArray& prodKinMomenta,
+		              const TClonesArray& decayKinMomenta);  ///< copies momenta of an event into the block
+
+		const TClonesArray& prodKinMomenta (const unsigned int eventIndex) const { return *_prodKinMomenta [eventIndex]; }
+		const TClonesArray& decayKinMomenta(const unsigned int eventIndex) const { return *_decayKinMomenta[eventIndex]; }
+
+		static const unsigned int defaultCapacity;
+
+	private:
+
+		kinematicsBlock(const kinematicsBlock&);
+		kinematicsBlock& operator =(const kinematicsBlock&);
+
+		std::vector<TClonesArray*> _prodKinMomenta;
+		std::vector<TClonesArray*> _decayKinMomenta;
+		unsigned int               _nmbEvents;
+
+	};
+
+
+	inline
+	kinematicsBlockPtr
+	createKinematicsBlock(const unsigned int capacity)
+	{
+		kinematicsBlockPtr block(new kinematicsBlock(capacity));
+		return block;
+	}
+
+
+}  // namespace rpwa
+
+
+#endif  // KINEMATICSBLOCK_H
@@ -41,6 +41,7 @@
 
 #pragma link C++ class rpwa::waveDescription+;
 #pragma link C++ class rpwa::ampIntegralMatrixMetadata+;
+#pragma link C++ class rpwa::ampIntegralShard+;
 // data model evolution rule that triggers parsing of key file string
 // whenever waveDescription is read from file
 // see http://root.cern.ch/root/html/io/DataModelEvolution.html
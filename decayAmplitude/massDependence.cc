@@ -90,6 +90,14 @@ binnedMassDependence::amp(const isobarDecayVertex& v)
 }
 
 
+ostream&
+binnedMassDependence::print(ostream& out) const
+{
+	out << name() << " [" << maxPrecision(_mMin) << ", " << maxPrecision(_mMax) << ")";
+	return out;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 complex<double>
 relativisticBreitWigner::amp(const isobarDecayVertex& v)
@@ -281,7 +289,6 @@ f0980Flatte::amp(const isobarDecayVertex& v)
 ////////////////////////////////////////////////////////////////////////////////
 piPiSWaveAuMorganPenningtonM::piPiSWaveAuMorganPenningtonM()
 	: massDependence(),
-	  _T       (2, 2),
 	  _a       (2, matrix<complex<double> >(2, 2)),
 	  _c       (5, matrix<complex<double> >(2, 2)),
 	  _sP      (1, 2),
@@ -379,8 +386,9 @@ piPiSWaveAuMorganPenningtonM::amp(const isobarDecayVertex& v)
 	M(0, 1) = 0;
 	M(1, 0) = 0;
 
-	invertMatrix<complex<double> >(M - imag * rho, _T);
-	const complex<double> amp = _T(0, 0);
+	matrix<complex<double> > T(2, 2);
+	invertMatrix<complex<double> >(M - imag * rho, T);
+	const complex<double> amp = T(0, 0);
 	if (_debug)
 		printDebug << name() << "(m = " << maxPrecision(mass) << " GeV) = "
 		           << maxPrecisionDouble(amp) << endl;
@@ -49,6 +49,8 @@ namespace rpwa {
 
 	class isobarDecayVertex;
 	typedef boost::shared_ptr<isobarDecayVertex> isobarDecayVertexPtr;
+	class massDependence;
+	typedef boost::shared_ptr<massDependence> massDependencePtr;
 
 
 	//////////////////////////////////////////////////////////////////////////////
@@ -60,6 +62,8 @@ namespace rpwa {
 		massDependence()          { }
 		virtual ~massDependence() { }
 
+		massDependencePtr clone() const { return massDependencePtr(doClone()); }  ///< creates copy of mass dependence; null pointer, if the type cannot be copied (e.g. mass dependences implemented in Python)
+
 		virtual std::complex<double> amp(const isobarDecayVertex& v) = 0;
 
 		virtual std::complex<double> operator ()(const isobarDecayVertex& v) { return amp(v); }
@@ -77,6 +81,12 @@ namespace rpwa {
 
 	protected:
 
+		virtual massDependence* doClone() const { return 0; }  ///< helper function to use covariant return types with smart pointers; needed for public clone()
+
+		template<class massDependenceT>
+		massDependence* cloneAs() const  ///< copies this as massDependenceT, if it is exactly of this type; derived classes that do not override doClone() are not copied
+		{ return (typeid(*this) == typeid(massDependenceT)) ? new massDependenceT(static_cast<const massDependenceT&>(*this)) : 0; }
+
 		virtual bool isEqualTo(const massDependence& massDep) const
 		{ return typeid(massDep) == typeid(*this); }  ///< returns whether massDep is of same type as this
 
@@ -85,9 +95,6 @@ namespace rpwa {
 	};
 
 
-	typedef boost::shared_ptr<massDependence> massDependencePtr;
-
-
 	inline
 	std::ostream&
 	operator <<(std::ostream&         out,
@@ -110,6 +117,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "flat"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<flatMassDependence>(); }
+
 	};
 
 
@@ -141,6 +152,12 @@ namespace rpwa {
 		double getMassMin() const { return _mMin; }
 		double getMassMax() const { return _mMax; }
 
+		virtual std::ostream& print(std::ostream& out) const;  ///< prints name and mass range
+
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<binnedMassDependence>(); }
+
 	private:
 		double _mMin;  ///< Lower limit of the isobar mass bin
 		double _mMax;  ///< Upper limit of the isobar mass bin
@@ -173,6 +190,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "relativisticBreitWigner"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<relativisticBreitWigner>(); }
+
 	};
 
 
@@ -201,6 +222,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "constWidthBreitWigner"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<constWidthBreitWigner>(); }
+
 	};
 
 
@@ -234,6 +259,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "rhoBreitWigner"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<rhoBreitWigner>(); }
+
 	};
 
 
@@ -264,6 +293,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "f_0(980)"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<f0980BreitWigner>(); }
+
 	};
 
 
@@ -293,6 +326,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "f_0(980)Flatte"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<f0980Flatte>(); }
+
 	private:
 		double _piChargedMass;
 		double _kaonChargedMass;
@@ -330,7 +367,8 @@ namespace rpwa {
 
 	protected:
 
-		ublas::matrix<std::complex<double> >               _T;
+		virtual massDependence* doClone() const { return cloneAs<piPiSWaveAuMorganPenningtonM>(); }
+
 		std::vector<ublas::matrix<std::complex<double> > > _a;
 		std::vector<ublas::matrix<std::complex<double> > > _c;
 		ublas::matrix<double>                              _sP;
@@ -372,6 +410,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "piPiSWaveAuMorganPenningtonVes"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<piPiSWaveAuMorganPenningtonVes>(); }
+
 	};
 
 
@@ -410,6 +452,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "piPiSWaveAuMorganPenningtonKachaev"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<piPiSWaveAuMorganPenningtonKachaev>(); }
+
 	};
 
 
@@ -439,6 +485,10 @@ namespace rpwa {
 
 		virtual std::string name() const { return "rhoPrime"; }  ///< returns label used in graph visualization, reporting, and key file
 
+	protected:
+
+		virtual massDependence* doClone() const { return cloneAs<rhoPrimeMassDep>(); }
+
 	};
 
 
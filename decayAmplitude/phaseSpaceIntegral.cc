@@ -23,19 +23,21 @@ using namespace std;
 using namespace rpwa;
 
 phaseSpaceIntegral* phaseSpaceIntegral::_instance = 0;
+once_flag phaseSpaceIntegral::_instanceFlag;
 
 phaseSpaceIntegral* phaseSpaceIntegral::instance()
 {
-	if(not _instance) {
+	call_once(_instanceFlag, []() {
 		printInfo << "singleton instantiated." << endl;
 		_instance = new phaseSpaceIntegral();
-	}
+	});
 	return _instance;
 }
 
 
 complex<double> phaseSpaceIntegral::operator()(const isobarDecayVertex& vertex) {
 
+	lock_guard<recursive_mutex> lock(_mutex);
 	map<const isobarDecayVertex*, string>::iterator name_it = _vertexToSubwaveName.find(&vertex);
 	if(name_it == _vertexToSubwaveName.end()) {
 		string waveName = integralTableContainer::getSubWaveNameFromVertex(vertex);
@@ -60,6 +62,7 @@ complex<double> phaseSpaceIntegral::operator()(const isobarDecayVertex& vertex)
 
 
 void phaseSpaceIntegral::removeVertex(const isobarDecayVertex* vertex) {
+	lock_guard<recursive_mutex> lock(_mutex);
 	map<const isobarDecayVertex*, string>::iterator name_it = _vertexToSubwaveName.find(vertex);
 	if(name_it != _vertexToSubwaveName.end()) {
 		_vertexToSubwaveName.erase(name_it);
@@ -2,6 +2,7 @@
 #define PHASESPACEINTEGRAL_H
 
 #include<complex>
+#include<mutex>
 
 #include"isobarDecayVertex.h"
 #include"isobarDecayTopology.h"
@@ -100,8 +101,13 @@ namespace rpwa {
 		phaseSpaceIntegral() { };
 
 		static phaseSpaceIntegral* _instance;
+		static std::once_flag _instanceFlag;
 		std::map<const isobarDecayVertex*, std::string> _vertexToSubwaveName;
 		std::map<std::string, integralTableContainer> _subwaveNameToIntegral;
+		// the amplitudes of several threads share the integral tables;
+		// recursive, because filling a table destroys temporary vertices,
+		// which remove themselves via removeVertex()
+		std::recursive_mutex _mutex;
 
 	};
 
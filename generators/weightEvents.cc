@@ -55,7 +55,7 @@
 
 #include "ampIntegralMatrix.h"
 #include "amplitudeMetadata.h"
-#include "amplitudeTreeLeaf.h"
+#include "eventWeights.h"
 #include "fitResult.h"
 #include "fileUtils.hpp"
 #include "partialWaveFitHelper.h"
@@ -68,18 +68,16 @@ using namespace rpwa;
 
 
 unsigned long
-openRootAmpFiles(const string&               ampDirName,
-                 const vector<string>&       waveNames,
-                 vector<TTree*>&             ampRootTrees,
-                 vector<amplitudeTreeLeaf*>& ampRootLeafs)
+openRootAmpFiles(const string&                      ampDirName,
+                 const vector<string>&              waveNames,
+                 vector<const amplitudeMetadata*>&  ampMetas)
 {
-	ampRootTrees.clear();
-	ampRootLeafs.assign(waveNames.size(), NULL);
+	ampMetas.clear();
 	unsigned long nmbAmpValues = 0;
 	for (size_t iWave = 0; iWave < waveNames.size(); ++iWave) {
 		// no amplitude file for the flat wave
 		if (waveNames[iWave] == "flat") {
-			ampRootTrees.push_back(NULL);
+			ampMetas.push_back(NULL);
 			continue;
 		}
 
@@ -101,7 +99,7 @@ openRootAmpFiles(const string&               ampDirName,
 		TTree* ampTree = ampMeta->amplitudeTree();
 
 		// check that all tree have the same number of entries
-		const unsigned long nmbEntries = ampTree->GetEntriesFast();
+		const unsigned long nmbEntries = ampMeta->nmbAmplitudes();
 		if (nmbEntries == 0) {
 			printErr << "amplitude tree '" << ampTree->GetName() << "' has zero entries. "
 			         << "skipping wave." << endl;
@@ -115,9 +113,7 @@ openRootAmpFiles(const string&               ampDirName,
 			continue;
 		}
 
-		// connect tree leaf
-		ampRootTrees.push_back(ampTree);
-		ampTree->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampRootLeafs[iWave]);
+		ampMetas.push_back(ampMeta);
 	}
 
 	return nmbAmpValues;
@@ -132,11 +128,12 @@ usage(const string& progName,
 	     << endl
 	     << "usage:" << endl
 	     << progName
-	     << " [-o output file -s -w fit-result file -n # of samples "
+	     << " [-o output file -x weight file -s -w fit-result file -n # of samples "
 	     << "-i integral file -d amplitude directory -R] "
 	     << "-m mass [-b mass bin width -t tree name -v -h]" << endl
 	     << "    where:" << endl
 	     << "        -o file    ROOT output file (default: './genpw.root')"<< endl
+	     << "        -x file    additionally write the weights to a binary weight file for the event file of the amplitudes (default: none)"<< endl
 	     << "        -s         write out weights for each single wave (caution: this vastly increase the size of the output file)" << endl
 	     << "        -w file    fit-result file containing the fitResult tree to be used as input (default: './fitresult.root')"<< endl
 	     << "        -n #       if > 1, additional production amplitudes are generated according to covariances (default: 1)"<< endl
@@ -170,6 +167,7 @@ main(int    argc,
 	// parse command line options
 	const string   progName                 = argv[0];
 	string         outFileName              = "./genpw.root";
+	string         weightFileName           = "";
 	string         fitResultFileName        = "./fitresult.root";
 	const string   fitResultTreeName        = "pwa";
 	const string   fitResultLeafName        = "fitResult_v2";
@@ -183,11 +181,14 @@ main(int    argc,
 	bool           debug                    = false;
 
 	int c;
-	while ((c = getopt(argc, argv, "o:sw:n:i:d:m:b:t:vh")) != -1) {
+	while ((c = getopt(argc, argv, "o:x:sw:n:i:d:m:b:t:vh")) != -1) {
 		switch (c) {
 		case 'o':
 			outFileName = optarg;
 			break;
+		case 'x':
+			weightFileName = optarg;
+			break;
 		case 's':
 			writeSingleWaveWeights = true;
 			break;
@@ -378,12 +379,10 @@ main(int    argc,
 	const unsigned int nmbProdAmps = prodAmpNames.size();
 
 	// open decay amplitude files
-	vector<TTree*>             ampRootTrees;
-	vector<amplitudeTreeLeaf*> ampRootLeafs;
-	const unsigned long        nmbEvents   = openRootAmpFiles(ampDirName, waveNames, ampRootTrees, ampRootLeafs);
+	vector<const amplitudeMetadata*> ampMetas;
+	const unsigned long              nmbEvents = openRootAmpFiles(ampDirName, waveNames, ampMetas);
 	// test that an amplitude file was opened for each wave
-	// note that ampRootLeafs cannot be used for this check
-	if (waveNames.size() != ampRootTrees.size()) {
+	if (waveNames.size() != ampMetas.size()) {
 		printErr << "error opening ROOT amplitude files." << endl;
 		exit(1);
 	}
@@ -392,6 +391,34 @@ main(int    argc,
 		exit(1);
 	}
 
+	// the binary weight file is bound to the content hash of the event
+	// file the amplitudes were calculated from
+	string eventContentHash = "";
+	if (weightFileName != "") {
+		for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave) {
+			if (not ampMetas[iWave])
+				continue;
+			if (ampMetas[iWave]->eventMetadata().size() != 1) {
+				printErr << "amplitudes of wave '" << waveNames[iWave] << "' do not belong to a single event file. "
+				         << "cannot write binary weight file. Aborting..." << endl;
+				exit(1);
+			}
+			const string& contentHash = ampMetas[iWave]->eventMetadata()[0].contentHash();
+			if (eventContentHash == "")
+				eventContentHash = contentHash;
+			else if (contentHash != eventContentHash) {
+				printErr << "amplitudes of wave '" << waveNames[iWave] << "' belong to a different event file "
+				         << "than the other amplitudes. cannot write binary weight file. Aborting..." << endl;
+				exit(1);
+			}
+		}
+		if (eventContentHash == "") {
+			printErr << "could not determine event file of the amplitudes. "
+			         << "cannot write binary weight file. Aborting..." << endl;
+			exit(1);
+		}
+	}
+
 	// create output file and tree
 	TFile* outFile = TFile::Open(outFileName.c_str(), "RECREATE");
 	TTree* outTree = new TTree(outTreeName.c_str(), outTreeName.c_str());
@@ -437,22 +464,32 @@ main(int    argc,
 	timer.Reset();
 	timer.Start();
 
-	// loop over amplitudes and calculate weight
+	// loop over amplitudes and calculate weight; the amplitudes are
+	// read in blocks of events
+	const unsigned long               ampBlockSize = amplitudeMetadata::defaultChunkSize;
+	vector<vector<complex<double> > > ampBlocks(nmbWaves, vector<complex<double> >(ampBlockSize, 0));  // [wave index][event index in block]
+	vector<complex<double> >          decayAmps(nmbWaves);
+	vector<double>                    weights;
+	if (weightFileName != "")
+		weights.reserve(nmbEvents);
 	progress_display progressIndicator(nmbEvents, cout, "");
 	for (unsigned long iEvent = 0; iEvent < nmbEvents; ++iEvent) {
 		++progressIndicator;
 
-		// read decay amplitudes for this event
-		vector<complex<double> > decayAmps(nmbWaves);
-			for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave) {
-			if (not ampRootTrees[iWave])  // e.g. flat wave
-				decayAmps[iWave] = complex<double>(0);
-			else {
-				ampRootTrees[iWave]->GetEntry(iEvent);
-				assert(ampRootLeafs[iWave]->nmbIncohSubAmps() == 1);
-				decayAmps[iWave] = ampRootLeafs[iWave]->incohSubAmp(0);
-			}
+		// read decay amplitudes of the next block of events
+		const unsigned long indexInBlock = iEvent % ampBlockSize;
+		if (indexInBlock == 0) {
+			const unsigned long nmbInBlock = min(ampBlockSize, nmbEvents - iEvent);
+			for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave)
+				// no amplitudes for e.g. the flat wave
+				if (ampMetas[iWave] and not ampMetas[iWave]->readAmplitudes(iEvent, nmbInBlock, ampBlocks[iWave].data())) {
+					printErr << "could not read amplitudes of wave '" << waveNames[iWave] << "' for events "
+					         << "[" << iEvent << ", " << iEvent + nmbInBlock << ")." << endl;
+					exit(1);
+				}
 		}
+		for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave)
+			decayAmps[iWave] = ampBlocks[iWave][indexInBlock];
 
 		// calculate weight for each sample of production amplitudes
 		for (unsigned int iSample = 0; iSample < nmbProdAmpSamples; ++iSample) {
@@ -511,6 +548,8 @@ main(int    argc,
 
 		}  // end loop over production-amplitude samples
 		outTree->Fill();
+		if (weightFileName != "")
+			weights.push_back(weight);
 	}
 
 	printSucc << "calculated weight for " << nmbEvents << " events" << endl;
@@ -522,12 +561,19 @@ main(int    argc,
 	outTree->Write();
 	outFile->Close();
 
+	if (weightFileName != "") {
+		if (not eventWeights::writeWeightFile(weightFileName, eventContentHash, weights)) {
+			printErr << "could not write binary weight file '" << weightFileName << "'. Aborting..." << endl;
+			exit(1);
+		}
+		printSucc << "wrote weights of " << weights.size() << " events to binary weight file '" << weightFileName << "'." << endl;
+	}
+
 	// cleanup
 	intFile->Close();
 	delete intFile;
 
-	ampRootTrees.clear();
-	ampRootLeafs.clear();
+	ampMetas.clear();
 
 	prodAmps.clear();
 
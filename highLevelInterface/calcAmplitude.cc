@@ -1,25 +1,194 @@
 
 #include "calcAmplitude.h"
 
+#include <algorithm>
+#include <map>
+
 #include <boost/progress.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <TClonesArray.h>
 #include <TTree.h>
 #include <TTreePerfStats.h>
 
+#include <amplitudeFileWriter.h>
+#include <amplitudeMatrixFileWriter.h>
 #include <reportingUtils.hpp>
 
 using namespace std;
 using namespace rpwa;
 
 
+namespace {
+
+	// the sub-amplitude cache is only valid during one pass over the
+	// events, so it is removed from the amplitudes when the pass ends
+	struct subAmplitudeCacheGuard {
+
+		subAmplitudeCacheGuard(const vector<isobarAmplitudePtr>& amplitudes)
+			: _amplitudes(amplitudes) { }
+
+		~subAmplitudeCacheGuard()
+		{
+			for(unsigned int i = 0; i < _amplitudes.size(); ++i) {
+				if(_amplitudes[i]) {
+					_amplitudes[i]->setSubAmplitudeCache(isobarSubAmplitudeCachePtr());
+				}
+			}
+		}
+
+		const vector<isobarAmplitudePtr>& _amplitudes;
+
+	};
+
+
+	// number of kinematics blocks per worker thread that are read from
+	// the tree before they are calculated in parallel
+	const unsigned int kinematicsBlocksPerWorker = 4;
+
+
+	unsigned int
+	nmbWorkerThreads(const unsigned int nmbThreads)
+	{
+#ifdef _OPENMP
+		return (nmbThreads == 0) ? omp_get_max_threads() : nmbThreads;
+#else
+		if(nmbThreads > 1) {
+			printWarn << "ROOTPWA was compiled without OpenMP support. "
+			          << "ignoring request to use " << nmbThreads << " threads." << endl;
+		}
+		return 1;
+#endif
+	}
+
+
+	// reads the events [firstEvent, lastEvent) sequentially into
+	// kinematics blocks and calculates the blocks in parallel, each
+	// worker thread with its own amplitudes; calcBlock(worker, iBlock,
+	// block, eventIndex) calculates the events of the iBlock-th block,
+	// whose first event is eventIndex, storeEvents(nmbEvents) collects the
+	// results of all blocks read in one go in event order. the global
+	// caches of Clebsch-Gordan coefficients, D-functions, and phase-space
+	// integrals, which the workers share, are thread-safe
+	template<typename calcBlockFunction, typename storeEventsFunction>
+	bool
+	processEventBlocks(TTree*                   tree,
+	                   TClonesArray*&           prodKinMomenta,
+	                   TClonesArray*&           decayKinMomenta,
+	                   const long               firstEvent,
+	                   const long               lastEvent,
+	                   const unsigned int       nmbWorkers,
+	                   boost::progress_display* progressIndicator,
+	                   calcBlockFunction        calcBlock,
+	                   storeEventsFunction      storeEvents)
+	{
+		vector<kinematicsBlockPtr> blocks;
+		for(unsigned int i = 0; i < kinematicsBlocksPerWorker * nmbWorkers; ++i) {
+			blocks.push_back(createKinematicsBlock(kinematicsBlock::defaultCapacity));
+		}
+		// vector<bool> cannot be written concurrently
+		vector<char> blockSuccess(blocks.size(), 0);
+		long eventIndex = firstEvent;
+		while(eventIndex < lastEvent) {
+			const long   roundStart    = eventIndex;
+			unsigned int nmbBlocksRound = 0;
+			while(nmbBlocksRound < blocks.size() and eventIndex < lastEvent) {
+				kinematicsBlock& block = *blocks[nmbBlocksRound++];
+				block.clear();
+				while(not block.full() and eventIndex < lastEvent) {
+					tree->GetEntry(eventIndex);
+					if(not prodKinMomenta or not decayKinMomenta) {
+						printWarn << "at least one of the input data arrays is a null pointer: "
+						          << "        production kinematics: " << "momenta = " << prodKinMomenta  << endl
+						          << "        decay kinematics:      " << "momenta = " << decayKinMomenta << endl
+						          << "skipping event." << endl;
+						return false;
+					}
+					block.addEvent(*prodKinMomenta, *decayKinMomenta);
+					++eventIndex;
+				}
+			}
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nmbWorkers)
+#endif
+			for(int i = 0; i < (int)nmbBlocksRound; ++i) {
+#ifdef _OPENMP
+				const unsigned int worker = omp_get_thread_num();
+#else
+				const unsigned int worker = 0;
+#endif
+				blockSuccess[i] = calcBlock(worker, i, *blocks[i], roundStart + i * kinematicsBlock::defaultCapacity);
+			}
+			for(unsigned int i = 0; i < nmbBlocksRound; ++i) {
+				if(not blockSuccess[i]) {
+					return false;
+				}
+			}
+			storeEvents(eventIndex - roundStart);
+			if(progressIndicator) {
+				(*progressIndicator) += eventIndex - roundStart;
+			}
+		}
+		return true;
+	}
+
+
+	// calculates the amplitudes of all waves for one event; the waves
+	// within one group share the transformation into the
+	// Gottfried-Jackson frame
+	bool
+	calcEventAmplitudes(const vector<isobarAmplitudePtr>&    amplitudes,
+	                    const vector<vector<unsigned int> >& waveGroups,
+	                    const isobarSubAmplitudeCachePtr&    subAmpCache,
+	                    const TClonesArray&                  prodKinMomenta,
+	                    const TClonesArray&                  decayKinMomenta,
+	                    const long                           eventIndex,
+	                    vector<complex<double> >&            eventAmps)
+	{
+		subAmpCache->newEvent();
+		for(unsigned int iGroup = 0; iGroup < waveGroups.size(); ++iGroup) {
+			const vector<unsigned int>& waveGroup = waveGroups[iGroup];
+			for(unsigned int i = 0; i < waveGroup.size(); ++i) {
+				if(not amplitudes[waveGroup[i]]->decayTopology()->readKinematicsData(prodKinMomenta, decayKinMomenta)) {
+					printWarn << "problems reading event[" << eventIndex << "] for wave " << waveGroup[i] << endl;
+					return false;
+				}
+			}
+			// the X Lorentz-vector is the sum of the final-state momenta of
+			// the event, which is the same for all waves in the group
+			const isobarDecayTopologyPtr& groupTopo = amplitudes[waveGroup[0]]->decayTopology();
+			const TLorentzVector   XLv     = groupTopo->calcIsobarLzVec();
+			const TLorentzVector   beamLv  = groupTopo->productionVertex()->referenceLzVec();
+			const TLorentzRotation gjTrans = isobarAmplitude::gjTransform(beamLv, XLv);
+			for(unsigned int i = 0; i < waveGroup.size(); ++i) {
+				const isobarAmplitudePtr& amplitude = amplitudes[waveGroup[i]];
+				// the reference Lorentz-vector also depends on the particle
+				// definitions in the production vertex of the wave
+				if(i == 0 or amplitude->decayTopology()->productionVertex()->referenceLzVec() == beamLv) {
+					eventAmps[waveGroup[i]] = amplitude->amplitude(gjTrans);
+				} else {
+					eventAmps[waveGroup[i]] = amplitude->amplitude();
+				}
+			}
+		}
+		return true;
+	}
+
+}
+
+
 vector<complex<double> >
 rpwa::hli::calcAmplitude(const eventMetadata&      eventMeta,
                          const isobarAmplitudePtr& amplitude,
                          const long int            maxNmbEvents,
                          const bool                printProgress,
                          const string&             treePerfStatOutFileName,         // root file name for tree performance result
-                         const long int            treeCacheSize)
+                         const long int            treeCacheSize,
+                         const unsigned int        nmbThreads)
 {
 	vector<complex<double> > retval;
 
@@ -50,10 +219,8 @@ rpwa::hli::calcAmplitude(const eventMetadata&      eventMeta,
 	tree->AddBranchToCache(eventMetadata::productionKinematicsMomentaBranchName.c_str(),  true);
 	tree->AddBranchToCache(eventMetadata::decayKinematicsMomentaBranchName.c_str(), true);
 	tree->StopCacheLearningPhase();
-	TTreePerfStats* treePerfStats = 0;
-	if(treePerfStatOutFileName != "") {
-		treePerfStats = new TTreePerfStats("ioPerf", tree);
-	}
+	// released on every return
+	const boost::scoped_ptr<TTreePerfStats> treePerfStats((treePerfStatOutFileName != "") ? new TTreePerfStats("ioPerf", tree) : 0);
 
 	// loop over events
 	if(not decayTopo->initKinematicsData(eventMeta.productionKinematicsParticleNames(), eventMeta.decayKinematicsParticleNames())) {
@@ -63,36 +230,328 @@ rpwa::hli::calcAmplitude(const eventMetadata&      eventMeta,
 	const long nmbEventsTree     = tree->GetEntries();
 	const long nmbEvents         = ((maxNmbEvents > 0) ? min(maxNmbEvents, nmbEventsTree)
 	                                : nmbEventsTree);
-	boost::progress_display* progressIndicator = (printProgress) ? new boost::progress_display(nmbEvents, cout, "") : 0;
-	for (long int eventIndex = 0; eventIndex < nmbEvents; ++eventIndex) {
-		if(progressIndicator) {
-			++(*progressIndicator);
+	const unsigned int nmbWorkers = nmbWorkerThreads(nmbThreads);
+	// every worker thread uses its own copy of the amplitude and its
+	// decay topology
+	vector<isobarAmplitudePtr> workerAmplitudes(1, amplitude);
+	for(unsigned int worker = 1; worker < nmbWorkers; ++worker) {
+		workerAmplitudes.push_back(amplitude->clone());
+	}
+	if(nmbWorkers > 1) {
+		printInfo << "calculating amplitudes using " << nmbWorkers << " threads." << endl;
+	}
+	retval.reserve(nmbEvents);
+	vector<complex<double> > roundAmps(kinematicsBlocksPerWorker * nmbWorkers * kinematicsBlock::defaultCapacity);
+	const boost::scoped_ptr<boost::progress_display> progressIndicator((printProgress) ? new boost::progress_display(nmbEvents, cout, "") : 0);
+	const bool success = processEventBlocks(
+		tree, prodKinMomenta, decayKinMomenta, 0, nmbEvents, nmbWorkers, progressIndicator.get(),
+		[&](const unsigned int worker, const unsigned int iBlock, const kinematicsBlock& block, const long eventIndex) -> bool {
+			if(not workerAmplitudes[worker]->amplitude(block, &roundAmps[iBlock * kinematicsBlock::defaultCapacity])) {
+				printWarn << "problems calculating amplitudes of events [" << eventIndex << ", "
+				          << eventIndex + block.nmbEvents() << ")" << endl;
+				return false;
+			}
+			return true;
+		},
+		[&](const long nmbEventsRound) {
+			retval.insert(retval.end(), roundAmps.begin(), roundAmps.begin() + nmbEventsRound);
+		});
+	if(not success) {
+		return vector<complex<double> >();
+	}
+
+	if(printProgress) {
+		tree->PrintCacheStats();
+	}
+	if(treePerfStats) {
+		treePerfStats->SaveAs(treePerfStatOutFileName.c_str());
+	}
+	return retval;
+}
+
+
+namespace {
+
+	// calculates the amplitudes of all given waves for the events
+	// [firstEvent, firstEvent + maxNmbEvents) in a single pass over the
+	// event tree. the amplitudes, the sub-amplitude caches, and the
+	// amplitude copies of the worker threads are set up only once; the
+	// events are calculated in blocks of eventBlockSize events (all
+	// events if eventBlockSize <= 0), whose amplitudes are passed as
+	// [wave][event] to storeBlock(waveAmps, blockFirstEvent)
+	template<typename storeBlockFunction>
+	bool
+	calcAmplitudesInBlocks(const eventMetadata&              eventMeta,
+	                       const vector<isobarAmplitudePtr>& amplitudes,
+	                       const long int                    firstEvent,
+	                       const long int                    maxNmbEvents,
+	                       const long int                    eventBlockSize,
+	                       const bool                        printProgress,
+	                       const string&                     treePerfStatOutFileName,
+	                       const long int                    treeCacheSize,
+	                       const unsigned int                nmbThreads,
+	                       storeBlockFunction                storeBlock)
+	{
+		TTree* tree = eventMeta.eventTree();
+		if(not tree) {
+			printErr << "event tree not found." << endl;
+			return false;
+		}
+
+		// initialize amplitudes and group them by production vertex and
+		// final state, the waves within one group share the transformation
+		// into the Gottfried-Jackson frame
+		vector<vector<unsigned int> > waveGroups;
+		map<string, unsigned int> waveGroupIndices;
+		for(unsigned int iWave = 0; iWave < amplitudes.size(); ++iWave) {
+			const isobarAmplitudePtr& amplitude = amplitudes[iWave];
+			if(not amplitude) {
+				printWarn << "null pointer to isobar decay amplitude for wave " << iWave << ". cannot process tree." << endl;
+				return false;
+			}
+			amplitude->init();
+			const isobarDecayTopologyPtr& decayTopo = amplitude->decayTopology();
+			if(not decayTopo->initKinematicsData(eventMeta.productionKinematicsParticleNames(), eventMeta.decayKinematicsParticleNames())) {
+				printWarn << "problems initializing input data for wave " << iWave << ". cannot read input data." << endl;
+				return false;
+			}
+			vector<string> fsParticleNames;
+			for(unsigned int i = 0; i < decayTopo->nmbFsParticles(); ++i) {
+				fsParticleNames.push_back(decayTopo->fsParticles()[i]->name());
+			}
+			sort(fsParticleNames.begin(), fsParticleNames.end());
+			string groupKey = decayTopo->productionVertex()->name();
+			for(unsigned int i = 0; i < fsParticleNames.size(); ++i) {
+				groupKey += " " + fsParticleNames[i];
+			}
+			map<string, unsigned int>::const_iterator group = waveGroupIndices.find(groupKey);
+			if(group == waveGroupIndices.end()) {
+				waveGroupIndices[groupKey] = waveGroups.size();
+				waveGroups.push_back(vector<unsigned int>(1, iWave));
+			} else {
+				waveGroups[group->second].push_back(iWave);
+			}
+		}
+		printInfo << "calculating amplitudes for " << amplitudes.size() << " waves in " << waveGroups.size() << " group(s) "
+		          << "with common Gottfried-Jackson frame." << endl;
+		// isobar sub-decays that appear in several waves are calculated only
+		// once per event
+		const isobarSubAmplitudeCachePtr subAmpCache = createIsobarSubAmplitudeCache();
+		const subAmplitudeCacheGuard     subAmpCacheGuard(amplitudes);
+		for(unsigned int iWave = 0; iWave < amplitudes.size(); ++iWave) {
+			if(not amplitudes[iWave]->setSubAmplitudeCache(subAmpCache)) {
+				printWarn << "could not register sub-decays of wave " << iWave << " in sub-amplitude cache." << endl;
+				return false;
+			}
+		}
+		printInfo << "found " << subAmpCache->nmbSubDecays() << " distinct isobar sub-decays in "
+		          << subAmpCache->nmbRegistrations() << " sub-decays of all waves and symmetrization terms." << endl;
+		// every worker thread uses its own copies of the amplitudes, which
+		// share a sub-amplitude cache of their own
+		const unsigned int nmbWorkers = nmbWorkerThreads(nmbThreads);
+		vector<vector<isobarAmplitudePtr> > workerAmplitudes(1, amplitudes);
+		vector<isobarSubAmplitudeCachePtr>  workerSubAmpCaches(1, subAmpCache);
+		for(unsigned int worker = 1; worker < nmbWorkers; ++worker) {
+			workerAmplitudes.push_back(vector<isobarAmplitudePtr>());
+			workerSubAmpCaches.push_back(createIsobarSubAmplitudeCache());
+			for(unsigned int iWave = 0; iWave < amplitudes.size(); ++iWave) {
+				workerAmplitudes[worker].push_back(amplitudes[iWave]->clone());
+				if(not workerAmplitudes[worker][iWave]->setSubAmplitudeCache(workerSubAmpCaches[worker])) {
+					printWarn << "could not register sub-decays of wave " << iWave << " in sub-amplitude cache "
+					          << "of thread " << worker << "." << endl;
+					return false;
+				}
+			}
+		}
+		if(nmbWorkers > 1) {
+			printInfo << "calculating amplitudes using " << nmbWorkers << " threads." << endl;
+		}
+
+		// create branch pointers and leaf variables
+		TBranch*      prodKinMomentaBr  = 0;
+		TBranch*      decayKinMomentaBr = 0;
+		TClonesArray* prodKinMomenta    = 0;
+		TClonesArray* decayKinMomenta   = 0;
+
+		// connect leaf variables to tree branches
+		tree->SetBranchAddress(eventMetadata::productionKinematicsMomentaBranchName.c_str(),  &prodKinMomenta,  &prodKinMomentaBr );
+		tree->SetBranchAddress(eventMetadata::decayKinematicsMomentaBranchName.c_str(), &decayKinMomenta, &decayKinMomentaBr);
+		tree->SetCacheSize(treeCacheSize);
+		tree->AddBranchToCache(eventMetadata::productionKinematicsMomentaBranchName.c_str(),  true);
+		tree->AddBranchToCache(eventMetadata::decayKinematicsMomentaBranchName.c_str(), true);
+		tree->StopCacheLearningPhase();
+		// released on every return
+		const boost::scoped_ptr<TTreePerfStats> treePerfStats((treePerfStatOutFileName != "") ? new TTreePerfStats("ioPerf", tree) : 0);
+
+		// loop over events
+		const long nmbEventsTree = tree->GetEntries();
+		if(firstEvent < 0 or firstEvent > nmbEventsTree) {
+			printWarn << "first event " << firstEvent << " is out of range [0, " << nmbEventsTree << "]." << endl;
+			return false;
 		}
+		const long lastEvent = ((maxNmbEvents > 0) ? min(firstEvent + maxNmbEvents, nmbEventsTree)
+		                        : nmbEventsTree);
+		const long blockSize = ((eventBlockSize > 0) ? eventBlockSize : max(lastEvent - firstEvent, 1L));
+		const boost::scoped_ptr<boost::progress_display> progressIndicator((printProgress) ? new boost::progress_display(lastEvent - firstEvent, cout, "") : 0);
+		vector<vector<complex<double> > > waveAmps(amplitudes.size());
+		vector<vector<complex<double> > > roundAmps;
+		if(nmbWorkers > 1) {
+			roundAmps.assign(kinematicsBlocksPerWorker * nmbWorkers * kinematicsBlock::defaultCapacity,
+			                 vector<complex<double> >(amplitudes.size()));
+		}
+		vector<complex<double> > eventAmps(amplitudes.size());
+		for(long blockFirstEvent = firstEvent; blockFirstEvent < lastEvent; blockFirstEvent += blockSize) {
+			const long blockLastEvent = min(blockFirstEvent + blockSize, lastEvent);
+			for(unsigned int iWave = 0; iWave < amplitudes.size(); ++iWave) {
+				waveAmps[iWave].clear();
+				waveAmps[iWave].reserve(blockLastEvent - blockFirstEvent);
+			}
+			if(nmbWorkers > 1) {
+				const bool success = processEventBlocks(
+					tree, prodKinMomenta, decayKinMomenta, blockFirstEvent, blockLastEvent, nmbWorkers, progressIndicator.get(),
+					[&](const unsigned int worker, const unsigned int iBlock, const kinematicsBlock& block, const long eventIndex) -> bool {
+						for(unsigned int i = 0; i < block.nmbEvents(); ++i) {
+							if(not calcEventAmplitudes(workerAmplitudes[worker], waveGroups, workerSubAmpCaches[worker],
+							                           block.prodKinMomenta(i), block.decayKinMomenta(i), eventIndex + i,
+							                           roundAmps[iBlock * kinematicsBlock::defaultCapacity + i])) {
+								return false;
+							}
+						}
+						return true;
+					},
+					[&](const long nmbEventsRound) {
+						for(long i = 0; i < nmbEventsRound; ++i) {
+							for(unsigned int iWave = 0; iWave < amplitudes.size(); ++iWave) {
+								waveAmps[iWave].push_back(roundAmps[i][iWave]);
+							}
+						}
+					});
+				if(not success) {
+					return false;
+				}
+			} else {
+				for (long int eventIndex = blockFirstEvent; eventIndex < blockLastEvent; ++eventIndex) {
+					if(progressIndicator) {
+						++(*progressIndicator);
+					}
+
+					tree->GetEntry(eventIndex);
 
-		tree->GetEntry(eventIndex);
+					if(not prodKinMomenta or not decayKinMomenta) {
+						printWarn << "at least one of the input data arrays is a null pointer: "
+						          << "        production kinematics: " << "momenta = " << prodKinMomenta  << endl
+						          << "        decay kinematics:      " << "momenta = " << decayKinMomenta << endl
+						          << "skipping event." << endl;
+						return false;
+					}
 
-		if(not prodKinMomenta or not decayKinMomenta) {
-			printWarn << "at least one of the input data arrays is a null pointer: "
-			          << "        production kinematics: " << "momenta = " << prodKinMomenta  << endl
-			          << "        decay kinematics:      " << "momenta = " << decayKinMomenta << endl
-			          << "skipping event." << endl;
-			return vector<complex<double> >();
+					if(not calcEventAmplitudes(amplitudes, waveGroups, subAmpCache, *prodKinMomenta, *decayKinMomenta, eventIndex, eventAmps)) {
+						return false;
+					}
+					for(unsigned int iWave = 0; iWave < amplitudes.size(); ++iWave) {
+						waveAmps[iWave].push_back(eventAmps[iWave]);
+					}
+				}
+			}
+			if(not storeBlock(waveAmps, blockFirstEvent)) {
+				return false;
+			}
 		}
 
-		if(decayTopo->readKinematicsData(*prodKinMomenta, *decayKinMomenta)) {
-			retval.push_back((*amplitude)());
-		} else {
-			printWarn << "problems reading event[" << eventIndex << "]" << endl;
-			return vector<complex<double> >();
+		for(unsigned int worker = 0; worker < nmbWorkers; ++worker) {
+			printInfo << *workerSubAmpCaches[worker] << endl;
 		}
-	}
 
-	if(printProgress) {
-		tree->PrintCacheStats();
+		if(printProgress) {
+			tree->PrintCacheStats();
+		}
+		if(treePerfStats) {
+			treePerfStats->SaveAs(treePerfStatOutFileName.c_str());
+		}
+		return true;
 	}
-	if(treePerfStats) {
-		treePerfStats->SaveAs(treePerfStatOutFileName.c_str());
-		delete treePerfStats;
+
+}
+
+
+vector<vector<complex<double> > >
+rpwa::hli::calcAmplitudes(const eventMetadata&              eventMeta,
+                          const vector<isobarAmplitudePtr>& amplitudes,
+                          const long int                    firstEvent,
+                          const long int                    maxNmbEvents,
+                          const bool                        printProgress,
+                          const string&                     treePerfStatOutFileName,         // root file name for tree performance result
+                          const long int                    treeCacheSize,
+                          const unsigned int                nmbThreads)
+{
+	vector<vector<complex<double> > > retval(amplitudes.size());
+	const bool success = calcAmplitudesInBlocks(
+		eventMeta, amplitudes, firstEvent, maxNmbEvents, -1, printProgress, treePerfStatOutFileName, treeCacheSize, nmbThreads,
+		[&](vector<vector<complex<double> > >& waveAmps, const long) -> bool {
+			retval.swap(waveAmps);
+			return true;
+		});
+	if(not success) {
+		return vector<vector<complex<double> > >();
 	}
 	return retval;
 }
+
+
+bool
+rpwa::hli::calcAmplitudes(const eventMetadata&                eventMeta,
+                          const vector<isobarAmplitudePtr>&   amplitudes,
+                          const vector<amplitudeFileWriter*>& ampFileWriters,
+                          const long int                      eventBlockSize,
+                          const bool                          printProgress,
+                          const string&                       treePerfStatOutFileName,         // root file name for tree performance result
+                          const long int                      treeCacheSize,
+                          const unsigned int                  nmbThreads)
+{
+	if(ampFileWriters.size() != amplitudes.size()) {
+		printWarn << "number of amplitude file writers (" << ampFileWriters.size() << ") does not match "
+		          << "number of waves (" << amplitudes.size() << ")." << endl;
+		return false;
+	}
+	for(unsigned int iWave = 0; iWave < ampFileWriters.size(); ++iWave) {
+		if(not ampFileWriters[iWave] or not ampFileWriters[iWave]->initialized()) {
+			printWarn << "amplitude file writer of wave " << iWave << " is not initialized." << endl;
+			return false;
+		}
+	}
+	return calcAmplitudesInBlocks(
+		eventMeta, amplitudes, 0, -1, eventBlockSize, printProgress, treePerfStatOutFileName, treeCacheSize, nmbThreads,
+		[&](vector<vector<complex<double> > >& waveAmps, const long) -> bool {
+			for(unsigned int iWave = 0; iWave < waveAmps.size(); ++iWave) {
+				ampFileWriters[iWave]->addAmplitudes(waveAmps[iWave]);
+			}
+			return true;
+		});
+}
+
+
+bool
+rpwa::hli::calcAmplitudes(const eventMetadata&              eventMeta,
+                          const vector<isobarAmplitudePtr>& amplitudes,
+                          amplitudeMatrixFileWriter&        ampMatrixFileWriter,
+                          const long int                    eventBlockSize,
+                          const bool                        printProgress,
+                          const string&                     treePerfStatOutFileName,         // root file name for tree performance result
+                          const long int                    treeCacheSize,
+                          const unsigned int                nmbThreads)
+{
+	if(not ampMatrixFileWriter.initialized()) {
+		printWarn << "amplitude matrix file writer is not initialized." << endl;
+		return false;
+	}
+	return calcAmplitudesInBlocks(
+		eventMeta, amplitudes, 0, -1, eventBlockSize, printProgress, treePerfStatOutFileName, treeCacheSize, nmbThreads,
+		[&](vector<vector<complex<double> > >& waveAmps, const long blockFirstEvent) -> bool {
+			if(not ampMatrixFileWriter.addEvents(waveAmps)) {
+				printWarn << "could not add amplitudes of events [" << blockFirstEvent << ", "
+				          << blockFirstEvent + (waveAmps.empty() ? 0 : waveAmps[0].size()) << ") to amplitude matrix." << endl;
+				return false;
+			}
+			return true;
+		});
+}
@@ -9,14 +9,62 @@
 
 namespace rpwa {
 
+	class amplitudeFileWriter;
+	class amplitudeMatrixFileWriter;
+
 	namespace hli {
 
+		// the events are read into kinematics blocks, whose amplitudes are
+		// calculated at once by isobarAmplitude::amplitude(const
+		// kinematicsBlock&, ...). with nmbThreads != 1 the blocks are
+		// calculated in parallel by clones of the amplitude (nmbThreads = 0
+		// uses all available threads); the result is identical to the one
+		// of a single thread
 		std::vector<std::complex<double> > calcAmplitude(const rpwa::eventMetadata&      eventMeta,
 		                                                 const rpwa::isobarAmplitudePtr& amplitude,
 		                                                 const long int                  maxNmbEvents            = -1,
 		                                                 const bool                      printProgress           = true,
 		                                                 const std::string&              treePerfStatOutFileName = "",         // root file name for tree performance result
-		                                                 const long int                  treeCacheSize           = 25000000);
+		                                                 const long int                  treeCacheSize           = 25000000,
+		                                                 const unsigned int              nmbThreads              = 1);
+
+		// calculates the amplitudes of all given waves for the events
+		// [firstEvent, firstEvent + maxNmbEvents) in a single pass over the
+		// event tree; every event is read only once, and the transformation
+		// into the Gottfried-Jackson frame is calculated only once per event
+		// for all waves with the same production vertex and final state.
+		// the amplitudes are returned as [wave][event]. nmbThreads has the
+		// same meaning as for calcAmplitude()
+		std::vector<std::vector<std::complex<double> > > calcAmplitudes(const rpwa::eventMetadata&                    eventMeta,
+		                                                                const std::vector<rpwa::isobarAmplitudePtr>& amplitudes,
+		                                                                const long int                               firstEvent              = 0,
+		                                                                const long int                               maxNmbEvents            = -1,
+		                                                                const bool                                   printProgress           = true,
+		                                                                const std::string&                           treePerfStatOutFileName = "",         // root file name for tree performance result
+		                                                                const long int                               treeCacheSize           = 25000000,
+		                                                                const unsigned int                           nmbThreads              = 1);
+
+		// calculates the amplitudes of all given waves for all events like
+		// calcAmplitudes() above and writes them into one amplitude file
+		// per wave or into an amplitude matrix. the amplitudes are set up
+		// only once, and only the amplitudes of eventBlockSize events are
+		// kept in memory at a time (eventBlockSize <= 0 keeps all of them)
+		bool calcAmplitudes(const rpwa::eventMetadata&                     eventMeta,
+		                    const std::vector<rpwa::isobarAmplitudePtr>&   amplitudes,
+		                    const std::vector<rpwa::amplitudeFileWriter*>& ampFileWriters,
+		                    const long int                                 eventBlockSize          = 100000,
+		                    const bool                                     printProgress           = true,
+		                    const std::string&                             treePerfStatOutFileName = "",         // root file name for tree performance result
+		                    const long int                                 treeCacheSize           = 25000000,
+		                    const unsigned int                             nmbThreads              = 1);
+		bool calcAmplitudes(const rpwa::eventMetadata&                    eventMeta,
+		                    const std::vector<rpwa::isobarAmplitudePtr>& amplitudes,
+		                    rpwa::amplitudeMatrixFileWriter&             ampMatrixFileWriter,
+		                    const long int                               eventBlockSize          = 100000,
+		                    const bool                                   printProgress           = true,
+		                    const std::string&                           treePerfStatOutFileName = "",         // root file name for tree performance result
+		                    const long int                               treeCacheSize           = 25000000,
+		                    const unsigned int                           nmbThreads              = 1);
 
 	}
 
@@ -0,0 +1,236 @@
+
+#include "calcIntegralOnTheFly.h"
+
+#include <boost/progress.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <TClonesArray.h>
+#include <TTree.h>
+
+#include <ampIntegralAccumulator.h>
+#include <hashCalculator.h>
+#include <kinematicsBlock.h>
+#include <reportingUtils.hpp>
+#include <waveDescription.h>
+
+using namespace std;
+using namespace rpwa;
+
+
+namespace {
+
+	// number of kinematics blocks per worker thread that are read from
+	// the tree before their amplitudes are calculated in parallel
+	const unsigned int kinematicsBlocksPerWorker = 4;
+
+}
+
+
+bool
+rpwa::hli::calcIntegralOnTheFly(ampIntegralMatrix&                        integral,
+                                vector<string>&                           amplitudeHashes,
+                                const eventMetadata&                      eventMeta,
+                                const vector<isobarAmplitudePtr>&         amplitudes,
+                                const map<string, pair<double, double> >& binningMap,
+                                const long int                            startEvent,
+                                const long int                            maxNmbEvents,
+                                const unsigned int                        nmbThreads,
+                                const bool                                printProgress,
+                                const long int                            treeCacheSize)
+{
+	amplitudeHashes.clear();
+	if(amplitudes.empty()) {
+		printWarn << "did not receive any amplitudes. cannot calculate integral." << endl;
+		return false;
+	}
+	TTree* tree = eventMeta.eventTree();
+	if(not tree) {
+		printErr << "event tree not found." << endl;
+		return false;
+	}
+
+	// initialize amplitudes
+	const unsigned int nmbWaves = amplitudes.size();
+	vector<string> waveNames(nmbWaves);
+	for(unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+		if(not amplitudes[waveIndex]) {
+			printWarn << "null pointer to isobar decay amplitude. cannot calculate integral." << endl;
+			return false;
+		}
+		amplitudes[waveIndex]->init();
+		const isobarDecayTopologyPtr& decayTopo = amplitudes[waveIndex]->decayTopology();
+		if(not decayTopo->initKinematicsData(eventMeta.productionKinematicsParticleNames(), eventMeta.decayKinematicsParticleNames())) {
+			printErr << "problems initializing input data. cannot read input data." << endl;
+			return false;
+		}
+		waveNames[waveIndex] = waveDescription::waveNameFromTopology(*decayTopo);
+	}
+	if(not integral.setWaveNames(waveNames)) {
+		printErr << "could not set wave names of integral matrix." << endl;
+		return false;
+	}
+
+	// the binning variables are read first, the momenta only for
+	// events in the bin
+	TBranch*      prodKinMomentaBr  = 0;
+	TBranch*      decayKinMomentaBr = 0;
+	TClonesArray* prodKinMomenta    = 0;
+	TClonesArray* decayKinMomenta   = 0;
+	tree->SetBranchAddress(eventMetadata::productionKinematicsMomentaBranchName.c_str(), &prodKinMomenta,  &prodKinMomentaBr );
+	tree->SetBranchAddress(eventMetadata::decayKinematicsMomentaBranchName.c_str(),      &decayKinMomenta, &decayKinMomentaBr);
+	vector<double>                binningVariables(binningMap.size());
+	vector<TBranch*>              binningBranches (binningMap.size(), 0);
+	vector<pair<double, double> > bounds;
+	for(map<string, pair<double, double> >::const_iterator elem = binningMap.begin(); elem != binningMap.end(); ++elem) {
+		const size_t binVarIndex = bounds.size();
+		const int err = tree->SetBranchAddress(elem->first.c_str(), &binningVariables[binVarIndex], &binningBranches[binVarIndex]);
+		if(err < 0 or not binningBranches[binVarIndex]) {
+			printErr << "could not set branch address for branch '" << elem->first << "' (error code " << err << ")." << endl;
+			tree->ResetBranchAddresses();
+			return false;
+		}
+		bounds.push_back(elem->second);
+	}
+	tree->SetCacheSize(treeCacheSize);
+	tree->AddBranchToCache(eventMetadata::productionKinematicsMomentaBranchName.c_str(), true);
+	tree->AddBranchToCache(eventMetadata::decayKinematicsMomentaBranchName.c_str(),      true);
+	for(map<string, pair<double, double> >::const_iterator elem = binningMap.begin(); elem != binningMap.end(); ++elem) {
+		tree->AddBranchToCache(elem->first.c_str(), true);
+	}
+	tree->StopCacheLearningPhase();
+
+	const long int nmbEventsTree = tree->GetEntries();
+	const long int firstEvent    = max(0L, startEvent);
+	const long int lastEvent     = ((maxNmbEvents > -1) ? min(nmbEventsTree, firstEvent + maxNmbEvents) : nmbEventsTree);
+
+#ifdef _OPENMP
+	const unsigned int nmbWorkers = (nmbThreads == 0) ? omp_get_max_threads() : nmbThreads;
+#else
+	const unsigned int nmbWorkers = 1;
+#endif
+	// every worker thread calculates the amplitudes of whole kinematics
+	// blocks with its own copies of the amplitudes
+	vector<vector<isobarAmplitudePtr> > workerAmplitudes(1, amplitudes);
+	for(unsigned int worker = 1; worker < nmbWorkers; ++worker) {
+		workerAmplitudes.push_back(vector<isobarAmplitudePtr>());
+		for(unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+			workerAmplitudes[worker].push_back(amplitudes[waveIndex]->clone());
+		}
+	}
+	if(nmbWorkers > 1) {
+		printInfo << "calculating amplitudes using " << nmbWorkers << " threads." << endl;
+	}
+	vector<kinematicsBlockPtr> blocks;
+	for(unsigned int i = 0; i < kinematicsBlocksPerWorker * nmbWorkers; ++i) {
+		blocks.push_back(createKinematicsBlock(kinematicsBlock::defaultCapacity));
+	}
+	// [wave][event of the blocks]
+	vector<vector<complex<double> > > blockAmps(nmbWaves, vector<complex<double> >(blocks.size() * kinematicsBlock::defaultCapacity));
+	// vector<bool> cannot be written concurrently
+	vector<char>                      blockSuccess(blocks.size(), 0);
+
+	ampIntegralAccumulator   accumulator(nmbWaves, ampIntegralAccumulator::defaultBlockSize, nmbThreads);
+	vector<hashCalculator>   hashers(nmbWaves);
+	vector<complex<double> > eventAmps(nmbWaves);
+	unsigned long            skippedEvents = 0;
+	bool                     success       = true;
+	boost::progress_display* progressIndicator = (printProgress and lastEvent > firstEvent) ? new boost::progress_display(lastEvent - firstEvent, cout, "") : 0;
+	long int eventIndex = firstEvent;
+	while(success and eventIndex < lastEvent) {
+		// read the events in the bin into the kinematics blocks
+		unsigned int nmbBlocks = 0;
+		blocks[0]->clear();
+		for(; eventIndex < lastEvent and nmbBlocks < blocks.size(); ++eventIndex) {
+			if(progressIndicator) {
+				++(*progressIndicator);
+			}
+			const long int treeEntry = tree->LoadTree(eventIndex);
+
+			bool veto = false;
+			for(size_t binVarIndex = 0; binVarIndex < bounds.size(); ++binVarIndex) {
+				binningBranches[binVarIndex]->GetEntry(treeEntry);
+				if(binningVariables[binVarIndex] < bounds[binVarIndex].first or binningVariables[binVarIndex] >= bounds[binVarIndex].second) {
+					veto = true;
+					break;
+				}
+			}
+			if(veto) {
+				++skippedEvents;
+				continue;
+			}
+
+			prodKinMomentaBr->GetEntry(treeEntry);
+			decayKinMomentaBr->GetEntry(treeEntry);
+			if(not prodKinMomenta or not decayKinMomenta) {
+				printErr << "at least one of the input data arrays is a null pointer: "
+				         << "        production kinematics: " << "momenta = " << prodKinMomenta  << endl
+				         << "        decay kinematics:      " << "momenta = " << decayKinMomenta << endl
+				         << "at event " << eventIndex << "." << endl;
+				success = false;
+				break;
+			}
+			blocks[nmbBlocks]->addEvent(*prodKinMomenta, *decayKinMomenta);
+			if(blocks[nmbBlocks]->full() and ++nmbBlocks < blocks.size()) {
+				blocks[nmbBlocks]->clear();
+			}
+		}
+		if(not success) {
+			break;
+		}
+		if(nmbBlocks < blocks.size() and blocks[nmbBlocks]->nmbEvents() > 0) {
+			++nmbBlocks;
+		}
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nmbWorkers)
+#endif
+		for(int i = 0; i < (int)nmbBlocks; ++i) {
+#ifdef _OPENMP
+			const unsigned int worker = omp_get_thread_num();
+#else
+			const unsigned int worker = 0;
+#endif
+			blockSuccess[i] = 1;
+			for(unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+				if(not workerAmplitudes[worker][waveIndex]->amplitude(*blocks[i], &blockAmps[waveIndex][i * kinematicsBlock::defaultCapacity])) {
+					blockSuccess[i] = 0;
+					break;
+				}
+			}
+		}
+
+		// the hashes and the integral are updated in event order
+		for(unsigned int i = 0; i < nmbBlocks; ++i) {
+			if(not blockSuccess[i]) {
+				printErr << "problems calculating amplitudes of the events in the bin." << endl;
+				success = false;
+				break;
+			}
+			for(unsigned int blockEvent = 0; blockEvent < blocks[i]->nmbEvents(); ++blockEvent) {
+				for(unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+					eventAmps[waveIndex] = blockAmps[waveIndex][i * kinematicsBlock::defaultCapacity + blockEvent];
+					hashers[waveIndex].Update(eventAmps[waveIndex]);
+				}
+				accumulator.addEvent(eventAmps.data());
+			}
+		}
+	}
+	delete progressIndicator;
+	tree->ResetBranchAddresses();
+	if(not success) {
+		return false;
+	}
+	printInfo << skippedEvents << " events rejected because they are outside the binning." << endl;
+
+	accumulator.flush();
+	accumulator.fillMatrix(integral.matrix());
+	integral.setNmbEvents(accumulator.nmbEvents());
+	amplitudeHashes.resize(nmbWaves);
+	for(unsigned int waveIndex = 0; waveIndex < nmbWaves; ++waveIndex) {
+		amplitudeHashes[waveIndex] = hashers[waveIndex].hash();
+	}
+	return true;
+}
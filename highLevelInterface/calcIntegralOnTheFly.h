@@ -0,0 +1,42 @@
+#ifndef HLI_CALCINTEGRALONTHEFLY_H
+#define HLI_CALCINTEGRALONTHEFLY_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ampIntegralMatrix.h>
+#include <eventMetadata.h>
+#include <isobarAmplitude.h>
+
+
+namespace rpwa {
+
+	namespace hli {
+
+		// calculates the integral matrix of the given amplitudes for the
+		// events in [startEvent, startEvent + maxNmbEvents) of the event
+		// file, which are in the bin given by binningMap, without writing
+		// the amplitudes to files. the amplitudes are calculated in native
+		// code for kinematics blocks of events, in parallel by clones of
+		// the amplitudes, and added in event order to a blocked integral
+		// accumulator. the wave names of the integral are set from the
+		// decay topologies, amplitudeHashes contains the content hash of
+		// the amplitude values of each wave calculated from the events in
+		// the bin.
+		bool calcIntegralOnTheFly(rpwa::ampIntegralMatrix&                                 integral,
+		                          std::vector<std::string>&                                amplitudeHashes,
+		                          const rpwa::eventMetadata&                               eventMeta,
+		                          const std::vector<rpwa::isobarAmplitudePtr>&             amplitudes,
+		                          const std::map<std::string, std::pair<double, double> >& binningMap    = std::map<std::string, std::pair<double, double> >(),
+		                          const long int                                           startEvent    = 0,
+		                          const long int                                           maxNmbEvents  = -1,
+		                          const unsigned int                                       nmbThreads    = 0,          // threads for the amplitude calculation and the update of the matrix elements (0 = number of threads given by the OpenMP runtime)
+		                          const bool                                               printProgress = true,
+		                          const long int                                           treeCacheSize = 25000000);
+
+	}
+
+}
+
+#endif // HLI_CALCINTEGRALONTHEFLY_H
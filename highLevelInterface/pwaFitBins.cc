@@ -0,0 +1,410 @@
+#include "pwaFitBins.h"
+
+#include <algorithm>
+#include <complex>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <TFile.h>
+#include <TROOT.h>
+#include <TStopwatch.h>
+
+#include <ampIntegralMatrix.h>
+#include <ampIntegralMatrixMetadata.h>
+#include <ampIntegralPackedMatrix.h>
+#include <amplitudeMetadata.h>
+#include <eventMetadata.h>
+#include <pwaFit.h>
+#ifdef USE_NLOPT
+#include <pwaNloptFit.h>
+#endif
+#include <reportingUtils.hpp>
+
+
+using namespace std;
+using namespace rpwa;
+
+
+namespace {
+
+	typedef pwaLikelihood<complex<double> > likelihoodType;
+
+
+	// queues of bin indices, one for each worker; a worker takes bins
+	// from the front of its own queue and steals from the back of the
+	// queues of the other workers once its own queue is empty
+	class workStealingQueues {
+
+	public:
+
+		workStealingQueues(const size_t nmbJobs,
+		                   const unsigned int nmbWorkers)
+			: _queues (nmbWorkers),
+			  _mutexes(nmbWorkers)
+		{
+			// neighboring bins go to the same worker, so that each worker
+			// starts with a contiguous range of bins
+			for (size_t iJob = 0; iJob < nmbJobs; ++iJob)
+				_queues[(iJob * nmbWorkers) / nmbJobs].push_back(iJob);
+		}
+
+		bool pop(const unsigned int iWorker,
+		         size_t&            job)
+		{
+			{
+				lock_guard<mutex> lock(_mutexes[iWorker]);
+				if (not _queues[iWorker].empty()) {
+					job = _queues[iWorker].front();
+					_queues[iWorker].pop_front();
+					return true;
+				}
+			}
+			for (size_t i = 1; i < _queues.size(); ++i) {
+				const size_t iVictim = (iWorker + i) % _queues.size();
+				lock_guard<mutex> lock(_mutexes[iVictim]);
+				if (not _queues[iVictim].empty()) {
+					job = _queues[iVictim].back();
+					_queues[iVictim].pop_back();
+					return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+
+		vector<deque<size_t> > _queues;
+		vector<mutex>          _mutexes;
+
+	};
+
+
+	// limits the total memory of the decay amplitudes of all bins
+	// that are resident at the same time
+	class memoryBudget {
+
+	public:
+
+		memoryBudget(const size_t budget)
+			: _budget(budget),
+			  _used  (0)
+		{ }
+
+		void acquire(const size_t nmbBytes)
+		{
+			unique_lock<mutex> lock(_mutex);
+			// a bin that alone exceeds the budget is admitted when nothing else is resident
+			while (_budget > 0 and _used > 0 and _used + nmbBytes > _budget)
+				_released.wait(lock);
+			_used += nmbBytes;
+		}
+
+		void release(const size_t nmbBytes)
+		{
+			{
+				lock_guard<mutex> lock(_mutex);
+				_used -= nmbBytes;
+			}
+			_released.notify_all();
+		}
+
+	private:
+
+		const size_t       _budget;
+		size_t             _used;
+		mutex              _mutex;
+		condition_variable _released;
+
+	};
+
+
+	// reads integral matrix from file and adds it as normalization or
+	// acceptance integral to the likelihood
+	bool
+	addIntegral(likelihoodType&    L,
+	            const string&      integralFileName,
+	            const bool         accIntegral,
+	            const unsigned int accEventsOverride)
+	{
+		// packed integral files are mapped and the likelihood gathers the
+		// elements directly from the mapped upper triangle
+		const string packedFileName = ampIntegralPackedMatrix::findPackedFile(integralFileName);
+		if (packedFileName != "") {
+			ampIntegralPackedMatrix integral;
+			if (not integral.open(packedFileName)) {
+				printErr << "could not open packed integral file '" << packedFileName << "'." << endl;
+				return false;
+			}
+			return (accIntegral) ? L.addAccIntegral(integral, accEventsOverride) : L.addNormIntegral(integral);
+		}
+
+		TFile* integralFile = TFile::Open(integralFileName.c_str(), "READ");
+		if (not integralFile or integralFile->IsZombie()) {
+			printErr << "could not open integral file '" << integralFileName << "'." << endl;
+			delete integralFile;
+			return false;
+		}
+		const ampIntegralMatrixMetadata* integralMeta = ampIntegralMatrixMetadata::readIntegralFile(integralFile);
+		bool success = false;
+		if (integralMeta) {
+			ampIntegralMatrix* integral = integralMeta->getAmpIntegralMatrix();
+			success = (accIntegral) ? L.addAccIntegral(*integral, accEventsOverride) : L.addNormIntegral(*integral);
+			// the likelihood keeps its own copy of the integral
+			delete integral;
+			delete integralMeta;
+		}
+		integralFile->Close();
+		delete integralFile;
+		return success;
+	}
+
+
+	// sets up the likelihood of the given bin up to the point where
+	// the decay amplitudes are loaded
+	bool
+	initLikelihood(likelihoodType&                                    L,
+	               const hli::pwaFitBin&                              bin,
+	               const vector<likelihoodType::waveReflThresType>&   waveReflThres,
+	               const double                                       massBinCenter,
+	               const unsigned int                                 rank,
+	               const bool                                         cauchy,
+	               const double                                       cauchyWidth,
+	               const unsigned int                                 accEventsOverride,
+	               const unsigned int                                 nmbThreads,
+	               const string&                                      binIndexDirectory)
+	{
+		if (bin.ampFileNames.size() != bin.eventFileNames.size()) {
+			printErr << "number of event files (" << bin.eventFileNames.size() << ") and "
+			         << "number of sets of amplitude files (" << bin.ampFileNames.size() << ") differ." << endl;
+			return false;
+		}
+
+		L.useNormalizedAmps(true);
+		L.setNmbThreads(nmbThreads);
+		L.setBinIndexDirectory(binIndexDirectory);
+		if (cauchy) {
+			L.setPriorType(likelihoodType::HALF_CAUCHY);
+			L.setCauchyWidth(cauchyWidth);
+		}
+		if (not L.init(waveReflThres, rank, massBinCenter)) {
+			printErr << "could not initialize likelihood." << endl;
+			return false;
+		}
+
+		if (not addIntegral(L, bin.normIntegralFileName, false, accEventsOverride)) {
+			printErr << "could not add normalization integral." << endl;
+			return false;
+		}
+		if (not addIntegral(L, bin.accIntegralFileName, true, accEventsOverride)) {
+			printErr << "could not add acceptance integral." << endl;
+			return false;
+		}
+
+		vector<TFile*>               eventFiles;
+		vector<const eventMetadata*> eventMetas;
+		bool success = true;
+		for (size_t iFile = 0; iFile < bin.eventFileNames.size(); ++iFile) {
+			TFile* eventFile = TFile::Open(bin.eventFileNames[iFile].c_str(), "READ");
+			if (not eventFile or eventFile->IsZombie()) {
+				printErr << "could not open event file '" << bin.eventFileNames[iFile] << "'." << endl;
+				delete eventFile;
+				success = false;
+				break;
+			}
+			eventFiles.push_back(eventFile);
+			const eventMetadata* eventMeta = eventMetadata::readEventFile(eventFile);
+			if (not eventMeta) {
+				printErr << "could not read event metadata from file '" << bin.eventFileNames[iFile] << "'." << endl;
+				success = false;
+				break;
+			}
+			eventMetas.push_back(eventMeta);
+		}
+		if (success)
+			success = L.setOnTheFlyBinning(bin.binning, eventMetas);
+		for (size_t iFile = 0; iFile < eventMetas.size(); ++iFile)
+			delete eventMetas[iFile];
+		for (size_t iFile = 0; iFile < eventFiles.size(); ++iFile) {
+			eventFiles[iFile]->Close();
+			delete eventFiles[iFile];
+		}
+		return success;
+	}
+
+
+	// loads the decay amplitudes of all waves into the likelihood
+	bool
+	addAmplitudes(likelihoodType&                                  L,
+	              const hli::pwaFitBin&                            bin,
+	              const vector<likelihoodType::waveReflThresType>& waveReflThres)
+	{
+		for (size_t iWave = 0; iWave < waveReflThres.size(); ++iWave) {
+			const string& waveName = boost::get<0>(waveReflThres[iWave]);
+			vector<TFile*>                   ampFiles;
+			vector<const amplitudeMetadata*> ampMetas;
+			bool success = true;
+			for (size_t iFile = 0; iFile < bin.ampFileNames.size(); ++iFile) {
+				map<string, string>::const_iterator ampFileName = bin.ampFileNames[iFile].find(waveName);
+				if (ampFileName == bin.ampFileNames[iFile].end()) {
+					printErr << "no amplitude file for wave '" << waveName << "' "
+					         << "and event file '" << bin.eventFileNames[iFile] << "'." << endl;
+					success = false;
+					break;
+				}
+				TFile* ampFile = TFile::Open(ampFileName->second.c_str(), "READ");
+				if (not ampFile or ampFile->IsZombie()) {
+					printErr << "could not open amplitude file '" << ampFileName->second << "'." << endl;
+					delete ampFile;
+					success = false;
+					break;
+				}
+				ampFiles.push_back(ampFile);
+				const amplitudeMetadata* ampMeta = amplitudeMetadata::readAmplitudeFile(ampFile, waveName);
+				if (not ampMeta) {
+					printErr << "could not get metadata for wave '" << waveName << "'." << endl;
+					success = false;
+					break;
+				}
+				ampMetas.push_back(ampMeta);
+			}
+			if (success)
+				success = L.addAmplitude(ampMetas);
+			for (size_t iFile = 0; iFile < ampMetas.size(); ++iFile)
+				delete ampMetas[iFile];
+			for (size_t iFile = 0; iFile < ampFiles.size(); ++iFile) {
+				ampFiles[iFile]->Close();
+				delete ampFiles[iFile];
+			}
+			if (not success) {
+				printErr << "could not add amplitude '" << waveName << "'." << endl;
+				return false;
+			}
+		}
+		return L.finishInit();
+	}
+
+
+}
+
+
+vector<vector<fitResultPtr> >
+rpwa::hli::pwaFitBins(const vector<pwaFitBin>&                        bins,
+                      const vector<likelihoodType::waveDescThresType>& waveDescThres,
+                      const unsigned int                              rank,
+                      const bool                                      cauchy,
+                      const double                                    cauchyWidth,
+                      const unsigned int                              accEventsOverride,
+                      const string&                                   startValFileName,
+                      const bool                                      checkHessian,
+                      const bool                                      saveSpace,
+                      const bool                                      useNlopt,
+                      const unsigned int                              nmbWorkers,
+                      const unsigned int                              nmbThreadsPerBin,
+                      const size_t                                    memoryBudget,
+                      const string&                                   binIndexDirectory,
+                      const bool                                      verbose)
+{
+	vector<vector<fitResultPtr> > results(bins.size());
+#ifndef USE_NLOPT
+	if (useNlopt) {
+		printErr << "NLopt fits were requested, but rootpwa was built without NLopt support." << endl;
+		return results;
+	}
+#endif
+
+	// the reflectivities of the waves are the same in all bins, so the
+	// decay topologies have to be constructed only once
+	vector<likelihoodType::waveReflThresType> waveReflThres;
+	if (not likelihoodType::getWaveReflThres(waveDescThres, waveReflThres)) {
+		printErr << "could not get reflectivities from wave descriptions." << endl;
+		return results;
+	}
+	// the verbosity of the likelihoods is a static flag, which is restored
+	// when all bins are fitted
+	const bool debug = likelihoodType::debug();
+	likelihoodType::setQuiet(not verbose);
+
+	unsigned int nmbThreads = (nmbWorkers > 0) ? nmbWorkers : thread::hardware_concurrency();
+	if (nmbThreads == 0)
+		nmbThreads = 1;
+#if ROOT_VERSION_CODE < ROOT_VERSION(6, 0, 0)
+	if (nmbThreads > 1) {
+		printWarn << "ROOT versions before 6 are not thread-safe. fitting bins sequentially." << endl;
+		nmbThreads = 1;
+	}
+#else
+	ROOT::EnableThreadSafety();
+#endif
+	nmbThreads = min(nmbThreads, max((unsigned int)bins.size(), 1u));
+
+	printInfo << "fitting " << bins.size() << " bins with " << nmbThreads << " worker threads" << endl
+	          << "    number of threads per bin ...................... " << nmbThreadsPerBin << endl
+	          << "    memory budget for decay amplitudes ............. ";
+	if (memoryBudget > 0)
+		cout << memoryBudget << " bytes" << endl;
+	else
+		cout << "unlimited" << endl;
+
+	TStopwatch timer;
+	timer.Start();
+
+	workStealingQueues queues(bins.size(), nmbThreads);
+	::memoryBudget     budget(memoryBudget);
+	vector<thread>     workers;
+	for (unsigned int iWorker = 0; iWorker < nmbThreads; ++iWorker) {
+		workers.push_back(thread([&, iWorker]() {
+			size_t iBin;
+			while (queues.pop(iWorker, iBin)) {
+				const pwaFitBin& bin = bins[iBin];
+				map<string, pair<double, double> >::const_iterator massBin = bin.binning.find("mass");
+				if (massBin == bin.binning.end()) {
+					printErr << "binning of bin " << iBin << " does not contain 'mass'. skipping bin." << endl;
+					continue;
+				}
+				const double massBinMin = massBin->second.first;
+				const double massBinMax = massBin->second.second;
+
+				size_t nmbBytes = 0;
+				{
+					likelihoodType L;
+					if (not initLikelihood(L, bin, waveReflThres, (massBinMin + massBinMax) / 2, rank,
+					                       cauchy, cauchyWidth, accEventsOverride, nmbThreadsPerBin, binIndexDirectory)) {
+						printErr << "error while initializing likelihood of bin " << iBin << ". skipping bin." << endl;
+						continue;
+					}
+
+					// the decay amplitudes dominate the memory needed by a bin
+					nmbBytes = L.decayAmpMemoryUsage(L.nmbEventsInBinning());
+					budget.acquire(nmbBytes);
+					if (addAmplitudes(L, bin, waveReflThres)) {
+						for (size_t iSeed = 0; iSeed < bin.seeds.size(); ++iSeed) {
+							fitResultPtr result;
+#ifdef USE_NLOPT
+							if (useNlopt)
+								result = pwaNloptFit(L, massBinMin, massBinMax, bin.seeds[iSeed], startValFileName, checkHessian, saveSpace, verbose);
+							else
+#endif
+								result = pwaFit(L, massBinMin, massBinMax, bin.seeds[iSeed], startValFileName, checkHessian, saveSpace, verbose);
+							results[iBin].push_back(result);
+						}
+					} else
+						printErr << "error while loading decay amplitudes of bin " << iBin << ". skipping bin." << endl;
+				}
+				budget.release(nmbBytes);
+				printInfo << "finished bin " << iBin << " [" << massBinMin << ", " << massBinMax << "] GeV/c^2" << endl;
+			}
+		}));
+	}
+	for (unsigned int iWorker = 0; iWorker < nmbThreads; ++iWorker)
+		workers[iWorker].join();
+	likelihoodType::setQuiet(not debug);
+
+	timer.Stop();
+	printSucc << "fitted " << bins.size() << " bins. " << flush;
+	cout << "used " << flush;
+	timer.Print();
+
+	return results;
+}
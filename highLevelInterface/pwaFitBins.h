@@ -0,0 +1,63 @@
+#ifndef HLI_PWAFITBINS_H
+#define HLI_PWAFITBINS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fitResult.h>
+#include <pwaLikelihood.h>
+
+namespace rpwa {
+
+	namespace hli {
+
+		// everything that is needed to set up the likelihood of a single
+		// kinematic bin; the amplitude files are given for each event
+		// file in the same order as the event file names
+		struct pwaFitBin {
+			std::map<std::string, std::pair<double, double> > binning;               // lower and upper bound of each binning variable, has to contain 'mass'
+			std::vector<std::string>                           eventFileNames;        // paths to the event files with events in this bin
+			std::vector<std::map<std::string, std::string> >   ampFileNames;          // paths to the amplitude files of each wave for each event file
+			std::string                                        normIntegralFileName;  // path to file with normalization integral
+			std::string                                        accIntegralFileName;   // path to file with acceptance integral
+			std::vector<unsigned int>                          seeds;                 // one fit attempt is performed for each seed
+		};
+
+		// fits many kinematic bins in a single process
+		//
+		// the bins are distributed over nmbWorkers threads (0 = number
+		// of hardware threads) that steal bins from each other once
+		// their own queue runs empty. the reflectivities of the waves
+		// are extracted from the wave descriptions once and are shared
+		// by all bins. a bin only loads its decay amplitudes once the
+		// total memory for the decay amplitudes of all resident bins
+		// stays within memoryBudget bytes (0 = unlimited); a single bin
+		// exceeding the budget is fitted once no other bin is resident.
+		// if binIndexDirectory is given, the events of the bins are
+		// selected with the bin indices of the event files, so that each
+		// event file is scanned at most once.
+		// returns the fit results of all attempts for each bin; the list
+		// of a bin that failed is empty
+		std::vector<std::vector<rpwa::fitResultPtr> >
+		pwaFitBins(const std::vector<rpwa::hli::pwaFitBin>&                                            bins,
+		           const std::vector<rpwa::pwaLikelihood<std::complex<double> >::waveDescThresType>& waveDescThres,
+		           const unsigned int                                                                 rank              = 1,
+		           const bool                                                                         cauchy            = false,
+		           const double                                                                       cauchyWidth       = 0.5,
+		           const unsigned int                                                                 accEventsOverride = 0,
+		           const std::string&                                                                 startValFileName  = "",
+		           const bool                                                                         checkHessian      = false,
+		           const bool                                                                         saveSpace         = false,
+		           const bool                                                                         useNlopt          = false,
+		           const unsigned int                                                                 nmbWorkers        = 0,
+		           const unsigned int                                                                 nmbThreadsPerBin  = 1,
+		           const std::size_t                                                                  memoryBudget      = 0,
+		           const std::string&                                                                 binIndexDirectory = "",
+		           const bool                                                                         verbose           = false);
+
+	}
+
+}
+
+#endif // HLI_PWAFITBINS_H
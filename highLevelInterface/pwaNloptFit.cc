@@ -1,6 +1,13 @@
 #include "pwaNloptFit.h"
 
+#include <algorithm>
 #include <complex>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <boost/scoped_ptr.hpp>
 
 #include <TFile.h>
 #include <TRandom3.h>
@@ -21,10 +28,42 @@ using namespace std;
 using namespace rpwa;
 
 
+namespace {
+
+	// state shared by the concurrent attempts of a multi-start fit
+	struct multiStartState {
+
+		multiStartState(const double threshold)
+			: stopThreshold (threshold),
+			  bestLikelihood(numeric_limits<double>::max()),
+			  bestNmbEvals  (0)
+		{ }
+
+		const double stopThreshold;   // attempts worse than the best one by more than this value are stopped; <= 0 disables stopping
+		mutex        mtx;
+		double       bestLikelihood;  // lowest likelihood of all converged attempts
+		unsigned int bestNmbEvals;    // number of likelihood evaluations of the attempt with the lowest likelihood
+
+	};
+
+
+	struct nloptFuncData {
+
+		const pwaLikelihood<complex<double> >* L;
+		nlopt::opt*                            optimizer;
+		multiStartState*                       state;     // NULL for single fits
+		unsigned int                           nmbEvals;  // number of likelihood evaluations of this attempt
+
+	};
+
+}
+
+
 double
 rpwaNloptFunc(unsigned int n, const double* x, double* gradient, void* func_data)
 {
-	const pwaLikelihood<complex<double> >* L = (const pwaLikelihood<complex<double> >*)func_data;
+	nloptFuncData* data = (nloptFuncData*)func_data;
+	const pwaLikelihood<complex<double> >* L = data->L;
 	if(n != L->nmbPars()) {
 		printErr << "parameter mismatch between NLopt and pwaLikelihood. Aborting..." << endl;
 		throw;
@@ -35,19 +74,39 @@ rpwaNloptFunc(unsigned int n, const double* x, double* gradient, void* func_data
 	} else {
 		likeli = L->DoEval(x);
 	}
+	++data->nmbEvals;
+	if(data->state and data->state->stopThreshold > 0.) {
+		lock_guard<mutex> lock(data->state->mtx);
+		if(data->state->bestNmbEvals > 0 and data->nmbEvals >= data->state->bestNmbEvals
+		   and likeli > data->state->bestLikelihood + data->state->stopThreshold) {
+			data->optimizer->force_stop();
+		}
+	}
 	return likeli;
 }
 
 
+// same as printInfo, printSucc and printWarn, but for an arbitrary
+// output stream
+#define printInfoTo(out) out << rpwa::setStreamTo(rpwa::BOLD     ) << ">>> " << rpwa::getClassMethod__(__PRETTY_FUNCTION__) << "(): info: "    << rpwa::setStreamTo(rpwa::NORMAL) << std::flush
+#define printSuccTo(out) out << rpwa::setStreamTo(rpwa::FG_GREEN ) << "*** " << rpwa::getClassMethod__(__PRETTY_FUNCTION__) << "(): success: " << rpwa::setStreamTo(rpwa::NORMAL) << std::flush
+#define printWarnTo(out) out << rpwa::setStreamTo(rpwa::FG_YELLOW) << "??? " << __PRETTY_FUNCTION__ << " [" << __FILE__ << ":" << __LINE__ << "]: warning: " << rpwa::setStreamTo(rpwa::NORMAL) << std::flush
+
+
+// performs a single fit attempt; state is NULL unless the attempt is
+// part of a multi-start fit; the output of the attempt is written to
+// out, errors are printed to cerr
+static
 fitResultPtr
-rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
-                       const double                           massBinMin,
-                       const double                           massBinMax,
-                       const unsigned int                     seed,
-                       const string&                          startValFileName,
-                       const bool                             checkHessian,
-                       const bool                             saveSpace,
-                       const bool                             verbose)
+nloptFit(const pwaLikelihood<complex<double> >& L,
+         const double                           massBinMin,
+         const double                           massBinMax,
+         const unsigned int                     seed,
+         const bool                             checkHessian,
+         const bool                             saveSpace,
+         const bool                             verbose,
+         multiStartState*                       state,
+         ostream&                               out)
 {
 
 #if ROOT_VERSION_CODE < ROOT_VERSION(6, 0, 0)
@@ -68,32 +127,31 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 	const bool         quiet                 = not verbose;
 
 	// report parameters
-	printInfo << "running pwaNloptFit with the following parameters:" << endl;
-	cout << "    mass bin [" << massBinMin << ", " << massBinMax << "] GeV/c^2" << endl
-	     << "    seed for random start values ................... "  << seed                    << endl
-	     << "    path to file with start values ................. '" << startValFileName << "'" << endl;
+	printInfoTo(out) << "running pwaNloptFit with the following parameters:" << endl;
+	out << "    mass bin [" << massBinMin << ", " << massBinMax << "] GeV/c^2" << endl
+	    << "    seed for random start values ................... "  << seed                    << endl;
 	if (useFixedStartValues)
-		cout << "    using fixed instead of random start values ..... " << defaultStartValue << endl;
-	cout << "    check analytical Hessian eigenvalues............ "  << yesNo(checkHessian)     << endl
-	     << "    minimizer tolerance ............................ "  << minimizerTolerance      << endl
-	     << "    likelihood tolerance ........................... "  << likelihoodTolerance     << endl
-	     << "    saving integral and covariance matrices......... "  << yesNo(not saveSpace)    << endl
-	     << "    quiet .......................................... "  << yesNo(quiet)            << endl;
+		out << "    using fixed instead of random start values ..... " << defaultStartValue << endl;
+	out << "    check analytical Hessian eigenvalues............ "  << yesNo(checkHessian)     << endl
+	    << "    minimizer tolerance ............................ "  << minimizerTolerance      << endl
+	    << "    likelihood tolerance ........................... "  << likelihoodTolerance     << endl
+	    << "    saving integral and covariance matrices......... "  << yesNo(not saveSpace)    << endl
+	    << "    quiet .......................................... "  << yesNo(quiet)            << endl;
 
 	// ---------------------------------------------------------------------------
 	// setup likelihood function
 	if (not quiet) {
-		printInfo << "likelihood initialized with the following parameters:" << endl;
-		cout << L << endl;
+		printInfoTo(out) << "likelihood initialized with the following parameters:" << endl;
+		out << L << endl;
 
-		printInfo << "using prior: ";
+		printInfoTo(out) << "using prior: ";
 		switch(L.priorType()) {
 			case pwaLikelihood<complex<double> >::FLAT:
-				cout << "flat" << endl;
+				out << "flat" << endl;
 				break;
 			case pwaLikelihood<complex<double> >::HALF_CAUCHY:
-				cout      << "half-cauchy" << endl;
-				printInfo << "cauchy width: " << L.cauchyWidth() << endl;
+				out << "half-cauchy" << endl;
+				printInfoTo(out) << "cauchy width: " << L.cauchyWidth() << endl;
 				break;
 		}
 	}
@@ -105,33 +163,27 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 	// ---------------------------------------------------------------------------
 	// setup minimizer
 	nlopt::opt optimizer(nlopt::LD_LBFGS, nmbPar);
-	optimizer.set_min_objective(&rpwaNloptFunc, &const_cast<pwaLikelihood<complex<double> >&>(L));
+	nloptFuncData funcData = {&L, &optimizer, state, 0};
+	optimizer.set_min_objective(&rpwaNloptFunc, &funcData);
 
 	optimizer.set_xtol_rel(minimizerTolerance);
 	optimizer.set_maxeval(maxNmbOfIterations);
 	optimizer.set_ftol_abs(likelihoodTolerance);
 
 	{
-		printInfo << "optimizer parameters:" << endl;
-		cout << "    absolute likelihood tolerance.............. " << optimizer.get_ftol_abs() << endl;
-		cout << "    relative likelihood tolerance.............. " << optimizer.get_ftol_rel() << endl;
-		cout << "    maximum number of likelihood evaluations... " << optimizer.get_maxeval() << endl;
-		cout << "    maximum time for optimization.............. " << optimizer.get_maxtime() << endl;
-		cout << "    stop when this likelihood is found......... " << optimizer.get_stopval() << endl;
-		cout << "    relative parameter tolerance............... " << optimizer.get_xtol_rel() << endl;
-	}
-
-	// ---------------------------------------------------------------------------
-	// read in fitResult with start values
-	if (startValFileName.length() > 0) {
-		printErr << "cannot use start values from fitResult with pwaNloptFit. Aborting..." << std::endl;
-		throw;
+		printInfoTo(out) << "optimizer parameters:" << endl;
+		out << "    absolute likelihood tolerance.............. " << optimizer.get_ftol_abs() << endl;
+		out << "    relative likelihood tolerance.............. " << optimizer.get_ftol_rel() << endl;
+		out << "    maximum number of likelihood evaluations... " << optimizer.get_maxeval() << endl;
+		out << "    maximum time for optimization.............. " << optimizer.get_maxtime() << endl;
+		out << "    stop when this likelihood is found......... " << optimizer.get_stopval() << endl;
+		out << "    relative parameter tolerance............... " << optimizer.get_xtol_rel() << endl;
 	}
 
 	// ---------------------------------------------------------------------------
 	// set start parameter values
-	printInfo << "setting start values for " << nmbPar << " parameters" << endl
-	          << "    parameter naming scheme is: V[rank index]_[wave name]" << endl;
+	printInfoTo(out) << "setting start values for " << nmbPar << " parameters" << endl
+	                 << "    parameter naming scheme is: V[rank index]_[wave name]" << endl;
 	unsigned int maxParNameLength = 0;       // maximum length of parameter names
 	vector<double>params(nmbPar);
 	{
@@ -158,8 +210,8 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 
 			// check if parameter needs to be fixed
 			if (not L.parameter(i).fixed()) {
-				cout << "    setting parameter [" << setw(3) << i << "] "
-				     << setw(maxParNameLength) << parName << " = " << maxPrecisionAlign(startVal) << endl;
+				out << "    setting parameter [" << setw(3) << i << "] "
+				    << setw(maxParNameLength) << parName << " = " << maxPrecisionAlign(startVal) << endl;
 				params[i] = startVal;
 			} else {
 				printErr << "thresholds are not implemented for fits with NLopt. Aborting..." << endl;
@@ -175,15 +227,29 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 	double likeli;
 	vector<double> correctParams;
 	TMatrixT<double> fitParCovMatrix(0, 0);
-	printInfo << "performing minimization." << endl;
+	printInfoTo(out) << "performing minimization." << endl;
 	{
 		TStopwatch timer;
 		timer.Start();
-		nlopt::result result = optimizer.optimize(params, likeli);
+		nlopt::result result;
+		try {
+			result = optimizer.optimize(params, likeli);
+		} catch(const nlopt::forced_stop&) {
+			// attempt was stopped because it is clearly worse than the best attempt
+			result = nlopt::FORCED_STOP;
+			likeli = L.DoEval(params.data());
+		}
 		if(result > 0) {
 			converged = true;
 		}
 		timer.Stop();
+		if(state and converged) {
+			lock_guard<mutex> lock(state->mtx);
+			if(likeli < state->bestLikelihood) {
+				state->bestLikelihood = likeli;
+				state->bestNmbEvals   = funcData.nmbEvals;
+			}
+		}
 
 		correctParams = L.CorrectParamSigns(params.data());
 		const double newLikelihood = L.DoEval(correctParams.data());
@@ -191,7 +257,7 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 			printErr << "Flipping signs according to sign conventions changed the likelihood (from " << maxPrecisionAlign(likeli) << " to " << maxPrecisionAlign(newLikelihood) << ")." << endl;
 			throw;
 		} else {
-			printInfo << "Likelihood unchanged at " << maxPrecisionAlign(newLikelihood) << " by flipping signs according to conventions." << endl;
+			printInfoTo(out) << "Likelihood unchanged at " << maxPrecisionAlign(newLikelihood) << " by flipping signs according to conventions." << endl;
 		}
 
 		if (checkHessian || not saveSpace) {
@@ -200,14 +266,14 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 			// calculate and check Hessian eigenvalues
 			vector<pair<TVectorT<double>, double> > eigenVectors = L.HessianEigenVectors(hessian);
 			if (not quiet) {
-				printInfo << "eigenvalues of (analytic) Hessian:" << endl;
+				printInfoTo(out) << "eigenvalues of (analytic) Hessian:" << endl;
 			}
 			for(size_t i=0; i<eigenVectors.size(); ++i) {
 				if (not quiet) {
-					cout << "    " << maxPrecisionAlign(eigenVectors[i].second) << endl;
+					out << "    " << maxPrecisionAlign(eigenVectors[i].second) << endl;
 				}
 				if (eigenVectors[i].second <= 0.) {
-					printWarn << "eigenvalue " << i << " of (analytic) Hessian is not positive (" << maxPrecisionAlign(eigenVectors[i].second) << ")." << endl;
+					printWarnTo(out) << "eigenvalue " << i << " of (analytic) Hessian is not positive (" << maxPrecisionAlign(eigenVectors[i].second) << ")." << endl;
 					converged = false;
 				}
 			}
@@ -218,70 +284,69 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 			}
 		}
 		if (converged) {
-			printSucc << "minimization finished successfully. " << flush;
+			printSuccTo(out) << "minimization finished successfully. " << flush;
 		} else {
-			printWarn << "minimization failed. " << flush;
+			printWarnTo(out) << "minimization failed. " << flush;
 		}
-		cout << "used " << flush;
-		timer.Print();
-		printInfo << "optimizer status:" << endl;
-		cout << "    ";
+		out << "used real time " << timer.RealTime() << " sec, CPU time " << timer.CpuTime() << " sec" << endl;
+		printInfoTo(out) << "optimizer status:" << endl;
+		out << "    ";
 		switch(result) {
 			case nlopt::SUCCESS:
-				cout << "success!" << endl;
+				out << "success!" << endl;
 				break;
 			case nlopt::STOPVAL_REACHED:
-				cout << "likelihood threshold reached." << endl;
+				out << "likelihood threshold reached." << endl;
 				break;
 			case nlopt::FTOL_REACHED:
-				cout << "function tolerance reached." << endl;
+				out << "function tolerance reached." << endl;
 				break;
 			case nlopt::XTOL_REACHED:
-				cout << "parameter tolerance reached." << endl;
+				out << "parameter tolerance reached." << endl;
 				break;
 			case nlopt::MAXEVAL_REACHED:
-				cout << "maximum number of evaluations reached." << endl;
+				out << "maximum number of evaluations reached." << endl;
 				break;
 			case nlopt::MAXTIME_REACHED:
-				cout << "time limit reached." << endl;
+				out << "time limit reached." << endl;
 				break;
 			case nlopt::FAILURE:
-				cout << "generic error." << endl;
+				out << "generic error." << endl;
 				break;
 			case nlopt::INVALID_ARGS:
-				cout << "invalid arguments." << endl;
+				out << "invalid arguments." << endl;
 				break;
 			case nlopt::OUT_OF_MEMORY:
-				cout << "out of memory." << endl;
+				out << "out of memory." << endl;
 				break;
 			case nlopt::ROUNDOFF_LIMITED:
-				cout << "roundoff errors limited progress." << endl;
+				out << "roundoff errors limited progress." << endl;
 				break;
 			case nlopt::FORCED_STOP:
-				cout << "forced stop." << endl;
+				out << "forced stop." << endl;
 				break;
 		}
 	}
 
 	// ---------------------------------------------------------------------------
 	// print results
-	printInfo << "minimization result:" << endl;
+	printInfoTo(out) << "minimization result:" << endl;
 	for (unsigned int i = 0; i < nmbPar; ++i) {
-		cout << "    parameter [" << setw(3) << i << "] "
-		     << setw(maxParNameLength) << L.parameter(i).parName() << " = "
-		     << setw(12) << maxPrecisionAlign(correctParams[i]) << " +- ";
+		out << "    parameter [" << setw(3) << i << "] "
+		    << setw(maxParNameLength) << L.parameter(i).parName() << " = "
+		    << setw(12) << maxPrecisionAlign(correctParams[i]) << " +- ";
 		if(not saveSpace) {
-			cout << setw(12) << maxPrecisionAlign(sqrt(fitParCovMatrix(i, i)));
+			out << setw(12) << maxPrecisionAlign(sqrt(fitParCovMatrix(i, i)));
 		} else {
-			cout << setw(12) << "[not available]";
+			out << setw(12) << "[not available]";
 		}
-		cout << endl;
+		out << endl;
 	}
-	printInfo << "function call summary:" << endl;
-	L.printFuncInfo(cout);
+	printInfoTo(out) << "function call summary:" << endl;
+	L.printFuncInfo(out);
 #ifdef USE_CUDA
-	printInfo << "total CUDA kernel time: "
-	          << cuda::likelihoodInterface<cuda::complex<double> >::kernelTime() << " sec" << endl;
+	printInfoTo(out) << "total CUDA kernel time: "
+	                 << cuda::likelihoodInterface<cuda::complex<double> >::kernelTime() << " sec" << endl;
 #endif
 
 	// get data structures to construct fitResult
@@ -298,15 +363,15 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 	}
 	const int normNmbEvents = 1;  // number of events to normalize to
 
-	cout << "filling fitResult:" << endl
-	     << "    number of fit parameters ............... " << nmbPar                        << endl
-	     << "    number of production amplitudes ........ " << prodAmps.size()               << endl
-	     << "    number of production amplitude names ... " << prodAmpNames.size()           << endl
-	     << "    number of wave names ................... " << nmbWaves                      << endl
-	     << "    number of cov. matrix indices .......... " << fitParCovMatrixIndices.size() << endl
-	     << "    dimension of covariance matrix ......... " << fitParCovMatrix.GetNrows() << " x " << fitParCovMatrix.GetNcols() << endl
-	     << "    dimension of normalization matrix ...... " << normIntegral.nRows()       << " x " << normIntegral.nCols()       << endl
-	     << "    dimension of acceptance matrix ......... " << accIntegral.nRows()        << " x " << accIntegral.nCols()        << endl;
+	out << "filling fitResult:" << endl
+	    << "    number of fit parameters ............... " << nmbPar                        << endl
+	    << "    number of production amplitudes ........ " << prodAmps.size()               << endl
+	    << "    number of production amplitude names ... " << prodAmpNames.size()           << endl
+	    << "    number of wave names ................... " << nmbWaves                      << endl
+	    << "    number of cov. matrix indices .......... " << fitParCovMatrixIndices.size() << endl
+	    << "    dimension of covariance matrix ......... " << fitParCovMatrix.GetNrows() << " x " << fitParCovMatrix.GetNcols() << endl
+	    << "    dimension of normalization matrix ...... " << normIntegral.nRows()       << " x " << normIntegral.nCols()       << endl
+	    << "    dimension of acceptance matrix ......... " << accIntegral.nRows()        << " x " << accIntegral.nCols()        << endl;
 
 	fitResult* result = new fitResult();
 	result->fill(L.nmbEvents(),
@@ -326,3 +391,119 @@ rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
 
 	return fitResultPtr(result);
 }
+
+
+fitResultPtr
+rpwa::hli::pwaNloptFit(const pwaLikelihood<complex<double> >& L,
+                       const double                           massBinMin,
+                       const double                           massBinMax,
+                       const unsigned int                     seed,
+                       const string&                          startValFileName,
+                       const bool                             checkHessian,
+                       const bool                             saveSpace,
+                       const bool                             verbose)
+{
+	if (startValFileName.length() > 0) {
+		printErr << "cannot use start values from fitResult with pwaNloptFit. Aborting..." << std::endl;
+		throw;
+	}
+	return nloptFit(L, massBinMin, massBinMax, seed, checkHessian, saveSpace, verbose, NULL, cout);
+}
+
+
+vector<fitResultPtr>
+rpwa::hli::pwaNloptMultiStartFit(const pwaLikelihood<complex<double> >& L,
+                                 const unsigned int                     nmbAttempts,
+                                 const double                           massBinMin,
+                                 const double                           massBinMax,
+                                 const unsigned int                     seed,
+                                 const bool                             checkHessian,
+                                 const bool                             saveSpace,
+                                 const unsigned int                     nmbWorkers,
+                                 const double                           stopThreshold,
+                                 const bool                             verbose)
+{
+	// derive distinct seeds for the attempts; a seed of 0 gives random
+	// start values in each attempt
+	vector<unsigned int> seeds(nmbAttempts, seed);
+	if (seed != 0 and nmbAttempts > 1) {
+		TRandom3 random(seed);
+		for (unsigned int iAttempt = 0; iAttempt < nmbAttempts; ++iAttempt) {
+			while (true) {
+				seeds[iAttempt] = 1000 + random.Integer(numeric_limits<unsigned int>::max() - 1000);
+				if (find(seeds.begin(), seeds.begin() + iAttempt, seeds[iAttempt]) == seeds.begin() + iAttempt)
+					break;
+			}
+		}
+	}
+
+	unsigned int nmbThreads = (nmbWorkers > 0) ? nmbWorkers : thread::hardware_concurrency();
+	if (nmbThreads == 0)
+		nmbThreads = 1;
+	if (L.cudaEnabled() or L.mpiEnabled()) {
+		// the CUDA kernels and the MPI communication are shared by all copies of the likelihood
+		printWarn << "CUDA kernels and MPI do not support concurrent fit attempts. "
+		          << "running fit attempts sequentially." << endl;
+		nmbThreads = 1;
+	}
+#if ROOT_VERSION_CODE < ROOT_VERSION(6, 0, 0)
+	if (nmbThreads > 1) {
+		printWarn << "ROOT versions before 6 are not thread-safe. running fit attempts sequentially." << endl;
+		nmbThreads = 1;
+	}
+#else
+	ROOT::EnableThreadSafety();
+#endif
+	nmbThreads = min(nmbThreads, max(nmbAttempts, 1u));
+	// distribute the threads of the event loops over the concurrent attempts
+	const unsigned int nmbThreadsPerAttempt = max(L.nmbThreads() / nmbThreads, 1u);
+
+	printInfo << "running " << nmbAttempts << " fit attempts on " << nmbThreads << " threads "
+	          << "with " << nmbThreadsPerAttempt << " threads per attempt" << endl;
+	if (stopThreshold > 0.)
+		printInfo << "stopping attempts with log-likelihood worse than best attempt by more than " << stopThreshold << endl;
+
+	vector<fitResultPtr> results(nmbAttempts);
+	multiStartState      state(stopThreshold);
+	unsigned int         nextAttempt = 0;
+	mutex                nextAttemptMutex;
+	mutex                outMutex;
+	vector<thread>       workers;
+	for (unsigned int iWorker = 0; iWorker < nmbThreads; ++iWorker) {
+		workers.push_back(thread([&]() {
+			while (true) {
+				unsigned int iAttempt;
+				{
+					lock_guard<mutex> lock(nextAttemptMutex);
+					if (nextAttempt >= nmbAttempts)
+						break;
+					iAttempt = nextAttempt++;
+				}
+				// each attempt works on its own copy of the likelihood,
+				// which shares the decay amplitudes with L
+				const boost::scoped_ptr<pwaLikelihood<complex<double> > > attemptL(L.Clone());
+				attemptL->setNmbThreads(nmbThreadsPerAttempt);
+				if (nmbThreads == 1) {
+					results[iAttempt] = nloptFit(*attemptL, massBinMin, massBinMax, seeds[iAttempt],
+					                             checkHessian, saveSpace, verbose, &state, cout);
+					continue;
+				}
+				// the output of concurrent attempts is collected and printed
+				// when the attempt is finished, with each line prefixed by
+				// the index of the attempt
+				ostringstream attemptOut;
+				results[iAttempt] = nloptFit(*attemptL, massBinMin, massBinMax, seeds[iAttempt],
+				                             checkHessian, saveSpace, verbose, &state, attemptOut);
+				lock_guard<mutex> lock(outMutex);
+				istringstream     attemptLines(attemptOut.str());
+				string            line;
+				while (getline(attemptLines, line))
+					cout << "[attempt " << iAttempt << "] " << line << endl;
+			}
+		}));
+	}
+	for (unsigned int iWorker = 0; iWorker < nmbThreads; ++iWorker)
+		workers[iWorker].join();
+
+	return results;
+}
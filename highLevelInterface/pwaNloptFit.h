@@ -1,6 +1,8 @@
 #ifndef HLI_PWANLOPTFIT_H
 #define HLI_PWANLOPTFIT_H
 
+#include <vector>
+
 #include <fitResult.h>
 #include <pwaLikelihood.h>
 
@@ -17,6 +19,27 @@ namespace rpwa {
 		                               const bool                                        saveSpace = false,
 		                               const bool                                        verbose = false);
 
+		// performs nmbAttempts fits from random start values against the
+		// same likelihood; the attempts run concurrently on nmbWorkers
+		// threads (0 = number of hardware threads), each on a copy of the
+		// likelihood that shares the decay amplitudes with L. the seeds of
+		// the attempts are derived from seed. if stopThreshold is
+		// positive, an attempt is stopped once it has used as many
+		// likelihood evaluations as the best converged attempt so far,
+		// but its likelihood is still worse by more than stopThreshold.
+		// returns the fit results of all attempts in the order of the
+		// seeds
+		std::vector<rpwa::fitResultPtr> pwaNloptMultiStartFit(const rpwa::pwaLikelihood<std::complex<double> >& L,
+		                                                      const unsigned int                                nmbAttempts,
+		                                                      const double                                      massBinMin = 0.,
+		                                                      const double                                      massBinMax = 0.,
+		                                                      const unsigned int                                seed = 0,
+		                                                      const bool                                        checkHessian = false,
+		                                                      const bool                                        saveSpace = false,
+		                                                      const unsigned int                                nmbWorkers = 0,
+		                                                      const double                                      stopThreshold = 0.,
+		                                                      const bool                                        verbose = false);
+
 	}
 
 }
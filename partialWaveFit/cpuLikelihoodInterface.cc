@@ -0,0 +1,595 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      CPU implementation of the interface of the CUDA likelihood
+//      functions
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "TStopwatch.h"
+
+#include "arrayUtils.hpp"
+#include "conversionUtils.hpp"
+#include "reportingUtils.hpp"
+#include "sumAccumulators.hpp"
+
+#include "cpuLikelihoodInterface.h"
+
+
+using namespace std;
+using namespace boost::accumulators;
+using namespace rpwa;
+using namespace rpwa::cpu;
+
+
+namespace {
+
+	// number of events that are processed as one unit of work; must
+	// not depend on the number of threads to guarantee reproducible
+	// results
+	const unsigned int nmbEventsPerChunk = 4096;
+
+	// number of partial sums that are added in each stage of the cascaded sum
+	const unsigned int nmbOfSumsAtEachStage = 6;
+
+	// number of independent partial sums in the derivative kernel
+	// that allow the compiler to vectorize the loop over the events
+	const unsigned int nmbLanes = 8;
+
+}
+
+
+template<typename complexT> bool likelihoodInterface<complexT>::_debug = false;
+
+
+template<typename complexT>
+likelihoodInterface<complexT>::likelihoodInterface()
+	: _decayAmps (),
+	  _nmbEvents (0),
+	  _nmbWavesMax(0),
+	  _nmbThreads(1),
+	  _kernelTime(0)
+{
+	_nmbWavesRefl[0] = 0;
+	_nmbWavesRefl[1] = 0;
+}
+
+
+template<typename complexT>
+bool
+likelihoodInterface<complexT>::init
+(const complexT*    decayAmps,        // array of decay amplitudes; [iRefl][iWave][iEvt] or [iEvt][iRefl][iWave]
+ const size_t       nmbDecayAmps,     // number of elements in decay amplitude array
+ const unsigned int nmbEvents,        // total number of events
+ const unsigned int nmbWavesRefl[2],  // number of waves for each reflectivity
+ const bool         reshuffleArray)   // if set decay amplitude array is reshuffled from [iEvt][iRefl][iWave] to [iRefl][iWave][iEvt]
+{
+	if (not loadDecayAmps(decayAmps, nmbDecayAmps, nmbEvents, nmbWavesRefl, reshuffleArray)) {
+		printWarn << "problems loading decay amplitudes" << endl;
+		return false;
+	}
+	return true;
+}
+
+
+template<typename complexT>
+bool
+likelihoodInterface<complexT>::init
+(vector<complexT>&  decayAmps,        // array of decay amplitudes; [iRefl][iWave][iEvt]
+ const unsigned int nmbEvents,        // total number of events
+ const unsigned int nmbWavesRefl[2])  // number of waves for each reflectivity
+{
+	if (not setDimensions(decayAmps.size(), nmbEvents, nmbWavesRefl))
+		return false;
+	// the array is taken over without copying it
+	boost::shared_ptr<vector<complexT> > amps(new vector<complexT>());
+	amps->swap(decayAmps);
+	vector<complexT>().swap(decayAmps);
+	_decayAmps = amps;
+	printLoadInfo();
+	return true;
+}
+
+
+template<typename complexT>
+void
+likelihoodInterface<complexT>::close()
+{
+	_decayAmps.reset();
+	_nmbEvents       = 0;
+	_nmbWavesRefl[0] = 0;
+	_nmbWavesRefl[1] = 0;
+	_nmbWavesMax     = 0;
+}
+
+
+template<typename complexT>
+bool
+likelihoodInterface<complexT>::loadDecayAmps
+(const complexT*    decayAmps,        // array of decay amplitudes; [iRefl][iWave][iEvt] or [iEvt][iRefl][iWave]
+ const size_t       nmbDecayAmps,     // number of elements in decay amplitude array
+ const unsigned int nmbEvents,        // total number of events
+ const unsigned int nmbWavesRefl[2],  // number of waves for each reflectivity
+ const bool         reshuffleArray)   // if set decay amplitude array is reshuffled from [iEvt][iRefl][iWave] to [iRefl][iWave][iEvt]
+{
+	if (not decayAmps) {
+		printErr << "null pointer to decay amplitudes. Aborting..." << endl;
+		throw;
+	}
+	if (not setDimensions(nmbDecayAmps, nmbEvents, nmbWavesRefl))
+		return false;
+
+	boost::shared_ptr<vector<complexT> > amps(new vector<complexT>());
+	if (reshuffleArray) {
+		// change memory layout of decay amplitudes from [iEvt][iRefl][iWave] to [iRefl][iWave][iEvt]
+		amps->assign(nmbDecayAmps, complexT(0));
+		const size_t decayAmpDimOld[3] = {_nmbEvents, 2, _nmbWavesMax};
+		const size_t decayAmpDimNew[3] = {2, _nmbWavesMax, _nmbEvents};
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+				for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
+					const size_t decayAmpIndicesOld[3] = {iEvt, iRefl, iWave};
+					const size_t offsetOld             = indicesToOffset<size_t>(decayAmpIndicesOld, decayAmpDimOld, 3);
+					const size_t decayAmpIndicesNew[3] = {iRefl, iWave, iEvt};
+					const size_t offsetNew             = indicesToOffset<size_t>(decayAmpIndicesNew, decayAmpDimNew, 3);
+					(*amps)[offsetNew] = decayAmps[offsetOld];
+				}
+	} else
+		amps->assign(decayAmps, decayAmps + nmbDecayAmps);
+	_decayAmps = amps;
+	printLoadInfo();
+	return true;
+}
+
+
+template<typename complexT>
+bool
+likelihoodInterface<complexT>::setDimensions(const size_t       nmbDecayAmps,
+                                             const unsigned int nmbEvents,
+                                             const unsigned int nmbWavesRefl[2])
+{
+	if (initialized()) {
+		printErr << "decay amplitudes are already loaded. call close() before loading new ones. Aborting..." << endl;
+		return false;
+	}
+	const unsigned int nmbWavesMax = max(nmbWavesRefl[0], nmbWavesRefl[1]);
+	if (nmbDecayAmps != (size_t)2 * nmbWavesMax * nmbEvents) {
+		printWarn << "size of decay amplitude array (" << nmbDecayAmps << ") does not match "
+		          << "2 x " << nmbWavesMax << " waves x " << nmbEvents << " events." << endl;
+		return false;
+	}
+	_nmbEvents       = nmbEvents;
+	_nmbWavesRefl[0] = nmbWavesRefl[0];
+	_nmbWavesRefl[1] = nmbWavesRefl[1];
+	_nmbWavesMax     = nmbWavesMax;
+	return true;
+}
+
+
+template<typename complexT>
+void
+likelihoodInterface<complexT>::printLoadInfo() const
+{
+	printInfo << "loaded decay amplitudes of " << _nmbEvents << " events and "
+	          << _nmbWavesRefl[0] + _nmbWavesRefl[1] << " waves ("
+	          << _decayAmps->size() * sizeof(complexT) / (1024. * 1024.) << " MiBytes)" << endl;
+}
+
+
+template<typename complexT>
+void
+likelihoodInterface<complexT>::setNmbThreads(const unsigned int nmbThreads)
+{
+#ifdef _OPENMP
+	_nmbThreads = (nmbThreads == 0) ? omp_get_max_threads() : nmbThreads;
+#else
+	if (nmbThreads > 1)
+		printWarn << "ROOTPWA was compiled without OpenMP support. "
+		          << "ignoring request to use " << nmbThreads << " threads." << endl;
+	_nmbThreads = 1;
+#endif
+}
+
+
+template<typename complexT>
+typename likelihoodInterface<complexT>::value_type
+likelihoodInterface<complexT>::logLikelihood
+(const complexT*    prodAmps,     // array of production amplitudes; [iRank][iRefl][iWave]
+ const unsigned int nmbProdAmps,  // number of elements in production amplitude array
+ const value_type   prodAmpFlat,  // (real) amplitude of flat wave
+ const unsigned int rank) const   // rank of spin-density matrix
+{
+	if (not prodAmps) {
+		printErr << "null pointer to production amplitudes. Aborting..." << endl;
+		throw;
+	}
+	if (not initialized()) {
+		printErr << "decay amplitudes were not loaded. Aborting..." << endl;
+		throw;
+	}
+	if (nmbProdAmps != rank * 2 * _nmbWavesMax) {
+		printErr << "size of production amplitude array (" << nmbProdAmps << ") does not match "
+		         << "rank " << rank << " x 2 x " << _nmbWavesMax << " waves. Aborting..." << endl;
+		throw;
+	}
+
+	TStopwatch timer;
+	timer.Start();
+
+	// first summation stage
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+	vector<value_type> logLikelihoodSums(max(nmbChunks, 1u), 0);
+	if (_debug)
+		printInfo << "running logLikelihoodKernel for " << nmbChunks << " chunks "
+		          << "with " << _nmbThreads << " threads" << endl;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		logLikelihoodSums[iChunk] = logLikelihoodKernel(prodAmps, prodAmpFlat * prodAmpFlat, rank, evtBegin, evtEnd);
+	}
+	// cascaded summation of log likelihoods
+	cascadedSum(nmbOfSumsAtEachStage, logLikelihoodSums);
+
+	timer.Stop();
+	_kernelTime += timer.RealTime();
+
+	return logLikelihoodSums[0];
+}
+
+
+template<typename complexT>
+void
+likelihoodInterface<complexT>::logLikelihoodDeriv
+(const complexT*    prodAmps,        // array of production amplitudes; [iRank][iRefl][iWave]
+ const unsigned int nmbProdAmps,     // number of elements in production amplitude array
+ const value_type   prodAmpFlat,     // (real) amplitude of flat wave
+ const unsigned int rank,            // rank of spin-density matrix
+ complexT*          derivatives,     // array of log likelihood derivatives; [iRank][iRefl][iWave]
+ value_type&        derivativeFlat,  // log likelihood derivative of flat wave
+ value_type*        logLikelihood) const  // if not null, log likelihood is stored here
+{
+	if (not prodAmps) {
+		printErr << "null pointer to production amplitudes. Aborting..." << endl;
+		throw;
+	}
+	if (not derivatives) {
+		printErr << "null pointer to derivatives array. Aborting..." << endl;
+		throw;
+	}
+	if (not initialized()) {
+		printErr << "decay amplitudes were not loaded. Aborting..." << endl;
+		throw;
+	}
+	if (nmbProdAmps != rank * 2 * _nmbWavesMax) {
+		printErr << "size of production amplitude array (" << nmbProdAmps << ") does not match "
+		         << "rank " << rank << " x 2 x " << _nmbWavesMax << " waves. Aborting..." << endl;
+		throw;
+	}
+
+	TStopwatch timer;
+	timer.Start();
+
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+
+	// first stage: precalculate derivative term and likelihoods for each event
+	vector<complexT>   derivTerms ((size_t)rank * 2 * _nmbEvents);
+	vector<value_type> likelihoods(_nmbEvents);
+	if (_debug)
+		printInfo << "running logLikelihoodDerivFirstTermKernel for " << nmbChunks << " chunks "
+		          << "with " << _nmbThreads << " threads" << endl;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		logLikelihoodDerivFirstTermKernel(prodAmps, prodAmpFlat * prodAmpFlat, rank, evtBegin, evtEnd,
+		                                  derivTerms.data(), likelihoods.data());
+	}
+
+	// second stage: sum derivatives
+	{
+		const unsigned int nmbDerivElements = rank * 2 * _nmbWavesMax;
+		vector<complexT>   derivativeSums(max(nmbChunks, 1u) * nmbDerivElements, complexT(0));
+		if (_debug)
+			printInfo << "running logLikelihoodDerivKernel for " << nmbChunks << " chunks "
+			          << "with " << _nmbThreads << " threads" << endl;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+		for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+			const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+			const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+			logLikelihoodDerivKernel(derivTerms.data(), likelihoods.data(), rank, evtBegin, evtEnd,
+			                         &derivativeSums[iChunk * nmbDerivElements]);
+		}
+		// cascaded summation of derivatives
+		cascadedSum(nmbOfSumsAtEachStage, derivativeSums, nmbDerivElements);
+		copy(derivativeSums.begin(), derivativeSums.begin() + nmbDerivElements, derivatives);
+	}
+
+	// flat wave requires special treatment; the log likelihood can be
+	// calculated in the same step from the likelihoods of the events
+	{
+		vector<value_type> derivativeFlatSums(max(nmbChunks, 1u), 0);
+		vector<value_type> logLikelihoodSums (max(nmbChunks, 1u), 0);
+		if (_debug)
+			printInfo << "running logLikelihoodDerivFlatKernel for " << nmbChunks << " chunks "
+			          << "with " << _nmbThreads << " threads" << endl;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+		for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+			const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+			const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+			derivativeFlatSums[iChunk] = logLikelihoodDerivFlatKernel(prodAmpFlat, likelihoods.data(), evtBegin, evtEnd);
+			if (logLikelihood) {
+				accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+				for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt)
+					logLikelihoodAcc(-log(likelihoods[iEvt]));
+				logLikelihoodSums[iChunk] = sum(logLikelihoodAcc);
+			}
+		}
+		// cascaded summation
+		cascadedSum(nmbOfSumsAtEachStage, derivativeFlatSums);
+		derivativeFlat = derivativeFlatSums[0];
+		if (logLikelihood) {
+			cascadedSum(nmbOfSumsAtEachStage, logLikelihoodSums);
+			*logLikelihood = logLikelihoodSums[0];
+		}
+	}
+
+	timer.Stop();
+	_kernelTime += timer.RealTime();
+}
+
+
+template<typename complexT>
+ostream&
+likelihoodInterface<complexT>::print(ostream& out) const
+{
+	out << "CPU likelihood interface:" << endl
+	    << "    decay amplitudes loaded .............. " << yesNo(initialized()) << endl
+	    << "    number of events ..................... " << _nmbEvents         << endl
+	    << "    number of negative reflectivity waves  " << _nmbWavesRefl[0]   << endl
+	    << "    number of positive reflectivity waves  " << _nmbWavesRefl[1]   << endl
+	    << "    memory used by decay amplitudes ...... " << ((initialized()) ? _decayAmps->size() * sizeof(complexT) / (1024. * 1024.) : 0.) << " MiBytes" << endl
+	    << "    number of threads .................... " << _nmbThreads        << endl
+	    << "    number of events per chunk ........... " << nmbEventsPerChunk  << endl;
+	return out;
+}
+
+
+// kernel that calculates real-data term of log likelihood sum for a number of events
+template<typename complexT>
+typename likelihoodInterface<complexT>::value_type
+likelihoodInterface<complexT>::logLikelihoodKernel
+(const complexT*    prodAmps,      // 3-dim. array of production amplitudes; [iRank][iRefl][iWave]
+ const value_type   prodAmpFlat2,  // squared production amplitude of flat wave
+ const unsigned int rank,          // rank of spin-density matrix
+ const unsigned int evtBegin,      // first event to process
+ const unsigned int evtEnd) const  // one after last event to process
+{
+	const unsigned int nmbEvts        = evtEnd - evtBegin;
+	const unsigned int prodAmpDim [3] = {rank, 2,            _nmbWavesMax};
+	const size_t       decayAmpDim[3] = {2,    _nmbWavesMax, _nmbEvents};
+	// the coherent sums of all events are calculated wave by wave, so
+	// that the decay amplitudes are read sequentially
+	vector<value_type> likelihoods  (nmbEvts, prodAmpFlat2);
+	vector<value_type> ampProdSumsRe(nmbEvts);
+	vector<value_type> ampProdSumsIm(nmbEvts);
+	for (unsigned int iRank = 0; iRank < rank; ++iRank) {  // incoherent sum over ranks
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+			fill(ampProdSumsRe.begin(), ampProdSumsRe.end(), 0);
+			fill(ampProdSumsIm.begin(), ampProdSumsIm.end(), 0);
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+				const unsigned int prodAmpIndices [3] = {iRank, iRefl, iWave};
+				const size_t       decayAmpIndices[3] = {iRefl, iWave, evtBegin};
+				const complexT     prodAmp            = prodAmps[indicesToOffset<unsigned int>(prodAmpIndices, prodAmpDim, 3)];
+				const value_type   prodAmpRe          = prodAmp.real();
+				const value_type   prodAmpIm          = prodAmp.imag();
+				const complexT*    decayAmps          = &(*_decayAmps)[indicesToOffset<size_t>(decayAmpIndices, decayAmpDim, 3)];
+				for (unsigned int i = 0; i < nmbEvts; ++i) {
+					ampProdSumsRe[i] += prodAmpRe * decayAmps[i].real() - prodAmpIm * decayAmps[i].imag();
+					ampProdSumsIm[i] += prodAmpRe * decayAmps[i].imag() + prodAmpIm * decayAmps[i].real();
+				}
+			}
+			for (unsigned int i = 0; i < nmbEvts; ++i)
+				likelihoods[i] += ampProdSumsRe[i] * ampProdSumsRe[i] + ampProdSumsIm[i] * ampProdSumsIm[i];
+		}
+	}
+	accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+	for (unsigned int i = 0; i < nmbEvts; ++i)
+		logLikelihoodAcc(-log(likelihoods[i]));
+	return sum(logLikelihoodAcc);
+}
+
+
+// kernel that calculates the real-data term of the derivative of
+// the log likelihood that is independent of the indices of the
+// production amplitude w.r.t. which the derivative is taken
+template<typename complexT>
+void
+likelihoodInterface<complexT>::logLikelihoodDerivFirstTermKernel
+(const complexT*    prodAmps,      // 3-dim. array of production amplitudes; [iRank][iRefl][iWave]
+ const value_type   prodAmpFlat2,  // squared production amplitude of flat wave
+ const unsigned int rank,          // rank of spin-density matrix
+ const unsigned int evtBegin,      // first event to process
+ const unsigned int evtEnd,        // one after last event to process
+ complexT*          derivTerms,    // 3-dim. output array of first derivative terms; [iRank][iRefl][iEvt]
+ value_type*        likelihoods) const  // output array of likelihoods for each event
+{
+	const unsigned int nmbEvts         = evtEnd - evtBegin;
+	const unsigned int prodAmpDim  [3] = {rank, 2,            _nmbWavesMax};
+	const size_t       decayAmpDim [3] = {2,    _nmbWavesMax, _nmbEvents};
+	const size_t       derivTermDim[3] = {rank, 2,            _nmbEvents};
+	vector<value_type> ampProdSumsRe(nmbEvts);
+	vector<value_type> ampProdSumsIm(nmbEvts);
+	for (unsigned int i = 0; i < nmbEvts; ++i)
+		likelihoods[evtBegin + i] = prodAmpFlat2;
+	for (unsigned int iRank = 0; iRank < rank; ++iRank) {  // incoherent sum over ranks
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+			fill(ampProdSumsRe.begin(), ampProdSumsRe.end(), 0);
+			fill(ampProdSumsIm.begin(), ampProdSumsIm.end(), 0);
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+				const unsigned int prodAmpIndices [3] = {iRank, iRefl, iWave};
+				const size_t       decayAmpIndices[3] = {iRefl, iWave, evtBegin};
+				const complexT     prodAmp            = prodAmps[indicesToOffset<unsigned int>(prodAmpIndices, prodAmpDim, 3)];
+				const value_type   prodAmpRe          = prodAmp.real();
+				const value_type   prodAmpIm          = prodAmp.imag();
+				const complexT*    decayAmps          = &(*_decayAmps)[indicesToOffset<size_t>(decayAmpIndices, decayAmpDim, 3)];
+				for (unsigned int i = 0; i < nmbEvts; ++i) {
+					ampProdSumsRe[i] += prodAmpRe * decayAmps[i].real() - prodAmpIm * decayAmps[i].imag();
+					ampProdSumsIm[i] += prodAmpRe * decayAmps[i].imag() + prodAmpIm * decayAmps[i].real();
+				}
+			}
+			// write derivative terms and likelihoods
+			const size_t       derivTermIndices[3] = {iRank, iRefl, evtBegin};
+			complexT*          derivTerm           = &derivTerms[indicesToOffset<size_t>(derivTermIndices, derivTermDim, 3)];
+			for (unsigned int i = 0; i < nmbEvts; ++i) {
+				derivTerm[i]               = complexT(ampProdSumsRe[i], ampProdSumsIm[i]);
+				likelihoods[evtBegin + i] += ampProdSumsRe[i] * ampProdSumsRe[i] + ampProdSumsIm[i] * ampProdSumsIm[i];
+			}
+		}
+	}
+}
+
+
+// kernel that operates on the output of logLikelihoodDerivFirstTermKernel
+// and calculates the real-data derivative sum of the log likelihood for
+// all production amplitudes
+template<typename complexT>
+void
+likelihoodInterface<complexT>::logLikelihoodDerivKernel
+(const complexT*    derivTerms,      // precalculated 3-dim. array of first derivative terms; [iRank][iRefl][iEvt]
+ const value_type*  likelihoods,     // precalculated array of likelihoods for each event
+ const unsigned int rank,            // rank of spin-density matrix
+ const unsigned int evtBegin,        // first event to process
+ const unsigned int evtEnd,          // one after last event to process
+ complexT*          derivativeSums) const  // output array of partial derivative sums; [iRank][iRefl][iWave]
+{
+	const unsigned int nmbEvts         = evtEnd - evtBegin;
+	const size_t       decayAmpDim [3] = {2,    _nmbWavesMax, _nmbEvents};
+	const size_t       derivTermDim[3] = {rank, 2,            _nmbEvents};
+	const unsigned int derivSumDim [3] = {rank, 2,            _nmbWavesMax};
+	// apply factor from derivative of log
+	vector<value_type> factors(nmbEvts);
+	for (unsigned int i = 0; i < nmbEvts; ++i)
+		factors[i] = -2. / likelihoods[evtBegin + i];
+	vector<value_type> termsRe(nmbEvts);
+	vector<value_type> termsIm(nmbEvts);
+	for (unsigned int iRank = 0; iRank < rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+			const size_t       derivTermIndices[3] = {iRank, iRefl, evtBegin};
+			const complexT*    derivTerm           = &derivTerms[indicesToOffset<size_t>(derivTermIndices, derivTermDim, 3)];
+			for (unsigned int i = 0; i < nmbEvts; ++i) {
+				termsRe[i] = factors[i] * derivTerm[i].real();
+				termsIm[i] = factors[i] * derivTerm[i].imag();
+			}
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+				// multiply derivative term 1 with with complex conjugate of
+				// decay amplitude of the wave with the derivative wave index
+				const size_t       decayAmpIndices[3] = {iRefl, iWave, evtBegin};
+				const complexT*    decayAmps          = &(*_decayAmps)[indicesToOffset<size_t>(decayAmpIndices, decayAmpDim, 3)];
+				value_type         derivativeSumsRe[nmbLanes] = {};
+				value_type         derivativeSumsIm[nmbLanes] = {};
+				unsigned int       i = 0;
+				for (; i + nmbLanes <= nmbEvts; i += nmbLanes)
+					for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+						derivativeSumsRe[iLane] += termsRe[i + iLane] * decayAmps[i + iLane].real() + termsIm[i + iLane] * decayAmps[i + iLane].imag();
+						derivativeSumsIm[iLane] += termsIm[i + iLane] * decayAmps[i + iLane].real() - termsRe[i + iLane] * decayAmps[i + iLane].imag();
+					}
+				for (; i < nmbEvts; ++i) {
+					derivativeSumsRe[0] += termsRe[i] * decayAmps[i].real() + termsIm[i] * decayAmps[i].imag();
+					derivativeSumsIm[0] += termsIm[i] * decayAmps[i].real() - termsRe[i] * decayAmps[i].imag();
+				}
+				accumulator_set<complexT, stats<tag::sum(compensated)> > derivativeAcc;
+				for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+					derivativeAcc(complexT(derivativeSumsRe[iLane], derivativeSumsIm[iLane]));
+				// write result
+				const unsigned int derivSumIndices[3] = {iRank, iRefl, iWave};
+				derivativeSums[indicesToOffset<unsigned int>(derivSumIndices, derivSumDim, 3)] = sum(derivativeAcc);
+			}
+		}
+}
+
+
+// kernel that operates on the output of logLikelihoodDerivFirstTermKernel
+// and calculates the real-data derivative sum of the log likelihood for the flat wave
+template<typename complexT>
+typename likelihoodInterface<complexT>::value_type
+likelihoodInterface<complexT>::logLikelihoodDerivFlatKernel
+(const value_type   prodAmpFlat,  // (real) production amplitude of flat wave
+ const value_type*  likelihoods,  // precalculated array of likelihoods for each event
+ const unsigned int evtBegin,     // first event to process
+ const unsigned int evtEnd)       // one after last event to process
+{
+	accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
+	for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt)
+		derivativeFlatAcc(-((value_type)2. / likelihoods[iEvt]) * prodAmpFlat);
+	return sum(derivativeFlatAcc);
+}
+
+
+// adds up partial sums in stages; in each stage nmbOfSumsAtEachStage
+// consecutive partial sums are combined into one; the order of the
+// additions is fixed by the number of partial sums only
+template<typename complexT>
+template<typename T>
+void
+likelihoodInterface<complexT>::cascadedSum(const unsigned int nmbOfSumsAtEachStage,
+                                           vector<T>&         sums,
+                                           const unsigned int sumElementSize)
+{
+	unsigned int nmbSums = sums.size() / sumElementSize;
+	while (nmbSums > 1) {
+		const unsigned int nmbSumsNext = (nmbSums + nmbOfSumsAtEachStage - 1) / nmbOfSumsAtEachStage;
+		for (unsigned int iSum = 0; iSum < nmbSumsNext; ++iSum)
+			for (unsigned int iElement = 0; iElement < sumElementSize; ++iElement) {
+				accumulator_set<T, stats<tag::sum(compensated)> > sumAcc;
+				for (unsigned int jSum = iSum * nmbOfSumsAtEachStage;
+				     jSum < min((iSum + 1) * nmbOfSumsAtEachStage, nmbSums); ++jSum)
+					sumAcc(sums[jSum * sumElementSize + iElement]);
+				sums[iSum * sumElementSize + iElement] = sum(sumAcc);
+			}
+		nmbSums = nmbSumsNext;
+	}
+}
+
+
+// explicit specializations
+template class rpwa::cpu::likelihoodInterface<complex<float > >;
+template class rpwa::cpu::likelihoodInterface<complex<double> >;
@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      CPU implementation of the interface of the CUDA likelihood
+//      functions (see cuda/likelihoodInterface.cuh)
+//
+//      the decay amplitudes are stored in the same [iRefl][iWave][iEvt]
+//      memory layout as on the CUDA device and the calculation is split
+//      into the same stages as the CUDA kernels; the events are
+//      processed in chunks of fixed size that are distributed over the
+//      threads and the partial sums of the chunks are added up in a
+//      cascaded sum with fixed order, so that the result does not
+//      depend on the number of threads
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef CPULIKELIHOODINTERFACE_H
+#define CPULIKELIHOODINTERFACE_H
+
+
+#include <iostream>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+
+
+namespace rpwa {
+
+	namespace cpu {
+
+
+		// each instance holds the decay amplitudes of one likelihood;
+		// copies of an instance share the decay amplitudes, but have their
+		// own number of threads and kernel timer, so that several
+		// likelihoods, or several copies of one likelihood, can use the CPU
+		// kernels at the same time
+		template<typename complexT>
+		class likelihoodInterface {
+
+		public:
+
+			typedef typename complexT::value_type value_type;
+
+			likelihoodInterface();
+
+			bool init(const complexT*    decayAmps,
+			          const std::size_t  nmbDecayAmps,
+			          const unsigned int nmbEvents,
+			          const unsigned int nmbWavesRefl[2],
+			          const bool         reshuffleArray = true);  ///< convenience routine that copies decay amplitudes into internal memory; fails if decay amplitudes are already loaded
+			bool init(std::vector<complexT>& decayAmps,
+			          const unsigned int     nmbEvents,
+			          const unsigned int     nmbWavesRefl[2]);  ///< takes over decay amplitudes in [iRefl][iWave][iEvt] layout without copying them; decayAmps is empty afterwards; fails if decay amplitudes are already loaded
+			void close();  ///< releases decay amplitudes of this instance; copies keep them
+			bool loadDecayAmps(const complexT*    decayAmps,
+			                   const std::size_t  nmbDecayAmps,
+			                   const unsigned int nmbEvents,
+			                   const unsigned int nmbWavesRefl[2],
+			                   const bool         reshuffleArray = true);  ///< copies decay amplitudes into internal memory
+
+			bool         initialized() const { return _decayAmps.get() != 0; }  ///< returns whether decay amplitudes were loaded
+			unsigned int nmbEvents  () const { return _nmbEvents; }  ///< returns number of loaded events
+
+			/// returns decay amplitude of given event and wave
+			const complexT& decayAmp(const unsigned int iRefl,
+			                         const unsigned int iWave,
+			                         const unsigned int iEvt) const
+			{ return (*_decayAmps)[((std::size_t)iRefl * _nmbWavesMax + iWave) * _nmbEvents + iEvt]; }
+
+			void         setNmbThreads(const unsigned int nmbThreads = 0);  ///< 0 uses the number of threads given by the OpenMP runtime
+			unsigned int nmbThreads   () const { return _nmbThreads; }  ///< returns number of threads used
+
+			value_type logLikelihood(const complexT*    prodAmps,
+			                         const unsigned int nmbProdAmps,
+			                         const value_type   prodAmpFlat,
+			                         const unsigned int rank) const;  ///< computes log likelihood for given production amplitudes
+
+			void logLikelihoodDeriv(const complexT*    prodAmps,
+			                        const unsigned int nmbProdAmps,
+			                        const value_type   prodAmpFlat,
+			                        const unsigned int rank,
+			                        complexT*          derivatives,
+			                        value_type&        derivativeFlat,
+			                        value_type*        logLikelihood = 0) const;  ///< computes derivatives of log likelihood (and optionally the log likelihood itself) for given production amplitudes
+
+			double kernelTime     () const { return _kernelTime; }  ///< returns total time spent in kernels [sec]
+			void   resetKernelTime()       { _kernelTime = 0;    }  ///< resets kernel time counter to 0
+
+			std::ostream& print(std::ostream& out) const;  ///< prints properties of interface
+
+			static bool debug() { return _debug; }                             ///< returns debug flag
+			static void setDebug(const bool debug = true) { _debug = debug; }  ///< sets debug flag
+
+
+		private:
+
+			// CPU versions of the CUDA kernels; each call processes the events [evtBegin, evtEnd)
+			value_type logLikelihoodKernel              (const complexT*    prodAmps,
+			                                             const value_type   prodAmpFlat2,
+			                                             const unsigned int rank,
+			                                             const unsigned int evtBegin,
+			                                             const unsigned int evtEnd) const;
+			void       logLikelihoodDerivFirstTermKernel(const complexT*    prodAmps,
+			                                             const value_type   prodAmpFlat2,
+			                                             const unsigned int rank,
+			                                             const unsigned int evtBegin,
+			                                             const unsigned int evtEnd,
+			                                             complexT*          derivTerms,
+			                                             value_type*        likelihoods) const;
+			void       logLikelihoodDerivKernel         (const complexT*    derivTerms,
+			                                             const value_type*  likelihoods,
+			                                             const unsigned int rank,
+			                                             const unsigned int evtBegin,
+			                                             const unsigned int evtEnd,
+			                                             complexT*          derivativeSums) const;
+			static value_type logLikelihoodDerivFlatKernel(const value_type   prodAmpFlat,
+			                                               const value_type*  likelihoods,
+			                                               const unsigned int evtBegin,
+			                                               const unsigned int evtEnd);
+
+			bool setDimensions(const std::size_t  nmbDecayAmps,
+			                   const unsigned int nmbEvents,
+			                   const unsigned int nmbWavesRefl[2]);  ///< checks and sets array dimensions; fails if decay amplitudes are already loaded
+			void printLoadInfo() const;
+
+			template<typename T>
+			static void cascadedSum(const unsigned int nmbOfSumsAtEachStage,
+			                        std::vector<T>&    sums,
+			                        const unsigned int sumElementSize = 1);  ///< sums up partial sums [i][element] in place into sums[0][element]
+
+
+			boost::shared_ptr<const std::vector<complexT> > _decayAmps;        ///< precalculated decay amplitudes [iRefl][iWave][iEvt]; shared by copies of this instance; null if not loaded
+			unsigned int                                    _nmbEvents;        ///< number of events to process
+			unsigned int                                    _nmbWavesRefl[2];  ///< number of waves for each reflectivity
+			unsigned int                                    _nmbWavesMax;      ///< maximum extent of wave index for production and decay amplitude arrays
+			unsigned int                                    _nmbThreads;       ///< number of threads used
+			mutable double                                  _kernelTime;       ///< accumulates time spent in kernels
+
+			static bool _debug;  ///< if set to true, debug messages are printed
+
+		};
+
+
+		template<typename complexT>
+		inline
+		std::ostream&
+		operator <<(std::ostream&                        out,
+		            const likelihoodInterface<complexT>& interface)
+		{
+			return interface.print(out);
+		}
+
+
+	}  // namespace cpu
+
+}  // namespace rpwa
+
+
+#endif  // CPULIKELIHOODINTERFACE_H
@@ -41,15 +41,28 @@
 #include <iomanip>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef USE_MPI
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/environment.hpp>
+#endif
+
 #include "TStopwatch.h"
 #include "TString.h"
 #include "TSystem.h"
 #include "TTree.h"
 
+#include "ampIntegralPackedMatrix.h"
+#include "amplitudeCacheFile.h"
+#include "amplitudeMatrixMetadata.h"
 #include "amplitudeMetadata.h"
-#include "amplitudeTreeLeaf.h"
 #include "complexMatrix.h"
 #include "conversionUtils.hpp"
+#include "cpuLikelihoodInterface.h"
+#include "eventBinIndex.h"
 #include "eventMetadata.h"
 #include "fileUtils.hpp"
 #include "reportingUtils.hpp"
@@ -74,6 +87,98 @@ template<typename complexT> bool pwaLikelihood<complexT>::_debug = true;
 
 namespace {
 
+	// number of events that are summed up in one chunk of the event loops;
+	// the chunk size must not depend on the number of threads to keep the
+	// summation order, and hence the result, independent of the latter
+	const unsigned int nmbEventsPerChunk = 4096;
+
+	// maximum number of parameter points that are processed in one pass
+	// over the events by the batched evaluation functions; limits the
+	// memory needed for the partial sums of the chunks
+	const std::size_t nmbPointsPerPass = 16;
+
+	// number of events per chunk and number of events per block within a
+	// chunk in the calculation of the Hessian; the outer products of the
+	// vectors of all events in a block are added to the matrix at once
+	const unsigned int nmbEventsPerHessianChunk = 1024;
+	const unsigned int nmbEventsPerHessianBlock = 16;
+	// size of the tiles in which the matrices are updated; a tile of
+	// vectors of a block fits into the L1 cache
+	const unsigned int hessianTileSize          = 32;
+
+	// number of elements in the packed upper triangle of a symmetric n x n matrix
+	inline
+	std::size_t
+	packedSize(const std::size_t n)
+	{
+		return n * (n + 1) / 2;
+	}
+
+	// element (i, j) of a symmetric n x n matrix stored as packed upper triangle
+	template<typename T>
+	inline
+	T
+	packedElement(const T*          packedMatrix,
+	              const std::size_t i,
+	              const std::size_t j,
+	              const std::size_t n)
+	{
+		if (i > j)
+			return packedMatrix[j * (2 * n - j + 1) / 2 + i - j];
+		return packedMatrix[i * (2 * n - i + 1) / 2 + j - i];
+	}
+
+	// adds the sum of the outer products v_e v_e^T of the vectors of a block of
+	// nmbEventsPerHessianBlock events to the packed upper triangle of a symmetric
+	// dim x dim matrix; component k of the vector of event e is stored in
+	// vectors[k * nmbEventsPerHessianBlock + e]
+	template<typename T>
+	void
+	addOuterProducts(const T*           vectors,
+	                 const unsigned int dim,
+	                 T*                 packedMatrix)
+	{
+		for (unsigned int iBegin = 0; iBegin < dim; iBegin += hessianTileSize) {
+			const unsigned int iEnd = std::min(iBegin + hessianTileSize, dim);
+			for (unsigned int jBegin = iBegin; jBegin < dim; jBegin += hessianTileSize) {
+				const unsigned int jEnd = std::min(jBegin + hessianTileSize, dim);
+				for (unsigned int i = iBegin; i < iEnd; ++i) {
+					const T* vectorI = vectors + (std::size_t)i * nmbEventsPerHessianBlock;
+					T*       row     = packedMatrix + (std::size_t)i * (2 * dim - i + 1) / 2 - i;  // row[j] is element (i, j)
+					for (unsigned int j = std::max(i, jBegin); j < jEnd; ++j) {
+						const T* vectorJ = vectors + (std::size_t)j * nmbEventsPerHessianBlock;
+						T        product = 0;
+						for (unsigned int e = 0; e < nmbEventsPerHessianBlock; ++e)
+							product += vectorI[e] * vectorJ[e];
+						row[j] += product;
+					}
+				}
+			}
+		}
+	}
+
+	// view of the decay amplitudes of one reflectivity that are stored
+	// with constant strides between events and between waves
+	template<typename complexT, typename storedT>
+	struct stridedDecayAmps {
+		const storedT* amps;
+		std::size_t    evtStride;
+		std::size_t    waveStride;
+		complexT operator ()(const unsigned int iEvt,
+		                     const unsigned int iWave) const
+		{ return complexT(amps[iEvt * evtStride + iWave * waveStride]); }
+	};
+
+	// view of the decay amplitudes of one reflectivity in the
+	// structure-of-arrays layout of the SIMD kernels
+	template<typename complexT, typename T>
+	struct simdDecayAmps {
+		const rpwa::simdDecayAmpArray<T>* amps;
+		complexT operator ()(const unsigned int iEvt,
+		                     const unsigned int iWave) const
+		{ return amps->template get<complexT>(iEvt, iWave); }
+	};
+
 	double cauchyFunction(const double x, const double gamma)
 	{
 		if(x < 0.) {
@@ -124,6 +229,7 @@ pwaLikelihood<complexT>::fitParameter::parName() const
 template<typename complexT>
 pwaLikelihood<complexT>::pwaLikelihood()
 	: _nmbEvents        (0),
+	  _nmbEventsTotal   (0),
 	  _rank             (1),
 	  _nmbWaves         (0),
 	  _nmbWavesReflMax  (0),
@@ -135,13 +241,29 @@ pwaLikelihood<complexT>::pwaLikelihood()
 #ifdef USE_CUDA
 	  _cudaEnabled      (false),
 #endif
+	  _simdEnabled      (false),
+	  _floatStorage     (false),
+	  _cpuKernelsEnabled(false),
+#ifdef USE_MPI
+	  _mpiEnabled       (false),
+#endif
+	  _ampCacheDirectory(""),
+	  _binIndexDirectory(""),
+	  _nmbThreads       (1),
 	  _useNormalizedAmps(true),
 	  _priorType        (FLAT),
 	  _cauchyWidth      (0.5),
-	  _numbAccEvents    (0)
+	  _numbAccEvents    (0),
+	  _decayAmps        (new decayAmpStorage()),
+	  _cpuKernels       (),
+	  _incrementalEnabled      (false),
+	  _maxNmbIncrementalUpdates(100),
+	  _coherentSumsValid       (false),
+	  _nmbIncrementalUpdates   (0)
 {
 	_nmbWavesRefl[0] = 0;
 	_nmbWavesRefl[1] = 0;
+	setNmbThreads();
 	resetFuncCallInfo();
 #ifdef USE_FDF
 	printInfo << "using FdF() to calculate likelihood" << endl;
@@ -158,6 +280,16 @@ pwaLikelihood<complexT>::~pwaLikelihood()
 }
 
 
+template<typename complexT>
+typename pwaLikelihood<complexT>::decayAmpStorage&
+pwaLikelihood<complexT>::decayAmpsForWriting()
+{
+	if (not _decayAmps.unique())
+		_decayAmps.reset(new decayAmpStorage(*_decayAmps));
+	return *_decayAmps;
+}
+
+
 template<typename complexT>
 void
 pwaLikelihood<complexT>::FdF
@@ -183,7 +315,6 @@ pwaLikelihood<complexT>::FdF
 	value_type        prodAmpFlat;
 	prodAmpsArrayType prodAmps;
 	copyFromParArray(par, prodAmps, prodAmpFlat);
-	const value_type prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
 
 	// create array of likelihood derivatives w.r.t. real and imaginary
 	// parts of the production amplitudes
@@ -197,112 +328,40 @@ pwaLikelihood<complexT>::FdF
 	// as well as derivatives with respect to parameters
 	TStopwatch timer;
 	timer.Start();
-	accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
-	accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
-	multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
-		derivativesAcc(derivShape);
-	for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-		accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-		prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for this event
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-				accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-					ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-				}
-				const complexT ampProdSum = sum(ampProdAcc);
-				likelihoodAcc(norm(ampProdSum));
-				// set derivative term that is independent on derivative wave index
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					// amplitude sums for current rank and for waves with same reflectivity
-					derivative[iRank][iRefl][iWave] = ampProdSum;
-			}
-			// loop again over waves for current rank and multiply with complex conjugate
-			// of decay amplitude of the wave with the derivative wave index
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivative[iRank][iRefl][iWave] *= conj(_decayAmps[iRefl][iEvt][iWave]);
-		}  // end loop over rank
-		likelihoodAcc   (prodAmpFlat2            );
-		logLikelihoodAcc(-log(sum(likelihoodAcc)));
-		// incorporate factor 2 / sigma
-		const value_type factor = 2. / sum(likelihoodAcc);
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivativesAcc[iRank][iRefl][iWave](-factor * derivative[iRank][iRefl][iWave]);
-		derivativeFlatAcc(-factor * prodAmpFlat);
-	}  // end loop over events
-	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-				derivatives[iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
-	derivativeFlat = sum(derivativeFlatAcc);
+	value_type logLikelihood = 0;
+	sumLogLikelihoodDeriv(prodAmps, prodAmpFlat, logLikelihood, derivatives, derivativeFlat);
 	// log time needed for likelihood calculation
 	timer.Stop();
 	_funcCallInfo[FDF].funcTime(timer.RealTime());
 
 	// compute normalization term of log likelihood and normalize derivatives w.r.t. parameters
 	timer.Start();
-	accumulator_set<value_type, stats<tag::sum(compensated)> > normFactorAcc;
-	const value_type nmbEvt      = (_useNormalizedAmps) ? 1 : _nmbEvents;
-	const value_type twiceNmbEvt = 2 * nmbEvt;
-	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
-				accumulator_set<complexT, stats<tag::sum(compensated)> > normFactorDerivAcc;
-				for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {  // inner loop over waves with same reflectivity
-					const complexT I = _accMatrix[iRefl][iWave][iRefl][jWave];
-					normFactorAcc(real((prodAmps[iRank][iRefl][iWave] * conj(prodAmps[iRank][iRefl][jWave]))
-					                   * I));
-					normFactorDerivAcc(prodAmps[iRank][iRefl][jWave] * conj(I));
-				}
-				derivatives[iRank][iRefl][iWave] += sum(normFactorDerivAcc) * twiceNmbEvt;  // account for 2 * nmbEvents
-			}
-	// take care of flat wave
-	normFactorAcc(prodAmpFlat2 * _totAcc);
-	derivativeFlat += prodAmpFlat * twiceNmbEvt * _totAcc;
+	const value_type nmbEvt     = (_useNormalizedAmps) ? 1 : _nmbEventsTotal;
+	const value_type normFactor = normalization(prodAmps, prodAmpFlat);
+	addNormalizationDeriv(prodAmps, prodAmpFlat, derivatives, derivativeFlat);
 	// log time needed for normalization
 	timer.Stop();
 	_funcCallInfo[FDF].normTime(timer.RealTime());
 
-	double priorValue = 0.;
-	switch(_priorType)
-	{
-		case FLAT:
-			break;
-		case HALF_CAUCHY:
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-						const double r = abs(prodAmps[iRank][iRefl][iWave]);
-						const double cauchyFunctionValue = cauchyFunction(r, _cauchyWidth);
-						const double factor = (1./(r*cauchyFunctionValue)) * cauchyFunctionDerivative(r, _cauchyWidth);
-						complexT derivative(factor*prodAmps[iRank][iRefl][iWave].real(), factor*prodAmps[iRank][iRefl][iWave].imag());
-						priorValue -= log(cauchyFunctionValue);
-						derivatives[iRank][iRefl][iWave] -= derivative;
-					}
-				}
-			}
-			break;
-	}
+	const double priorValue = prior(prodAmps);
+	addPriorDeriv(prodAmps, derivatives);
 
 	// sort derivative results into output array and cache
 	copyToParArray(derivatives, derivativeFlat, gradient);
 	copyToParArray(derivatives, derivativeFlat, _derivCache.data());
 
 	// calculate log likelihood value
-	funcVal = sum(logLikelihoodAcc) + nmbEvt * sum(normFactorAcc) + priorValue;
+	funcVal = logLikelihood + nmbEvt * normFactor + priorValue;
 
 	// log total consumed time
 	timerTot.Stop();
 	_funcCallInfo[FDF].totalTime(timerTot.RealTime());
 
 	if (_debug)
-		printDebug << "raw log likelihood = "        << maxPrecisionAlign(sum(logLikelihoodAcc)) << ", "
-		           << "normalization = "             << maxPrecisionAlign(sum(normFactorAcc)   ) << ", "
-		           << "prior = "                     << maxPrecisionAlign(priorValue           ) << ", "
-		           << "normalized log likelihood = " << maxPrecisionAlign(funcVal              ) << endl;
+		printDebug << "raw log likelihood = "        << maxPrecisionAlign(logLikelihood) << ", "
+		           << "normalization = "             << maxPrecisionAlign(normFactor   ) << ", "
+		           << "prior = "                     << maxPrecisionAlign(priorValue   ) << ", "
+		           << "normalized log likelihood = " << maxPrecisionAlign(funcVal      ) << endl;
 }
 
 
@@ -334,7 +393,6 @@ pwaLikelihood<complexT>::DoEval(const double* par) const
 	value_type        prodAmpFlat;
 	prodAmpsArrayType prodAmps;
 	copyFromParArray(par, prodAmps, prodAmpFlat);
-	const value_type prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
 
 	// loop over events and calculate real-data term of log likelihood
 	TStopwatch timer;
@@ -347,78 +405,33 @@ pwaLikelihood<complexT>::DoEval(const double* par) const
 			 prodAmps.num_elements(), prodAmpFlat, _rank);
 	} else
 #endif
-	{
-		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
-		for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-						ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-					}
-					const complexT ampProdSum = sum(ampProdAcc);
-					likelihoodAcc(norm(ampProdSum));
-				}
-			}  // end loop over rank
-			likelihoodAcc   (prodAmpFlat2            );
-			logLikelihoodAcc(-log(sum(likelihoodAcc)));
-		}  // end loop over events
-		logLikelihood = sum(logLikelihoodAcc);
-	}
+		sumLogLikelihood(prodAmps, prodAmpFlat, logLikelihood);
 	// log time needed for likelihood calculation
 	timer.Stop();
 	_funcCallInfo[DOEVAL].funcTime(timer.RealTime());
 
 	// compute normalization term of log likelihood
 	timer.Start();
-	accumulator_set<value_type, stats<tag::sum(compensated)> > normFactorAcc;
-	const value_type nmbEvt = (_useNormalizedAmps) ? 1 : _nmbEvents;
-	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
-				for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {  // inner loop over waves with same reflectivity
-					const complexT I = _accMatrix[iRefl][iWave][iRefl][jWave];
-					normFactorAcc(real((prodAmps[iRank][iRefl][iWave] * conj(prodAmps[iRank][iRefl][jWave]))
-					                   * I));
-				}
-			}
-	// take care of flat wave
-	normFactorAcc(prodAmpFlat2 * _totAcc);
+	const value_type nmbEvt     = (_useNormalizedAmps) ? 1 : _nmbEventsTotal;
+	const value_type normFactor = normalization(prodAmps, prodAmpFlat);
 	// log time needed for normalization
 	timer.Stop();
 	_funcCallInfo[DOEVAL].normTime(timer.RealTime());
 
-	double priorValue = 0.;
-	switch(_priorType)
-	{
-		case FLAT:
-			break;
-		case HALF_CAUCHY:
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-						const double r = abs(prodAmps[iRank][iRefl][iWave]);
-						const double cauchyFunctionValue = cauchyFunction(r, _cauchyWidth);
-						priorValue -= log(cauchyFunctionValue);
-					}
-				}
-			}
-			break;
-	}
+	const double priorValue = prior(prodAmps);
 
 	// calculate log likelihood value
-	const double funcVal = logLikelihood + nmbEvt * sum(normFactorAcc) + priorValue;
+	const double funcVal = logLikelihood + nmbEvt * normFactor + priorValue;
 
 	// log total consumed time
 	timerTot.Stop();
 	_funcCallInfo[DOEVAL].totalTime(timerTot.RealTime());
 
 	if (_debug)
-		printDebug << "raw log likelihood = "        << maxPrecisionAlign(logLikelihood     ) << ", "
-		           << "normalization = "             << maxPrecisionAlign(sum(normFactorAcc)) << ", "
-		           << "prior = "                     << maxPrecisionAlign(priorValue        ) << ", "
-		           << "normalized log likelihood = " << maxPrecisionAlign(funcVal           ) << endl;
+		printDebug << "raw log likelihood = "        << maxPrecisionAlign(logLikelihood) << ", "
+		           << "normalization = "             << maxPrecisionAlign(normFactor   ) << ", "
+		           << "prior = "                     << maxPrecisionAlign(priorValue   ) << ", "
+		           << "normalized log likelihood = " << maxPrecisionAlign(funcVal      ) << endl;
 
 	return funcVal;
 
@@ -531,46 +544,8 @@ pwaLikelihood<complexT>::Gradient
 	} else
 #endif
 	{
-		accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
-		multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
-			derivativesAcc(derivShape);
-		const value_type prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
-		for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-			prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for this event
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-						ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-					}
-					const complexT ampProdSum = sum(ampProdAcc);
-					likelihoodAcc(norm(ampProdSum));
-					// set derivative term that is independent on derivative wave index
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-						// amplitude sums for current rank and for waves with same reflectivity
-						derivative[iRank][iRefl][iWave] = ampProdSum;
-				}
-				// loop again over waves for current rank and multiply with complex conjugate
-				// of decay amplitude of the wave with the derivative wave index
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-						derivative[iRank][iRefl][iWave] *= conj(_decayAmps[iRefl][iEvt][iWave]);
-			}  // end loop over rank
-			likelihoodAcc(prodAmpFlat2);
-			// incorporate factor 2 / sigma
-			const value_type factor = 2. / sum(likelihoodAcc);
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-						derivativesAcc[iRank][iRefl][iWave](-factor * derivative[iRank][iRefl][iWave]);
-			derivativeFlatAcc(-factor * prodAmpFlat);
-		}  // end loop over events
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivatives[iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
-		derivativeFlat = sum(derivativeFlatAcc);
+		value_type logLikelihood = 0;
+		sumLogLikelihoodDeriv(prodAmps, prodAmpFlat, logLikelihood, derivatives, derivativeFlat);
 	}
 	// log time needed for likelihood calculation
 	timer.Stop();
@@ -578,42 +553,12 @@ pwaLikelihood<complexT>::Gradient
 
 	// normalize derivatives w.r.t. parameters
 	timer.Start();
-	const value_type nmbEvt      = (_useNormalizedAmps) ? 1 : _nmbEvents;
-	const value_type twiceNmbEvt = 2 * nmbEvt;
-	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
-				accumulator_set<complexT, stats<tag::sum(compensated)> > normFactorDerivAcc;
-				for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {  // inner loop over waves with same reflectivity
-					const complexT I = _accMatrix[iRefl][iWave][iRefl][jWave];
-					normFactorDerivAcc(prodAmps[iRank][iRefl][jWave] * conj(I));
-				}
-				derivatives[iRank][iRefl][iWave] += sum(normFactorDerivAcc) * twiceNmbEvt;  // account for 2 * nmbEvents
-			}
-	// take care of flat wave
-	derivativeFlat += prodAmpFlat * twiceNmbEvt * _totAcc;
+	addNormalizationDeriv(prodAmps, prodAmpFlat, derivatives, derivativeFlat);
 	// log time needed for normalization
 	timer.Stop();
 	_funcCallInfo[GRADIENT].normTime(timer.RealTime());
 
-	switch(_priorType)
-	{
-		case FLAT:
-			break;
-		case HALF_CAUCHY:
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-						const double r = abs(prodAmps[iRank][iRefl][iWave]);
-						const double cauchyFunctionValue = cauchyFunction(r, _cauchyWidth);
-						const double factor = (1./(r*cauchyFunctionValue)) * cauchyFunctionDerivative(r, _cauchyWidth);
-						complexT derivative(factor*prodAmps[iRank][iRefl][iWave].real(), factor*prodAmps[iRank][iRefl][iWave].imag());
-						derivatives[iRank][iRefl][iWave] -= derivative;
-					}
-				}
-			}
-			break;
-	}
+	addPriorDeriv(prodAmps, derivatives);
 
 	// sort derivative results into output array and cache
 	copyToParArray(derivatives, derivativeFlat, gradient);
@@ -627,139 +572,210 @@ pwaLikelihood<complexT>::Gradient
 }
 
 
-// calculate Hessian with respect to parameters
 template<typename complexT>
-TMatrixT<double>
-pwaLikelihood<complexT>::Hessian
-(const double* par) const  // parameter array; reduced by rank conditions
+void
+pwaLikelihood<complexT>::evaluateBatch(const double*     pars,
+                                       const std::size_t nmbPoints,
+                                       double*           values) const
 {
 	if (not _initFinished) {
 		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
 		throw;
 	}
-	++(_funcCallInfo[HESSIAN].nmbCalls);
+	++(_funcCallInfo[EVALUATEBATCH].nmbCalls);
 
 	// timer for total time
 	TStopwatch timerTot;
 	timerTot.Start();
 
-	// build complex production amplitudes from function parameters taking into account rank restrictions
-	value_type        prodAmpFlat;
-	prodAmpsArrayType prodAmps;
-	copyFromParArray(par, prodAmps, prodAmpFlat);
-	const value_type prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	// the batched event loops are only implemented for decay amplitudes
+	// in [event][wave] layout that are processed in this process; for
+	// all other cases the points are evaluated one by one (see header)
+	if (_simdEnabled or _cpuKernelsEnabled or cudaEnabled() or mpiEnabled()) {
+		for (size_t iPoint = 0; iPoint < nmbPoints; ++iPoint)
+			values[iPoint] = DoEval(pars + iPoint * _nmbPars);
+		timerTot.Stop();
+		_funcCallInfo[EVALUATEBATCH].totalTime(timerTot.RealTime());
+		return;
+	}
 
-	// create array to store likelihood hessian w.r.t. real and imaginary
-	// parts of the production amplitudes
-	value_type                                         hessianFlat  = 0;       // term in Hessian matrix where we derive twice w.r.t. the flat wave
-	boost::array<typename prodAmpsArrayType::index, 3> derivShape   = {{ _rank, 2, _nmbWavesReflMax }};
-	prodAmpsArrayType                                  flatTerms(derivShape);  // array for terms where we first derive w.r.t to
-	                                                                           // a non-flat term and then w.r.t. the flat wave
-	boost::array<typename prodAmpsArrayType::index, 7> hessianShape = {{ _rank, 2, _nmbWavesReflMax, _rank, 2, _nmbWavesReflMax, 3 }};
-	boost::multi_array<value_type, 7>                  hessian(hessianShape);  // array to store components for Hessian matrix
+	const value_type nmbEvt = (_useNormalizedAmps) ? 1 : _nmbEventsTotal;
+	TStopwatch       timer;
+	for (size_t pointBegin = 0; pointBegin < nmbPoints; pointBegin += nmbPointsPerPass) {
+		const size_t nmbPointsPass = min(nmbPointsPerPass, nmbPoints - pointBegin);
+
+		// build complex production amplitudes for all points of this pass
+		vector<prodAmpsArrayType> prodAmps   (nmbPointsPass);
+		vector<value_type>        prodAmpFlat(nmbPointsPass, 0);
+		for (size_t iPoint = 0; iPoint < nmbPointsPass; ++iPoint)
+			copyFromParArray(pars + (pointBegin + iPoint) * _nmbPars, prodAmps[iPoint], prodAmpFlat[iPoint]);
+
+		// loop once over events and calculate real-data terms of log likelihood for all points
+		timer.Start();
+		vector<value_type> logLikelihoods;
+		sumLogLikelihoodBatch(prodAmps, prodAmpFlat, logLikelihoods);
+		timer.Stop();
+		_funcCallInfo[EVALUATEBATCH].funcTime(timer.RealTime());
+
+		timer.Start();
+		for (size_t iPoint = 0; iPoint < nmbPointsPass; ++iPoint)
+			values[pointBegin + iPoint] = logLikelihoods[iPoint]
+			                              + nmbEvt * normalization(prodAmps[iPoint], prodAmpFlat[iPoint])
+			                              + prior(prodAmps[iPoint]);
+		timer.Stop();
+		_funcCallInfo[EVALUATEBATCH].normTime(timer.RealTime());
+	}
 
-	// loop over events and calculate second derivatives with respect to
-	// parameters for the raw likelihood part
-	TStopwatch timer;
-	timer.Start();
-	accumulator_set<value_type, stats<tag::sum(compensated)> > hessianFlatAcc;
-	multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
-		flatTermsAcc(derivShape);
-	multi_array<accumulator_set<value_type, stats<tag::sum(compensated)> >, 7>
-		hessianAcc(hessianShape);
-	for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-		accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-		prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for this event
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-				accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-					ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-				}
-				const complexT ampProdSum = sum(ampProdAcc);
-				likelihoodAcc(norm(ampProdSum));
-				// set derivative term that is independent on derivative wave index
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					// amplitude sums for current rank and for waves with same reflectivity
-					derivative[iRank][iRefl][iWave] = ampProdSum;
-			}
-			// loop again over waves for current rank and multiply with complex conjugate
-			// of decay amplitude of the wave with the derivative wave index
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivative[iRank][iRefl][iWave] *= conj(_decayAmps[iRefl][iEvt][iWave]);
-		}  // end loop over rank
-		likelihoodAcc(prodAmpFlat2);
-		// incorporate factor 2 / sigma
-		const value_type factor  = 2. / sum(likelihoodAcc);
-		const value_type factor2 = factor*factor;
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
-					for (unsigned int jRank = 0; jRank < _rank; ++jRank) {
-						for (unsigned int jRefl = 0; jRefl < 2; ++jRefl) {
-							for (unsigned int jWave = 0; jWave < _nmbWavesRefl[jRefl]; ++jWave) {
-								// last array index 0 indicates derivative w.r.t. real part of first prodAmp and real part of the second prodAmp
-								hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][0](factor2 * derivative[jRank][jRefl][jWave].real() * derivative[iRank][iRefl][iWave].real());
-								// last array index 1 indicates derivative w.r.t. real part of first prodAmp and imaginary part of the second prodAmp
-								hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][1](factor2 * derivative[jRank][jRefl][jWave].imag() * derivative[iRank][iRefl][iWave].real());
-								// last array index 2 indicates derivative w.r.t. imaginary part of first prodAmp and imaginary part of the second prodAmp
-								hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][2](factor2 * derivative[jRank][jRefl][jWave].imag() * derivative[iRank][iRefl][iWave].imag());
-								if(iRank == jRank and iRefl == jRefl) {
-									const complexT uPrime = conj(_decayAmps[jRefl][iEvt][jWave]) * _decayAmps[iRefl][iEvt][iWave];
-									hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][0](-factor * uPrime.real());
-									hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][1](-factor * uPrime.imag());
-									hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][2](-factor * uPrime.real());
-								}
-							}
-						}
-					}
-					flatTermsAcc[iRank][iRefl][iWave](factor2 * prodAmpFlat * derivative[iRank][iRefl][iWave]);  // calculate terms where we first derive w.r.t. real/imag part
-					                                                                                             // of a prodAmp and then w.r.t. the flat wave
-				}
-			}
-		}
-		hessianFlatAcc(factor2 * prodAmpFlat2 - factor);
-	}  // end loop over events
-	for (unsigned int iRank = 0; iRank < _rank; ++iRank) {
-		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+	// log total consumed time
+	timerTot.Stop();
+	_funcCallInfo[EVALUATEBATCH].totalTime(timerTot.RealTime());
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::evaluateGradientBatch(const double*     pars,
+                                               const std::size_t nmbPoints,
+                                               double*           values,
+                                               double*           gradients) const
+{
+	if (not _initFinished) {
+		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
+		throw;
+	}
+	++(_funcCallInfo[EVALUATEGRADIENTBATCH].nmbCalls);
+
+	// timer for total time
+	TStopwatch timerTot;
+	timerTot.Start();
+
+	// the batched event loops are only implemented for decay amplitudes
+	// in [event][wave] layout that are processed in this process; for
+	// all other cases the points are evaluated one by one (see header)
+	if (_simdEnabled or _cpuKernelsEnabled or cudaEnabled() or mpiEnabled()) {
+		for (size_t iPoint = 0; iPoint < nmbPoints; ++iPoint)
+			FdF(pars + iPoint * _nmbPars, values[iPoint], gradients + iPoint * _nmbPars);
+		timerTot.Stop();
+		_funcCallInfo[EVALUATEGRADIENTBATCH].totalTime(timerTot.RealTime());
+		return;
+	}
+
+	const value_type                                   nmbEvt     = (_useNormalizedAmps) ? 1 : _nmbEventsTotal;
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape = {{ _rank, 2, _nmbWavesReflMax }};
+	TStopwatch                                         timer;
+	for (size_t pointBegin = 0; pointBegin < nmbPoints; pointBegin += nmbPointsPerPass) {
+		const size_t nmbPointsPass = min(nmbPointsPerPass, nmbPoints - pointBegin);
+
+		// build complex production amplitudes for all points of this pass
+		vector<prodAmpsArrayType> prodAmps   (nmbPointsPass);
+		vector<value_type>        prodAmpFlat(nmbPointsPass, 0);
+		for (size_t iPoint = 0; iPoint < nmbPointsPass; ++iPoint)
+			copyFromParArray(pars + (pointBegin + iPoint) * _nmbPars, prodAmps[iPoint], prodAmpFlat[iPoint]);
+
+		// loop once over events and calculate real-data terms of log likelihood
+		// as well as derivatives with respect to parameters for all points
+		vector<value_type>        logLikelihoods;
+		vector<prodAmpsArrayType> derivatives   (nmbPointsPass, prodAmpsArrayType(derivShape));
+		vector<value_type>        derivativeFlat(nmbPointsPass, 0);
+		timer.Start();
+		sumLogLikelihoodDerivBatch(prodAmps, prodAmpFlat, logLikelihoods, derivatives, derivativeFlat);
+		timer.Stop();
+		_funcCallInfo[EVALUATEGRADIENTBATCH].funcTime(timer.RealTime());
+
+		timer.Start();
+		for (size_t iPoint = 0; iPoint < nmbPointsPass; ++iPoint) {
+			values[pointBegin + iPoint] = logLikelihoods[iPoint]
+			                              + nmbEvt * normalization(prodAmps[iPoint], prodAmpFlat[iPoint])
+			                              + prior(prodAmps[iPoint]);
+			addNormalizationDeriv(prodAmps[iPoint], prodAmpFlat[iPoint], derivatives[iPoint], derivativeFlat[iPoint]);
+			addPriorDeriv(prodAmps[iPoint], derivatives[iPoint]);
+			copyToParArray(derivatives[iPoint], derivativeFlat[iPoint], gradients + (pointBegin + iPoint) * _nmbPars);
+		}
+		timer.Stop();
+		_funcCallInfo[EVALUATEGRADIENTBATCH].normTime(timer.RealTime());
+	}
+
+	// log total consumed time
+	timerTot.Stop();
+	_funcCallInfo[EVALUATEGRADIENTBATCH].totalTime(timerTot.RealTime());
+}
+
+
+template<typename complexT>
+typename pwaLikelihood<complexT>::value_type
+pwaLikelihood<complexT>::normalization(const prodAmpsArrayType& prodAmps,
+                                       const value_type         prodAmpFlat) const
+{
+	accumulator_set<value_type, stats<tag::sum(compensated)> > normFactorAcc;
+	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
 			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
-				for (unsigned int jRank = 0; jRank < _rank; ++jRank) {
-					for (unsigned int jRefl = 0; jRefl < 2; ++jRefl) {
-						for (unsigned int jWave = 0; jWave < _nmbWavesRefl[jRefl]; ++jWave) {
-							hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][0] = sum(hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][0]);
-							hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][1] = sum(hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][1]);
-							hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][2] = sum(hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][2]);
-						}
-					}
+				for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {  // inner loop over waves with same reflectivity
+					const complexT I = _accMatrix[iRefl][iWave][iRefl][jWave];
+					normFactorAcc(real((prodAmps[iRank][iRefl][iWave] * conj(prodAmps[iRank][iRefl][jWave]))
+					                   * I));
 				}
-				flatTerms[iRank][iRefl][iWave] = sum(flatTermsAcc[iRank][iRefl][iWave]);
 			}
-		}
-	}
-	hessianFlat = sum(hessianFlatAcc);
-	// log time needed for calculation of second derivatives of raw likelhood part
-	timer.Stop();
-	_funcCallInfo[HESSIAN].funcTime(timer.RealTime());
+	// take care of flat wave
+	normFactorAcc(prodAmpFlat * prodAmpFlat * _totAcc);
+	return sum(normFactorAcc);
+}
 
-	// normalize second derivatives w.r.t. parameters
-	timer.Start();
-	const value_type nmbEvt      = (_useNormalizedAmps) ? 1 : _nmbEvents;
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::addNormalizationDeriv(const prodAmpsArrayType& prodAmps,
+                                               const value_type         prodAmpFlat,
+                                               prodAmpsArrayType&       derivatives,
+                                               value_type&              derivativeFlat) const
+{
+	const value_type nmbEvt      = (_useNormalizedAmps) ? 1 : _nmbEventsTotal;
 	const value_type twiceNmbEvt = 2 * nmbEvt;
 	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
 		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-				for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+				accumulator_set<complexT, stats<tag::sum(compensated)> > normFactorDerivAcc;
+				for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {  // inner loop over waves with same reflectivity
 					const complexT I = _accMatrix[iRefl][iWave][iRefl][jWave];
-					hessian[iRank][iRefl][iWave][iRank][iRefl][jWave][0] += I.real() * twiceNmbEvt;
-					hessian[iRank][iRefl][iWave][iRank][iRefl][jWave][1] += I.imag() * twiceNmbEvt;
-					hessian[iRank][iRefl][iWave][iRank][iRefl][jWave][2] += I.real() * twiceNmbEvt;
+					normFactorDerivAcc(prodAmps[iRank][iRefl][jWave] * conj(I));
 				}
-	hessianFlat += twiceNmbEvt * _totAcc;
-	// log time needed for normalization
-	timer.Stop();
-	_funcCallInfo[HESSIAN].normTime(timer.RealTime());
+				derivatives[iRank][iRefl][iWave] += sum(normFactorDerivAcc) * twiceNmbEvt;  // account for 2 * nmbEvents
+			}
+	// take care of flat wave
+	derivativeFlat += prodAmpFlat * twiceNmbEvt * _totAcc;
+}
+
+
+template<typename complexT>
+double
+pwaLikelihood<complexT>::prior(const prodAmpsArrayType& prodAmps) const
+{
+	double priorValue = 0.;
+	switch(_priorType)
+	{
+		case FLAT:
+			break;
+		case HALF_CAUCHY:
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+						const double r = abs(prodAmps[iRank][iRefl][iWave]);
+						const double cauchyFunctionValue = cauchyFunction(r, _cauchyWidth);
+						priorValue -= log(cauchyFunctionValue);
+					}
+				}
+			}
+			break;
+	}
+	return priorValue;
+}
+
 
+template<typename complexT>
+void
+pwaLikelihood<complexT>::addPriorDeriv(const prodAmpsArrayType& prodAmps,
+                                       prodAmpsArrayType&       derivatives) const
+{
 	switch(_priorType)
 	{
 		case FLAT:
@@ -769,29 +785,809 @@ pwaLikelihood<complexT>::Hessian
 				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
 					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
 						const double r = abs(prodAmps[iRank][iRefl][iWave]);
+						const double cauchyFunctionValue = cauchyFunction(r, _cauchyWidth);
+						const double factor = (1./(r*cauchyFunctionValue)) * cauchyFunctionDerivative(r, _cauchyWidth);
+						complexT derivative(factor*prodAmps[iRank][iRefl][iWave].real(), factor*prodAmps[iRank][iRefl][iWave].imag());
+						derivatives[iRank][iRefl][iWave] -= derivative;
+					}
+				}
+			}
+			break;
+	}
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumLogLikelihood(const prodAmpsArrayType& prodAmps,
+                                          const value_type         prodAmpFlat,
+                                          value_type&              logLikelihood) const
+{
+#ifdef USE_MPI
+	if (_mpiEnabled and _mpiComm.rank() == 0)
+		mpiSendRequest(WORKER_LOGLIKELIHOOD, prodAmps, prodAmpFlat);
+#endif
+	sumLogLikelihoodLocal(prodAmps, prodAmpFlat, logLikelihood);
+#ifdef USE_MPI
+	if (_mpiEnabled)
+		mpiSum(&logLikelihood, 1);
+#endif
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodDeriv(const prodAmpsArrayType& prodAmps,
+                                               const value_type         prodAmpFlat,
+                                               value_type&              logLikelihood,
+                                               prodAmpsArrayType&       derivatives,
+                                               value_type&              derivativeFlat) const
+{
+#ifdef USE_MPI
+	if (_mpiEnabled and _mpiComm.rank() == 0)
+		mpiSendRequest(WORKER_LOGLIKELIHOODDERIV, prodAmps, prodAmpFlat);
+#endif
+	sumLogLikelihoodDerivLocal(prodAmps, prodAmpFlat, logLikelihood, derivatives, derivativeFlat);
+#ifdef USE_MPI
+	if (_mpiEnabled) {
+		// combine all sums into a single reduction
+		vector<value_type> sums(2 * derivatives.num_elements() + 2);
+		const value_type*  derivativesData = reinterpret_cast<const value_type*>(derivatives.data());
+		copy(derivativesData, derivativesData + 2 * derivatives.num_elements(), sums.begin());
+		sums[sums.size() - 2] = logLikelihood;
+		sums[sums.size() - 1] = derivativeFlat;
+		mpiSum(sums.data(), sums.size());
+		copy(sums.begin(), sums.end() - 2, reinterpret_cast<value_type*>(derivatives.data()));
+		logLikelihood  = sums[sums.size() - 2];
+		derivativeFlat = sums[sums.size() - 1];
+	}
+#endif
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodLocal(const prodAmpsArrayType& prodAmps,
+                                               const value_type         prodAmpFlat,
+                                               value_type&              logLikelihood) const
+{
+	if (_incrementalEnabled) {
+		sumLogLikelihoodIncremental(prodAmps, prodAmpFlat, logLikelihood);
+		return;
+	}
+
+	if (_cpuKernelsEnabled) {
+		logLikelihood = _cpuKernels.logLikelihood
+			(prodAmps.data(), prodAmps.num_elements(), prodAmpFlat, _rank);
+		return;
+	}
+
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+	vector<value_type> logLikelihoodChunks(nmbChunks, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+		if (_simdEnabled) {
+			if (_floatStorage)
+				sumLogLikelihoodSimd(_decayAmps->ampsSimdFloat, prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc);
+			else
+				sumLogLikelihoodSimd(_decayAmps->ampsSimd,      prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc);
+		} else {
+			if (_floatStorage)
+				sumLogLikelihoodScalar(_decayAmps->ampsFloat, prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc);
+			else
+				sumLogLikelihoodScalar(_decayAmps->amps,      prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc);
+		}
+		logLikelihoodChunks[iChunk] = sum(logLikelihoodAcc);
+	}  // end loop over chunks
+
+	// add up partial sums in fixed order
+	accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+	for (unsigned int iChunk = 0; iChunk < nmbChunks; ++iChunk)
+		logLikelihoodAcc(logLikelihoodChunks[iChunk]);
+	logLikelihood = sum(logLikelihoodAcc);
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodIncremental(const prodAmpsArrayType& prodAmps,
+                                                     const value_type         prodAmpFlat,
+                                                     value_type&              logLikelihood) const
+{
+	// find production amplitudes that changed since the coherent sums were calculated
+	vector<bt::tuple<unsigned int, unsigned int, unsigned int> > changedAmps;
+	unsigned int                                                  nmbAmps = 0;
+	bool recalculate = (not _coherentSumsValid) or (_nmbIncrementalUpdates >= _maxNmbIncrementalUpdates);
+	if (not recalculate) {
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = iRank; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+					++nmbAmps;
+					if (prodAmps[iRank][iRefl][iWave] != _coherentSumsProdAmps[iRank][iRefl][iWave])
+						changedAmps.push_back(bt::make_tuple(iRank, iRefl, iWave));
+				}
+		// updating is only faster than recalculating if few amplitudes changed
+		if (2 * changedAmps.size() > nmbAmps)
+			recalculate = true;
+	}
+	// differences of the changed production amplitudes
+	vector<complexT> deltaAmps(changedAmps.size());
+	for (size_t i = 0; i < changedAmps.size(); ++i) {
+		const unsigned int iRank = bt::get<0>(changedAmps[i]);
+		const unsigned int iRefl = bt::get<1>(changedAmps[i]);
+		const unsigned int iWave = bt::get<2>(changedAmps[i]);
+		deltaAmps[i] = prodAmps[iRank][iRefl][iWave] - _coherentSumsProdAmps[iRank][iRefl][iWave];
+	}
+	if (recalculate) {
+		_coherentSums.resize            ((size_t)_nmbEvents * _rank * 2);
+		_coherentSumsCompensation.resize((size_t)_nmbEvents * _rank * 2);
+	}
+
+	// views of the decay amplitudes in the layout they are stored in
+	typedef typename complexT::value_type T;
+	stridedDecayAmps<complexT, complexT>             stridedAmps     [2];
+	stridedDecayAmps<complexT, std::complex<float> > stridedAmpsFloat[2];
+	simdDecayAmps   <complexT, T>                    simdAmps        [2];
+	simdDecayAmps   <complexT, float>                simdAmpsFloat   [2];
+	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+		if (_cpuKernelsEnabled) {
+			// [reflectivity][wave index][event index]
+			stridedAmps[iRefl].amps       = &_cpuKernels.decayAmp(iRefl, 0, 0);
+			stridedAmps[iRefl].evtStride  = 1;
+			stridedAmps[iRefl].waveStride = _nmbEvents;
+		} else {
+			// [reflectivity][event index][wave index]
+			stridedAmps[iRefl].amps            = _decayAmps->amps[iRefl].data();
+			stridedAmps[iRefl].evtStride       = _decayAmps->amps[iRefl].strides()[0];
+			stridedAmps[iRefl].waveStride      = _decayAmps->amps[iRefl].strides()[1];
+			stridedAmpsFloat[iRefl].amps       = _decayAmps->ampsFloat[iRefl].data();
+			stridedAmpsFloat[iRefl].evtStride  = _decayAmps->ampsFloat[iRefl].strides()[0];
+			stridedAmpsFloat[iRefl].waveStride = _decayAmps->ampsFloat[iRefl].strides()[1];
+		}
+		simdAmps     [iRefl].amps = &_decayAmps->ampsSimd     [iRefl];
+		simdAmpsFloat[iRefl].amps = &_decayAmps->ampsSimdFloat[iRefl];
+	}
+
+	const value_type   prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	const unsigned int nmbChunks    = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+	vector<value_type> logLikelihoodChunks(nmbChunks, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		// same dispatch as in decayAmp(), but once per chunk instead of once per amplitude
+		if (_cpuKernelsEnabled)
+			updateCoherentSums(stridedAmps,      prodAmps, changedAmps, deltaAmps, recalculate, evtBegin, evtEnd);
+		else if (_simdEnabled and _floatStorage)
+			updateCoherentSums(simdAmpsFloat,    prodAmps, changedAmps, deltaAmps, recalculate, evtBegin, evtEnd);
+		else if (_simdEnabled)
+			updateCoherentSums(simdAmps,         prodAmps, changedAmps, deltaAmps, recalculate, evtBegin, evtEnd);
+		else if (_floatStorage)
+			updateCoherentSums(stridedAmpsFloat, prodAmps, changedAmps, deltaAmps, recalculate, evtBegin, evtEnd);
+		else
+			updateCoherentSums(stridedAmps,      prodAmps, changedAmps, deltaAmps, recalculate, evtBegin, evtEnd);
+		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+		for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+			const complexT* coherentSums = &_coherentSums[(size_t)iEvt * _rank * 2];  // [rank][reflectivity]
+			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)  // incoherent sum over ranks
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)  // incoherent sum over reflectivities
+					likelihoodAcc(norm(coherentSums[iRank * 2 + iRefl]));
+			likelihoodAcc   (prodAmpFlat2            );
+			logLikelihoodAcc(-log(sum(likelihoodAcc)));
+		}  // end loop over events
+		logLikelihoodChunks[iChunk] = sum(logLikelihoodAcc);
+	}  // end loop over chunks
+
+	// add up partial sums in fixed order
+	accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+	for (unsigned int iChunk = 0; iChunk < nmbChunks; ++iChunk)
+		logLikelihoodAcc(logLikelihoodChunks[iChunk]);
+	logLikelihood = sum(logLikelihoodAcc);
+
+	// remember production amplitudes the coherent sums belong to
+	_coherentSumsProdAmps.resize(extents[_rank][2][_nmbWavesReflMax]);
+	_coherentSumsProdAmps  = prodAmps;
+	_coherentSumsValid     = true;
+	_nmbIncrementalUpdates = (recalculate) ? 0 : _nmbIncrementalUpdates + 1;
+}
+
+
+template<typename complexT>
+template<typename decayAmpsT>
+void
+pwaLikelihood<complexT>::updateCoherentSums(const decayAmpsT                                         decayAmps[2],
+                                            const prodAmpsArrayType&                                 prodAmps,
+                                            const vector<bt::tuple<unsigned int, unsigned int, unsigned int> >& changedAmps,
+                                            const vector<complexT>&                                  deltaAmps,
+                                            const bool                                               recalculate,
+                                            const unsigned int                                       evtBegin,
+                                            const unsigned int                                       evtEnd) const
+{
+	const size_t nmbSums = (size_t)_rank * 2;  // number of coherent sums per event
+	if (recalculate) {
+		for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+			complexT* coherentSums  = &_coherentSums            [iEvt * nmbSums];  // [rank][reflectivity]
+			complexT* compensations = &_coherentSumsCompensation[iEvt * nmbSums];  // [rank][reflectivity]
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+					const complexT*   prodAmpsRefl = &prodAmps[iRank][iRefl][0];
+					const decayAmpsT& amps         = decayAmps[iRefl];
+					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)  // coherent sum over waves
+						ampProdAcc(prodAmpsRefl[iWave] * amps(iEvt, iWave));
+					coherentSums [iRank * 2 + iRefl] = sum(ampProdAcc);
+					compensations[iRank * 2 + iRefl] = 0;
+				}
+		}
+		return;
+	}
+	// rank-1 corrections for the changed production amplitudes; the corrections
+	// are added with Kahan summation, so that the updated coherent sums agree with
+	// the recalculated ones within rounding also after many updates
+	for (size_t i = 0; i < changedAmps.size(); ++i) {
+		const unsigned int iRank        = bt::get<0>(changedAmps[i]);
+		const unsigned int iRefl        = bt::get<1>(changedAmps[i]);
+		const unsigned int iWave        = bt::get<2>(changedAmps[i]);
+		const complexT     deltaAmp     = deltaAmps[i];
+		const decayAmpsT&  amps         = decayAmps[iRefl];
+		complexT*          coherentSum  = &_coherentSums            [evtBegin * nmbSums + iRank * 2 + iRefl];
+		complexT*          compensation = &_coherentSumsCompensation[evtBegin * nmbSums + iRank * 2 + iRefl];
+		for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt, coherentSum += nmbSums, compensation += nmbSums) {
+			const complexT term   = deltaAmp * amps(iEvt, iWave) - *compensation;
+			const complexT newSum = *coherentSum + term;
+			*compensation = (newSum - *coherentSum) - term;
+			*coherentSum  = newSum;
+		}
+	}
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodDerivLocal(const prodAmpsArrayType& prodAmps,
+                                                    const value_type         prodAmpFlat,
+                                                    value_type&              logLikelihood,
+                                                    prodAmpsArrayType&       derivatives,
+                                                    value_type&              derivativeFlat) const
+{
+	if (_cpuKernelsEnabled) {
+		_cpuKernels.logLikelihoodDeriv
+			(prodAmps.data(), prodAmps.num_elements(), prodAmpFlat, _rank,
+			 derivatives.data(), derivativeFlat, &logLikelihood);
+		return;
+	}
+
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape = {{ _rank, 2, _nmbWavesReflMax }};
+	vector<value_type> logLikelihoodChunks (nmbChunks, 0);
+	vector<value_type> derivativeFlatChunks(nmbChunks, 0);
+	multi_array<complexT, 4> derivativesChunks(extents[nmbChunks][_rank][2][_nmbWavesReflMax]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+		accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
+		multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
+			derivativesAcc(derivShape);
+		if (_simdEnabled) {
+			if (_floatStorage)
+				sumLogLikelihoodDerivSimd(_decayAmps->ampsSimdFloat, prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc, derivativesAcc, derivativeFlatAcc);
+			else
+				sumLogLikelihoodDerivSimd(_decayAmps->ampsSimd,      prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc, derivativesAcc, derivativeFlatAcc);
+		} else {
+			if (_floatStorage)
+				sumLogLikelihoodDerivScalar(_decayAmps->ampsFloat, prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc, derivativesAcc, derivativeFlatAcc);
+			else
+				sumLogLikelihoodDerivScalar(_decayAmps->amps,      prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc, derivativesAcc, derivativeFlatAcc);
+		}
+		logLikelihoodChunks [iChunk] = sum(logLikelihoodAcc);
+		derivativeFlatChunks[iChunk] = sum(derivativeFlatAcc);
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					derivativesChunks[iChunk][iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
+	}  // end loop over chunks
+
+	// add up partial sums in fixed order
+	accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+	accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
+	multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
+		derivativesAcc(derivShape);
+	for (unsigned int iChunk = 0; iChunk < nmbChunks; ++iChunk) {
+		logLikelihoodAcc (logLikelihoodChunks [iChunk]);
+		derivativeFlatAcc(derivativeFlatChunks[iChunk]);
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					derivativesAcc[iRank][iRefl][iWave](derivativesChunks[iChunk][iRank][iRefl][iWave]);
+	}
+	logLikelihood = sum(logLikelihoodAcc);
+	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+				derivatives[iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
+	derivativeFlat = sum(derivativeFlatAcc);
+}
+
+
+template<typename complexT>
+template<typename ampT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodScalar(const multi_array<ampT, 2>* decayAmps,
+                                                const prodAmpsArrayType&    prodAmps,
+                                                const value_type            prodAmpFlat,
+                                                const unsigned int          evtBegin,
+                                                const unsigned int          evtEnd,
+                                                valueAccType&               logLikelihoodAcc) const
+{
+	const value_type prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+		accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+				accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+					ampProdAcc(prodAmps[iRank][iRefl][iWave] * complexT(decayAmps[iRefl][iEvt][iWave]));
+				}
+				const complexT ampProdSum = sum(ampProdAcc);
+				likelihoodAcc(norm(ampProdSum));
+			}
+		}  // end loop over rank
+		likelihoodAcc   (prodAmpFlat2            );
+		logLikelihoodAcc(-log(sum(likelihoodAcc)));
+	}  // end loop over events
+}
+
+
+template<typename complexT>
+template<typename ampT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodDerivScalar(const multi_array<ampT, 2>*     decayAmps,
+                                                     const prodAmpsArrayType&        prodAmps,
+                                                     const value_type                prodAmpFlat,
+                                                     const unsigned int              evtBegin,
+                                                     const unsigned int              evtEnd,
+                                                     valueAccType&                   logLikelihoodAcc,
+                                                     multi_array<complexAccType, 3>& derivativesAcc,
+                                                     valueAccType&                   derivativeFlatAcc) const
+{
+	const value_type prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape = {{ _rank, 2, _nmbWavesReflMax }};
+	prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for a single event
+	for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+		accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+				accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+					ampProdAcc(prodAmps[iRank][iRefl][iWave] * complexT(decayAmps[iRefl][iEvt][iWave]));
+				}
+				const complexT ampProdSum = sum(ampProdAcc);
+				likelihoodAcc(norm(ampProdSum));
+				// set derivative term that is independent on derivative wave index
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					// amplitude sums for current rank and for waves with same reflectivity
+					derivative[iRank][iRefl][iWave] = ampProdSum;
+			}
+			// loop again over waves for current rank and multiply with complex conjugate
+			// of decay amplitude of the wave with the derivative wave index
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					derivative[iRank][iRefl][iWave] *= conj(complexT(decayAmps[iRefl][iEvt][iWave]));
+		}  // end loop over rank
+		likelihoodAcc   (prodAmpFlat2            );
+		logLikelihoodAcc(-log(sum(likelihoodAcc)));
+		// incorporate factor 2 / sigma
+		const value_type factor = 2. / sum(likelihoodAcc);
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					derivativesAcc[iRank][iRefl][iWave](-factor * derivative[iRank][iRefl][iWave]);
+		derivativeFlatAcc(-factor * prodAmpFlat);
+	}  // end loop over events
+}
+
 
-						const double cauchyFunctionValue                 = cauchyFunction                (r, _cauchyWidth);
-						const double cauchyFunctionDerivativeValue       = cauchyFunctionDerivative      (r, _cauchyWidth);
-						const double cauchyFunctionSecondDerivativeValue = cauchyFunctionSecondDerivative(r, _cauchyWidth);
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodBatch(const vector<prodAmpsArrayType>& prodAmps,
+                                               const vector<value_type>&        prodAmpFlat,
+                                               vector<value_type>&              logLikelihoods) const
+{
+	const unsigned int nmbPoints = prodAmps.size();
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+	multi_array<value_type, 2> logLikelihoodChunks(extents[nmbChunks][nmbPoints]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		vector<valueAccType> logLikelihoodAcc(nmbPoints);
+		if (_floatStorage)
+			sumLogLikelihoodBatchScalar(_decayAmps->ampsFloat, prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc);
+		else
+			sumLogLikelihoodBatchScalar(_decayAmps->amps,      prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc);
+		for (unsigned int iPoint = 0; iPoint < nmbPoints; ++iPoint)
+			logLikelihoodChunks[iChunk][iPoint] = sum(logLikelihoodAcc[iPoint]);
+	}  // end loop over chunks
+
+	// add up partial sums in fixed order
+	logLikelihoods.assign(nmbPoints, 0);
+	for (unsigned int iPoint = 0; iPoint < nmbPoints; ++iPoint) {
+		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+		for (unsigned int iChunk = 0; iChunk < nmbChunks; ++iChunk)
+			logLikelihoodAcc(logLikelihoodChunks[iChunk][iPoint]);
+		logLikelihoods[iPoint] = sum(logLikelihoodAcc);
+	}
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodDerivBatch(const vector<prodAmpsArrayType>& prodAmps,
+                                                    const vector<value_type>&        prodAmpFlat,
+                                                    vector<value_type>&              logLikelihoods,
+                                                    vector<prodAmpsArrayType>&       derivatives,
+                                                    vector<value_type>&              derivativeFlat) const
+{
+	const unsigned int nmbPoints = prodAmps.size();
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape = {{ _rank, 2, _nmbWavesReflMax }};
+	multi_array<value_type, 2> logLikelihoodChunks (extents[nmbChunks][nmbPoints]);
+	multi_array<value_type, 2> derivativeFlatChunks(extents[nmbChunks][nmbPoints]);
+	multi_array<complexT,   5> derivativesChunks   (extents[nmbChunks][nmbPoints][_rank][2][_nmbWavesReflMax]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		vector<valueAccType>                    logLikelihoodAcc (nmbPoints);
+		vector<valueAccType>                    derivativeFlatAcc(nmbPoints);
+		vector<multi_array<complexAccType, 3> > derivativesAcc   (nmbPoints, multi_array<complexAccType, 3>(derivShape));
+		if (_floatStorage)
+			sumLogLikelihoodDerivBatchScalar(_decayAmps->ampsFloat, prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc, derivativesAcc, derivativeFlatAcc);
+		else
+			sumLogLikelihoodDerivBatchScalar(_decayAmps->amps,      prodAmps, prodAmpFlat, evtBegin, evtEnd, logLikelihoodAcc, derivativesAcc, derivativeFlatAcc);
+		for (unsigned int iPoint = 0; iPoint < nmbPoints; ++iPoint) {
+			logLikelihoodChunks [iChunk][iPoint] = sum(logLikelihoodAcc [iPoint]);
+			derivativeFlatChunks[iChunk][iPoint] = sum(derivativeFlatAcc[iPoint]);
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+						derivativesChunks[iChunk][iPoint][iRank][iRefl][iWave] = sum(derivativesAcc[iPoint][iRank][iRefl][iWave]);
+		}
+	}  // end loop over chunks
 
-						const double a1 = cauchyFunctionSecondDerivativeValue / (cauchyFunctionValue * r*r);
-						const double a2 = cauchyFunctionDerivativeValue*cauchyFunctionDerivativeValue / (cauchyFunctionValue*cauchyFunctionValue * r*r);
-						const double a3 = cauchyFunctionDerivativeValue / (cauchyFunctionValue * r);
-						const double a4 = cauchyFunctionDerivativeValue / (cauchyFunctionValue * r*r*r);
-						const double a124 = a1 - a2 - a4;
+	// add up partial sums in fixed order
+	logLikelihoods.assign(nmbPoints, 0);
+	for (unsigned int iPoint = 0; iPoint < nmbPoints; ++iPoint) {
+		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+		accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
+		multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
+			derivativesAcc(derivShape);
+		for (unsigned int iChunk = 0; iChunk < nmbChunks; ++iChunk) {
+			logLikelihoodAcc (logLikelihoodChunks [iChunk][iPoint]);
+			derivativeFlatAcc(derivativeFlatChunks[iChunk][iPoint]);
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+						derivativesAcc[iRank][iRefl][iWave](derivativesChunks[iChunk][iPoint][iRank][iRefl][iWave]);
+		}
+		logLikelihoods[iPoint] = sum(logLikelihoodAcc);
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					derivatives[iPoint][iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
+		derivativeFlat[iPoint] = sum(derivativeFlatAcc);
+	}
+}
 
-						const double re = prodAmps[iRank][iRefl][iWave].real();
-						const double im = prodAmps[iRank][iRefl][iWave].imag();
 
-						hessian[iRank][iRefl][iWave][iRank][iRefl][iWave][0] -= (a124) * re*re + a3;
-						hessian[iRank][iRefl][iWave][iRank][iRefl][iWave][1] -= (a124) * re*im;
-						hessian[iRank][iRefl][iWave][iRank][iRefl][iWave][2] -= (a124) * im*im + a3;
+template<typename complexT>
+template<typename ampT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodBatchScalar(const multi_array<ampT, 2>*      decayAmps,
+                                                     const vector<prodAmpsArrayType>& prodAmps,
+                                                     const vector<value_type>&        prodAmpFlat,
+                                                     const unsigned int               evtBegin,
+                                                     const unsigned int               evtEnd,
+                                                     vector<valueAccType>&            logLikelihoodAcc) const
+{
+	const unsigned int nmbPoints = prodAmps.size();
+	// decay amplitudes of the current event, which are read only once for all points
+	multi_array<complexT, 2> evtDecayAmps(extents[2][_nmbWavesReflMax]);
+	for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+				evtDecayAmps[iRefl][iWave] = complexT(decayAmps[iRefl][iEvt][iWave]);
+		for (unsigned int iPoint = 0; iPoint < nmbPoints; ++iPoint) {
+			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+						ampProdAcc(prodAmps[iPoint][iRank][iRefl][iWave] * evtDecayAmps[iRefl][iWave]);
 					}
+					const complexT ampProdSum = sum(ampProdAcc);
+					likelihoodAcc(norm(ampProdSum));
 				}
+			}  // end loop over rank
+			likelihoodAcc           (prodAmpFlat[iPoint] * prodAmpFlat[iPoint]);
+			logLikelihoodAcc[iPoint](-log(sum(likelihoodAcc))                 );
+		}  // end loop over points
+	}  // end loop over events
+}
+
+
+template<typename complexT>
+template<typename ampT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodDerivBatchScalar(const multi_array<ampT, 2>*              decayAmps,
+                                                          const vector<prodAmpsArrayType>&         prodAmps,
+                                                          const vector<value_type>&                prodAmpFlat,
+                                                          const unsigned int                       evtBegin,
+                                                          const unsigned int                       evtEnd,
+                                                          vector<valueAccType>&                    logLikelihoodAcc,
+                                                          vector<multi_array<complexAccType, 3> >& derivativesAcc,
+                                                          vector<valueAccType>&                    derivativeFlatAcc) const
+{
+	const unsigned int nmbPoints = prodAmps.size();
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape = {{ _rank, 2, _nmbWavesReflMax }};
+	prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for a single event and point
+	// decay amplitudes of the current event, which are read only once for all points
+	multi_array<complexT, 2> evtDecayAmps(extents[2][_nmbWavesReflMax]);
+	for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+				evtDecayAmps[iRefl][iWave] = complexT(decayAmps[iRefl][iEvt][iWave]);
+		for (unsigned int iPoint = 0; iPoint < nmbPoints; ++iPoint) {
+			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+						ampProdAcc(prodAmps[iPoint][iRank][iRefl][iWave] * evtDecayAmps[iRefl][iWave]);
+					}
+					const complexT ampProdSum = sum(ampProdAcc);
+					likelihoodAcc(norm(ampProdSum));
+					// set derivative term that is independent on derivative wave index
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+						// amplitude sums for current rank and for waves with same reflectivity
+						derivative[iRank][iRefl][iWave] = ampProdSum;
+				}
+				// loop again over waves for current rank and multiply with complex conjugate
+				// of decay amplitude of the wave with the derivative wave index
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+						derivative[iRank][iRefl][iWave] *= conj(evtDecayAmps[iRefl][iWave]);
+			}  // end loop over rank
+			likelihoodAcc           (prodAmpFlat[iPoint] * prodAmpFlat[iPoint]);
+			logLikelihoodAcc[iPoint](-log(sum(likelihoodAcc))                 );
+			// incorporate factor 2 / sigma
+			const value_type factor = 2. / sum(likelihoodAcc);
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+						derivativesAcc[iPoint][iRank][iRefl][iWave](-factor * derivative[iRank][iRefl][iWave]);
+			derivativeFlatAcc[iPoint](-factor * prodAmpFlat[iPoint]);
+		}  // end loop over points
+	}  // end loop over events
+}
+
+
+template<typename complexT>
+template<typename storageT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodSimd(const simdDecayAmpArray<storageT>* decayAmps,
+                                              const prodAmpsArrayType&           prodAmps,
+                                              const value_type                   prodAmpFlat,
+                                              const unsigned int                 evtBegin,
+                                              const unsigned int                 evtEnd,
+                                              valueAccType&                      logLikelihoodAcc) const
+{
+	const unsigned int nmbLanes     = simdDecayAmpArray<storageT>::nmbEventsPerBlock;
+	const value_type   prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	for (unsigned int iBlock = evtBegin / nmbLanes; iBlock * nmbLanes < evtEnd; ++iBlock) {
+		value_type likelihood[nmbLanes];
+		for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+			likelihood[iLane] = prodAmpFlat2;
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+				value_type ampProdSumRe[nmbLanes] = {};
+				value_type ampProdSumIm[nmbLanes] = {};
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+					const value_type  prodAmpRe = prodAmps[iRank][iRefl][iWave].real();
+					const value_type  prodAmpIm = prodAmps[iRank][iRefl][iWave].imag();
+					const storageT*   decayAmpRe = decayAmps[iRefl].real(iBlock, iWave);
+					const storageT*   decayAmpIm = decayAmps[iRefl].imag(iBlock, iWave);
+					for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+						ampProdSumRe[iLane] += prodAmpRe * decayAmpRe[iLane] - prodAmpIm * decayAmpIm[iLane];
+						ampProdSumIm[iLane] += prodAmpRe * decayAmpIm[iLane] + prodAmpIm * decayAmpRe[iLane];
+					}
+				}
+				for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+					likelihood[iLane] += ampProdSumRe[iLane] * ampProdSumRe[iLane] + ampProdSumIm[iLane] * ampProdSumIm[iLane];
 			}
-			break;
+		}  // end loop over rank
+		// padding events at the end of the last block do not contribute
+		const unsigned int nmbEvts = decayAmps[0].nmbEventsInBlock(iBlock);
+		value_type logLikelihoodBlock = 0;
+		for (unsigned int iLane = 0; iLane < nmbEvts; ++iLane)
+			logLikelihoodBlock -= log(likelihood[iLane]);
+		logLikelihoodAcc(logLikelihoodBlock);
+	}  // end loop over blocks
+}
+
+
+template<typename complexT>
+template<typename storageT>
+void
+pwaLikelihood<complexT>::sumLogLikelihoodDerivSimd(const simdDecayAmpArray<storageT>* decayAmps,
+                                                   const prodAmpsArrayType&           prodAmps,
+                                                   const value_type                   prodAmpFlat,
+                                                   const unsigned int                 evtBegin,
+                                                   const unsigned int                 evtEnd,
+                                                   valueAccType&                      logLikelihoodAcc,
+                                                   multi_array<complexAccType, 3>&    derivativesAcc,
+                                                   valueAccType&                      derivativeFlatAcc) const
+{
+	const unsigned int nmbLanes     = simdDecayAmpArray<storageT>::nmbEventsPerBlock;
+	const value_type   prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	// amplitude sums for each rank and reflectivity [rank][reflectivity][event in block]
+	multi_array<value_type, 3> ampProdSumRe(extents[_rank][2][nmbLanes]);
+	multi_array<value_type, 3> ampProdSumIm(extents[_rank][2][nmbLanes]);
+	for (unsigned int iBlock = evtBegin / nmbLanes; iBlock * nmbLanes < evtEnd; ++iBlock) {
+		value_type likelihood[nmbLanes];
+		for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+			likelihood[iLane] = prodAmpFlat2;
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+				value_type* sumRe = ampProdSumRe[iRank][iRefl].origin();
+				value_type* sumIm = ampProdSumIm[iRank][iRefl].origin();
+				for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+					sumRe[iLane] = sumIm[iLane] = 0;
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+					const value_type  prodAmpRe = prodAmps[iRank][iRefl][iWave].real();
+					const value_type  prodAmpIm = prodAmps[iRank][iRefl][iWave].imag();
+					const storageT*   decayAmpRe = decayAmps[iRefl].real(iBlock, iWave);
+					const storageT*   decayAmpIm = decayAmps[iRefl].imag(iBlock, iWave);
+					for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+						sumRe[iLane] += prodAmpRe * decayAmpRe[iLane] - prodAmpIm * decayAmpIm[iLane];
+						sumIm[iLane] += prodAmpRe * decayAmpIm[iLane] + prodAmpIm * decayAmpRe[iLane];
+					}
+				}
+				for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+					likelihood[iLane] += sumRe[iLane] * sumRe[iLane] + sumIm[iLane] * sumIm[iLane];
+			}
+		}  // end loop over rank
+		// incorporate factor -2 / sigma; padding events at the end of the last block do not contribute
+		const unsigned int nmbEvts = decayAmps[0].nmbEventsInBlock(iBlock);
+		value_type logLikelihoodBlock = 0;
+		value_type factor[nmbLanes]   = {};
+		value_type factorSum          = 0;
+		for (unsigned int iLane = 0; iLane < nmbEvts; ++iLane) {
+			logLikelihoodBlock -= log(likelihood[iLane]);
+			factor[iLane]       = -2. / likelihood[iLane];
+			factorSum          += factor[iLane];
+		}
+		logLikelihoodAcc (logLikelihoodBlock      );
+		derivativeFlatAcc(factorSum * prodAmpFlat);
+		// multiply amplitude sums with complex conjugate of decay amplitude of the wave with the
+		// derivative wave index and sum over the events in the block
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+				value_type termRe[nmbLanes];
+				value_type termIm[nmbLanes];
+				for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+					termRe[iLane] = factor[iLane] * ampProdSumRe[iRank][iRefl][iLane];
+					termIm[iLane] = factor[iLane] * ampProdSumIm[iRank][iRefl][iLane];
+				}
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+					const storageT*   decayAmpRe = decayAmps[iRefl].real(iBlock, iWave);
+					const storageT*   decayAmpIm = decayAmps[iRefl].imag(iBlock, iWave);
+					value_type derivLaneRe[nmbLanes];
+					value_type derivLaneIm[nmbLanes];
+					for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+						derivLaneRe[iLane] = termRe[iLane] * decayAmpRe[iLane] + termIm[iLane] * decayAmpIm[iLane];
+						derivLaneIm[iLane] = termIm[iLane] * decayAmpRe[iLane] - termRe[iLane] * decayAmpIm[iLane];
+					}
+					value_type derivRe = 0;
+					value_type derivIm = 0;
+					for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+						derivRe += derivLaneRe[iLane];
+						derivIm += derivLaneIm[iLane];
+					}
+					derivativesAcc[iRank][iRefl][iWave](complexT(derivRe, derivIm));
+				}
+			}
+	}  // end loop over blocks
+}
+
+
+template<typename complexT>
+complexT
+pwaLikelihood<complexT>::decayAmp(const unsigned int iRefl,
+                                  const unsigned int iEvt,
+                                  const unsigned int iWave) const
+{
+	if (_cpuKernelsEnabled)
+		return _cpuKernels.decayAmp(iRefl, iWave, iEvt);
+	if (_simdEnabled and _floatStorage)
+		return _decayAmps->ampsSimdFloat[iRefl].template get<complexT>(iEvt, iWave);
+	if (_simdEnabled)
+		return _decayAmps->ampsSimd[iRefl].template get<complexT>(iEvt, iWave);
+	if (_floatStorage)
+		return complexT(_decayAmps->ampsFloat[iRefl][iEvt][iWave]);
+	return _decayAmps->amps[iRefl][iEvt][iWave];
+}
+
+
+// calculate Hessian with respect to parameters
+template<typename complexT>
+TMatrixT<double>
+pwaLikelihood<complexT>::Hessian
+(const double* par) const  // parameter array; reduced by rank conditions
+{
+	if (not _initFinished) {
+		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
+		throw;
 	}
+	++(_funcCallInfo[HESSIAN].nmbCalls);
+
+	// timer for total time
+	TStopwatch timerTot;
+	timerTot.Start();
+
+	// build complex production amplitudes from function parameters taking into account rank restrictions
+	value_type        prodAmpFlat;
+	prodAmpsArrayType prodAmps;
+	copyFromParArray(par, prodAmps, prodAmpFlat);
 
+	// loop over events and calculate second derivatives with respect to
+	// parameters for the raw likelihood part
+	TStopwatch timer;
+	timer.Start();
+#ifdef USE_MPI
+	if (_mpiEnabled and _mpiComm.rank() == 0)
+		mpiSendRequest(WORKER_HESSIAN, prodAmps, prodAmpFlat);
+#endif
+	vector<value_type> hessianSums;
+	sumHessian(prodAmps, prodAmpFlat, hessianSums);
+#ifdef USE_MPI
+	if (_mpiEnabled)
+		mpiSum(hessianSums.data(), hessianSums.size());
+#endif
+	// log time needed for calculation of second derivatives of raw likelhood part
+	timer.Stop();
+	_funcCallInfo[HESSIAN].funcTime(timer.RealTime());
+
+	// the event sums are stored in packed upper-triangle form (see sumHessian())
+	const unsigned int nmbAmps       = _rank * (_nmbWavesRefl[0] + _nmbWavesRefl[1]);
+	const unsigned int dim           = 2 * nmbAmps + 1;
+	const unsigned int dimRefl[2]    = { 2 * _nmbWavesRefl[0], 2 * _nmbWavesRefl[1] };
+	const value_type*  outerProducts = hessianSums.data();
+	const value_type*  decayAmpProducts[2];
+	decayAmpProducts[0] = outerProducts       + packedSize(dim);
+	decayAmpProducts[1] = decayAmpProducts[0] + packedSize(dimRefl[0]);
+	const value_type   factorSum     = hessianSums.back();
+
+	// assemble Hessian matrix w.r.t. parameters and add normalization and prior
+	timer.Start();
+	const value_type nmbEvt      = (_useNormalizedAmps) ? 1 : _nmbEventsTotal;
+	const value_type twiceNmbEvt = 2 * nmbEvt;
 	TMatrixT<double> hessianMatrix(_nmbPars, _nmbPars);
 	for (unsigned int iRank = 0; iRank < _rank; ++iRank) {
 		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
@@ -806,6 +1602,7 @@ pwaLikelihood<complexT>::Hessian
 					continue;
 				assert(i1 < 0 || not _parameters[i1].fixed());
 
+				const unsigned int a = hessianAmpIndex(iRank, iRefl, iWave);
 				for (unsigned int jRank = 0; jRank < _rank; ++jRank) {
 					for (unsigned int jRefl = 0; jRefl < 2; ++jRefl) {
 						for (unsigned int jWave = 0; jWave < _nmbWavesRefl[jRefl]; ++jWave) {
@@ -813,40 +1610,399 @@ pwaLikelihood<complexT>::Hessian
 							const int r2 = get<0>(parIndices2);
 							const int i2 = get<1>(parIndices2);
 
-							if (r2 < 0)
-								continue;
-							if (_parameters[r2].fixed())
-								continue;
-							assert(i2 < 0 || not _parameters[i2].fixed());
+							if (r2 < 0)
+								continue;
+							if (_parameters[r2].fixed())
+								continue;
+							assert(i2 < 0 || not _parameters[i2].fixed());
+
+							// derivatives w.r.t. real/real, real/imaginary, imaginary/real, and imaginary/imaginary parts
+							const unsigned int b = hessianAmpIndex(jRank, jRefl, jWave);
+							value_type hessianRR = packedElement(outerProducts, 2 * a,     2 * b,     dim);
+							value_type hessianRI = packedElement(outerProducts, 2 * a,     2 * b + 1, dim);
+							value_type hessianIR = packedElement(outerProducts, 2 * a + 1, 2 * b,     dim);
+							value_type hessianII = packedElement(outerProducts, 2 * a + 1, 2 * b + 1, dim);
+							if (iRank == jRank and iRefl == jRefl) {
+								// sum over events of factor * decayAmp[iWave] * conj(decayAmp[jWave])
+								const value_type* products = decayAmpProducts[iRefl];
+								const complexT    uPrime(packedElement(products, 2 * iWave,     2 * jWave,     dimRefl[iRefl])
+								                         + packedElement(products, 2 * iWave + 1, 2 * jWave + 1, dimRefl[iRefl]),
+								                         packedElement(products, 2 * iWave + 1, 2 * jWave,     dimRefl[iRefl])
+								                         - packedElement(products, 2 * iWave,     2 * jWave + 1, dimRefl[iRefl]));
+								hessianRR -= uPrime.real();
+								hessianRI -= uPrime.imag();
+								hessianIR += uPrime.imag();
+								hessianII -= uPrime.real();
+								// normalization
+								const complexT I = _accMatrix[iRefl][iWave][iRefl][jWave];
+								hessianRR += I.real() * twiceNmbEvt;
+								hessianRI += I.imag() * twiceNmbEvt;
+								hessianIR += _accMatrix[iRefl][jWave][iRefl][iWave].imag() * twiceNmbEvt;
+								hessianII += I.real() * twiceNmbEvt;
+								// prior
+								if (iWave == jWave and _priorType == HALF_CAUCHY) {
+									const priorHessianType priorHessian = priorHessianDiag(prodAmps[iRank][iRefl][iWave]);
+									hessianRR -= priorHessian.RR;
+									hessianRI -= priorHessian.RI;
+									hessianIR -= priorHessian.RI;
+									hessianII -= priorHessian.II;
+								}
+							}
+
+							hessianMatrix[r1][r2] = hessianRR;
+							if (i2 >= 0) // real/imaginary derivative
+								hessianMatrix[r1][i2] = hessianRI;
+							if (i1 >= 0) // imaginary/real derivative
+								hessianMatrix[i1][r2] = hessianIR;
+							if (i1 >= 0 && i2 >= 0) // imaginary/imaginary derivative
+								hessianMatrix[i1][i2] = hessianII;
+						}
+					}
+				}
+
+				// second derivatives w.r.t. flat wave
+				const value_type flatTermRe = packedElement(outerProducts, 2 * a,     dim - 1, dim);
+				const value_type flatTermIm = packedElement(outerProducts, 2 * a + 1, dim - 1, dim);
+				hessianMatrix[r1][_nmbPars - 1] = flatTermRe;
+				hessianMatrix[_nmbPars - 1][r1] = flatTermRe;
+				if (i1 >= 0) {
+					hessianMatrix[i1][_nmbPars - 1] = flatTermIm;
+					hessianMatrix[_nmbPars - 1][i1] = flatTermIm;
+				}
+			}
+		}
+	}
+	// enter flat/flat term
+	hessianMatrix[_nmbPars - 1][_nmbPars - 1] = packedElement(outerProducts, dim - 1, dim - 1, dim) - factorSum
+	                                            + twiceNmbEvt * _totAcc;
+	// log time needed for normalization
+	timer.Stop();
+	_funcCallInfo[HESSIAN].normTime(timer.RealTime());
+
+	// log total consumed time
+	timerTot.Stop();
+	_funcCallInfo[HESSIAN].totalTime(timerTot.RealTime());
+
+	return hessianMatrix;
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::HessianVectorProduct
+(const double* par,             // parameter array; reduced by rank conditions
+ const double* vec,             // vector that is multiplied with the Hessian
+ double*       product) const   // Hessian times vector
+{
+	if (not _initFinished) {
+		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
+		throw;
+	}
+
+	// build complex production amplitudes from function parameters taking into account rank restrictions
+	value_type        prodAmpFlat;
+	prodAmpsArrayType prodAmps;
+	copyFromParArray(par, prodAmps, prodAmpFlat);
+	// same for the vector; fixed parameters do not enter the Hessian
+	vector<double> vecFree(vec, vec + _nmbPars);
+	for (unsigned int i = 0; i < _nmbPars; ++i)
+		if (_parameters[i].fixed())
+			vecFree[i] = 0;
+	value_type        directionFlat;
+	prodAmpsArrayType direction;
+	copyFromParArray(vecFree.data(), direction, directionFlat);
+
+	// loop over events and calculate product of the Hessian of the raw
+	// likelihood part with the vector
+	value_type                                         productFlat  = 0;
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape   = {{ _rank, 2, _nmbWavesReflMax }};
+	prodAmpsArrayType                                  productAmps(derivShape);
+#ifdef USE_MPI
+	if (_mpiEnabled and _mpiComm.rank() == 0) {
+		mpiSendRequest(WORKER_HESSIANVECTOR, prodAmps, prodAmpFlat);
+		boost::mpi::broadcast(_mpiComm, reinterpret_cast<value_type*>(direction.data()), 2 * direction.num_elements(), 0);
+		boost::mpi::broadcast(_mpiComm, directionFlat, 0);
+	}
+#endif
+	sumHessianVectorProduct(prodAmps, prodAmpFlat, direction, directionFlat, productAmps, productFlat);
+#ifdef USE_MPI
+	if (_mpiEnabled) {
+		mpiSum(reinterpret_cast<value_type*>(productAmps.data()), 2 * productAmps.num_elements());
+		mpiSum(&productFlat, 1);
+	}
+#endif
+
+	// add normalization and prior
+	const value_type nmbEvt      = (_useNormalizedAmps) ? 1 : _nmbEventsTotal;
+	const value_type twiceNmbEvt = 2 * nmbEvt;
+	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+				accumulator_set<complexT, stats<tag::sum(compensated)> > normProductAcc;
+				for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {  // inner loop over waves with same reflectivity
+					const complexT I = _accMatrix[iRefl][iWave][iRefl][jWave];
+					normProductAcc(conj(I) * direction[iRank][iRefl][jWave]);
+				}
+				productAmps[iRank][iRefl][iWave] += sum(normProductAcc) * twiceNmbEvt;
+				if (_priorType == HALF_CAUCHY) {
+					const priorHessianType priorHessian = priorHessianDiag(prodAmps[iRank][iRefl][iWave]);
+					const complexT&            d            = direction[iRank][iRefl][iWave];
+					productAmps[iRank][iRefl][iWave] -= complexT(priorHessian.RR * d.real() + priorHessian.RI * d.imag(),
+					                                             priorHessian.RI * d.real() + priorHessian.II * d.imag());
+				}
+			}
+	productFlat += twiceNmbEvt * _totAcc * directionFlat;
+
+	copyToParArray(productAmps, productFlat, product);
+	for (unsigned int i = 0; i < _nmbPars; ++i)
+		if (_parameters[i].fixed())
+			product[i] = 0;
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumHessian(const prodAmpsArrayType& prodAmps,
+                                    const value_type         prodAmpFlat,
+                                    vector<value_type>&      hessianSums) const
+{
+	// for each event the second derivatives of the real-data term are
+	//     factor^2 * x x^T - factor * M
+	// with factor = 2 / sigma, the vector x = (Re d_0, Im d_0, Re d_1, ..., prodAmpFlat)
+	// of the likelihood derivatives d_a w.r.t. all production amplitudes a
+	// (see hessianAmpIndex()), and M the real representation of the matrix
+	// decayAmp_i conj(decayAmp_j) within each rank and reflectivity;
+	// the event sums are stored in hessianSums as
+	//     [packed upper triangle of sum of (factor x) (factor x)^T]
+	//     [packed upper triangle of sum of (sqrt(factor) y_refl) (sqrt(factor) y_refl)^T for refl = 0, 1]
+	//     [sum of factor]
+	// with y_refl = (Re decayAmp_0, Im decayAmp_0, ...) of the waves with reflectivity refl
+	const unsigned int nmbAmps    = _rank * (_nmbWavesRefl[0] + _nmbWavesRefl[1]);
+	const unsigned int dim        = 2 * nmbAmps + 1;
+	const unsigned int dimRefl[2] = { 2 * _nmbWavesRefl[0], 2 * _nmbWavesRefl[1] };
+	const size_t       nmbSums    = packedSize(dim) + packedSize(dimRefl[0]) + packedSize(dimRefl[1]) + 1;
+
+	// the chunks are processed in rounds of nmbThreads chunks, each of
+	// which is summed into its own partial sums; the partial sums are
+	// then added in the order of the chunks, so that the result does
+	// not depend on the number of threads
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerHessianChunk - 1) / nmbEventsPerHessianChunk;
+	const unsigned int nmbSlots  = max(1u, min(_nmbThreads, nmbChunks));
+	vector<vector<value_type> > chunkSums(nmbSlots, vector<value_type>(nmbSums, 0));
+	vector<valueAccType>        hessianAcc(nmbSums);
+	for (unsigned int roundBegin = 0; roundBegin < nmbChunks; roundBegin += nmbSlots) {
+		const unsigned int nmbChunksRound = min(nmbSlots, nmbChunks - roundBegin);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(_nmbThreads)
+#endif
+		for (long iSlot = 0; iSlot < (long)nmbChunksRound; ++iSlot) {
+			const unsigned int evtBegin = (roundBegin + iSlot) * nmbEventsPerHessianChunk;
+			const unsigned int evtEnd   = min(evtBegin + nmbEventsPerHessianChunk, _nmbEvents);
+			fill(chunkSums[iSlot].begin(), chunkSums[iSlot].end(), 0);
+			sumHessianChunk(prodAmps, prodAmpFlat, evtBegin, evtEnd, chunkSums[iSlot].data());
+		}
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(_nmbThreads)
+#endif
+		for (long i = 0; i < (long)nmbSums; ++i)
+			for (unsigned int iSlot = 0; iSlot < nmbChunksRound; ++iSlot)
+				hessianAcc[i](chunkSums[iSlot][i]);
+	}
+
+	hessianSums.resize(nmbSums);
+	for (size_t i = 0; i < nmbSums; ++i)
+		hessianSums[i] = sum(hessianAcc[i]);
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumHessianChunk(const prodAmpsArrayType& prodAmps,
+                                         const value_type         prodAmpFlat,
+                                         const unsigned int       evtBegin,
+                                         const unsigned int       evtEnd,
+                                         value_type*              hessianSums) const
+{
+	const unsigned int nmbAmps    = _rank * (_nmbWavesRefl[0] + _nmbWavesRefl[1]);
+	const unsigned int dim        = 2 * nmbAmps + 1;
+	const unsigned int dimRefl[2] = { 2 * _nmbWavesRefl[0], 2 * _nmbWavesRefl[1] };
+	value_type*        outerProducts = hessianSums;
+	value_type*        decayAmpProducts[2];
+	decayAmpProducts[0] = outerProducts       + packedSize(dim);
+	decayAmpProducts[1] = decayAmpProducts[0] + packedSize(dimRefl[0]);
+	value_type&        factorSum     = decayAmpProducts[1][packedSize(dimRefl[1])];
+
+	// vectors of a block of events; component k of the vector of event e is stored at [k][e]
+	vector<value_type>       derivVectors(dim * nmbEventsPerHessianBlock);                 // factor * likelihood derivatives
+	vector<value_type>       decayAmpVectors[2] = { vector<value_type>(dimRefl[0] * nmbEventsPerHessianBlock),
+	                                                vector<value_type>(dimRefl[1] * nmbEventsPerHessianBlock) };  // sqrt(factor) * decay amplitudes
+	multi_array<complexT, 2> evtDecayAmps(extents[2][_nmbWavesReflMax]);
+	multi_array<complexT, 2> ampProdSums (extents[_rank][2]);
+	for (unsigned int blockBegin = evtBegin; blockBegin < evtEnd; blockBegin += nmbEventsPerHessianBlock) {
+		const unsigned int nmbEvtsBlock = min((unsigned int)nmbEventsPerHessianBlock, evtEnd - blockBegin);
+		if (nmbEvtsBlock < (unsigned int)nmbEventsPerHessianBlock) {
+			// unused entries of the last block do not contribute
+			fill(derivVectors.begin(), derivVectors.end(), 0);
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				fill(decayAmpVectors[iRefl].begin(), decayAmpVectors[iRefl].end(), 0);
+		}
+		for (unsigned int iEvtBlock = 0; iEvtBlock < nmbEvtsBlock; ++iEvtBlock) {
+			const unsigned int iEvt = blockBegin + iEvtBlock;
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					evtDecayAmps[iRefl][iWave] = decayAmp(iRefl, iEvt, iWave);
+			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+						ampProdAcc(prodAmps[iRank][iRefl][iWave] * evtDecayAmps[iRefl][iWave]);
+					}
+					ampProdSums[iRank][iRefl] = sum(ampProdAcc);
+					likelihoodAcc(norm(ampProdSums[iRank][iRefl]));
+				}
+			}  // end loop over rank
+			likelihoodAcc(prodAmpFlat * prodAmpFlat);
+			// incorporate factor 2 / sigma
+			const value_type factor     = 2. / sum(likelihoodAcc);
+			const value_type sqrtFactor = sqrt(factor);
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+						// likelihood derivative w.r.t. this production amplitude
+						const complexT     derivative = ampProdSums[iRank][iRefl] * conj(evtDecayAmps[iRefl][iWave]);
+						const unsigned int a          = hessianAmpIndex(iRank, iRefl, iWave);
+						derivVectors[(2 * a    ) * nmbEventsPerHessianBlock + iEvtBlock] = factor * derivative.real();
+						derivVectors[(2 * a + 1) * nmbEventsPerHessianBlock + iEvtBlock] = factor * derivative.imag();
+					}
+			derivVectors[(dim - 1) * nmbEventsPerHessianBlock + iEvtBlock] = factor * prodAmpFlat;
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+					decayAmpVectors[iRefl][(2 * iWave    ) * nmbEventsPerHessianBlock + iEvtBlock] = sqrtFactor * evtDecayAmps[iRefl][iWave].real();
+					decayAmpVectors[iRefl][(2 * iWave + 1) * nmbEventsPerHessianBlock + iEvtBlock] = sqrtFactor * evtDecayAmps[iRefl][iWave].imag();
+				}
+			factorSum += factor;
+		}  // end loop over events in block
+		addOuterProducts(derivVectors.data(), dim, outerProducts);
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			addOuterProducts(decayAmpVectors[iRefl].data(), dimRefl[iRefl], decayAmpProducts[iRefl]);
+	}  // end loop over event blocks
+}
+
 
-							hessianMatrix[r1][r2] = hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][0];
-							if (i2 >= 0) // real/imaginary derivative
-								hessianMatrix[r1][i2] = hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][1];
-							if (i1 >= 0) // imaginary/real derivative
-								hessianMatrix[i1][r2] = hessian[jRank][jRefl][jWave][iRank][iRefl][iWave][1];
-							if (i1 >= 0 && i2 >= 0) // imaginary/imaginary derivative
-								hessianMatrix[i1][i2] = hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][2];
-						}
+template<typename complexT>
+void
+pwaLikelihood<complexT>::sumHessianVectorProduct(const prodAmpsArrayType& prodAmps,
+                                                 const value_type         prodAmpFlat,
+                                                 const prodAmpsArrayType& direction,
+                                                 const value_type         directionFlat,
+                                                 prodAmpsArrayType&       product,
+                                                 value_type&              productFlat) const
+{
+	const unsigned int nmbChunks = (_nmbEvents + nmbEventsPerChunk - 1) / nmbEventsPerChunk;
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape = {{ _rank, 2, _nmbWavesReflMax }};
+	vector<value_type>       productFlatChunks(nmbChunks, 0);
+	multi_array<complexT, 4> productChunks(extents[nmbChunks][_rank][2][_nmbWavesReflMax]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(_nmbThreads)
+#endif
+	for (long iChunk = 0; iChunk < (long)nmbChunks; ++iChunk) {
+		const unsigned int evtBegin = iChunk * nmbEventsPerChunk;
+		const unsigned int evtEnd   = min(evtBegin + nmbEventsPerChunk, _nmbEvents);
+		accumulator_set<value_type, stats<tag::sum(compensated)> > productFlatAcc;
+		multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
+			productAcc(derivShape);
+		multi_array<complexT, 2> evtDecayAmps(extents[2][_nmbWavesReflMax]);
+		multi_array<complexT, 2> ampProdSums (extents[_rank][2]);
+		multi_array<complexT, 2> ampDirSums  (extents[_rank][2]);
+		for (unsigned int iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					evtDecayAmps[iRefl][iWave] = decayAmp(iRefl, iEvt, iWave);
+			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+					accumulator_set<complexT, stats<tag::sum(compensated)> > ampDirAcc;
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+						ampProdAcc(prodAmps [iRank][iRefl][iWave] * evtDecayAmps[iRefl][iWave]);
+						ampDirAcc (direction[iRank][iRefl][iWave] * evtDecayAmps[iRefl][iWave]);
 					}
+					ampProdSums[iRank][iRefl] = sum(ampProdAcc);
+					ampDirSums [iRank][iRefl] = sum(ampDirAcc);
+					likelihoodAcc(norm(ampProdSums[iRank][iRefl]));
 				}
+			}  // end loop over rank
+			likelihoodAcc(prodAmpFlat * prodAmpFlat);
+			// incorporate factor 2 / sigma
+			const value_type factor  = 2. / sum(likelihoodAcc);
+			const value_type factor2 = factor * factor;
+			// scalar product of the likelihood derivatives with the direction
+			accumulator_set<value_type, stats<tag::sum(compensated)> > derivDirAcc;
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					derivDirAcc(real(conj(ampProdSums[iRank][iRefl]) * ampDirSums[iRank][iRefl]));
+			derivDirAcc(prodAmpFlat * directionFlat);
+			const value_type derivDir = sum(derivDirAcc);
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+						const complexT conjDecayAmp = conj(evtDecayAmps[iRefl][iWave]);
+						productAcc[iRank][iRefl][iWave](factor2 * derivDir * ampProdSums[iRank][iRefl] * conjDecayAmp
+						                                - factor * conjDecayAmp * ampDirSums[iRank][iRefl]);
+					}
+			productFlatAcc(factor2 * derivDir * prodAmpFlat - factor * directionFlat);
+		}  // end loop over events
+		productFlatChunks[iChunk] = sum(productFlatAcc);
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					productChunks[iChunk][iRank][iRefl][iWave] = sum(productAcc[iRank][iRefl][iWave]);
+	}  // end loop over chunks
 
-				// second derivatives w.r.t. flat wave
-				hessianMatrix[r1][_nmbPars - 1] = flatTerms[iRank][iRefl][iWave].real();
-				hessianMatrix[_nmbPars - 1][r1] = flatTerms[iRank][iRefl][iWave].real();
-				if (i1 >= 0) {
-					hessianMatrix[i1][_nmbPars - 1] = flatTerms[iRank][iRefl][iWave].imag();
-					hessianMatrix[_nmbPars - 1][i1] = flatTerms[iRank][iRefl][iWave].imag();
-				}
-			}
-		}
+	// add up partial sums in fixed order
+	accumulator_set<value_type, stats<tag::sum(compensated)> > productFlatAcc;
+	multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
+		productAcc(derivShape);
+	for (unsigned int iChunk = 0; iChunk < nmbChunks; ++iChunk) {
+		productFlatAcc(productFlatChunks[iChunk]);
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					productAcc[iRank][iRefl][iWave](productChunks[iChunk][iRank][iRefl][iWave]);
 	}
-	hessianMatrix[_nmbPars - 1][_nmbPars - 1] = hessianFlat;  // enter flat/flat term
+	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+				product[iRank][iRefl][iWave] = sum(productAcc[iRank][iRefl][iWave]);
+	productFlat = sum(productFlatAcc);
+}
 
-	// log total consumed time
-	timerTot.Stop();
-	_funcCallInfo[HESSIAN].totalTime(timerTot.RealTime());
 
-	return hessianMatrix;
+template<typename complexT>
+typename pwaLikelihood<complexT>::priorHessianType
+pwaLikelihood<complexT>::priorHessianDiag(const complexT& prodAmp) const
+{
+	const double r = abs(prodAmp);
+
+	const double cauchyFunctionValue                 = cauchyFunction                (r, _cauchyWidth);
+	const double cauchyFunctionDerivativeValue       = cauchyFunctionDerivative      (r, _cauchyWidth);
+	const double cauchyFunctionSecondDerivativeValue = cauchyFunctionSecondDerivative(r, _cauchyWidth);
+
+	const double a1 = cauchyFunctionSecondDerivativeValue / (cauchyFunctionValue * r*r);
+	const double a2 = cauchyFunctionDerivativeValue*cauchyFunctionDerivativeValue / (cauchyFunctionValue*cauchyFunctionValue * r*r);
+	const double a3 = cauchyFunctionDerivativeValue / (cauchyFunctionValue * r);
+	const double a4 = cauchyFunctionDerivativeValue / (cauchyFunctionValue * r*r*r);
+	const double a124 = a1 - a2 - a4;
+
+	const double re = prodAmp.real();
+	const double im = prodAmp.imag();
+
+	priorHessianType priorHessian;
+	priorHessian.RR = (a124) * re*re + a3;
+	priorHessian.RI = (a124) * re*im;
+	priorHessian.II = (a124) * im*im + a3;
+	return priorHessian;
 }
 
 
@@ -1038,13 +2194,171 @@ pwaLikelihood<complexT>::cudaEnabled() const
 }
 
 
+template<typename complexT>
+void
+pwaLikelihood<complexT>::enableSimd(const bool enableSimd)
+{
+	if (_nmbEventsTotal != 0) {
+		printWarn << "decay amplitudes were already added. "
+		          << "call pwaLikelihood::enableSimd() before pwaLikelihood::addAmplitude(). "
+		          << "ignoring request." << endl;
+		return;
+	}
+	_simdEnabled = enableSimd;
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::enableFloatStorage(const bool enableFloat)
+{
+	if (_nmbEventsTotal != 0) {
+		printWarn << "decay amplitudes were already added. "
+		          << "call pwaLikelihood::enableFloatStorage() before pwaLikelihood::addAmplitude(). "
+		          << "ignoring request." << endl;
+		return;
+	}
+	_floatStorage = enableFloat;
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::enableCpuKernels(const bool enableCpu)
+{
+	// after finishInit() the decay amplitudes are either in the memory
+	// of the CPU kernels or in the likelihood, but not in both
+	if (_initFinished) {
+		printErr << "pwaLikelihood::finishInit() was already called. "
+		         << "call pwaLikelihood::enableCpuKernels() before pwaLikelihood::finishInit()." << endl;
+		return false;
+	}
+	_cpuKernelsEnabled = enableCpu;
+	return true;
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::setNmbThreads(const unsigned int nmbThreads)
+{
+#ifdef _OPENMP
+	_nmbThreads = (nmbThreads == 0) ? omp_get_max_threads() : nmbThreads;
+#else
+	if (nmbThreads > 1)
+		printWarn << "ROOTPWA was compiled without OpenMP support. "
+		          << "ignoring request to use " << nmbThreads << " threads." << endl;
+	_nmbThreads = 1;
+#endif
+	_cpuKernels.setNmbThreads(_nmbThreads);
+}
+
+
+template<typename complexT>
+void
+#ifdef USE_MPI
+pwaLikelihood<complexT>::enableMpi(const bool enableMpi)
+{
+	if (_nmbEventsTotal != 0) {
+		printWarn << "decay amplitudes were already added. "
+		          << "call pwaLikelihood::enableMpi() before pwaLikelihood::addAmplitude(). "
+		          << "ignoring request." << endl;
+		return;
+	}
+	if (enableMpi and not boost::mpi::environment::initialized()) {
+		// MPI is finalized when the environment is destroyed at program exit
+		static boost::mpi::environment mpiEnvironment;
+	}
+	_mpiEnabled = enableMpi;
+}
+#else
+pwaLikelihood<complexT>::enableMpi(const bool enableMpi)
+{
+	if (enableMpi)
+		printWarn << "ROOTPWA was compiled without MPI support. ignoring request to enable MPI." << endl;
+}
+#endif
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::enableIncrementalUpdates(const bool         enableIncremental,
+                                                  const unsigned int maxNmbIncrementalUpdates)
+{
+	_incrementalEnabled       = enableIncremental;
+	_maxNmbIncrementalUpdates = maxNmbIncrementalUpdates;
+	// (re)calculate coherent sums in the next call
+	_coherentSumsValid        = false;
+	_nmbIncrementalUpdates    = 0;
+	if (not _incrementalEnabled) {
+		_coherentSums.clear();
+		_coherentSums.shrink_to_fit();
+		_coherentSumsCompensation.clear();
+		_coherentSumsCompensation.shrink_to_fit();
+	}
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::mpiEnabled() const
+{
+#ifdef USE_MPI
+	return _mpiEnabled;
+#else
+	return false;
+#endif
+}
+
+
+template<typename complexT>
+unsigned int
+pwaLikelihood<complexT>::mpiRank() const
+{
+#ifdef USE_MPI
+	if (_mpiEnabled)
+		return _mpiComm.rank();
+#endif
+	return 0;
+}
+
+
+template<typename complexT>
+unsigned int
+pwaLikelihood<complexT>::mpiSize() const
+{
+#ifdef USE_MPI
+	if (_mpiEnabled)
+		return _mpiComm.size();
+#endif
+	return 1;
+}
+
+
 template<typename complexT>
 bool
-pwaLikelihood<complexT>::init(const vector<waveDescThresType>& waveDescThresType,
+pwaLikelihood<complexT>::init(const vector<waveDescThresType>& waveDescThres,
                               const unsigned int               rank,
                               const double                     massBinCenter)
 {
-	if (not readWaveList(waveDescThresType))
+	vector<waveReflThresType> waveReflThres;
+	if (not getWaveReflThres(waveDescThres, waveReflThres))
+		return false;
+	return init(waveReflThres, rank, massBinCenter);
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::init(const vector<waveReflThresType>& waveReflThres,
+                              const unsigned int               rank,
+                              const double                     massBinCenter)
+{
+	if (_initFinished) {
+		printErr << "likelihood was already initialized. cannot initialize it again. Aborting..." << endl;
+		return false;
+	}
+	if (not readWaveList(waveReflThres))
 		return false;
 	if (not buildParDataStruct(rank, massBinCenter))
 		return false;
@@ -1054,46 +2368,207 @@ pwaLikelihood<complexT>::init(const vector<waveDescThresType>& waveDescThresType
 }
 
 
-template<typename complexT>
-bool
-pwaLikelihood<complexT>::addNormIntegral(const ampIntegralMatrix& normMatrix)
-{
-	if (not _initialized) {
-		printErr << "likelihood not initialized!" << endl
-		         << "call pwaLikelihood::init() before pwaLikelihood::addNormIntegral()" << endl
-		         << "Aborting..." << endl;
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::addNormIntegral(const ampIntegralMatrix& normMatrix)
+{
+	if (not _initialized) {
+		printErr << "likelihood not initialized!" << endl
+		         << "call pwaLikelihood::init() before pwaLikelihood::addNormIntegral()" << endl
+		         << "Aborting..." << endl;
+		return false;
+	}
+
+	_numbAccEvents = normMatrix.nmbEvents();
+
+	reorderIntegralMatrix(normMatrix, _normMatrix);
+
+	_normIntAdded = true;
+	return true;
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::addNormIntegral(const ampIntegralPackedMatrix& normMatrix)
+{
+	if (not _initialized) {
+		printErr << "likelihood not initialized!" << endl
+		         << "call pwaLikelihood::init() before pwaLikelihood::addNormIntegral()" << endl
+		         << "Aborting..." << endl;
+		return false;
+	}
+
+	_numbAccEvents = normMatrix.nmbEvents();
+
+	reorderIntegralMatrix(normMatrix, normMatrix.nmbEvents(), _normMatrix);
+
+	_normIntAdded = true;
+	return true;
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::addAccIntegral(ampIntegralMatrix& accMatrix,
+                                        const unsigned int accEventsOverride)
+{
+	if (not _normIntAdded) {
+		printErr << "normalization integral not added before acceptance integral!" << endl
+		         << "call pwaLikelihood::addNormIntegral() before pwaLikelihood::addAccIntegral()" << endl
+		         << "Aborting..." << endl;
+		return false;
+	}
+
+	_numbAccEvents = accEventsOverride==0 ? _numbAccEvents : accEventsOverride;
+	_totAcc = (double) accMatrix.nmbEvents() / _numbAccEvents;
+	accMatrix.setNmbEvents(_numbAccEvents);
+	printInfo << "total acceptance in this bin: " << _totAcc << endl;
+
+	reorderIntegralMatrix(accMatrix, _accMatrix);
+
+	_accIntAdded = true;
+	return true;
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::addAccIntegral(const ampIntegralPackedMatrix& accMatrix,
+                                        const unsigned int             accEventsOverride)
+{
+	if (not _normIntAdded) {
+		printErr << "normalization integral not added before acceptance integral!" << endl
+		         << "call pwaLikelihood::addNormIntegral() before pwaLikelihood::addAccIntegral()" << endl
+		         << "Aborting..." << endl;
+		return false;
+	}
+
+	_numbAccEvents = accEventsOverride==0 ? _numbAccEvents : accEventsOverride;
+	_totAcc = (double) accMatrix.nmbEvents() / _numbAccEvents;
+	printInfo << "total acceptance in this bin: " << _totAcc << endl;
+
+	// the packed matrix is read-only, so the elements are normalized to
+	// the number of accepted events while they are gathered
+	reorderIntegralMatrix(accMatrix, _numbAccEvents, _accMatrix);
+
+	_accIntAdded = true;
+	return true;
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::prepareDecayAmps(const vector<const vector<eventMetadata>*>& evtMetas,
+                                          const vector<size_t>&                        nmbEntries,
+                                          size_t&                                      totalEvents,
+                                          size_t&                                      evtBegin,
+                                          size_t&                                      evtEnd)
+{
+	const bool onTheFlyBinning = not _eventFileProperties.empty();
+	{
+		// check ordering of event files
+		const bool eventFileHashOrderWasEmpty = _eventFileHashOrder.empty();
+		size_t runningEventFileIndex = 0;
+		for(size_t iAmpMeta = 0; iAmpMeta < evtMetas.size(); ++iAmpMeta) {
+			for(size_t iEvtMeta = 0; iEvtMeta < evtMetas[iAmpMeta]->size(); ++iEvtMeta) {
+				const string& eventFileHash = (*evtMetas[iAmpMeta])[iEvtMeta].contentHash();
+				if(eventFileHashOrderWasEmpty) {
+					_eventFileHashOrder.push_back(eventFileHash);
+				} else {
+					if (runningEventFileIndex >= _eventFileHashOrder.size() or _eventFileHashOrder[runningEventFileIndex] != eventFileHash) {
+						printErr << "order of event files differs between corresponding amplitude files. Aborting..." << endl;
+						return false;
+					}
+					++runningEventFileIndex;
+				}
+				if(onTheFlyBinning) {
+					if(_eventFileProperties.count(eventFileHash) == 0) {
+						printErr << "event file hash from amplitude metadata not in "
+						         << "on-the-fly binning information. Aborting..." << endl;
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	// counting all events
+	totalEvents = 0;
+	for (size_t iAmpMeta = 0; iAmpMeta < evtMetas.size(); ++iAmpMeta) {
+		if (onTheFlyBinning) {
+			for (size_t iEvtMeta = 0; iEvtMeta < evtMetas[iAmpMeta]->size(); ++iEvtMeta) {
+				totalEvents += _eventFileProperties[(*evtMetas[iAmpMeta])[iEvtMeta].contentHash()].second.size();
+			}
+		} else {
+			totalEvents += nmbEntries[iAmpMeta];
+		}
+	}
+	if (totalEvents == 0) {
+		printErr << "no events to load. Aborting..." << endl;
 		return false;
 	}
 
-	_numbAccEvents = normMatrix.nmbEvents();
-
-	reorderIntegralMatrix(normMatrix, _normMatrix);
+	// in MPI mode each process stores only a contiguous slice of the events
+	evtBegin = 0;
+	evtEnd   = totalEvents;
+#ifdef USE_MPI
+	if (_mpiEnabled) {
+		evtBegin = (totalEvents *  _mpiComm.rank()     ) / _mpiComm.size();
+		evtEnd   = (totalEvents * (_mpiComm.rank() + 1)) / _mpiComm.size();
+	}
+#endif
 
-	_normIntAdded = true;
+	if (_nmbEventsTotal == 0) {
+		// first amplitude file read
+		decayAmpStorage& decayAmps = decayAmpsForWriting();
+		_nmbEventsTotal = totalEvents;
+		_nmbEvents      = evtEnd - evtBegin;
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+			if (_simdEnabled and _floatStorage)
+				decayAmps.ampsSimdFloat[iRefl].resize(_nmbEvents, _nmbWavesRefl[iRefl]);
+			else if (_simdEnabled)
+				decayAmps.ampsSimd     [iRefl].resize(_nmbEvents, _nmbWavesRefl[iRefl]);
+			else if (_floatStorage)
+				decayAmps.ampsFloat    [iRefl].resize(extents[_nmbEvents][_nmbWavesRefl[iRefl]]);
+			else
+				decayAmps.amps         [iRefl].resize(extents[_nmbEvents][_nmbWavesRefl[iRefl]]);
+		}
+	}
+	if (totalEvents != _nmbEventsTotal) {
+		printWarn << "size mismatch in amplitude files: this file contains " << totalEvents
+		          << " events, previous file had " << _nmbEventsTotal << " events." << endl;
+		return false;
+	}
 	return true;
 }
 
 
 template<typename complexT>
 bool
-pwaLikelihood<complexT>::addAccIntegral(ampIntegralMatrix& accMatrix,
-                                        const unsigned int accEventsOverride)
+pwaLikelihood<complexT>::storeDecayAmp(decayAmpStorage&   decayAmps,
+                                       const unsigned int refl,
+                                       const unsigned int waveIndex,
+                                       const unsigned int iEvt,
+                                       complexT           amp) const
 {
-	if (not _normIntAdded) {
-		printErr << "normalization integral not added before acceptance integral!" << endl
-		         << "call pwaLikelihood::addNormIntegral() before pwaLikelihood::addAccIntegral()" << endl
-		         << "Aborting..." << endl;
-		return false;
+	if (_useNormalizedAmps) {  // normalize data, if option is switched on
+		const complexT normInt = _normMatrix[refl][waveIndex][refl][waveIndex];
+		if (normInt == (value_type)0. && amp != (value_type)0.) {
+			printErr << "normalization integral for wave '" << _waveNames[refl][waveIndex] << "' is zero, but the amplitude is not. Aborting...";
+			return false;
+		}
+		if (normInt != (value_type)0.)
+			amp /= sqrt(normInt.real());  // rescale decay amplitude
 	}
-
-	_numbAccEvents = accEventsOverride==0 ? _numbAccEvents : accEventsOverride;
-	_totAcc = (double) accMatrix.nmbEvents() / _numbAccEvents;
-	accMatrix.setNmbEvents(_numbAccEvents);
-	printInfo << "total acceptance in this bin: " << _totAcc << endl;
-
-	reorderIntegralMatrix(accMatrix, _accMatrix);
-
-	_accIntAdded = true;
+	if (_simdEnabled and _floatStorage)
+		decayAmps.ampsSimdFloat[refl].set(iEvt, waveIndex, amp);
+	else if (_simdEnabled)
+		decayAmps.ampsSimd     [refl].set(iEvt, waveIndex, amp);
+	else if (_floatStorage)
+		decayAmps.ampsFloat    [refl][iEvt][waveIndex] = complex<float>(amp);
+	else
+		decayAmps.amps         [refl][iEvt][waveIndex] = amp;
 	return true;
 }
 
@@ -1130,122 +2605,207 @@ pwaLikelihood<complexT>::addAmplitude(const vector<const amplitudeMetadata*>& am
 		return false;
 	}
 
-	// counting all events
-	const bool onTheFlyBinning = not _eventFileProperties.empty();
-	size_t totalEvents = 0;
+	vector<const vector<eventMetadata>*> evtMetas(ampMetas.size());
+	vector<size_t> nmbEntries(ampMetas.size());
 	for (size_t iAmpMeta = 0; iAmpMeta < ampMetas.size(); ++iAmpMeta) {
-		if (onTheFlyBinning) {
-			const vector<eventMetadata>& evtMetas = ampMetas[iAmpMeta]->eventMetadata();
-			for (size_t iEvtMeta = 0; iEvtMeta < evtMetas.size(); ++iEvtMeta) {
-				totalEvents += _eventFileProperties[evtMetas[iEvtMeta].contentHash()].second.size();
-			}
-		} else {
-			totalEvents += ampMetas[iAmpMeta]->amplitudeTree()->GetEntriesFast();
-		}
+		evtMetas  [iAmpMeta] = &ampMetas[iAmpMeta]->eventMetadata();
+		nmbEntries[iAmpMeta] = ampMetas[iAmpMeta]->nmbAmplitudes();
 	}
-	if (totalEvents == 0) {
-		printErr << "no events to load. Aborting..." << endl;
+	size_t totalEvents, evtBegin, evtEnd;
+	if (not prepareDecayAmps(evtMetas, nmbEntries, totalEvents, evtBegin, evtEnd))
 		return false;
-	}
 
-	{
-		// check ordering of event files
-		const bool eventFileHashOrderWasEmpty = _eventFileHashOrder.empty();
-		size_t runningEventFileIndex = 0;
-		for(size_t iAmpMeta = 0; iAmpMeta < ampMetas.size(); ++iAmpMeta) {
-			const amplitudeMetadata* ampMeta = ampMetas[iAmpMeta];
-			for(size_t iEvtMeta = 0; iEvtMeta < ampMeta->eventMetadata().size(); ++iEvtMeta) {
-				const string& eventFileHash = ampMeta->eventMetadata()[iEvtMeta].contentHash();
-				if(eventFileHashOrderWasEmpty) {
-					_eventFileHashOrder.push_back(eventFileHash);
-				} else {
-					if (runningEventFileIndex >= _eventFileHashOrder.size() or _eventFileHashOrder[runningEventFileIndex] != eventFileHash) {
-						printErr << "order of event files differs between corresponding amplitude files. Aborting..." << endl;
-						return false;
-					}
-					++runningEventFileIndex;
-				}
-				if(onTheFlyBinning) {
-					if(_eventFileProperties.count(eventFileHash) == 0) {
-						printErr << "event file hash from amplitude metadata not in "
-						         << "on-the-fly binning information. Aborting..." << endl;
-						return false;
-					}
-				}
-			}
-		}
-	}
+	const bool onTheFlyBinning = not _eventFileProperties.empty();
 
-	vector<complexT> amps(totalEvents);
+	vector<complexT> amps(evtEnd - evtBegin);
+	// amplitudes are read in bulk into this buffer and then converted
+	vector<complex<double> > ampBuffer;
 	size_t eventCount = 0; // Running count for event number over all single files
 	for (size_t iAmpMeta = 0; iAmpMeta < ampMetas.size(); ++iAmpMeta) {
 		const amplitudeMetadata* ampMeta = ampMetas[iAmpMeta];
-		// connect tree leaf
-		amplitudeTreeLeaf* ampTreeLeaf = 0;
-		ampMeta->amplitudeTree()->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeaf);
-		if (not ampTreeLeaf) {
-			printWarn << "null pointer to amplitude leaf. Aborting..." << endl;
-			return false;
-		}
-
+		// the cache file is mapped only while the amplitudes of this file are copied
+		amplitudeCacheFile ampCache;
+		if (not _ampCacheDirectory.empty() and not ampCache.open(_ampCacheDirectory, *ampMeta))
+			printWarn << "could not use amplitude cache for wave '" << waveName << "'. "
+			          << "reading decay amplitudes from amplitude file." << endl;
 		if (onTheFlyBinning) {
 			size_t skipEvents  = 0;
 			for(size_t iEvtMeta = 0; iEvtMeta < ampMeta->eventMetadata().size(); ++iEvtMeta) {
 				const string& eventFileHash = ampMeta->eventMetadata()[iEvtMeta].contentHash();
 				const vector<size_t>& entriesInBin = _eventFileProperties[eventFileHash].second;
-				for(size_t iEvent = 0; iEvent < entriesInBin.size(); ++iEvent, ++eventCount) {
-					ampMeta->amplitudeTree()->GetEntry(skipEvents + entriesInBin[iEvent]);
-					assert(ampTreeLeaf->nmbIncohSubAmps() == 1);
-					complexT amp(ampTreeLeaf->incohSubAmp(0).real(), ampTreeLeaf->incohSubAmp(0).imag());
-					amps[eventCount] = amp;
+				const size_t firstEvent = max(eventCount, evtBegin);
+				const size_t lastEvent  = min(eventCount + entriesInBin.size(), evtEnd);
+				if (firstEvent < lastEvent) {
+					const vector<size_t> entriesToRead(entriesInBin.begin() + (firstEvent - eventCount),
+					                                   entriesInBin.begin() + (lastEvent  - eventCount));
+					if (ampCache.isOpen()) {
+						const complex<double>* cachedAmps = ampCache.amplitudes() + skipEvents;
+						for (size_t iEvent = 0; iEvent < entriesToRead.size(); ++iEvent) {
+							const complex<double>& amp = cachedAmps[entriesToRead[iEvent]];
+							amps[firstEvent - evtBegin + iEvent] = complexT(amp.real(), amp.imag());
+						}
+					} else {
+						ampBuffer.resize(entriesToRead.size());
+						if (not ampMeta->readAmplitudes(entriesToRead, skipEvents, ampBuffer.data())) {
+							printErr << "could not read decay amplitudes for wave '" << waveName << "'. Aborting..." << endl;
+							return false;
+						}
+						for (size_t iEvent = 0; iEvent < ampBuffer.size(); ++iEvent)
+							amps[firstEvent - evtBegin + iEvent] = complexT(ampBuffer[iEvent].real(), ampBuffer[iEvent].imag());
+					}
 				}
+				eventCount += entriesInBin.size();
 				skipEvents += _eventFileProperties[eventFileHash].first;
 			}
 		} else {
-			for(long iEvent = 0; iEvent < ampMeta->amplitudeTree()->GetEntriesFast(); ++iEvent, ++eventCount) {
-				ampMeta->amplitudeTree()->GetEntry(iEvent);
-				assert(ampTreeLeaf->nmbIncohSubAmps() == 1);
-				complexT amp(ampTreeLeaf->incohSubAmp(0).real(), ampTreeLeaf->incohSubAmp(0).imag());
-				amps[eventCount] = amp;
+			const size_t nmbAmps    = ampMeta->nmbAmplitudes();
+			const size_t firstEvent = max(eventCount, evtBegin);
+			const size_t lastEvent  = min(eventCount + nmbAmps, evtEnd);
+			if (firstEvent < lastEvent) {
+				if (ampCache.isOpen()) {
+					const complex<double>* cachedAmps = ampCache.amplitudes() + (firstEvent - eventCount);
+					for (size_t iEvent = 0; iEvent < lastEvent - firstEvent; ++iEvent)
+						amps[firstEvent - evtBegin + iEvent] = complexT(cachedAmps[iEvent].real(), cachedAmps[iEvent].imag());
+				} else {
+					ampBuffer.resize(lastEvent - firstEvent);
+					if (not ampMeta->readAmplitudes(firstEvent - eventCount, ampBuffer.size(), ampBuffer.data())) {
+						printErr << "could not read decay amplitudes for wave '" << waveName << "'. Aborting..." << endl;
+						return false;
+					}
+					for (size_t iEvent = 0; iEvent < ampBuffer.size(); ++iEvent)
+						amps[firstEvent - evtBegin + iEvent] = complexT(ampBuffer[iEvent].real(), ampBuffer[iEvent].imag());
+				}
 			}
+			eventCount += nmbAmps;
 		}
 	}
 
-	if (_nmbEvents == 0) {
-		// first amplitude file read
-		_nmbEvents = totalEvents;
-		_decayAmps[0].resize(extents[_nmbEvents][_nmbWavesRefl[0]]);
-		_decayAmps[1].resize(extents[_nmbEvents][_nmbWavesRefl[1]]);
+	decayAmpStorage& decayAmps = decayAmpsForWriting();
+	const unsigned int refl = _waveParams[waveName].first;
+	const unsigned int waveIndex = _waveParams[waveName].second;
+
+	// copy decay amplitudes into array that is indexed [event index][reflectivity][wave index]
+	// this index scheme ensures a more linear memory access pattern in the likelihood function
+	for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt)
+		if (not storeDecayAmp(decayAmps, refl, waveIndex, iEvt, amps[iEvt]))
+			return false;
+
+	_waveAmpAdded[refl][waveIndex] = true; // note that this amplitude has been added to the likelihood
+
+	printInfo << "read decay amplitudes of " << _nmbEvents << " of " << totalEvents << " events for wave '" << waveName << "' into memory" << endl;
+	return true;
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::addAmplitudeMatrix(const vector<const amplitudeMatrixMetadata*>& ampMatrixMetas)
+{
+	if (not _accIntAdded) {
+		printErr << "no acceptance integral found. "
+		         << "Call pwaLikelihood::addAccIntegral() before pwaLikelihood::addAmplitudeMatrix(). "
+		         << "Aborting..." << endl;
+		return false;
 	}
-	if (totalEvents != _nmbEvents) {
-		printWarn << "size mismatch in amplitude files: this file contains " << totalEvents
-		          << " events, previous file had " << _nmbEvents << " events." << endl;
+	if (ampMatrixMetas.size() == 0) {
+		printErr << "no amplitudeMatrixMetadata given. Aborting..." << endl;
 		return false;
 	}
+	for (size_t iAmpMeta = 0; iAmpMeta < ampMatrixMetas.size(); ++iAmpMeta) {
+		if (not ampMatrixMetas[iAmpMeta]) {
+			printErr << "amplitudeMatrixMetadata metas[" << iAmpMeta << "] not valid. Aborting..." << endl;
+			return false;
+		}
+		if (ampMatrixMetas[iAmpMeta]->waveNames() != ampMatrixMetas[0]->waveNames()) {
+			printErr << "waves in different amplitude matrix metadatas do not match. Aborting..." << endl;
+			return false;
+		}
+	}
 
-	const unsigned int refl = _waveParams[waveName].first;
-	const unsigned int waveIndex = _waveParams[waveName].second;
+	// waves of the matrix that are not in the wave list are skipped
+	const vector<string>& matrixWaveNames = ampMatrixMetas[0]->waveNames();
+	vector<unsigned int> matrixWaveIndices;
+	vector<pair<unsigned int, unsigned int> > reflWaveIndices;
+	for (unsigned int iMatrixWave = 0; iMatrixWave < matrixWaveNames.size(); ++iMatrixWave) {
+		typename waveParamsType::const_iterator it = _waveParams.find(matrixWaveNames[iMatrixWave]);
+		if (it == _waveParams.end())
+			continue;
+		matrixWaveIndices.push_back(iMatrixWave);
+		reflWaveIndices.push_back(it->second);
+	}
+	if (matrixWaveIndices.empty()) {
+		printErr << "amplitude matrix does not contain any wave of the wavelist. Aborting..." << endl;
+		return false;
+	}
 
-	// get normalization
-	const complexT normInt = _normMatrix[refl][waveIndex][refl][waveIndex];
+	vector<const vector<eventMetadata>*> evtMetas(ampMatrixMetas.size());
+	vector<size_t> nmbEntries(ampMatrixMetas.size());
+	for (size_t iAmpMeta = 0; iAmpMeta < ampMatrixMetas.size(); ++iAmpMeta) {
+		evtMetas  [iAmpMeta] = &ampMatrixMetas[iAmpMeta]->eventMetadata();
+		nmbEntries[iAmpMeta] = ampMatrixMetas[iAmpMeta]->nmbEvents();
+	}
+	size_t totalEvents, evtBegin, evtEnd;
+	if (not prepareDecayAmps(evtMetas, nmbEntries, totalEvents, evtBegin, evtEnd))
+		return false;
 
-	// copy decay amplitudes into array that is indexed [event index][reflectivity][wave index]
-	// this index scheme ensures a more linear memory access pattern in the likelihood function
-	for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-		if (_useNormalizedAmps) {  // normalize data, if option is switched on
-			if (normInt == (value_type)0. && amps[iEvt] != (value_type)0.) {
-				printErr << "normalization integral for wave '" << waveName << "' is zero, but the amplitude is not. Aborting...";
-				return false;
+	// the matrix is read in blocks of events, which are directly
+	// distributed to the decay amplitude arrays; this way, the
+	// amplitudes of all waves are never held twice in memory
+	decayAmpStorage& decayAmps = decayAmpsForWriting();
+	const bool onTheFlyBinning = not _eventFileProperties.empty();
+	const size_t nmbMatrixWaves = matrixWaveNames.size();
+	vector<complex<double> > ampBuffer;
+	size_t eventCount = 0; // Running count for event number over all single files
+	for (size_t iAmpMeta = 0; iAmpMeta < ampMatrixMetas.size(); ++iAmpMeta) {
+		const amplitudeMatrixMetadata* ampMatrixMeta = ampMatrixMetas[iAmpMeta];
+		const size_t blockSize = ampMatrixMeta->chunkSize();
+		size_t skipEvents  = 0;
+		const size_t nmbEvtMetas = onTheFlyBinning ? ampMatrixMeta->eventMetadata().size() : 1;
+		for (size_t iEvtMeta = 0; iEvtMeta < nmbEvtMetas; ++iEvtMeta) {
+			const vector<size_t>* entriesInBin = 0;
+			size_t nmbEventsToRead = ampMatrixMeta->nmbEvents();
+			if (onTheFlyBinning) {
+				const string& eventFileHash = ampMatrixMeta->eventMetadata()[iEvtMeta].contentHash();
+				entriesInBin    = &_eventFileProperties[eventFileHash].second;
+				nmbEventsToRead = entriesInBin->size();
+			}
+			const size_t firstEvent = max(eventCount, evtBegin);
+			const size_t lastEvent  = min(eventCount + nmbEventsToRead, evtEnd);
+			for (size_t blockBegin = firstEvent; blockBegin < lastEvent; blockBegin += blockSize) {
+				const size_t blockEnd = min(blockBegin + blockSize, lastEvent);
+				ampBuffer.resize((blockEnd - blockBegin) * nmbMatrixWaves);
+				bool success;
+				if (onTheFlyBinning) {
+					const vector<size_t> entriesToRead(entriesInBin->begin() + (blockBegin - eventCount),
+					                                   entriesInBin->begin() + (blockEnd   - eventCount));
+					success = ampMatrixMeta->readAmplitudes(entriesToRead, skipEvents, ampBuffer.data());
+				} else
+					success = ampMatrixMeta->readAmplitudes(blockBegin - eventCount, blockEnd - blockBegin, ampBuffer.data());
+				if (not success) {
+					printErr << "could not read decay amplitudes from amplitude matrix. Aborting..." << endl;
+					return false;
+				}
+				for (size_t iEvent = blockBegin; iEvent < blockEnd; ++iEvent) {
+					const complex<double>* eventAmps = &ampBuffer[(iEvent - blockBegin) * nmbMatrixWaves];
+					for (size_t iWave = 0; iWave < matrixWaveIndices.size(); ++iWave) {
+						const complex<double>& amp = eventAmps[matrixWaveIndices[iWave]];
+						if (not storeDecayAmp(decayAmps, reflWaveIndices[iWave].first, reflWaveIndices[iWave].second,
+						                      iEvent - evtBegin, complexT(amp.real(), amp.imag())))
+							return false;
+					}
+				}
 			}
-			if (normInt != (value_type)0.)
-				amps[iEvt] /= sqrt(normInt.real());  // rescale decay amplitude
+			eventCount += nmbEventsToRead;
+			if (onTheFlyBinning)
+				skipEvents += _eventFileProperties[ampMatrixMeta->eventMetadata()[iEvtMeta].contentHash()].first;
 		}
-		_decayAmps[refl][iEvt][waveIndex] = amps[iEvt];
 	}
 
-	_waveAmpAdded[refl][waveIndex] = true; // note that this amplitude has been added to the likelihood
+	for (size_t iWave = 0; iWave < reflWaveIndices.size(); ++iWave)
+		_waveAmpAdded[reflWaveIndices[iWave].first][reflWaveIndices[iWave].second] = true; // note that this amplitude has been added to the likelihood
 
-	printInfo << "read decay amplitudes of " << totalEvents << " events for wave '" << waveName << "' into memory" << endl;
+	printInfo << "read decay amplitudes of " << _nmbEvents << " of " << totalEvents << " events for "
+	          << reflWaveIndices.size() << " waves from amplitude matrix into memory" << endl;
 	return true;
 }
 
@@ -1254,6 +2814,10 @@ template<typename complexT>
 bool
 pwaLikelihood<complexT>::finishInit()
 {
+	if (_initFinished) {
+		printErr << "pwaLikelihood::finishInit() was already called. Aborting..." << endl;
+		return false;
+	}
 	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
 		for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
 			if (not _waveAmpAdded[iRefl][iWave]) {
@@ -1314,17 +2878,215 @@ pwaLikelihood<complexT>::finishInit()
 	}  // _useNormalizedAmps
 
 #ifdef USE_CUDA
-	if (_cudaEnabled)
-		cuda::likelihoodInterface<cuda::complex<value_type> >::init
-			(reinterpret_cast<cuda::complex<value_type>*>(_decayAmps.data()),
-			 _decayAmps.num_elements(), _nmbEvents, _nmbWavesRefl, true);
+	if (_cudaEnabled and _simdEnabled) {
+		printErr << "CUDA and SIMD event loops cannot be used at the same time. Aborting..." << endl;
+		return false;
+	}
+	if (_cudaEnabled and _floatStorage) {
+		printErr << "CUDA kernels do not support single-precision storage of decay amplitudes. Aborting..." << endl;
+		return false;
+	}
+	if (_cudaEnabled and _cpuKernelsEnabled) {
+		printErr << "CUDA and CPU kernels cannot be used at the same time. Aborting..." << endl;
+		return false;
+	}
+	if (_cudaEnabled and mpiEnabled()) {
+		printErr << "CUDA kernels cannot be used in MPI mode. Aborting..." << endl;
+		return false;
+	}
+#endif
+	if (_cpuKernelsEnabled and (_simdEnabled or _floatStorage)) {
+		printErr << "CPU kernels support neither SIMD event loops nor single-precision storage "
+		         << "of decay amplitudes. Aborting..." << endl;
+		return false;
+	}
+
+	if (_cpuKernelsEnabled or cudaEnabled()) {
+		// the CPU and CUDA kernels expect the decay amplitudes in a
+		// single array that is indexed [reflectivity][wave index][event index]
+		vector<complexT> decayAmps((size_t)2 * _nmbWavesReflMax * _nmbEvents, 0);
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+				for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt)
+					decayAmps[((size_t)iRefl * _nmbWavesReflMax + iWave) * _nmbEvents + iEvt] = _decayAmps->amps[iRefl][iEvt][iWave];
+#ifdef USE_CUDA
+		if (_cudaEnabled)
+			cuda::likelihoodInterface<cuda::complex<value_type> >::init
+				(reinterpret_cast<cuda::complex<value_type>*>(decayAmps.data()),
+				 decayAmps.size(), _nmbEvents, _nmbWavesRefl, false);
 #endif
+		if (_cpuKernelsEnabled) {
+			// the CPU kernels of this likelihood take over the reshuffled
+			// array without copying it; the decay amplitudes are only kept
+			// in the memory of the CPU kernels
+			_cpuKernels.close();
+			_cpuKernels.setNmbThreads(_nmbThreads);
+			if (not _cpuKernels.init(decayAmps, _nmbEvents, _nmbWavesRefl)) {
+				printErr << "could not initialize CPU kernels. Aborting..." << endl;
+				return false;
+			}
+			decayAmpStorage& storage = decayAmpsForWriting();
+			storage.amps[0].resize(extents[0][0]);
+			storage.amps[1].resize(extents[0][0]);
+		}
+	}
 
 	_initFinished = true;
 	return true;
 }
 
 
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::runMpiWorker() const
+{
+#ifdef USE_MPI
+	if (not _initFinished) {
+		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
+		return false;
+	}
+	if (not _mpiEnabled or _mpiComm.rank() == 0) {
+		printErr << "pwaLikelihood::runMpiWorker() has to be called by MPI processes with rank > 0. Aborting..." << endl;
+		return false;
+	}
+	printInfo << "MPI process " << _mpiComm.rank() << " is waiting for requests from rank 0" << endl;
+	boost::array<typename prodAmpsArrayType::index, 3> prodAmpsShape = {{ _rank, 2, _nmbWavesReflMax }};
+	prodAmpsArrayType                                  prodAmps(prodAmpsShape);
+	value_type                                         prodAmpFlat = 0;
+	while (true) {
+		int request = WORKER_STOP;
+		boost::mpi::broadcast(_mpiComm, request, 0);
+		if (request == WORKER_STOP)
+			break;
+		boost::mpi::broadcast(_mpiComm, reinterpret_cast<value_type*>(prodAmps.data()), 2 * prodAmps.num_elements(), 0);
+		boost::mpi::broadcast(_mpiComm, prodAmpFlat, 0);
+		switch (request) {
+			case WORKER_LOGLIKELIHOOD: {
+				value_type logLikelihood = 0;
+				sumLogLikelihood(prodAmps, prodAmpFlat, logLikelihood);
+				break;
+			}
+			case WORKER_LOGLIKELIHOODDERIV: {
+				value_type        logLikelihood  = 0;
+				value_type        derivativeFlat = 0;
+				prodAmpsArrayType derivatives(prodAmpsShape);
+				sumLogLikelihoodDeriv(prodAmps, prodAmpFlat, logLikelihood, derivatives, derivativeFlat);
+				break;
+			}
+			case WORKER_HESSIAN: {
+				vector<double> par(_nmbPars, 0);
+				copyToParArray(prodAmps, prodAmpFlat, par.data());
+				Hessian(par.data());
+				break;
+			}
+			case WORKER_HESSIANVECTOR: {
+				value_type        directionFlat = 0;
+				prodAmpsArrayType direction(prodAmpsShape);
+				boost::mpi::broadcast(_mpiComm, reinterpret_cast<value_type*>(direction.data()), 2 * direction.num_elements(), 0);
+				boost::mpi::broadcast(_mpiComm, directionFlat, 0);
+				value_type        productFlat = 0;
+				prodAmpsArrayType product(prodAmpsShape);
+				sumHessianVectorProduct(prodAmps, prodAmpFlat, direction, directionFlat, product, productFlat);
+				mpiSum(reinterpret_cast<value_type*>(product.data()), 2 * product.num_elements());
+				mpiSum(&productFlat, 1);
+				break;
+			}
+			default:
+				printErr << "unknown request " << request << " from MPI process with rank 0. Aborting..." << endl;
+				throw;
+		}
+	}
+	printInfo << "MPI process " << _mpiComm.rank() << " received stop request" << endl;
+	return true;
+#else
+	printErr << "ROOTPWA was compiled without MPI support. Aborting..." << endl;
+	return false;
+#endif
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::stopMpiWorkers() const
+{
+#ifdef USE_MPI
+	if (_mpiEnabled and _mpiComm.rank() == 0) {
+		int request = WORKER_STOP;
+		boost::mpi::broadcast(_mpiComm, request, 0);
+	}
+#endif
+}
+
+
+#ifdef USE_MPI
+template<typename complexT>
+void
+pwaLikelihood<complexT>::mpiSendRequest(const mpiRequestEnum     request,
+                                        const prodAmpsArrayType& prodAmps,
+                                        const value_type         prodAmpFlat) const
+{
+	int requestValue = request;
+	boost::mpi::broadcast(_mpiComm, requestValue, 0);
+	// the root process only reads from the buffers
+	boost::mpi::broadcast(_mpiComm, const_cast<value_type*>(reinterpret_cast<const value_type*>(prodAmps.data())),
+	                      2 * prodAmps.num_elements(), 0);
+	value_type prodAmpFlatValue = prodAmpFlat;
+	boost::mpi::broadcast(_mpiComm, prodAmpFlatValue, 0);
+}
+
+
+template<typename complexT>
+template<typename T>
+void
+pwaLikelihood<complexT>::mpiSum(T*                values,
+                                const std::size_t nmbValues) const
+{
+	vector<T> sums(nmbValues);
+	boost::mpi::all_reduce(_mpiComm, values, nmbValues, sums.data(), std::plus<T>());
+	copy(sums.begin(), sums.end(), values);
+}
+#endif
+
+
+template<typename complexT>
+size_t
+pwaLikelihood<complexT>::nmbEventsInBinning() const
+{
+	size_t nmbEvents = 0;
+	typedef map<string, pair<size_t, vector<size_t> > >::const_iterator it_type;
+	for (it_type it = _eventFileProperties.begin(); it != _eventFileProperties.end(); ++it)
+		nmbEvents += it->second.second.size();
+	return nmbEvents;
+}
+
+
+// the layouts of the decay amplitudes are the ones allocated in
+// prepareDecayAmps() and finishInit()
+template<typename complexT>
+size_t
+pwaLikelihood<complexT>::decayAmpMemoryUsage(const size_t nmbEvents) const
+{
+	size_t nmbBytes = 0;
+	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+		if (_simdEnabled) {
+			// the structure-of-arrays layout pads the events to full blocks
+			const size_t nmbEventsPerBlock = simdDecayAmpArray<value_type>::nmbEventsPerBlock;
+			const size_t nmbEventsPadded   = ((nmbEvents + nmbEventsPerBlock - 1) / nmbEventsPerBlock) * nmbEventsPerBlock;
+			nmbBytes += nmbEventsPadded * _nmbWavesRefl[iRefl] * 2 * ((_floatStorage) ? sizeof(float) : sizeof(value_type));
+		} else
+			nmbBytes += nmbEvents * _nmbWavesRefl[iRefl] * ((_floatStorage) ? sizeof(std::complex<float>) : sizeof(complexT));
+	}
+	// the CPU and CUDA kernels get a copy in [reflectivity][wave index][event index]
+	// layout, which exists at the same time as the original one in finishInit()
+	if (_cpuKernelsEnabled or cudaEnabled())
+		nmbBytes += 2 * _nmbWavesReflMax * nmbEvents * sizeof(complexT);
+	// cached coherent sums and their compensations
+	if (_incrementalEnabled)
+		nmbBytes += 2 * nmbEvents * _rank * 2 * sizeof(complexT);
+	return nmbBytes;
+}
+
+
 template<typename complexT>
 bool
 pwaLikelihood<complexT>::setOnTheFlyBinning(const map<string, pair<double, double> >& binningMap,
@@ -1342,29 +3104,42 @@ pwaLikelihood<complexT>::setOnTheFlyBinning(const map<string, pair<double, doubl
 			return false;
 		}
 		const string& evtHash = evtMeta->contentHash();
-		map<string, double> binningVariables;
-		typedef map<string, pair<double, double> >::const_iterator it_type;
-		for(it_type iterator = binningMap.begin(); iterator != binningMap.end(); ++iterator) {
-			const string& additionalVar = iterator->first;
-			binningVariables[additionalVar] = 0.;
-			evtTree->SetBranchAddress(additionalVar.c_str(), &binningVariables[additionalVar]);
-		}
 		vector<size_t> eventIndices;
-		for (long eventIndex = 0; eventIndex < evtTree->GetEntriesFast(); ++eventIndex) {
-			evtTree->GetEntry(eventIndex);
-			bool useEvent = true;
+		bool eventsSelected = false;
+		if (not _binIndexDirectory.empty()) {
+			vector<string> variables;
+			for (map<string, pair<double, double> >::const_iterator elem = binningMap.begin(); elem != binningMap.end(); ++elem)
+				variables.push_back(elem->first);
+			const eventBinIndex* binIndex = eventBinIndex::getBinIndex(*evtMeta, _binIndexDirectory, variables);
+			if (binIndex and binIndex->nmbEvents() == evtTree->GetEntries())
+				eventsSelected = binIndex->entriesInBin(binningMap, eventIndices);
+			if (not eventsSelected)
+				printWarn << "could not use bin index of event file. scanning the event tree." << endl;
+		}
+		if (not eventsSelected) {
+			map<string, double> binningVariables;
+			typedef map<string, pair<double, double> >::const_iterator it_type;
 			for(it_type iterator = binningMap.begin(); iterator != binningMap.end(); ++iterator) {
 				const string& additionalVar = iterator->first;
-				const double& lowerBound = iterator->second.first;
-				const double& upperBound = iterator->second.second;
-				const double& binVarValue = binningVariables[additionalVar];
-				if (binVarValue < lowerBound or binVarValue >= upperBound) {
-					useEvent = false;
-					break;
-				}
+				binningVariables[additionalVar] = 0.;
+				evtTree->SetBranchAddress(additionalVar.c_str(), &binningVariables[additionalVar]);
 			}
-			if (useEvent) {
-				eventIndices.push_back(eventIndex);
+			for (long eventIndex = 0; eventIndex < evtTree->GetEntriesFast(); ++eventIndex) {
+				evtTree->GetEntry(eventIndex);
+				bool useEvent = true;
+				for(it_type iterator = binningMap.begin(); iterator != binningMap.end(); ++iterator) {
+					const string& additionalVar = iterator->first;
+					const double& lowerBound = iterator->second.first;
+					const double& upperBound = iterator->second.second;
+					const double& binVarValue = binningVariables[additionalVar];
+					if (binVarValue < lowerBound or binVarValue >= upperBound) {
+						useEvent = false;
+						break;
+					}
+				}
+				if (useEvent) {
+					eventIndices.push_back(eventIndex);
+				}
 			}
 		}
 		printInfo << "found " << eventIndices.size() << " of " << evtMeta->eventTree()->GetEntriesFast() << " in the event file to be in given bin." << endl;
@@ -1376,20 +3151,36 @@ pwaLikelihood<complexT>::setOnTheFlyBinning(const map<string, pair<double, doubl
 
 template<typename complexT>
 bool
-pwaLikelihood<complexT>::readWaveList(const vector<waveDescThresType>& waveDescThres)
+pwaLikelihood<complexT>::getWaveReflThres(const vector<waveDescThresType>& waveDescThres,
+                                          vector<waveReflThresType>&       waveReflThres)
 {
-	vector<string> waveNames[2];
-	vector<double> waveThres[2];
+	waveReflThres.clear();
+	waveReflThres.reserve(waveDescThres.size());
 	for (unsigned int i = 0; i < waveDescThres.size(); ++i) {
 		const waveDescription& waveDesc = boost::get<1>(waveDescThres[i]);
 		isobarDecayTopologyPtr decayTopo;
-		waveDesc.constructDecayTopology(decayTopo);
+		if (not waveDesc.constructDecayTopology(decayTopo)) {
+			printErr << "could not construct decay topology for wave '" << boost::get<0>(waveDescThres[i]) << "'." << endl;
+			return false;
+		}
 		isobarDecayVertexPtr   decayVertex = decayTopo->XIsobarDecayVertex();
 		particlePtr            X           = decayVertex->parent();
+		waveReflThres.push_back(waveReflThresType(boost::get<0>(waveDescThres[i]), X->reflectivity(), boost::get<2>(waveDescThres[i])));
+	}
+	return true;
+}
 
-		const int    refl      = X->reflectivity();
-		const string waveName  = boost::get<0>(waveDescThres[i]);
-		const double threshold = boost::get<2>(waveDescThres[i]);
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::readWaveList(const vector<waveReflThresType>& waveReflThres)
+{
+	vector<string> waveNames[2];
+	vector<double> waveThres[2];
+	for (unsigned int i = 0; i < waveReflThres.size(); ++i) {
+		const int    refl      = boost::get<1>(waveReflThres[i]);
+		const string waveName  = boost::get<0>(waveReflThres[i]);
+		const double threshold = boost::get<2>(waveReflThres[i]);
 
 		assert(refl == -1 || refl == +1);
 		if (refl > 0) {
@@ -1508,6 +3299,32 @@ pwaLikelihood<complexT>::reorderIntegralMatrix(const ampIntegralMatrix& integral
 }
 
 
+// returns integral matrix reordered according to _waveNames array; the
+// wave indices are looked up once and the elements are gathered from
+// the packed upper triangle without a full copy of the matrix
+template<typename complexT>
+void
+pwaLikelihood<complexT>::reorderIntegralMatrix(const ampIntegralPackedMatrix& integral,
+                                               const unsigned long            nmbEvents,
+                                               normMatrixArrayType&           reorderedMatrix) const
+{
+	reorderedMatrix.resize(extents[2][_nmbWavesReflMax][2][_nmbWavesReflMax]);
+	const double norm = 1. / nmbEvents;
+	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+		vector<unsigned int> integralIndices(_nmbWavesRefl[iRefl]);
+		for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+			integralIndices[iWave] = integral.waveIndex(_waveNames[iRefl][iWave]);
+		for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+			for (unsigned int jWave = 0; jWave < _nmbWavesRefl[iRefl]; ++jWave) {
+				const unsigned int    i   = integralIndices[iWave];
+				const unsigned int    j   = integralIndices[jWave];
+				const complex<double> val = norm * ((j >= i) ? integral.upperElement(i, j) : conj(integral.upperElement(j, i)));
+				reorderedMatrix[iRefl][iWave][iRefl][jWave] = complexT(val.real(), val.imag());
+			}
+	}
+}
+
+
 template<typename complexT>
 void
 pwaLikelihood<complexT>::getIntegralMatrices(complexMatrix&  normMatrix,
@@ -1603,8 +3420,13 @@ template<typename complexT>
 void
 pwaLikelihood<complexT>::clear()
 {
-	_decayAmps[0].resize(extents[0][0]);
-	_decayAmps[1].resize(extents[0][0]);
+	// the decay amplitudes are released when the last copy of the
+	// likelihood that shares them is cleared
+	_decayAmps.reset(new decayAmpStorage());
+	_cpuKernels.close();
+	_coherentSums.clear();
+	_coherentSumsCompensation.clear();
+	_coherentSumsValid = false;
 }
 
 
@@ -1670,7 +3492,8 @@ ostream&
 pwaLikelihood<complexT>::print(ostream& out) const
 {
 	out << "pwaLikelihood parameters:" << endl
-	    << "number of events ........................ " << _nmbEvents         << endl
+	    << "number of events ........................ " << _nmbEventsTotal    << endl
+	    << "number of events in this process ........ " << _nmbEvents         << endl
 	    << "rank .................................... " << _rank              << endl
 	    << "number of waves ......................... " << _nmbWaves          << endl
 	    << "number of positive reflectivity waves ... " << _nmbWavesRefl[1]   << endl
@@ -1681,6 +3504,15 @@ pwaLikelihood<complexT>::print(ostream& out) const
 #ifdef USE_CUDA
 	    << "use CUDA kernels ........................ " << _cudaEnabled       << endl
 #endif
+	    << "use SIMD event loops .................... " << _simdEnabled       << endl
+	    << "store amplitudes in single precision .... " << _floatStorage      << endl
+	    << "use CPU kernels ......................... " << _cpuKernelsEnabled << endl
+	    << "use MPI ................................. " << mpiEnabled()       << endl
+	    << "number of MPI processes ................. " << mpiSize()          << endl
+	    << "number of threads ....................... " << _nmbThreads        << endl
+	    << "use incremental updates ................. " << _incrementalEnabled << endl
+	    << "amplitude cache directory ............... '" << _ampCacheDirectory << "'" << endl
+	    << "bin index directory ..................... '" << _binIndexDirectory << "'" << endl
 	    << "use normalized amplitudes ............... " << _useNormalizedAmps << endl
 	    << "list of waves: " << endl;
 	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
@@ -1700,7 +3532,8 @@ template<typename complexT>
 ostream&
 pwaLikelihood<complexT>::printFuncInfo(ostream& out) const
 {
-	const string funcNames[NMB_FUNCTIONCALLENUM] = {"FdF", "Gradient", "DoEval", "DoDerivative", "Hessian"};
+	const string funcNames[NMB_FUNCTIONCALLENUM] = {"FdF", "Gradient", "DoEval", "DoDerivative", "Hessian",
+	                                                "evaluateBatch", "evaluateGradientBatch"};
 	for (unsigned int i = 0; i < NMB_FUNCTIONCALLENUM; ++i)
 		if (_funcCallInfo[i].nmbCalls > 0)
 			out << "    " << _funcCallInfo[i].nmbCalls
@@ -42,13 +42,19 @@
 
 #define BOOST_DISABLE_ASSERTS
 #include "boost/multi_array.hpp"
+#include "boost/shared_ptr.hpp"
 #include "boost/tuple/tuple.hpp"
+#ifdef USE_MPI
+#include "boost/mpi/communicator.hpp"
+#endif
 
 #include "Math/IFunction.h"
 #include "TMatrixT.h"
 #include "TVectorT.h"
 
 #include "ampIntegralMatrix.h"
+#include "cpuLikelihoodInterface.h"
+#include "simdDecayAmpArray.hpp"
 #include "sumAccumulators.hpp"
 
 
@@ -58,6 +64,8 @@ class TString;
 namespace rpwa {
 
 
+	class ampIntegralPackedMatrix;
+	class amplitudeMatrixMetadata;
 	class complexMatrix;
 	class eventMetadata;
 
@@ -75,23 +83,27 @@ namespace rpwa {
 		typedef boost::multi_array<boost::tuples::tuple<int, int>,            3> ampToParMapType;       // array for mapping of amplitudes to parameters
 		typedef boost::multi_array<complexT,                                  3> prodAmpsArrayType;     // array for production and decay amplitudes
 		typedef boost::multi_array<complexT,                                  2> decayAmpsArrayType;    // with memory layout to save memory
+		typedef boost::multi_array<std::complex<float>,                       2> decayAmpsFloatArrayType;  // same in single precision
 		typedef boost::multi_array<complexT,                                  4> normMatrixArrayType;   // array for normalization matrices
 		typedef boost::multi_array<value_type,                                2> phaseSpaceIntType;     // array for phase space integrals
 		typedef boost::multi_array<bool,                                      2> waveAmpAddedArrayType; // array for wave amplitudes read
 		typedef std::map<std::string, std::pair<unsigned int, unsigned int>    > waveParamsType;        // map wave names to reflectivity and index in reflectivity
 		typedef boost::tuples::tuple<std::string, rpwa::waveDescription, double> waveDescThresType;     // tuple for wave name, wave description and threshold
+		typedef boost::tuples::tuple<std::string, int, double>                   waveReflThresType;     // tuple for wave name, reflectivity and threshold
 
 
 	public:
 
 		// enum for function call counters
 		enum functionCallEnum {
-			FDF                  = 0,
-			GRADIENT             = 1,
-			DOEVAL               = 2,
-			DODERIVATIVE         = 3,
-			HESSIAN              = 4,
-			NMB_FUNCTIONCALLENUM = 5
+			FDF                   = 0,
+			GRADIENT              = 1,
+			DOEVAL                = 2,
+			DODERIVATIVE          = 3,
+			HESSIAN               = 4,
+			EVALUATEBATCH         = 5,
+			EVALUATEGRADIENTBATCH = 6,
+			NMB_FUNCTIONCALLENUM  = 7
 		};
 
 		struct functionCallInfo {
@@ -167,8 +179,29 @@ namespace rpwa {
 		virtual double DoDerivative(const double*      par,
 		                            const unsigned int derivativeIndex) const;
 
+		// the batched evaluation loops once over the events for all
+		// points. the batched event loops always calculate the full sums,
+		// i.e. they neither use nor modify the cached coherent sums of the
+		// incremental updates. they exist only for decay amplitudes in the
+		// default [event][wave] layout in double or single precision; with
+		// SIMD event loops, CPU or CUDA kernels, or MPI the points are
+		// evaluated one after the other by DoEval() or FdF() instead
+		/// calculates function values at nmbPoints points at once; the parameters of the i-th point are pars[i * nmbPars(), (i + 1) * nmbPars())
+		void evaluateBatch        (const double*     pars,
+		                           const std::size_t nmbPoints,
+		                           double*           values) const;
+		/// calculates function values and gradients at nmbPoints points at once; the gradient of the i-th point is written to gradients[i * nmbPars(), (i + 1) * nmbPars())
+		void evaluateGradientBatch(const double*     pars,
+		                           const std::size_t nmbPoints,
+		                           double*           values,
+		                           double*           gradients) const;
+
 		/// calculates Hessian of function at point defined by par
 		TMatrixT<double> Hessian(const double* par) const;
+		/// calculates product of Hessian at point defined by par with vector vec without building the Hessian
+		void HessianVectorProduct(const double* par,
+		                          const double* vec,
+		                          double*       product) const;
 		/// calculates eigenvectors/-values of Hessian
 		std::vector<std::pair<TVectorT<double>, double> > HessianEigenVectors(const TMatrixT<double>& hessian) const;
 
@@ -180,7 +213,9 @@ namespace rpwa {
 		/// flips the signs of the paramaters according to conventions (amplitudes of each anchor wave and the flat wave are real and positive)
 		std::vector<double> CorrectParamSigns(const double* par) const;
 
-		unsigned int                     nmbEvents   ()                                    const { return _nmbEvents;               }  ///< returns number of events that enter in the likelihood
+		unsigned int                     nmbEvents   ()                                    const { return _nmbEventsTotal;          }  ///< returns number of events that enter in the likelihood
+		std::size_t                      nmbEventsInBinning()                              const;                                      ///< returns number of events selected by setOnTheFlyBinning(), i.e. before the decay amplitudes are loaded
+		std::size_t                      decayAmpMemoryUsage(const std::size_t nmbEvents) const;                                   ///< returns the peak memory in bytes needed by the decay amplitudes of nmbEvents events with the current wave set and storage options, including the copies for the CPU or CUDA kernels and the incremental updates
 		unsigned int                     rank        ()                                    const { return _rank;                    }  ///< returns rank of spin density matrix
 		unsigned int                     nmbWaves    (const int          reflectivity = 0) const;                                      ///< returns total number of waves (reflectivity == 0) or number or number of waves with positive/negative reflectivity; flat wave is not counted!
 		unsigned int                     nmbPars     ()                                    const { return _nmbPars;                 }  ///< returns total number of parameters
@@ -200,26 +235,62 @@ namespace rpwa {
 		// modifiers
 		void          enableCuda       (const bool      enableCuda = true);
 		bool          cudaEnabled      () const;
+		void          enableSimd       (const bool      enableSimd = true);  ///< has to be called before the first amplitude is added
+		bool          simdEnabled      () const                            { return _simdEnabled;            }
+		void          enableFloatStorage(const bool     enableFloat = true);  ///< stores decay amplitudes in single precision; has to be called before the first amplitude is added
+		bool          floatStorageEnabled() const                          { return _floatStorage;           }
+		bool          enableCpuKernels (const bool      enableCpu  = true);  ///< uses the CPU implementation of the CUDA kernels; has to be called before finishInit()
+		bool          cpuKernelsEnabled() const                            { return _cpuKernelsEnabled;      }
+		void          enableMpi        (const bool      enableMpi  = true);  ///< distributes the events over the MPI processes; has to be called before the first amplitude is added
+		bool          mpiEnabled       () const;
+		unsigned int  mpiRank          () const;  ///< returns rank of this process in the MPI communicator; 0 if MPI is not enabled
+		unsigned int  mpiSize          () const;  ///< returns number of MPI processes; 1 if MPI is not enabled
+		void          enableIncrementalUpdates(const bool         enableIncremental         = true,
+		                                       const unsigned int maxNmbIncrementalUpdates = 100);  ///< caches the coherent sums of each event and updates only the terms of changed production amplitudes in DoEval(); after maxNmbIncrementalUpdates updates the sums are recalculated
+		bool          incrementalUpdatesEnabled() const                    { return _incrementalEnabled;     }
+		void          setAmplitudeCacheDirectory(const std::string& cacheDirectory) { _ampCacheDirectory = cacheDirectory; }  ///< if not empty, decay amplitudes are read from memory-mapped cache files in this directory, which are created on first use; has to be called before the first amplitude is added
+		const std::string& amplitudeCacheDirectory() const                { return _ampCacheDirectory;      }
+		void          setBinIndexDirectory(const std::string& indexDirectory) { _binIndexDirectory = indexDirectory; }  ///< if not empty, setOnTheFlyBinning() selects the events with the bin indices in this directory, which are created on first use, instead of scanning the event trees
+		const std::string& binIndexDirectory() const                      { return _binIndexDirectory;      }
+		void          setNmbThreads    (const unsigned int nmbThreads = 0);  ///< 0 uses the number of threads given by the OpenMP runtime
+		unsigned int  nmbThreads       () const                            { return _nmbThreads;             }
 		void          useNormalizedAmps(const bool      useNorm    = true) { _useNormalizedAmps = useNorm;   }
 		void          setPriorType     (const priorEnum priorType  = FLAT) { _priorType         = priorType; }
 		priorEnum     priorType        () const                            { return _priorType;              }
 		void          setCauchyWidth   (const double    cauchyWidth)       { _cauchyWidth = cauchyWidth;     }
 		double        cauchyWidth      () const                            { return _cauchyWidth;            }
 		static void   setQuiet         (const bool      flag       = true) { _debug             = !flag;     }
+		static bool   debug            ()                                  { return _debug;                  }
 
 		// operations
 		bool init(const std::vector<waveDescThresType>& waveDescThres,
 		          const unsigned int                    rank = 1,
 		          const double                          massBinCenter = 0.);  ///< prepares all internal data structures
+		bool init(const std::vector<waveReflThresType>& waveReflThres,
+		          const unsigned int                    rank = 1,
+		          const double                          massBinCenter = 0.);  ///< same as above, but with reflectivities already extracted from the wave descriptions
+
+		static bool getWaveReflThres(const std::vector<waveDescThresType>& waveDescThres,
+		                             std::vector<waveReflThresType>&       waveReflThres);  ///< constructs the decay topologies once to get the reflectivities of the waves
 
 		bool addNormIntegral(const rpwa::ampIntegralMatrix& normMatrix);
+		bool addNormIntegral(const rpwa::ampIntegralPackedMatrix& normMatrix);  ///< gathers the matrix elements directly from the packed upper triangle
 
 		bool addAccIntegral(rpwa::ampIntegralMatrix& accMatrix, const unsigned int accEventsOverride = 0);
+		bool addAccIntegral(const rpwa::ampIntegralPackedMatrix& accMatrix, const unsigned int accEventsOverride = 0);  ///< gathers the matrix elements directly from the packed upper triangle
 
 		bool addAmplitude(const std::vector<const rpwa::amplitudeMetadata*>& meta);
+		bool addAmplitudeMatrix(const std::vector<const rpwa::amplitudeMatrixMetadata*>& meta);  ///< adds the decay amplitudes of all waves of the wave list contained in the amplitude matrices
 
 		bool finishInit();
 
+		// in MPI mode only the process with rank 0 drives the minimizer;
+		// all other processes have to call runMpiWorker() after
+		// finishInit(), which contributes their events to the likelihood
+		// sums requested by rank 0 until rank 0 calls stopMpiWorkers()
+		bool runMpiWorker  () const;
+		void stopMpiWorkers() const;
+
 		bool setOnTheFlyBinning(const std::map<std::string, std::pair<double, double> >& binningMap,
 		                        const std::vector<const eventMetadata*>&                 evtMeta);
 
@@ -243,16 +314,194 @@ namespace rpwa {
 
 	private:
 
+		// requests sent from MPI process with rank 0 to the workers
+		enum mpiRequestEnum {
+			WORKER_STOP               = 0,
+			WORKER_LOGLIKELIHOOD      = 1,
+			WORKER_LOGLIKELIHOODDERIV = 2,
+			WORKER_HESSIAN            = 3,
+			WORKER_HESSIANVECTOR      = 4
+		};
+
+		// second derivatives of the prior w.r.t. real and imaginary part of a production amplitude
+		struct priorHessianType {
+			double RR;
+			double RI;
+			double II;
+		};
+
 		void clear();
 
 		// helper functions
-		bool readWaveList      (const std::vector<waveDescThresType>& waveDescThres);  ///< reads wave names and thresholds from wave list file
+		bool readWaveList      (const std::vector<waveReflThresType>& waveReflThres);  ///< sets up wave names and thresholds
 		bool buildParDataStruct(const unsigned int rank,
 		                        const double       massBinCenter);                     ///< builds parameter data structures
 
 		void reorderIntegralMatrix(const rpwa::ampIntegralMatrix& integral,
 		                           normMatrixArrayType&           reorderedMatrix) const;
+		void reorderIntegralMatrix(const rpwa::ampIntegralPackedMatrix& integral,
+		                           const unsigned long                  nmbEvents,
+		                           normMatrixArrayType&                 reorderedMatrix) const;  ///< elements are divided by nmbEvents
+
+		// sums up the real-data term of the log likelihood (and its derivatives) over all events;
+		// in MPI mode the sums of all processes are combined
+		void sumLogLikelihood     (const prodAmpsArrayType& prodAmps,
+		                           const value_type         prodAmpFlat,
+		                           value_type&              logLikelihood) const;
+		void sumLogLikelihoodDeriv(const prodAmpsArrayType& prodAmps,
+		                           const value_type         prodAmpFlat,
+		                           value_type&              logLikelihood,
+		                           prodAmpsArrayType&       derivatives,
+		                           value_type&              derivativeFlat) const;
+		// same as above for several sets of production amplitudes, which are all
+		// processed in a single loop over the events; not used in MPI mode
+		void sumLogLikelihoodBatch     (const std::vector<prodAmpsArrayType>& prodAmps,
+		                                const std::vector<value_type>&        prodAmpFlat,
+		                                std::vector<value_type>&              logLikelihoods) const;
+		void sumLogLikelihoodDerivBatch(const std::vector<prodAmpsArrayType>& prodAmps,
+		                                const std::vector<value_type>&        prodAmpFlat,
+		                                std::vector<value_type>&              logLikelihoods,
+		                                std::vector<prodAmpsArrayType>&       derivatives,
+		                                std::vector<value_type>&              derivativeFlat) const;
+		// same as sumLogLikelihoodLocal() using the cached coherent sums of each event; only the
+		// terms of the production amplitudes that changed since the last call are recalculated
+		void sumLogLikelihoodIncremental(const prodAmpsArrayType& prodAmps,
+		                                 const value_type         prodAmpFlat,
+		                                 value_type&              logLikelihood) const;
+		// recalculates the cached coherent sums of the events in [evtBegin, evtEnd) or adds the
+		// corrections for the changed production amplitudes to them; decayAmps[iRefl](iEvt, iWave)
+		// returns the decay amplitudes without going through decayAmp()
+		template<typename decayAmpsT>
+		void updateCoherentSums(const decayAmpsT                                                               decayAmps[2],
+		                        const prodAmpsArrayType&                                                       prodAmps,
+		                        const std::vector<boost::tuples::tuple<unsigned int, unsigned int, unsigned int> >& changedAmps,
+		                        const std::vector<complexT>&                                                   deltaAmps,
+		                        const bool                                                                     recalculate,
+		                        const unsigned int                                                             evtBegin,
+		                        const unsigned int                                                             evtEnd) const;
+		// loops over the events of this process and sums up the real-data term of the log likelihood
+		// (and its derivatives); events are processed in chunks of fixed size, which are distributed
+		// over the threads; the partial sums of the chunks are added in fixed order, so that the
+		// result does not depend on the number of threads
+		void sumLogLikelihoodLocal     (const prodAmpsArrayType& prodAmps,
+		                                const value_type         prodAmpFlat,
+		                                value_type&              logLikelihood) const;
+		void sumLogLikelihoodDerivLocal(const prodAmpsArrayType& prodAmps,
+		                                const value_type         prodAmpFlat,
+		                                value_type&              logLikelihood,
+		                                prodAmpsArrayType&       derivatives,
+		                                value_type&              derivativeFlat) const;
+		// normalization term and prior of the log likelihood and their contributions to the derivatives
+		value_type normalization        (const prodAmpsArrayType& prodAmps,
+		                                 const value_type         prodAmpFlat) const;
+		void       addNormalizationDeriv(const prodAmpsArrayType& prodAmps,
+		                                 const value_type         prodAmpFlat,
+		                                 prodAmpsArrayType&       derivatives,
+		                                 value_type&              derivativeFlat) const;
+		double     prior                (const prodAmpsArrayType& prodAmps) const;
+		void       addPriorDeriv        (const prodAmpsArrayType& prodAmps,
+		                                 prodAmpsArrayType&       derivatives) const;
+		// loops over the events of this process and sums up the terms of the second derivatives of
+		// the real-data term of the log likelihood; only the upper triangles of the symmetric
+		// matrices are stored (see pwaLikelihood.cc for the layout); the chunks are processed in
+		// parallel with separate partial sums for each thread
+		void sumHessian             (const prodAmpsArrayType&  prodAmps,
+		                             const value_type          prodAmpFlat,
+		                             std::vector<value_type>&  hessianSums) const;
+		void sumHessianChunk        (const prodAmpsArrayType&  prodAmps,
+		                             const value_type          prodAmpFlat,
+		                             const unsigned int        evtBegin,
+		                             const unsigned int        evtEnd,
+		                             value_type*               hessianSums) const;
+		// same for the product of the second derivatives with a vector; the Hessian is not built
+		void sumHessianVectorProduct(const prodAmpsArrayType&  prodAmps,
+		                             const value_type          prodAmpFlat,
+		                             const prodAmpsArrayType&  direction,
+		                             const value_type          directionFlat,
+		                             prodAmpsArrayType&        product,
+		                             value_type&               productFlat) const;
+		priorHessianType priorHessianDiag(const complexT& prodAmp) const;  ///< second derivatives of the prior w.r.t. a production amplitude
+		/// index of production amplitude in the vectors used by sumHessian()
+		unsigned int hessianAmpIndex(const unsigned int iRank,
+		                             const unsigned int iRefl,
+		                             const unsigned int iWave) const
+		{ return iRank * (_nmbWavesRefl[0] + _nmbWavesRefl[1]) + iRefl * _nmbWavesRefl[0] + iWave; }
+	#ifdef USE_MPI
+		void mpiSendRequest(const mpiRequestEnum     request,
+		                    const prodAmpsArrayType& prodAmps,
+		                    const value_type         prodAmpFlat) const;  ///< sends request and production amplitudes from rank 0 to the workers
+		template<typename T>
+		void mpiSum(T* values, const std::size_t nmbValues) const;  ///< replaces values by their sum over all MPI processes
+	#endif
 
+		typedef boost::accumulators::accumulator_set
+		  <value_type, boost::accumulators::stats
+			<boost::accumulators::tag::sum(boost::accumulators::compensated)> > valueAccType;
+		typedef boost::accumulators::accumulator_set
+		  <complexT, boost::accumulators::stats
+			<boost::accumulators::tag::sum(boost::accumulators::compensated)> > complexAccType;
+
+		// event loops over the events [evtBegin, evtEnd) of a chunk for the different
+		// storage formats of the decay amplitudes; independent of the type used to store
+		// the decay amplitudes all sums are calculated with value_type precision
+		template<typename ampT>
+		void sumLogLikelihoodScalar     (const boost::multi_array<ampT, 2>*         decayAmps,
+		                                 const prodAmpsArrayType&                   prodAmps,
+		                                 const value_type                           prodAmpFlat,
+		                                 const unsigned int                         evtBegin,
+		                                 const unsigned int                         evtEnd,
+		                                 valueAccType&                              logLikelihoodAcc) const;
+		template<typename ampT>
+		void sumLogLikelihoodDerivScalar(const boost::multi_array<ampT, 2>*         decayAmps,
+		                                 const prodAmpsArrayType&                   prodAmps,
+		                                 const value_type                           prodAmpFlat,
+		                                 const unsigned int                         evtBegin,
+		                                 const unsigned int                         evtEnd,
+		                                 valueAccType&                              logLikelihoodAcc,
+		                                 boost::multi_array<complexAccType, 3>&     derivativesAcc,
+		                                 valueAccType&                              derivativeFlatAcc) const;
+		// same for several sets of production amplitudes; the decay amplitudes of each
+		// event are read only once and then used for all sets
+		template<typename ampT>
+		void sumLogLikelihoodBatchScalar     (const boost::multi_array<ampT, 2>*                  decayAmps,
+		                                      const std::vector<prodAmpsArrayType>&               prodAmps,
+		                                      const std::vector<value_type>&                      prodAmpFlat,
+		                                      const unsigned int                                  evtBegin,
+		                                      const unsigned int                                  evtEnd,
+		                                      std::vector<valueAccType>&                          logLikelihoodAcc) const;
+		template<typename ampT>
+		void sumLogLikelihoodDerivBatchScalar(const boost::multi_array<ampT, 2>*                  decayAmps,
+		                                      const std::vector<prodAmpsArrayType>&               prodAmps,
+		                                      const std::vector<value_type>&                      prodAmpFlat,
+		                                      const unsigned int                                  evtBegin,
+		                                      const unsigned int                                  evtEnd,
+		                                      std::vector<valueAccType>&                          logLikelihoodAcc,
+		                                      std::vector<boost::multi_array<complexAccType, 3> >& derivativesAcc,
+		                                      std::vector<valueAccType>&                          derivativeFlatAcc) const;
+		// same using the decay amplitudes in structure-of-arrays layout; the coherent sums
+		// are calculated for a whole block of events at once and only the sums over the
+		// blocks are compensated
+		template<typename storageT>
+		void sumLogLikelihoodSimd       (const rpwa::simdDecayAmpArray<storageT>*   decayAmps,
+		                                 const prodAmpsArrayType&                   prodAmps,
+		                                 const value_type                           prodAmpFlat,
+		                                 const unsigned int                         evtBegin,
+		                                 const unsigned int                         evtEnd,
+		                                 valueAccType&                              logLikelihoodAcc) const;
+		template<typename storageT>
+		void sumLogLikelihoodDerivSimd  (const rpwa::simdDecayAmpArray<storageT>*   decayAmps,
+		                                 const prodAmpsArrayType&                   prodAmps,
+		                                 const value_type                           prodAmpFlat,
+		                                 const unsigned int                         evtBegin,
+		                                 const unsigned int                         evtEnd,
+		                                 valueAccType&                              logLikelihoodAcc,
+		                                 boost::multi_array<complexAccType, 3>&     derivativesAcc,
+		                                 valueAccType&                              derivativeFlatAcc) const;
+
+		/// returns decay amplitude independent of the memory layout
+		complexT decayAmp(const unsigned int iRefl,
+		                  const unsigned int iEvt,
+		                  const unsigned int iWave) const;
 	public:
 
 		void copyFromParArray(const double*      inPar,              // input parameter array
@@ -266,7 +515,8 @@ namespace rpwa {
 
 		void resetFuncCallInfo() const;
 
-		unsigned int _nmbEvents;        // number of events
+		unsigned int _nmbEvents;        // number of events stored in this process
+		unsigned int _nmbEventsTotal;   // total number of events (summed over all MPI processes)
 		unsigned int _rank;             // rank of spin density matrix
 		unsigned int _nmbWaves;         // number of waves
 		unsigned int _nmbWavesRefl[2];  // number of negative (= 0) and positive (= 1) reflectivity waves
@@ -281,6 +531,16 @@ namespace rpwa {
 	#ifdef USE_CUDA
 		bool                _cudaEnabled;        // if true CUDA kernels are used for some calculations
 	#endif
+		bool                _simdEnabled;        // if true decay amplitudes are stored and processed in structure-of-arrays layout
+		bool                _floatStorage;       // if true decay amplitudes are stored in single precision
+		bool                _cpuKernelsEnabled;  // if true the CPU implementation of the CUDA kernels is used
+	#ifdef USE_MPI
+		bool                     _mpiEnabled;  // if true events are distributed over the MPI processes
+		boost::mpi::communicator _mpiComm;     // communicator of the MPI processes
+	#endif
+		std::string         _ampCacheDirectory;  // directory of the amplitude cache files; empty if no cache is used
+		std::string         _binIndexDirectory;  // directory of the bin index files of the event files; empty if the event trees are scanned
+		unsigned int        _nmbThreads;         // number of threads used in the event loops
 		bool                _useNormalizedAmps;  // if true normalized amplitudes are used
 		priorEnum           _priorType;          // which prior to apply to parameters
 		double              _cauchyWidth;        // width for the half-Cauchy prior
@@ -300,11 +560,47 @@ namespace rpwa {
 		                                                // array; negative indices mean that the parameter
 		                                                // is not existing due to rank restrictions
 
-		decayAmpsArrayType _decayAmps[2];  // precalculated decay amplitudes [event index][reflectivity][wave index]
+		// the decay amplitudes are not modified after finishInit() and
+		// are shared by all copies of the likelihood, so that Clone()
+		// does not copy them
+		struct decayAmpStorage {
+			decayAmpsArrayType                  amps[2];           // precalculated decay amplitudes [reflectivity][event index][wave index]
+			rpwa::simdDecayAmpArray<value_type> ampsSimd[2];       // precalculated decay amplitudes in structure-of-arrays layout, if SIMD is enabled [reflectivity]
+			decayAmpsFloatArrayType             ampsFloat[2];      // same as amps in single precision, if float storage is enabled
+			rpwa::simdDecayAmpArray<float>      ampsSimdFloat[2];  // same as ampsSimd in single precision, if float storage is enabled
+		};
+		decayAmpStorage& decayAmpsForWriting();  ///< returns decay amplitudes of this likelihood, copies them first if they are shared with other copies
+
+		bool prepareDecayAmps(const std::vector<const std::vector<rpwa::eventMetadata>*>& evtMetas,
+		                      const std::vector<std::size_t>&                             nmbEntries,
+		                      std::size_t&                                                totalEvents,
+		                      std::size_t&                                                evtBegin,
+		                      std::size_t&                                                evtEnd);  ///< checks the event files of added amplitudes, counts the events to load and allocates the decay amplitude arrays
+		bool storeDecayAmp(decayAmpStorage&   decayAmps,
+		                   const unsigned int refl,
+		                   const unsigned int waveIndex,
+		                   const unsigned int iEvt,
+		                   complexT           amp) const;  ///< normalizes a decay amplitude (if requested) and stores it
+
+		boost::shared_ptr<decayAmpStorage> _decayAmps;  // precalculated decay amplitudes
+
+		// the CPU kernels hold the decay amplitudes in their own layout
+		// instead of _decayAmps; copies of the likelihood share the
+		// amplitudes, but have their own number of threads and kernel timer
+		rpwa::cpu::likelihoodInterface<complexT> _cpuKernels;
 
 		mutable std::vector<double> _parCache;    // parameter cache for derivative calc.
 		mutable std::vector<double> _derivCache;  // cache for derivatives
 
+		// cache for incremental updates of the real-data term of the log likelihood
+		bool                          _incrementalEnabled;        // if true DoEval() updates the cached coherent sums
+		unsigned int                  _maxNmbIncrementalUpdates;  // number of incremental updates after which the coherent sums are recalculated
+		mutable bool                  _coherentSumsValid;         // indicates whether the cached coherent sums belong to _coherentSumsProdAmps
+		mutable unsigned int          _nmbIncrementalUpdates;     // number of incremental updates since the last recalculation
+		mutable std::vector<complexT> _coherentSums;              // coherent sums over waves [event index][rank][reflectivity]
+		mutable std::vector<complexT> _coherentSumsCompensation;  // running compensations of the incremental updates of _coherentSums (Kahan summation)
+		mutable prodAmpsArrayType     _coherentSumsProdAmps;      // production amplitudes the cached coherent sums were calculated with
+
 		// normalization integrals
 		normMatrixArrayType _normMatrix;          // normalization matrix w/o acceptance [reflectivity 1][wave index 1][reflectivity 2][wave index 2]
 		normMatrixArrayType _accMatrix;           // normalization matrix with acceptance [reflectivity 1][wave index 1][reflectivity 2][wave index 2]
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      container for decay amplitudes in structure-of-arrays layout
+//
+//      events are grouped into blocks of nmbEventsPerBlock events; for
+//      each block and wave the real and the imaginary parts of the
+//      amplitudes are stored in two separate contiguous lanes:
+//
+//      [event block][wave][real, imag][event in block]
+//
+//      with this layout loops over the events in a block map directly
+//      to SIMD instructions (AVX2 for float, AVX-512 for double), when
+//      compiled with ARCH_NATIVE. unused entries of the last block are
+//      zero.
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef SIMDDECAYAMPARRAY_HPP
+#define SIMDDECAYAMPARRAY_HPP
+
+
+#include <complex>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
+
+namespace rpwa {
+
+
+	template<typename T>  // type of real and imaginary parts
+	class simdDecayAmpArray {
+
+	public:
+
+		typedef T value_type;
+
+		enum {
+			nmbEventsPerBlock = 8,   // number of events processed in parallel
+			alignment         = 64   // alignment of each lane in bytes
+		};
+
+		simdDecayAmpArray()
+			: _nmbEvents(0),
+			  _nmbWaves (0),
+			  _nmbBlocks(0)
+		{ }
+
+		void resize(const unsigned int nmbEvents,
+		            const unsigned int nmbWaves)
+		{
+			_nmbEvents = nmbEvents;
+			_nmbWaves  = nmbWaves;
+			_nmbBlocks = (nmbEvents + nmbEventsPerBlock - 1) / nmbEventsPerBlock;
+			_data.assign((std::size_t)_nmbBlocks * _nmbWaves * 2 * nmbEventsPerBlock, (T)0);
+		}
+
+		void clear() { resize(0, 0); _data.shrink_to_fit(); }
+
+		unsigned int nmbEvents() const { return _nmbEvents; }  ///< returns number of events
+		unsigned int nmbWaves () const { return _nmbWaves;  }  ///< returns number of waves
+		unsigned int nmbBlocks() const { return _nmbBlocks; }  ///< returns number of event blocks
+
+		/// returns number of valid events in given block
+		unsigned int nmbEventsInBlock(const unsigned int iBlock) const
+		{
+			const unsigned int nmbEvts = _nmbEvents - iBlock * nmbEventsPerBlock;
+			return (nmbEvts < (unsigned int)nmbEventsPerBlock) ? nmbEvts : (unsigned int)nmbEventsPerBlock;
+		}
+
+		/// returns pointer to lane with real parts of amplitudes of given wave in given block
+		const T* real(const unsigned int iBlock,
+		              const unsigned int iWave) const { return &_data[offset(iBlock, iWave)];                     }
+		/// returns pointer to lane with imaginary parts of amplitudes of given wave in given block
+		const T* imag(const unsigned int iBlock,
+		              const unsigned int iWave) const { return &_data[offset(iBlock, iWave) + nmbEventsPerBlock]; }
+
+		template<typename complexT>
+		complexT get(const unsigned int iEvt,
+		             const unsigned int iWave) const
+		{
+			const std::size_t i = offset(iEvt / nmbEventsPerBlock, iWave) + iEvt % nmbEventsPerBlock;
+			return complexT(_data[i], _data[i + nmbEventsPerBlock]);
+		}
+
+		template<typename complexT>
+		void set(const unsigned int iEvt,
+		         const unsigned int iWave,
+		         const complexT&    amp)
+		{
+			const std::size_t i = offset(iEvt / nmbEventsPerBlock, iWave) + iEvt % nmbEventsPerBlock;
+			_data[i                    ] = amp.real();
+			_data[i + nmbEventsPerBlock] = amp.imag();
+		}
+
+		std::size_t memoryUsage() const { return _data.size() * sizeof(T); }  ///< returns size of data in bytes
+
+	private:
+
+		std::size_t offset(const unsigned int iBlock,
+		                   const unsigned int iWave) const
+		{
+			return ((std::size_t)iBlock * _nmbWaves + iWave) * 2 * nmbEventsPerBlock;
+		}
+
+		unsigned int _nmbEvents;
+		unsigned int _nmbWaves;
+		unsigned int _nmbBlocks;
+
+		std::vector<T, boost::alignment::aligned_allocator<T, alignment> > _data;
+
+	};
+
+
+}  // namespace rpwa
+
+
+#endif  // SIMDDECAYAMPARRAY_HPP
@@ -49,7 +49,9 @@ namespace {
 	                                 const long maxNmbEvents,
 	                                 const std::string& weightFileName,
 	                                 const rpwa::eventMetadata* eventMeta,
-	                                 const bp::dict& pyOtfBin)
+	                                 const bp::dict& pyOtfBin,
+	                                 const std::string& binIndexDirectory,
+	                                 const unsigned int nmbThreads)
 	{
 		std::vector<const rpwa::amplitudeMetadata*> amplitudeMeta;
 		if(not rpwa::py::convertBPObjectToVector<const rpwa::amplitudeMetadata*>(pyAmplitudeMetadata, amplitudeMeta)) {
@@ -65,7 +67,40 @@ namespace {
 					                          bp::extract<double>(pyOtfBin[pyOtfBin.keys()[i]][1]));
 			}
 		}
-		return self.integrate(amplitudeMeta, maxNmbEvents, weightFileName, eventMeta, otfBin);
+		return self.integrate(amplitudeMeta, maxNmbEvents, weightFileName, eventMeta, otfBin, binIndexDirectory, nmbThreads);
+	}
+
+	bp::object ampIntegralMatrix_integrateBins(const bp::object&          pyAmplitudeMetadata,
+	                                           const rpwa::eventMetadata& eventMeta,
+	                                           const bp::list&            pyBins,
+	                                           const long                 maxNmbEvents,
+	                                           const std::string&         weightFileName,
+	                                           const unsigned int         nmbThreads)
+	{
+		std::vector<const rpwa::amplitudeMetadata*> amplitudeMeta;
+		if(not rpwa::py::convertBPObjectToVector<const rpwa::amplitudeMetadata*>(pyAmplitudeMetadata, amplitudeMeta)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudeMetadata when executing rpwa::ampIntegralMatrix::integrateBins()");
+			bp::throw_error_already_set();
+		}
+		std::vector<std::map<std::string, std::pair<double, double> > > bins(bp::len(pyBins));
+		for(unsigned int iBin = 0; iBin < bins.size(); ++iBin) {
+			const bp::dict pyBin = bp::extract<bp::dict>(pyBins[iBin]);
+			const bp::list keys = pyBin.keys();
+			for(unsigned int i = 0; i < len(keys); ++i) {
+				bins[iBin][bp::extract<std::string>(keys[i])] =
+					std::pair<double, double>(bp::extract<double>(pyBin[keys[i]][0]),
+					                          bp::extract<double>(pyBin[keys[i]][1]));
+			}
+		}
+		std::vector<rpwa::ampIntegralMatrix> integrals;
+		if(not rpwa::ampIntegralMatrix::integrateBins(integrals, amplitudeMeta, eventMeta, bins, maxNmbEvents, weightFileName, nmbThreads)) {
+			return bp::object();
+		}
+		bp::list pyIntegrals;
+		for(size_t iBin = 0; iBin < integrals.size(); ++iBin) {
+			pyIntegrals.append(integrals[iBin]);
+		}
+		return pyIntegrals;
 	}
 
 	bool ampIntegralMatrix_setWaveNames(rpwa::ampIntegralMatrix& self,
@@ -162,8 +197,20 @@ void rpwa::py::exportAmpIntegralMatrix() {
 		        bp::arg("maxNmbEvents")=0,
 		        bp::arg("weightFileName")="",
 		        bp::arg("eventMeta")=bp::object(),
-		        bp::arg("otfBin")=bp::dict())
+		        bp::arg("otfBin")=bp::dict(),
+		        bp::arg("binIndexDirectory")="",
+		        bp::arg("nmbThreads")=0)
+		)
+		.def("integrateBins"
+		     , &ampIntegralMatrix_integrateBins
+		     , (bp::arg("amplitudeMetadata"),
+		        bp::arg("eventMeta"),
+		        bp::arg("bins"),
+		        bp::arg("maxNmbEvents")=0,
+		        bp::arg("weightFileName")="",
+		        bp::arg("nmbThreads")=0)
 		)
+		.staticmethod("integrateBins")
 		.def("setWaveNames"
 		     , &ampIntegralMatrix_setWaveNames
 		     , bp::arg("waveNames"))
@@ -0,0 +1,76 @@
+#include "ampIntegralPackedMatrix_py.h"
+
+#include <boost/python.hpp>
+
+#include "ampIntegralMatrix.h"
+#include "ampIntegralMatrixMetadata.h"
+#include "ampIntegralPackedMatrix.h"
+#include "stlContainers_py.h"
+
+namespace bp = boost::python;
+
+
+namespace {
+
+	bp::list ampIntegralPackedMatrix_waveNames(const rpwa::ampIntegralPackedMatrix& self)
+	{
+		return bp::list(self.waveNames());
+	}
+
+	std::complex<double> ampIntegralPackedMatrix_element1(const rpwa::ampIntegralPackedMatrix& self,
+	                                                      const unsigned int                   waveIndexI,
+	                                                      const unsigned int                   waveIndexJ)
+	{
+		return self.element(waveIndexI, waveIndexJ);
+	}
+
+	std::complex<double> ampIntegralPackedMatrix_element2(const rpwa::ampIntegralPackedMatrix& self,
+	                                                      const std::string&                   waveNameI,
+	                                                      const std::string&                   waveNameJ)
+	{
+		return self.element(waveNameI, waveNameJ);
+	}
+
+	bp::object ampIntegralPackedMatrix_getIntegralMatrix(const rpwa::ampIntegralPackedMatrix& self)
+	{
+		rpwa::ampIntegralMatrix integral;
+		if(not self.getIntegralMatrix(integral)) {
+			return bp::object();
+		}
+		return bp::object(integral);
+	}
+
+}
+
+
+void rpwa::py::exportAmpIntegralPackedMatrix() {
+
+	bp::class_<rpwa::ampIntegralPackedMatrix, boost::noncopyable>("ampIntegralPackedMatrix")
+
+		.def("open", &rpwa::ampIntegralPackedMatrix::open, bp::arg("fileName"))
+		.def("close", &rpwa::ampIntegralPackedMatrix::close)
+		.def("isOpen", &rpwa::ampIntegralPackedMatrix::isOpen)
+		.def("nmbWaves", &rpwa::ampIntegralPackedMatrix::nmbWaves)
+		.def("nmbEvents", &rpwa::ampIntegralPackedMatrix::nmbEvents)
+		.def("waveNames", &ampIntegralPackedMatrix_waveNames)
+		.def("containsWave", &rpwa::ampIntegralPackedMatrix::containsWave, bp::arg("waveName"))
+		.def("waveIndex", &rpwa::ampIntegralPackedMatrix::waveIndex, bp::arg("waveName"))
+		.def("element", &ampIntegralPackedMatrix_element1, (bp::arg("waveIndexI"), bp::arg("waveIndexJ")))
+		.def("element", &ampIntegralPackedMatrix_element2, (bp::arg("waveNameI"), bp::arg("waveNameJ")))
+		.def("getIntegralMatrix", &ampIntegralPackedMatrix_getIntegralMatrix)
+
+		.def("integralContentHash", &rpwa::ampIntegralPackedMatrix::integralContentHash, bp::return_value_policy<bp::copy_const_reference>())
+
+		.def("write"
+		     , &rpwa::ampIntegralPackedMatrix::write
+		     , (bp::arg("fileName"), bp::arg("integralMeta"))
+		)
+		.staticmethod("write")
+		.def("isPackedFile", &rpwa::ampIntegralPackedMatrix::isPackedFile, bp::arg("fileName"))
+		.staticmethod("isPackedFile")
+		.def("packedFileName", &rpwa::ampIntegralPackedMatrix::packedFileName, bp::arg("integralFileName"))
+		.staticmethod("packedFileName")
+		.def("findPackedFile", &rpwa::ampIntegralPackedMatrix::findPackedFile, bp::arg("integralFileName"))
+		.staticmethod("findPackedFile");
+
+}
@@ -0,0 +1,10 @@
+#ifndef AMPINTEGRALPACKEDMATRIX_PY_H
+#define AMPINTEGRALPACKEDMATRIX_PY_H
+
+namespace rpwa {
+	namespace py {
+		void exportAmpIntegralPackedMatrix();
+	}
+}
+
+#endif//AMPINTEGRALPACKEDMATRIX_PY_H
@@ -0,0 +1,131 @@
+#include "ampIntegralShard_py.h"
+
+#include <boost/python.hpp>
+
+#include "ampIntegralMatrix.h"
+#include "ampIntegralShard.h"
+#include "amplitudeMetadata.h"
+#include "stlContainers_py.h"
+
+namespace bp = boost::python;
+
+
+namespace {
+
+	bool ampIntegralShard_integrate(rpwa::ampIntegralShard&    self,
+	                                const bp::object&          pyAmplitudeMetadata,
+	                                const rpwa::eventMetadata& eventMeta,
+	                                const long                 firstEvent,
+	                                const long                 lastEvent,
+	                                const std::string&         weightFileName,
+	                                const bp::dict&            pyOtfBin,
+	                                const std::string&         checkpointFileName,
+	                                const long                 checkpointInterval,
+	                                const unsigned int         nmbThreads)
+	{
+		std::vector<const rpwa::amplitudeMetadata*> amplitudeMeta;
+		if(not rpwa::py::convertBPObjectToVector<const rpwa::amplitudeMetadata*>(pyAmplitudeMetadata, amplitudeMeta)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudeMetadata when executing rpwa::ampIntegralShard::integrate()");
+			bp::throw_error_already_set();
+		}
+		std::map<std::string, std::pair<double, double> > otfBin;
+		const bp::list keys = pyOtfBin.keys();
+		for(unsigned int i = 0; i < bp::len(keys); ++i) {
+			otfBin[bp::extract<std::string>(keys[i])] =
+				std::pair<double, double>(bp::extract<double>(pyOtfBin[keys[i]][0]),
+				                          bp::extract<double>(pyOtfBin[keys[i]][1]));
+		}
+		return self.integrate(amplitudeMeta, eventMeta, firstEvent, lastEvent, weightFileName, otfBin, checkpointFileName, checkpointInterval, nmbThreads);
+	}
+
+	bp::object ampIntegralShard_getIntegralMatrix(const rpwa::ampIntegralShard& self)
+	{
+		rpwa::ampIntegralMatrix integral;
+		if(not self.getIntegralMatrix(integral)) {
+			return bp::object();
+		}
+		return bp::object(integral);
+	}
+
+	bp::list ampIntegralShard_waveNames(const rpwa::ampIntegralShard& self)
+	{
+		return bp::list(self.waveNames());
+	}
+
+	bp::list ampIntegralShard_keyFileContents(const rpwa::ampIntegralShard& self)
+	{
+		return bp::list(self.keyFileContents());
+	}
+
+	bp::list ampIntegralShard_amplitudeHashes(const rpwa::ampIntegralShard& self)
+	{
+		return bp::list(self.amplitudeHashes());
+	}
+
+	bp::dict ampIntegralShard_binningMap(const rpwa::ampIntegralShard& self)
+	{
+		bp::dict retval;
+		const std::map<std::string, std::pair<double, double> >& binningMap = self.binningMap();
+		for(std::map<std::string, std::pair<double, double> >::const_iterator it = binningMap.begin(); it != binningMap.end(); ++it) {
+			retval[it->first] = bp::make_tuple(it->second.first, it->second.second);
+		}
+		return retval;
+	}
+
+	bp::object ampIntegralShard_readShardFile(const std::string& fileName,
+	                                          const bool         quiet)
+	{
+		const rpwa::ampIntegralShard* shard = rpwa::ampIntegralShard::readShardFile(fileName, quiet);
+		if(not shard) {
+			return bp::object();
+		}
+		const rpwa::ampIntegralShard retval = *shard;
+		delete shard;
+		return bp::object(retval);
+	}
+
+}
+
+
+void rpwa::py::exportAmpIntegralShard() {
+
+	bp::class_<rpwa::ampIntegralShard>("ampIntegralShard")
+		.def(bp::init<const rpwa::ampIntegralShard&>())
+
+		.def(bp::self_ns::str(bp::self))
+
+		.def("waveNames", &ampIntegralShard_waveNames)
+		.def("keyFileContents", &ampIntegralShard_keyFileContents)
+		.def("amplitudeHashes", &ampIntegralShard_amplitudeHashes)
+		.def("binningMap", &ampIntegralShard_binningMap)
+		.def("useWeights", &rpwa::ampIntegralShard::useWeights)
+		.def("nmbEvents", &rpwa::ampIntegralShard::nmbEvents)
+		.def("weightSum", &rpwa::ampIntegralShard::weightSum)
+		.def("nmbEventsVisited", &rpwa::ampIntegralShard::nmbEventsVisited)
+
+		.def("integrate"
+		     , &ampIntegralShard_integrate
+		     , (bp::arg("amplitudeMetadata"),
+		        bp::arg("eventMeta"),
+		        bp::arg("firstEvent")=0,
+		        bp::arg("lastEvent")=-1,
+		        bp::arg("weightFileName")="",
+		        bp::arg("otfBin")=bp::dict(),
+		        bp::arg("checkpointFileName")="",
+		        bp::arg("checkpointInterval")=1000000,
+		        bp::arg("nmbThreads")=0)
+		)
+		.def("merge", &rpwa::ampIntegralShard::merge, bp::arg("shard"))
+		.def("getIntegralMatrix", &ampIntegralShard_getIntegralMatrix)
+
+		.def("readShardFile"
+		     , &ampIntegralShard_readShardFile
+		     , (bp::arg("fileName"), bp::arg("quiet")=false)
+		)
+		.staticmethod("readShardFile")
+		.def("writeToFile", &rpwa::ampIntegralShard::writeToFile, bp::arg("fileName"))
+		.def("writeIntegralFile", &rpwa::ampIntegralShard::writeIntegralFile, bp::arg("integralFileName"))
+
+		.def_readonly("objectNameInFile", &rpwa::ampIntegralShard::objectNameInFile);
+
+}
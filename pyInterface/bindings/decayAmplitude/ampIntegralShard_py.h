@@ -0,0 +1,10 @@
+#ifndef AMPINTEGRALSHARD_PY_H
+#define AMPINTEGRALSHARD_PY_H
+
+namespace rpwa {
+	namespace py {
+		void exportAmpIntegralShard();
+	}
+}
+
+#endif//AMPINTEGRALSHARD_PY_H
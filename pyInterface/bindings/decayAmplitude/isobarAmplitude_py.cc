@@ -68,6 +68,19 @@ namespace {
 		return rpwa::py::convertToPy<TLorentzRotation>(rpwa::isobarAmplitude::gjTransform(*beamLv, *XLv));
 	}
 
+	std::complex<double> isobarAmplitude_amplitude(const rpwa::isobarAmplitude& self) {
+		return self.amplitude();
+	}
+
+	bp::object isobarAmplitude_amplitudeGjTrans(const rpwa::isobarAmplitude& self, PyObject* pyGjTrans) {
+		TLorentzRotation* gjTrans = rpwa::py::convertFromPy<TLorentzRotation*>(pyGjTrans);
+		if(gjTrans == NULL) {
+			printErr<<"Got invalid input when executing rpwa::isobarAmplitude::amplitude()."<<std::endl;
+			return bp::object();
+		}
+		return bp::object(self.amplitude(*gjTrans));
+	}
+
 	std::string isobarAmplitude_printParameters(const rpwa::isobarAmplitude& self) {
 		std::stringstream sstr;
 		self.printParameters(sstr);
@@ -90,6 +103,8 @@ void rpwa::py::exportIsobarAmplitude() {
 
 		.def("setDecayTopology", &rpwa::isobarAmplitude::setDecayTopology)
 
+		.def("clone", &rpwa::isobarAmplitude::clone)
+
 		.def("init", &isobarAmplitudeWrapper::init, &isobarAmplitudeWrapper::default_init)
 		.def("init", &rpwa::isobarAmplitude::init)
 
@@ -98,11 +113,14 @@ void rpwa::py::exportIsobarAmplitude() {
 		.add_property("isospinSymmetrization", &rpwa::isobarAmplitude::isospinSymmetrization, &rpwa::isobarAmplitude::enableIsospinSymmetrization)
 		.add_property("doSpaceInversion", &rpwa::isobarAmplitude::doSpaceInversion, &rpwa::isobarAmplitude::enableSpaceInversion)
 		.add_property("doReflection", &rpwa::isobarAmplitude::doReflection, &rpwa::isobarAmplitude::enableReflection)
+		.add_property("useCompiledProgram", &rpwa::isobarAmplitude::useCompiledProgram, &rpwa::isobarAmplitude::enableCompiledProgram)
+		.add_property("programCompiled", &rpwa::isobarAmplitude::programCompiled)
 
 		.def("gjTransform", &isobarAmplitude_gjTransform)
 		.staticmethod("gjTransform")
 
-		.def("amplitude", &rpwa::isobarAmplitude::amplitude)
+		.def("amplitude", &isobarAmplitude_amplitude)
+		.def("amplitude", &isobarAmplitude_amplitudeGjTrans, bp::arg("gjTrans"))
 
 		.def("__call__", &rpwa::isobarAmplitude::operator())
 
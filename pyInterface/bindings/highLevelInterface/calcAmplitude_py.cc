@@ -2,7 +2,10 @@
 
 #include <boost/python.hpp>
 
+#include "amplitudeFileWriter.h"
+#include "amplitudeMatrixFileWriter.h"
 #include "calcAmplitude.h"
+#include "stlContainers_py.h"
 
 namespace bp = boost::python;
 
@@ -14,14 +17,101 @@ namespace {
 	                       const long int                  maxNmbEvents,
 	                       const bool                      printProgress,
 	                       const std::string&              treePerfStatOutFileName,
-	                       const long int                  treeCacheSize)
+	                       const long int                  treeCacheSize,
+	                       const unsigned int              nmbThreads)
 	{
 		return bp::list(rpwa::hli::calcAmplitude(eventMeta,
 		                                         amplitude,
 		                                         maxNmbEvents,
 		                                         printProgress,
 		                                         treePerfStatOutFileName,
-		                                         treeCacheSize));
+		                                         treeCacheSize,
+		                                         nmbThreads));
+	}
+
+	bp::object calcAmplitudes(rpwa::eventMetadata& eventMeta,
+	                          bp::object           pyAmplitudes,
+	                          const long int       firstEvent,
+	                          const long int       maxNmbEvents,
+	                          const bool           printProgress,
+	                          const std::string&   treePerfStatOutFileName,
+	                          const long int       treeCacheSize,
+	                          const unsigned int   nmbThreads)
+	{
+		std::vector<rpwa::isobarAmplitudePtr> amplitudes;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::isobarAmplitudePtr>(pyAmplitudes, amplitudes)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudes when executing rpwa::hli::calcAmplitudes()");
+			bp::throw_error_already_set();
+		}
+		const std::vector<std::vector<std::complex<double> > > waveAmplitudes = rpwa::hli::calcAmplitudes(eventMeta,
+		                                                                                                  amplitudes,
+		                                                                                                  firstEvent,
+		                                                                                                  maxNmbEvents,
+		                                                                                                  printProgress,
+		                                                                                                  treePerfStatOutFileName,
+		                                                                                                  treeCacheSize,
+		                                                                                                  nmbThreads);
+		if(waveAmplitudes.size() != amplitudes.size()) {
+			return bp::object();
+		}
+		bp::list pyWaveAmplitudes;
+		for(unsigned int iWave = 0; iWave < waveAmplitudes.size(); ++iWave) {
+			pyWaveAmplitudes.append(bp::list(waveAmplitudes[iWave]));
+		}
+		return pyWaveAmplitudes;
+	}
+
+	bool writeAmplitudes(rpwa::eventMetadata& eventMeta,
+	                     bp::object           pyAmplitudes,
+	                     bp::object           pyAmpFileWriters,
+	                     const long int       eventBlockSize,
+	                     const bool           printProgress,
+	                     const std::string&   treePerfStatOutFileName,
+	                     const long int       treeCacheSize,
+	                     const unsigned int   nmbThreads)
+	{
+		std::vector<rpwa::isobarAmplitudePtr> amplitudes;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::isobarAmplitudePtr>(pyAmplitudes, amplitudes)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudes when executing rpwa::hli::calcAmplitudes()");
+			bp::throw_error_already_set();
+		}
+		std::vector<rpwa::amplitudeFileWriter*> ampFileWriters;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::amplitudeFileWriter*>(pyAmpFileWriters, ampFileWriters)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for ampFileWriters when executing rpwa::hli::calcAmplitudes()");
+			bp::throw_error_already_set();
+		}
+		return rpwa::hli::calcAmplitudes(eventMeta,
+		                                 amplitudes,
+		                                 ampFileWriters,
+		                                 eventBlockSize,
+		                                 printProgress,
+		                                 treePerfStatOutFileName,
+		                                 treeCacheSize,
+		                                 nmbThreads);
+	}
+
+	bool writeAmplitudeMatrix(rpwa::eventMetadata&             eventMeta,
+	                          bp::object                       pyAmplitudes,
+	                          rpwa::amplitudeMatrixFileWriter& ampMatrixFileWriter,
+	                          const long int                   eventBlockSize,
+	                          const bool                       printProgress,
+	                          const std::string&               treePerfStatOutFileName,
+	                          const long int                   treeCacheSize,
+	                          const unsigned int               nmbThreads)
+	{
+		std::vector<rpwa::isobarAmplitudePtr> amplitudes;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::isobarAmplitudePtr>(pyAmplitudes, amplitudes)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudes when executing rpwa::hli::calcAmplitudes()");
+			bp::throw_error_already_set();
+		}
+		return rpwa::hli::calcAmplitudes(eventMeta,
+		                                 amplitudes,
+		                                 ampMatrixFileWriter,
+		                                 eventBlockSize,
+		                                 printProgress,
+		                                 treePerfStatOutFileName,
+		                                 treeCacheSize,
+		                                 nmbThreads);
 	}
 
 }
@@ -38,7 +128,47 @@ void rpwa::py::exportCalcAmplitude()
 		   bp::arg("maxNmbEvents") = -1,
 		   bp::arg("printProgress") = true,
 		   bp::arg("treePerfStatOutFileName") = "",
-		   bp::arg("treeCacheSize") = 25000000)
+		   bp::arg("treeCacheSize") = 25000000,
+		   bp::arg("nmbThreads") = 1)
+	);
+
+	bp::def(
+		"calcAmplitudes"
+		, &::calcAmplitudes
+		, (bp::arg("eventMeta"),
+		   bp::arg("amplitudes"),
+		   bp::arg("firstEvent") = 0,
+		   bp::arg("maxNmbEvents") = -1,
+		   bp::arg("printProgress") = true,
+		   bp::arg("treePerfStatOutFileName") = "",
+		   bp::arg("treeCacheSize") = 25000000,
+		   bp::arg("nmbThreads") = 1)
+	);
+
+	bp::def(
+		"writeAmplitudes"
+		, &::writeAmplitudes
+		, (bp::arg("eventMeta"),
+		   bp::arg("amplitudes"),
+		   bp::arg("ampFileWriters"),
+		   bp::arg("eventBlockSize") = 100000,
+		   bp::arg("printProgress") = true,
+		   bp::arg("treePerfStatOutFileName") = "",
+		   bp::arg("treeCacheSize") = 25000000,
+		   bp::arg("nmbThreads") = 1)
+	);
+
+	bp::def(
+		"writeAmplitudeMatrix"
+		, &::writeAmplitudeMatrix
+		, (bp::arg("eventMeta"),
+		   bp::arg("amplitudes"),
+		   bp::arg("ampMatrixFileWriter"),
+		   bp::arg("eventBlockSize") = 100000,
+		   bp::arg("printProgress") = true,
+		   bp::arg("treePerfStatOutFileName") = "",
+		   bp::arg("treeCacheSize") = 25000000,
+		   bp::arg("nmbThreads") = 1)
 	);
 
 }
@@ -0,0 +1,71 @@
+#include "calcIntegralOnTheFly_py.h"
+
+#include <boost/python.hpp>
+
+#include "calcIntegralOnTheFly.h"
+#include "stlContainers_py.h"
+
+namespace bp = boost::python;
+
+
+namespace {
+
+	bp::object calcIntegralOnTheFly(const rpwa::eventMetadata& eventMeta,
+	                                const bp::object&          pyAmplitudes,
+	                                const bp::dict&            pyBinningMap,
+	                                const long int             startEvent,
+	                                const long int             maxNmbEvents,
+	                                const unsigned int         nmbThreads,
+	                                const bool                 printProgress,
+	                                const long int             treeCacheSize)
+	{
+		std::vector<rpwa::isobarAmplitudePtr> amplitudes;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::isobarAmplitudePtr>(pyAmplitudes, amplitudes)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudes when executing rpwa::hli::calcIntegralOnTheFly()");
+			bp::throw_error_already_set();
+		}
+		std::map<std::string, std::pair<double, double> > binningMap;
+		const bp::list keys = pyBinningMap.keys();
+		for(unsigned int i = 0; i < bp::len(keys); ++i) {
+			const std::string key = bp::extract<std::string>(keys[i]);
+			binningMap[key] = std::pair<double, double>(bp::extract<double>(pyBinningMap[key][0]),
+			                                            bp::extract<double>(pyBinningMap[key][1]));
+		}
+		rpwa::ampIntegralMatrix  integral;
+		std::vector<std::string> amplitudeHashes;
+		if(not rpwa::hli::calcIntegralOnTheFly(integral,
+		                                       amplitudeHashes,
+		                                       eventMeta,
+		                                       amplitudes,
+		                                       binningMap,
+		                                       startEvent,
+		                                       maxNmbEvents,
+		                                       nmbThreads,
+		                                       printProgress,
+		                                       treeCacheSize))
+		{
+			return bp::object();
+		}
+		return bp::make_tuple(integral, bp::list(amplitudeHashes));
+	}
+
+}
+
+
+void rpwa::py::exportCalcIntegralOnTheFly()
+{
+
+	bp::def(
+		"calcIntegralOnTheFly"
+		, &::calcIntegralOnTheFly
+		, (bp::arg("eventMeta"),
+		   bp::arg("amplitudes"),
+		   bp::arg("binningMap") = bp::dict(),
+		   bp::arg("startEvent") = 0,
+		   bp::arg("maxNmbEvents") = -1,
+		   bp::arg("nmbThreads") = 0,
+		   bp::arg("printProgress") = true,
+		   bp::arg("treeCacheSize") = 25000000)
+	);
+
+}
@@ -0,0 +1,10 @@
+#ifndef CALCINTEGRALONTHEFLY_PY_H
+#define CALCINTEGRALONTHEFLY_PY_H
+
+namespace rpwa {
+	namespace py {
+		void exportCalcIntegralOnTheFly();
+	}
+}
+
+#endif
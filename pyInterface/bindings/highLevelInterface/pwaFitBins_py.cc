@@ -0,0 +1,137 @@
+#include "pwaFitBins_py.h"
+
+#include <boost/python.hpp>
+
+#include "boostContainers_py.hpp"
+#include "pwaFitBins.h"
+#include "rootConverters_py.h"
+#include "stlContainers_py.h"
+
+namespace bp = boost::python;
+
+
+namespace {
+
+	bp::list
+	pwaFitBins_pwaFitBins(const bp::list&    pyBins,
+	                      const bp::list&    pyWaveDescriptionThresholds,
+	                      const unsigned int rank,
+	                      const bool         cauchy,
+	                      const double       cauchyWidth,
+	                      const unsigned int accEventsOverride,
+	                      const std::string& startValFileName,
+	                      const bool         checkHessian,
+	                      const bool         saveSpace,
+	                      const bool         useNlopt,
+	                      const unsigned int nmbWorkers,
+	                      const unsigned int nmbThreadsPerBin,
+	                      const double       memoryBudget,
+	                      const std::string& binIndexDirectory,
+	                      const bool         verbose)
+	{
+		std::vector<boost::python::tuple> vectorPyTuples;
+		if(not rpwa::py::convertBPObjectToVector<boost::python::tuple>(pyWaveDescriptionThresholds, vectorPyTuples)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for waveDescriptionThresholds when executing rpwa::hli::pwaFitBins()");
+			bp::throw_error_already_set();
+		}
+		std::vector<rpwa::pwaLikelihood<std::complex<double> >::waveDescThresType> vectorWaveDescriptionThresholds;
+		for(size_t i = 0; i < vectorPyTuples.size(); ++i) {
+			boost::tuples::tuple<std::string, rpwa::waveDescription, double> waveDescriptionThresholds;
+			if(not rpwa::py::convertBPTupleToTuple<std::string, rpwa::waveDescription, double>(vectorPyTuples[i], waveDescriptionThresholds)) {
+				PyErr_SetString(PyExc_TypeError, "Got invalid input for waveDescriptionThresholds when executing rpwa::hli::pwaFitBins()");
+				bp::throw_error_already_set();
+			}
+			vectorWaveDescriptionThresholds.push_back(waveDescriptionThresholds);
+		}
+
+		// each bin is given as dictionary with the keys 'binning',
+		// 'eventAndAmpFileDict', 'normIntegralFileName',
+		// 'accIntegralFileName' and 'seeds'
+		std::vector<rpwa::hli::pwaFitBin> bins(bp::len(pyBins));
+		for(unsigned int iBin = 0; iBin < bins.size(); ++iBin) {
+			const bp::dict pyBin = bp::extract<bp::dict>(pyBins[iBin]);
+			rpwa::hli::pwaFitBin& bin = bins[iBin];
+
+			const bp::dict pyBinning = bp::extract<bp::dict>(pyBin["binning"]);
+			const bp::list binningVars = pyBinning.keys();
+			for(unsigned int i = 0; i < bp::len(binningVars); ++i) {
+				const std::string binningVar = bp::extract<std::string>(binningVars[i]);
+				bin.binning[binningVar] = std::pair<double, double>(bp::extract<double>(pyBinning[binningVar][0]),
+				                                                    bp::extract<double>(pyBinning[binningVar][1]));
+			}
+
+			const bp::dict pyEventAndAmpFileDict = bp::extract<bp::dict>(pyBin["eventAndAmpFileDict"]);
+			const bp::list eventFileNames = pyEventAndAmpFileDict.keys();
+			for(unsigned int i = 0; i < bp::len(eventFileNames); ++i) {
+				const std::string eventFileName = bp::extract<std::string>(eventFileNames[i]);
+				bin.eventFileNames.push_back(eventFileName);
+				const bp::dict pyAmpFileDict = bp::extract<bp::dict>(pyEventAndAmpFileDict[eventFileName]);
+				const bp::list waveNames = pyAmpFileDict.keys();
+				std::map<std::string, std::string> ampFileNames;
+				for(unsigned int j = 0; j < bp::len(waveNames); ++j) {
+					const std::string waveName = bp::extract<std::string>(waveNames[j]);
+					ampFileNames[waveName] = bp::extract<std::string>(pyAmpFileDict[waveName]);
+				}
+				bin.ampFileNames.push_back(ampFileNames);
+			}
+
+			bin.normIntegralFileName = bp::extract<std::string>(pyBin["normIntegralFileName"]);
+			bin.accIntegralFileName  = bp::extract<std::string>(pyBin["accIntegralFileName"]);
+			if(not rpwa::py::convertBPObjectToVector<unsigned int>(pyBin["seeds"], bin.seeds)) {
+				PyErr_SetString(PyExc_TypeError, "Got invalid input for seeds when executing rpwa::hli::pwaFitBins()");
+				bp::throw_error_already_set();
+			}
+		}
+
+		const std::vector<std::vector<rpwa::fitResultPtr> > results = rpwa::hli::pwaFitBins(bins,
+		                                                                                     vectorWaveDescriptionThresholds,
+		                                                                                     rank,
+		                                                                                     cauchy,
+		                                                                                     cauchyWidth,
+		                                                                                     accEventsOverride,
+		                                                                                     startValFileName,
+		                                                                                     checkHessian,
+		                                                                                     saveSpace,
+		                                                                                     useNlopt,
+		                                                                                     nmbWorkers,
+		                                                                                     nmbThreadsPerBin,
+		                                                                                     (std::size_t)memoryBudget,
+		                                                                                     binIndexDirectory,
+		                                                                                     verbose);
+		bp::list pyResults;
+		for(size_t iBin = 0; iBin < results.size(); ++iBin) {
+			bp::list pyBinResults;
+			for(size_t iResult = 0; iResult < results[iBin].size(); ++iResult)
+				pyBinResults.append(results[iBin][iResult]);
+			pyResults.append(pyBinResults);
+		}
+		return pyResults;
+	}
+
+}
+
+
+void rpwa::py::exportPwaFitBins()
+{
+
+	bp::def(
+		"pwaFitBins"
+		, ::pwaFitBins_pwaFitBins
+		, (bp::arg("bins"),
+		   bp::arg("waveDescriptionThresholds"),
+		   bp::arg("rank") = 1,
+		   bp::arg("cauchy") = false,
+		   bp::arg("cauchyWidth") = 0.5,
+		   bp::arg("accEventsOverride") = 0,
+		   bp::arg("startValFileName") = "",
+		   bp::arg("checkHessian") = false,
+		   bp::arg("saveSpace") = false,
+		   bp::arg("useNlopt") = false,
+		   bp::arg("nmbWorkers") = 0,
+		   bp::arg("nmbThreadsPerBin") = 1,
+		   bp::arg("memoryBudget") = 0.,
+		   bp::arg("binIndexDirectory") = "",
+		   bp::arg("verbose") = false)
+	);
+
+}
@@ -0,0 +1,10 @@
+#ifndef PWAFITBINS_PY_H
+#define PWAFITBINS_PY_H
+
+namespace rpwa {
+	namespace py {
+		void exportPwaFitBins();
+	}
+}
+
+#endif
@@ -9,6 +9,31 @@
 namespace bp = boost::python;
 
 
+namespace {
+
+	bp::list
+	pwaNloptMultiStartFit(const rpwa::pwaLikelihood<std::complex<double> >& L,
+	                      const unsigned int                                nmbAttempts,
+	                      const double                                      massBinMin,
+	                      const double                                      massBinMax,
+	                      const unsigned int                                seed,
+	                      const bool                                        checkHessian,
+	                      const bool                                        saveSpace,
+	                      const unsigned int                                nmbWorkers,
+	                      const double                                      stopThreshold,
+	                      const bool                                        verbose)
+	{
+		const std::vector<rpwa::fitResultPtr> results = rpwa::hli::pwaNloptMultiStartFit(L, nmbAttempts, massBinMin, massBinMax, seed,
+		                                                                                 checkHessian, saveSpace, nmbWorkers, stopThreshold, verbose);
+		bp::list pyResults;
+		for(size_t i = 0; i < results.size(); ++i)
+			pyResults.append(results[i]);
+		return pyResults;
+	}
+
+}
+
+
 void rpwa::py::exportPwaNloptFit()
 {
 
@@ -25,4 +50,19 @@ void rpwa::py::exportPwaNloptFit()
 		   bp::arg("verbose") = false)
 	);
 
+	bp::def(
+		"pwaNloptMultiStartFit"
+		, ::pwaNloptMultiStartFit
+		, (bp::arg("likelihood"),
+		   bp::arg("nmbAttempts"),
+		   bp::arg("massBinMin") = 0,
+		   bp::arg("massBinMax") = 0,
+		   bp::arg("seed") = 0,
+		   bp::arg("checkHessian") = false,
+		   bp::arg("saveSpace") = false,
+		   bp::arg("nmbWorkers") = 0,
+		   bp::arg("stopThreshold") = 0.,
+		   bp::arg("verbose") = false)
+	);
+
 }
@@ -2,6 +2,8 @@
 
 #include <boost/python.hpp>
 
+#include "ampIntegralPackedMatrix.h"
+#include "amplitudeMatrixMetadata.h"
 #include "amplitudeMetadata.h"
 #include "boostContainers_py.hpp"
 #include "pwaLikelihood.h"
@@ -54,6 +56,22 @@ namespace {
 	}
 
 
+	bool
+	pwaLikelihood_addNormIntegral2(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                               const rpwa::ampIntegralMatrix&              normMatrix)
+	{
+		return self.addNormIntegral(normMatrix);
+	}
+
+
+	bool
+	pwaLikelihood_addNormIntegralPacked(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                                    const rpwa::ampIntegralPackedMatrix&        normMatrix)
+	{
+		return self.addNormIntegral(normMatrix);
+	}
+
+
 	bool
 	pwaLikelihood_addAmplitude(rpwa::pwaLikelihood<std::complex<double> >& self,
 	                           bp::list                                    pyMetas)
@@ -67,6 +85,19 @@ namespace {
 	}
 
 
+	bool
+	pwaLikelihood_addAmplitudeMatrix(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                                 bp::list                                    pyMetas)
+	{
+		std::vector<const rpwa::amplitudeMatrixMetadata*> metas;
+		if (not rpwa::py::convertBPObjectToVector<const rpwa::amplitudeMatrixMetadata*>(pyMetas, metas)){
+			PyErr_SetString(PyExc_TypeError, "could not extract vector of amplitude matrix metadata");
+			bp::throw_error_already_set();
+		}
+		return self.addAmplitudeMatrix(metas);
+	}
+
+
 	bool
 	pwaLikelihood_addAccIntegral(rpwa::pwaLikelihood<std::complex<double> >& self,
 	                             PyObject*                                   pyAccMatrix,
@@ -81,6 +112,24 @@ namespace {
 	}
 
 
+	bool
+	pwaLikelihood_addAccIntegral2(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                              rpwa::ampIntegralMatrix&                    accMatrix,
+	                              const unsigned int                          accEventsOverride)
+	{
+		return self.addAccIntegral(accMatrix, accEventsOverride);
+	}
+
+
+	bool
+	pwaLikelihood_addAccIntegralPacked(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                                   const rpwa::ampIntegralPackedMatrix&        accMatrix,
+	                                   const unsigned int                          accEventsOverride)
+	{
+		return self.addAccIntegral(accMatrix, accEventsOverride);
+	}
+
+
 	bp::list
 	pwaLikelihood_Gradient(rpwa::pwaLikelihood<std::complex<double> >& self,
 	                       const bp::list&                             pyPar)
@@ -125,6 +174,57 @@ namespace {
 	}
 
 
+	bp::list
+	pwaLikelihood_evaluateBatch(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                            const bp::list&                             pyPars)
+	{
+		const unsigned int nmbPoints = bp::len(pyPars);
+		const unsigned int nmbPar    = self.nmbPars();
+		std::vector<double> pars(nmbPoints * nmbPar, 0);
+		for(unsigned int i = 0; i < nmbPoints; ++i) {
+			const bp::list pyPar = bp::extract<bp::list>(pyPars[i]);
+			if(bp::len(pyPar) != nmbPar) {
+				PyErr_SetString(PyExc_ValueError, "Got parameter point with wrong number of parameters when executing rpwa::pwaLikelihood::evaluateBatch()");
+				bp::throw_error_already_set();
+			}
+			for(unsigned int j = 0; j < nmbPar; ++j) {
+				pars[i * nmbPar + j] = bp::extract<double>(pyPar[j]);
+			}
+		}
+		std::vector<double> values(nmbPoints, 0.);
+		self.evaluateBatch(pars.data(), nmbPoints, values.data());
+		return bp::list(values);
+	}
+
+
+	bp::tuple
+	pwaLikelihood_evaluateGradientBatch(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                                    const bp::list&                             pyPars)
+	{
+		const unsigned int nmbPoints = bp::len(pyPars);
+		const unsigned int nmbPar    = self.nmbPars();
+		std::vector<double> pars(nmbPoints * nmbPar, 0);
+		for(unsigned int i = 0; i < nmbPoints; ++i) {
+			const bp::list pyPar = bp::extract<bp::list>(pyPars[i]);
+			if(bp::len(pyPar) != nmbPar) {
+				PyErr_SetString(PyExc_ValueError, "Got parameter point with wrong number of parameters when executing rpwa::pwaLikelihood::evaluateGradientBatch()");
+				bp::throw_error_already_set();
+			}
+			for(unsigned int j = 0; j < nmbPar; ++j) {
+				pars[i * nmbPar + j] = bp::extract<double>(pyPar[j]);
+			}
+		}
+		std::vector<double> values(nmbPoints, 0.);
+		std::vector<double> gradients(nmbPoints * nmbPar, 0.);
+		self.evaluateGradientBatch(pars.data(), nmbPoints, values.data(), gradients.data());
+		bp::list pyGradients;
+		for(unsigned int i = 0; i < nmbPoints; ++i) {
+			pyGradients.append(bp::list(std::vector<double>(gradients.begin() + i * nmbPar, gradients.begin() + (i + 1) * nmbPar)));
+		}
+		return bp::make_tuple(bp::list(values), pyGradients);
+	}
+
+
 	double
 	pwaLikelihood_DoDerivative(rpwa::pwaLikelihood<std::complex<double> >& self,
 	                           const bp::list&                             pyPar,
@@ -152,6 +252,28 @@ namespace {
 	}
 
 
+	bp::list
+	pwaLikelihood_HessianVectorProduct(rpwa::pwaLikelihood<std::complex<double> >& self,
+	                                   const bp::list&                             pyPar,
+	                                   const bp::list&                             pyVec)
+	{
+		const unsigned int nmbPar = bp::len(pyPar);
+		if(bp::len(pyVec) != nmbPar) {
+			PyErr_SetString(PyExc_ValueError, "Got vector with wrong number of elements when executing rpwa::pwaLikelihood::HessianVectorProduct()");
+			bp::throw_error_already_set();
+		}
+		std::vector<double> par(nmbPar, 0);
+		std::vector<double> vec(nmbPar, 0);
+		for(unsigned int i = 0; i < nmbPar; ++i) {
+			par[i] = bp::extract<double>(pyPar[i]);
+			vec[i] = bp::extract<double>(pyVec[i]);
+		}
+		std::vector<double> product(nmbPar, 0.);
+		self.HessianVectorProduct(par.data(), vec.data(), product.data());
+		return bp::list(product);
+	}
+
+
 	bp::list
 	pwaLikelihood_HessianEigenVectors(rpwa::pwaLikelihood<std::complex<double> >& self,
 	                                  PyObject*                                   pyHessian)
@@ -244,7 +366,8 @@ void rpwa::py::exportPwaLikelihood() {
 			   bp::arg("massBinCenter") = 0.)
 		)
 		.def("addNormIntegral", ::pwaLikelihood_addNormIntegral)
-		.def("addNormIntegral", &rpwa::pwaLikelihood<std::complex<double> >::addNormIntegral)
+		.def("addNormIntegral", ::pwaLikelihood_addNormIntegral2)
+		.def("addNormIntegral", ::pwaLikelihood_addNormIntegralPacked)
 		.def(
 			"addAccIntegral"
 			, ::pwaLikelihood_addAccIntegral
@@ -253,18 +376,28 @@ void rpwa::py::exportPwaLikelihood() {
 		)
 		.def(
 			"addAccIntegral"
-			, &rpwa::pwaLikelihood<std::complex<double> >::addAccIntegral
+			, ::pwaLikelihood_addAccIntegral2
+			, (bp::arg("accMatrix"),
+			   bp::arg("accEventsOverride") = 0)
+		)
+		.def(
+			"addAccIntegral"
+			, ::pwaLikelihood_addAccIntegralPacked
 			, (bp::arg("accMatrix"),
 			   bp::arg("accEventsOverride") = 0)
 		)
 		.def("addAmplitude", ::pwaLikelihood_addAmplitude)
+		.def("addAmplitudeMatrix", ::pwaLikelihood_addAmplitudeMatrix)
 		.def("setOnTheFlyBinning", ::pwaLikelihood_setOnTheFlyBinning)
 		.def("finishInit", &rpwa::pwaLikelihood<std::complex<double> >::finishInit)
 		.def("Gradient", ::pwaLikelihood_Gradient)
 		.def("FdF", ::pwaLikelihood_FdF)
 		.def("DoEval", ::pwaLikelihood_DoEval)
 		.def("DoDerivative", ::pwaLikelihood_DoDerivative)
+		.def("evaluateBatch", ::pwaLikelihood_evaluateBatch)
+		.def("evaluateGradientBatch", ::pwaLikelihood_evaluateGradientBatch)
 		.def("Hessian", ::pwaLikelihood_Hessian)
+		.def("HessianVectorProduct", ::pwaLikelihood_HessianVectorProduct)
 		.def("HessianEigenVectors", ::pwaLikelihood_HessianEigenVectors)
 		.def("CovarianceMatrix", ::pwaLikelihood_CovarianceMatrixFromMatrix)
 		.def("CovarianceMatrix", ::pwaLikelihood_CovarianceMatrixFromPar)
@@ -288,6 +421,67 @@ void rpwa::py::exportPwaLikelihood() {
 			, &rpwa::pwaLikelihood<std::complex<double> >::parameters
 			, bp::return_internal_reference<>()
 		)
+		.def(
+			"enableSimd"
+			, &rpwa::pwaLikelihood<std::complex<double> >::enableSimd
+			, (bp::arg("enableSimd") = true)
+		)
+		.def("simdEnabled", &rpwa::pwaLikelihood<std::complex<double> >::simdEnabled)
+		.def(
+			"enableFloatStorage"
+			, &rpwa::pwaLikelihood<std::complex<double> >::enableFloatStorage
+			, (bp::arg("enableFloat") = true)
+		)
+		.def("floatStorageEnabled", &rpwa::pwaLikelihood<std::complex<double> >::floatStorageEnabled)
+		.def(
+			"enableCpuKernels"
+			, &rpwa::pwaLikelihood<std::complex<double> >::enableCpuKernels
+			, (bp::arg("enableCpu") = true)
+		)
+		.def("cpuKernelsEnabled", &rpwa::pwaLikelihood<std::complex<double> >::cpuKernelsEnabled)
+		.def(
+			"enableIncrementalUpdates"
+			, &rpwa::pwaLikelihood<std::complex<double> >::enableIncrementalUpdates
+			, (bp::arg("enableIncremental") = true,
+			   bp::arg("maxNmbIncrementalUpdates") = 100)
+		)
+		.def("incrementalUpdatesEnabled", &rpwa::pwaLikelihood<std::complex<double> >::incrementalUpdatesEnabled)
+		.def(
+			"setAmplitudeCacheDirectory"
+			, &rpwa::pwaLikelihood<std::complex<double> >::setAmplitudeCacheDirectory
+			, (bp::arg("cacheDirectory"))
+		)
+		.def(
+			"amplitudeCacheDirectory"
+			, &rpwa::pwaLikelihood<std::complex<double> >::amplitudeCacheDirectory
+			, bp::return_value_policy<bp::copy_const_reference>()
+		)
+		.def(
+			"setBinIndexDirectory"
+			, &rpwa::pwaLikelihood<std::complex<double> >::setBinIndexDirectory
+			, (bp::arg("indexDirectory"))
+		)
+		.def(
+			"binIndexDirectory"
+			, &rpwa::pwaLikelihood<std::complex<double> >::binIndexDirectory
+			, bp::return_value_policy<bp::copy_const_reference>()
+		)
+		.def(
+			"enableMpi"
+			, &rpwa::pwaLikelihood<std::complex<double> >::enableMpi
+			, (bp::arg("enableMpi") = true)
+		)
+		.def("mpiEnabled", &rpwa::pwaLikelihood<std::complex<double> >::mpiEnabled)
+		.def("mpiRank", &rpwa::pwaLikelihood<std::complex<double> >::mpiRank)
+		.def("mpiSize", &rpwa::pwaLikelihood<std::complex<double> >::mpiSize)
+		.def("runMpiWorker", &rpwa::pwaLikelihood<std::complex<double> >::runMpiWorker)
+		.def("stopMpiWorkers", &rpwa::pwaLikelihood<std::complex<double> >::stopMpiWorkers)
+		.def(
+			"setNmbThreads"
+			, &rpwa::pwaLikelihood<std::complex<double> >::setNmbThreads
+			, (bp::arg("nmbThreads") = 0)
+		)
+		.def("nmbThreads", &rpwa::pwaLikelihood<std::complex<double> >::nmbThreads)
 		.def("useNormalizedAmps", &rpwa::pwaLikelihood<std::complex<double> >::useNormalizedAmps)
 		.def("setPriorType", &rpwa::pwaLikelihood<std::complex<double> >::setPriorType)
 		.def("priorType", &rpwa::pwaLikelihood<std::complex<double> >::priorType)
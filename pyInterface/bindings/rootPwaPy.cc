@@ -7,6 +7,8 @@
 // decayAmplitude
 #include "ampIntegralMatrix_py.h"
 #include "ampIntegralMatrixMetadata_py.h"
+#include "ampIntegralPackedMatrix_py.h"
+#include "ampIntegralShard_py.h"
 #include "decayTopology_py.h"
 #include "diffractiveDissVertex_py.h"
 #include "fsVertex_py.h"
@@ -34,8 +36,10 @@
 
 // highLevelInterface
 #include "calcAmplitude_py.h"
+#include "calcIntegralOnTheFly_py.h"
 #include "getMassShapes_py.h"
 #include "pwaFit_py.h"
+#include "pwaFitBins_py.h"
 #ifdef USE_NLOPT
 #include "pwaNloptFit_py.h"
 #endif
@@ -58,10 +62,13 @@
 
 // storageFormats
 #include "amplitudeFileWriter_py.h"
+#include "amplitudeMatrixFileWriter_py.h"
+#include "amplitudeMatrixMetadata_py.h"
 #include "amplitudeMetadata_py.h"
 #include "amplitudeTreeLeaf_py.h"
 #include "eventFileWriter_py.h"
 #include "eventMetadata_py.h"
+#include "eventWeights_py.h"
 #include "hashCalculator_py.h"
 
 // utilities
@@ -90,6 +97,8 @@ BOOST_PYTHON_MODULE(libRootPwaPy){
 	rpwa::py::exportAmplitudeTreeLeaf();
 	rpwa::py::exportAmpIntegralMatrix();
 	rpwa::py::exportAmpIntegralMatrixMetadata();
+	rpwa::py::exportAmpIntegralPackedMatrix();
+	rpwa::py::exportAmpIntegralShard();
 	rpwa::py::exportPhaseSpaceIntegral();
 	rpwa::py::exportNBodyPhaseSpaceKinematics();
 	rpwa::py::exportNBodyPhaseSpaceGenerator();
@@ -110,12 +119,17 @@ BOOST_PYTHON_MODULE(libRootPwaPy){
 	rpwa::py::exportReportingUtilsEnvironment();
 	rpwa::py::exportEventFileWriter();
 	rpwa::py::exportEventMetadata();
+	rpwa::py::exportEventWeights();
 	rpwa::py::exportHashCalculator();
 	rpwa::py::exportAmplitudeFileWriter();
 	rpwa::py::exportAmplitudeMetadata();
+	rpwa::py::exportAmplitudeMatrixFileWriter();
+	rpwa::py::exportAmplitudeMatrixMetadata();
 	rpwa::py::exportCalcAmplitude();
+	rpwa::py::exportCalcIntegralOnTheFly();
 	rpwa::py::exportPwaLikelihood();
 	rpwa::py::exportPwaFit();
+	rpwa::py::exportPwaFitBins();
 	rpwa::py::exportGetMassShapes();
 #ifdef USE_NLOPT
 	rpwa::py::exportPwaNloptFit();
@@ -17,7 +17,8 @@ namespace {
 	                                    const std::string&         keyfileContent,
 	                                    const std::string&         objectBasename,
 	                                    const int&                 splitlevel = 99,
-	                                    const int&                 buffsize = 256000)
+	                                    const int&                 buffsize = 256000,
+	                                    const unsigned int         columnarChunkSize = 0)
 	{
 		TFile* outputFile = rpwa::py::convertFromPy<TFile*>(pyOutputFile);
 		std::vector<const rpwa::eventMetadata*> eventMeta;
@@ -26,7 +27,7 @@ namespace {
 			PyErr_SetString(PyExc_TypeError, "Got invalid input for eventMetadata when executing rpwa::amplitudeFileWriter::initialize()");
 			bp::throw_error_already_set();
 		}
-		return self.initialize(*outputFile, eventMeta, keyfileContent, objectBasename, splitlevel, buffsize);
+		return self.initialize(*outputFile, eventMeta, keyfileContent, objectBasename, splitlevel, buffsize, columnarChunkSize);
 	}
 
 	void amplitudeFileWriter_addAmplitudes(rpwa::amplitudeFileWriter& self,
@@ -55,7 +56,8 @@ void rpwa::py::exportAmplitudeFileWriter() {
 			   bp::arg("keyfileContent"),
 			   bp::arg("objectBaseName"),
 			   bp::arg("splitlevel")=99,
-			   bp::arg("buffsize")=256000)
+			   bp::arg("buffsize")=256000,
+			   bp::arg("columnarChunkSize")=0)
 		)
 
 		.def("addAmplitude", &rpwa::amplitudeFileWriter::addAmplitude)
@@ -0,0 +1,129 @@
+#include "amplitudeMatrixFileWriter_py.h"
+
+#include <boost/python.hpp>
+
+#include "amplitudeMatrixFileWriter.h"
+#include "amplitudeMetadata.h"
+#include "rootConverters_py.h"
+#include "stlContainers_py.h"
+
+namespace bp = boost::python;
+
+
+namespace {
+
+	bool amplitudeMatrixFileWriter_initialize(rpwa::amplitudeMatrixFileWriter& self,
+	                                          PyObject*                        pyOutputFile,
+	                                          bp::object                       pyEventMetadata,
+	                                          bp::object                       pyWaveNames,
+	                                          bp::object                       pyKeyfileContents,
+	                                          const std::string&               objectBasename,
+	                                          const unsigned int               chunkSize = rpwa::amplitudeMatrixMetadata::defaultChunkSize,
+	                                          const int&                       buffsize = 256000)
+	{
+		TFile* outputFile = rpwa::py::convertFromPy<TFile*>(pyOutputFile);
+		std::vector<const rpwa::eventMetadata*> eventMeta;
+		if(not rpwa::py::convertBPObjectToVector<const rpwa::eventMetadata*>(pyEventMetadata, eventMeta))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for eventMetadata when executing rpwa::amplitudeMatrixFileWriter::initialize()");
+			bp::throw_error_already_set();
+		}
+		std::vector<std::string> waveNames;
+		if(not rpwa::py::convertBPObjectToVector<std::string>(pyWaveNames, waveNames))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for waveNames when executing rpwa::amplitudeMatrixFileWriter::initialize()");
+			bp::throw_error_already_set();
+		}
+		std::vector<std::string> keyfileContents;
+		if(not rpwa::py::convertBPObjectToVector<std::string>(pyKeyfileContents, keyfileContents))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for keyfileContents when executing rpwa::amplitudeMatrixFileWriter::initialize()");
+			bp::throw_error_already_set();
+		}
+		return self.initialize(*outputFile, eventMeta, waveNames, keyfileContents, objectBasename, chunkSize, buffsize);
+	}
+
+	bool amplitudeMatrixFileWriter_addEvent(rpwa::amplitudeMatrixFileWriter& self,
+	                                        bp::object                       pyAmplitudes)
+	{
+		std::vector<std::complex<double> > amplitudes;
+		if(not rpwa::py::convertBPObjectToVector<std::complex<double> >(pyAmplitudes, amplitudes))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudes when executing rpwa::amplitudeMatrixFileWriter::addEvent()");
+			bp::throw_error_already_set();
+		}
+		return self.addEvent(amplitudes);
+	}
+
+	bool amplitudeMatrixFileWriter_addEvents(rpwa::amplitudeMatrixFileWriter& self,
+	                                         bp::object                       pyWaveAmplitudes)
+	{
+		bp::list pyWaveAmplitudesList = bp::extract<bp::list>(pyWaveAmplitudes);
+		std::vector<std::vector<std::complex<double> > > waveAmplitudes(bp::len(pyWaveAmplitudesList));
+		for(unsigned int iWave = 0; iWave < waveAmplitudes.size(); ++iWave) {
+			if(not rpwa::py::convertBPObjectToVector<std::complex<double> >(pyWaveAmplitudesList[iWave], waveAmplitudes[iWave]))
+			{
+				PyErr_SetString(PyExc_TypeError, "Got invalid input for waveAmplitudes when executing rpwa::amplitudeMatrixFileWriter::addEvents()");
+				bp::throw_error_already_set();
+			}
+		}
+		return self.addEvents(waveAmplitudes);
+	}
+
+	bool amplitudeMatrixFileWriter_convertAmplitudeFiles(PyObject*          pyOutputFile,
+	                                                     bp::object         pyAmpMetas,
+	                                                     const std::string& objectBaseName,
+	                                                     const unsigned int chunkSize = rpwa::amplitudeMatrixMetadata::defaultChunkSize)
+	{
+		TFile* outputFile = rpwa::py::convertFromPy<TFile*>(pyOutputFile);
+		if(not outputFile) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for outputFile when executing rpwa::amplitudeMatrixFileWriter::convertAmplitudeFiles()");
+			bp::throw_error_already_set();
+		}
+		std::vector<const rpwa::amplitudeMetadata*> ampMetas;
+		if(not rpwa::py::convertBPObjectToVector<const rpwa::amplitudeMetadata*>(pyAmpMetas, ampMetas))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudeMetadata when executing rpwa::amplitudeMatrixFileWriter::convertAmplitudeFiles()");
+			bp::throw_error_already_set();
+		}
+		return rpwa::amplitudeMatrixFileWriter::convertAmplitudeFiles(*outputFile, ampMetas, objectBaseName, chunkSize);
+	}
+
+}
+
+
+void rpwa::py::exportAmplitudeMatrixFileWriter() {
+
+	bp::class_<rpwa::amplitudeMatrixFileWriter, boost::noncopyable>("amplitudeMatrixFileWriter")
+		.def(
+			"initialize"
+			, &amplitudeMatrixFileWriter_initialize
+			, (bp::arg("outputFile"),
+			   bp::arg("eventMetadata"),
+			   bp::arg("waveNames"),
+			   bp::arg("keyfileContents"),
+			   bp::arg("objectBaseName"),
+			   bp::arg("chunkSize")=rpwa::amplitudeMatrixMetadata::defaultChunkSize,
+			   bp::arg("buffsize")=256000)
+		)
+
+		.def("addEvent", &amplitudeMatrixFileWriter_addEvent)
+		.def("addEvents", &amplitudeMatrixFileWriter_addEvents)
+		.def("reset", &rpwa::amplitudeMatrixFileWriter::reset)
+		.def("finalize", &rpwa::amplitudeMatrixFileWriter::finalize)
+		.def(
+			"initialized"
+			, &rpwa::amplitudeMatrixFileWriter::initialized
+			, bp::return_value_policy<bp::copy_const_reference>()
+		)
+		.def(
+			"convertAmplitudeFiles"
+			, &amplitudeMatrixFileWriter_convertAmplitudeFiles
+			, (bp::arg("outputFile"),
+			   bp::arg("amplitudeMetadata"),
+			   bp::arg("objectBaseName"),
+			   bp::arg("chunkSize")=rpwa::amplitudeMatrixMetadata::defaultChunkSize)
+		)
+		.staticmethod("convertAmplitudeFiles");
+
+}
@@ -0,0 +1,10 @@
+#ifndef AMPLITUDEMATRIXFILEWRITER_PY_H
+#define AMPLITUDEMATRIXFILEWRITER_PY_H
+
+namespace rpwa {
+	namespace py {
+		void exportAmplitudeMatrixFileWriter();
+	}
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include "amplitudeMatrixMetadata_py.h"
+
+#include <boost/python.hpp>
+
+#include <TPython.h>
+#include <TTree.h>
+
+#include "amplitudeMatrixMetadata.h"
+#include "rootConverters_py.h"
+
+namespace bp = boost::python;
+
+
+namespace {
+
+	bp::list amplitudeMatrixMetadata_contentHashes(const rpwa::amplitudeMatrixMetadata& self)
+	{
+		return bp::list(self.contentHashes());
+	}
+
+	bp::list amplitudeMatrixMetadata_eventMetadata(const rpwa::amplitudeMatrixMetadata& self)
+	{
+		bp::list retval;
+		const std::vector<rpwa::eventMetadata>& metas = self.eventMetadata();
+		for(unsigned int i = 0; i < metas.size(); ++i) {
+			retval.append(bp::object(boost::cref(metas[i])));
+		}
+		return retval;
+	}
+
+	bp::list amplitudeMatrixMetadata_waveNames(const rpwa::amplitudeMatrixMetadata& self)
+	{
+		return bp::list(self.waveNames());
+	}
+
+	bp::list amplitudeMatrixMetadata_keyfileContents(const rpwa::amplitudeMatrixMetadata& self)
+	{
+		return bp::list(self.keyfileContents());
+	}
+
+	const rpwa::amplitudeMatrixMetadata* amplitudeMatrixMetadata_readAmplitudeMatrixFile(PyObject* pyInputFile,
+	                                                                                     const std::string& objectBaseName,
+	                                                                                     const bool& quiet = false)
+	{
+		TFile* inputFile = rpwa::py::convertFromPy<TFile*>(pyInputFile);
+		if(not inputFile) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for inputFile when executing rpwa::amplitudeMatrixMetadata::readAmplitudeMatrixFile()");
+			bp::throw_error_already_set();
+		}
+		return rpwa::amplitudeMatrixMetadata::readAmplitudeMatrixFile(inputFile, objectBaseName, quiet);
+	}
+
+	PyObject* amplitudeMatrixMetadata_amplitudeTree(rpwa::amplitudeMatrixMetadata& self)
+	{
+		TTree* tree = self.amplitudeTree();
+		return TPython::ObjectProxy_FromVoidPtr(tree, tree->ClassName());
+	}
+
+}
+
+
+void rpwa::py::exportAmplitudeMatrixMetadata() {
+
+	bp::class_<rpwa::amplitudeMatrixMetadata, boost::noncopyable>("amplitudeMatrixMetadata", bp::no_init)
+		.def(bp::self_ns::str(bp::self))
+		.def("contentHashes", &amplitudeMatrixMetadata_contentHashes)
+		.def("eventMetadata", &amplitudeMatrixMetadata_eventMetadata)
+		.def("waveNames", &amplitudeMatrixMetadata_waveNames)
+		.def("keyfileContents", &amplitudeMatrixMetadata_keyfileContents)
+		.def(
+			"rootpwaGitHash"
+			, &rpwa::amplitudeMatrixMetadata::rootpwaGitHash
+			, bp::return_value_policy<bp::copy_const_reference>()
+		)
+		.def(
+			"objectBaseName"
+			, &rpwa::amplitudeMatrixMetadata::objectBaseName
+			, bp::return_value_policy<bp::copy_const_reference>()
+		)
+		.def("chunkSize", &rpwa::amplitudeMatrixMetadata::chunkSize)
+		.def("nmbWaves", &rpwa::amplitudeMatrixMetadata::nmbWaves)
+		.def("nmbEvents", &rpwa::amplitudeMatrixMetadata::nmbEvents)
+		.def("waveIndex", &rpwa::amplitudeMatrixMetadata::waveIndex, bp::arg("waveName"))
+		.def(
+			"checkHashes"
+			, &rpwa::amplitudeMatrixMetadata::checkHashes
+			, (bp::arg("printProgress")=false)
+		)
+		.def(
+			"readAmplitudeMatrixFile"
+			, &amplitudeMatrixMetadata_readAmplitudeMatrixFile
+			, (bp::arg("inputFile"), bp::arg("objectBaseName"), bp::arg("quiet")=false)
+			, bp::return_value_policy<bp::manage_new_object, bp::with_custodian_and_ward_postcall<0, 1> >()
+		)
+		.staticmethod("readAmplitudeMatrixFile")
+		.def("amplitudeTree", &amplitudeMatrixMetadata_amplitudeTree)
+		.def_readonly("defaultChunkSize", &rpwa::amplitudeMatrixMetadata::defaultChunkSize)
+		;
+
+}
@@ -0,0 +1,10 @@
+#ifndef AMPLITUDEMATRIXMETADATA_PY_H
+#define AMPLITUDEMATRIXMETADATA_PY_H
+
+namespace rpwa {
+	namespace py {
+		void exportAmplitudeMatrixMetadata();
+	}
+}
+
+#endif
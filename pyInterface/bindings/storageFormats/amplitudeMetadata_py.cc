@@ -35,6 +35,22 @@ namespace {
 		return rpwa::amplitudeMetadata::readAmplitudeFile(inputFile, objectBaseName, quiet);
 	}
 
+	bp::list amplitudeMetadata_readAmplitudes(const rpwa::amplitudeMetadata& self,
+	                                          const long firstAmplitude,
+	                                          const long nmbAmplitudes)
+	{
+		std::vector<std::complex<double> > amplitudes(nmbAmplitudes);
+		if(not self.readAmplitudes(firstAmplitude, nmbAmplitudes, amplitudes.data())) {
+			PyErr_SetString(PyExc_ValueError, "Could not read amplitudes when executing rpwa::amplitudeMetadata::readAmplitudes()");
+			bp::throw_error_already_set();
+		}
+		bp::list retval;
+		for(unsigned int i = 0; i < amplitudes.size(); ++i) {
+			retval.append(amplitudes[i]);
+		}
+		return retval;
+	}
+
 	PyObject* amplitudeMetadata_amplitudeTree(rpwa::amplitudeMetadata& self)
 	{
 		TTree* tree = self.amplitudeTree();
@@ -81,8 +97,17 @@ void rpwa::py::exportAmplitudeMetadata() {
 			, bp::return_value_policy<bp::manage_new_object, bp::with_custodian_and_ward_postcall<0, 1> >()
 		)
 		.staticmethod("readAmplitudeFile")
+		.def("columnar", &rpwa::amplitudeMetadata::columnar)
+		.def("chunkSize", &rpwa::amplitudeMetadata::chunkSize)
+		.def("nmbAmplitudes", &rpwa::amplitudeMetadata::nmbAmplitudes)
+		.def(
+			"readAmplitudes"
+			, &amplitudeMetadata_readAmplitudes
+			, (bp::arg("firstAmplitude"), bp::arg("nmbAmplitudes"))
+		)
 		.def("amplitudeTree", &amplitudeMetadata_amplitudeTree)
 		.def_readonly("amplitudeLeafName", &rpwa::amplitudeMetadata::amplitudeLeafName)
+		.def_readonly("defaultChunkSize", &rpwa::amplitudeMetadata::defaultChunkSize)
 		;
 
 }
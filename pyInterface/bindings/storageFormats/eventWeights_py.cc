@@ -0,0 +1,59 @@
+#include "eventWeights_py.h"
+
+#include <boost/python.hpp>
+
+#include "eventMetadata.h"
+#include "eventWeights.h"
+#include "stlContainers_py.h"
+
+namespace bp = boost::python;
+
+
+namespace {
+
+	bp::object eventWeights_readWeights(const std::string&         weightSource,
+	                                    const rpwa::eventMetadata& eventMeta)
+	{
+		std::vector<double> weights;
+		if(not rpwa::eventWeights::readWeights(weightSource, eventMeta, weights)) {
+			return bp::object();
+		}
+		return bp::list(weights);
+	}
+
+	bool eventWeights_writeWeightFile(const std::string& fileName,
+	                                  const std::string& eventContentHash,
+	                                  const bp::object&  pyWeights)
+	{
+		std::vector<double> weights;
+		if(not rpwa::py::convertBPObjectToVector<double>(pyWeights, weights)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for weights when executing rpwa::eventWeights::writeWeightFile()");
+			bp::throw_error_already_set();
+		}
+		return rpwa::eventWeights::writeWeightFile(fileName, eventContentHash, weights);
+	}
+
+}
+
+
+void rpwa::py::exportEventWeights() {
+
+	bp::scope theScope = bp::class_<rpwa::eventWeights, boost::noncopyable>("eventWeights", bp::no_init)
+
+		.def("sourceType", &rpwa::eventWeights::sourceType, (bp::arg("weightSource"), bp::arg("eventMeta")))
+		.staticmethod("sourceType")
+		.def("readWeights", &::eventWeights_readWeights, (bp::arg("weightSource"), bp::arg("eventMeta")))
+		.staticmethod("readWeights")
+		.def("writeWeightFile", &::eventWeights_writeWeightFile, (bp::arg("fileName"), bp::arg("eventContentHash"), bp::arg("weights")))
+		.staticmethod("writeWeightFile")
+		.def_readonly("weightVariableLabel", &rpwa::eventWeights::weightVariableLabel)
+
+		;
+
+	bp::enum_<rpwa::eventWeights::sourceTypeEnum>("sourceTypeEnum")
+		.value("COLUMN", rpwa::eventWeights::COLUMN)
+		.value("BINARY_FILE", rpwa::eventWeights::BINARY_FILE)
+		.value("TEXT_FILE", rpwa::eventWeights::TEXT_FILE)
+		.export_values();
+
+}
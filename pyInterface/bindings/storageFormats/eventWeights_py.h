@@ -0,0 +1,10 @@
+#ifndef EVENTWEIGHTS_PY_H
+#define EVENTWEIGHTS_PY_H
+
+namespace rpwa {
+	namespace py {
+		void exportEventWeights();
+	}
+}
+
+#endif//EVENTWEIGHTS_PY_H
@@ -1,5 +1,9 @@
 
+from _amplitude import amplitudeMatrixObjectBaseName
 from _amplitude import calcAmplitude
+from _amplitude import calcAmplitudes
+from _amplitude import convertToAmplitudeMatrix
+from _amplitude import getAmplitudeMatrixFilePath
 from _config import rootPwaConfig
 from _fileManager import fileManager
 from _fileManager import saveFileManager
@@ -7,6 +11,9 @@ from _fileManager import loadFileManager
 from _fit import pwaFit
 from _fit import pwaNloptFit
 from _integrals import calcIntegrals
+from _integrals import calcIntegralsForBins
+from _integrals import calcIntegralShard
+from _integrals import mergeIntegralShards
 from _integralsOnTheFly import calcIntegralsOnTheFly
 from _likelihood import initLikelihood
 
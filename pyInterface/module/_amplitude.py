@@ -1,5 +1,6 @@
 
 import os as _os
+import socket as _socket
 
 import pyRootPwa.core
 import pyRootPwa.utils
@@ -9,7 +10,10 @@ def calcAmplitude(inputFileName,
                   waveName,
                   waveDescription,
                   outputFileName,
-                  printProgress = True):
+                  printProgress = True,
+                  columnar = False,
+                  nmbThreads = 1,
+                  compiledProgram = False):
 
 	printInfo = pyRootPwa.utils.printInfo
 	printSucc = pyRootPwa.utils.printSucc
@@ -40,14 +44,16 @@ def calcAmplitude(inputFileName,
 		printWarn("could not construct amplitude for wave '" + waveName + "'.")
 		outputFile.Close()
 		return False
+	amplitude.useCompiledProgram = compiledProgram
 
 	ampFileWriter = pyRootPwa.core.amplitudeFileWriter()
 	objectBaseName = waveDescription.waveNameFromTopology(amplitude.decayTopology())
-	if not ampFileWriter.initialize(outputFile, [eventMeta], waveDescription.keyFileContent(), objectBaseName):
+	columnarChunkSize = pyRootPwa.core.amplitudeMetadata.defaultChunkSize if columnar else 0
+	if not ampFileWriter.initialize(outputFile, [eventMeta], waveDescription.keyFileContent(), objectBaseName, columnarChunkSize = columnarChunkSize):
 		printWarn("could not initialize amplitudeFileWriter.")
 		outputFile.Close()
 		return False
-	amplitudes = pyRootPwa.core.calcAmplitude(eventMeta, amplitude, -1, printProgress)
+	amplitudes = pyRootPwa.core.calcAmplitude(eventMeta, amplitude, -1, printProgress, nmbThreads = nmbThreads)
 	if not amplitudes:
 		printWarn("could not calculate amplitudes.")
 		outputFile.Close()
@@ -66,3 +72,203 @@ def calcAmplitude(inputFileName,
 	outputFile.Close()
 	printSucc("successfully calculated amplitude for " + str(nEvents) + " events.")
 	return True
+
+
+def calcAmplitudes(inputFileName,
+                   waveNames,
+                   waveDescriptions,
+                   outputFileNames,
+                   printProgress = True,
+                   columnar = False,
+                   eventBlockSize = 100000,
+                   nmbThreads = 1,
+                   compiledProgram = False):
+	# calculates the amplitudes of all given waves in a single pass over
+	# the events of the input file; outputFileNames is either a list with
+	# one amplitude file per wave or the name of a single amplitude matrix
+	# file. the events are processed in blocks of eventBlockSize events,
+	# so that only the amplitudes of one block are kept in memory. with
+	# nmbThreads != 1 the amplitudes are calculated in parallel
+	# (0 = all available threads). with compiledProgram the decay trees
+	# are evaluated by the compiled decay programs
+
+	printInfo = pyRootPwa.utils.printInfo
+	printSucc = pyRootPwa.utils.printSucc
+	printWarn = pyRootPwa.utils.printWarn
+
+	writeMatrix = isinstance(outputFileNames, str)
+	if writeMatrix:
+		printInfo("Calculating amplitudes for " + str(len(waveNames)) + " waves with input file '" + inputFileName + "', " +
+		          "output amplitude matrix file '" + outputFileNames + "'.")
+	else:
+		if len(outputFileNames) != len(waveNames):
+			printWarn("number of output files (" + str(len(outputFileNames)) + ") does not match number of waves (" + str(len(waveNames)) + ").")
+			return False
+		printInfo("Calculating amplitudes for " + str(len(waveNames)) + " waves with input file '" + inputFileName + "'.")
+
+	if 'ROOTPWA' not in _os.environ:
+		printWarn("$ROOTPWA not set.")
+		return False
+
+	# existing output files are never overwritten; waves whose amplitude
+	# file already exists are skipped
+	if writeMatrix:
+		if _os.path.exists(outputFileNames):
+			printWarn("output file '" + outputFileNames + "' already exists.")
+			return False
+	else:
+		waveIndices = [ ]
+		for waveIndex, outputFileName in enumerate(outputFileNames):
+			if _os.path.exists(outputFileName):
+				printInfo("output file '" + outputFileName + "' already exists. skipping wave '" + waveNames[waveIndex] + "'.")
+			else:
+				waveIndices.append(waveIndex)
+		if not waveIndices:
+			printSucc("amplitudes of all " + str(len(waveNames)) + " waves exist already.")
+			return True
+		waveNames        = [ waveNames[waveIndex]        for waveIndex in waveIndices ]
+		waveDescriptions = [ waveDescriptions[waveIndex] for waveIndex in waveIndices ]
+		outputFileNames  = [ outputFileNames[waveIndex]  for waveIndex in waveIndices ]
+
+	inputFile = ROOT.TFile.Open(inputFileName, "READ")
+	if not inputFile:
+		printWarn("could not open input file '" + inputFileName + "'.")
+		return False
+	eventMeta = pyRootPwa.core.eventMetadata.readEventFile(inputFile, True)
+	if not eventMeta:
+		printWarn("could not read metadata from input file '" + inputFileName + "'.")
+		return False
+
+	amplitudes = [ ]
+	objectBaseNames = [ ]
+	for waveName, waveDescription in zip(waveNames, waveDescriptions):
+		(result, amplitude) = waveDescription.constructAmplitude()
+		if not result:
+			printWarn("could not construct amplitude for wave '" + waveName + "'.")
+			return False
+		amplitude.useCompiledProgram = compiledProgram
+		amplitudes.append(amplitude)
+		objectBaseNames.append(waveDescription.waveNameFromTopology(amplitude.decayTopology()))
+
+	# the amplitudes are written to temporary files, which are renamed
+	# only after all of them were finalized, so that no partial output
+	# files are left behind if anything fails
+	tmpSuffix = ".tmp." + _socket.gethostname() + "." + str(_os.getpid())
+	outputFiles = [ ]
+	tmpFileNames = [ ]
+	ampFileWriters = [ ]
+	def closeOutputFiles():
+		for outputFile in outputFiles:
+			outputFile.Close()
+		del outputFiles[:]
+	def removeOutputFiles():
+		closeOutputFiles()
+		for tmpFileName in tmpFileNames:
+			if _os.path.exists(tmpFileName):
+				_os.remove(tmpFileName)
+	if writeMatrix:
+		tmpFileNames.append(outputFileNames + tmpSuffix)
+		outputFile = ROOT.TFile.Open(tmpFileNames[-1], "NEW")
+		if not outputFile:
+			printWarn("could not open output file '" + tmpFileNames[-1] + "'.")
+			removeOutputFiles()
+			return False
+		outputFiles.append(outputFile)
+		ampFileWriter = pyRootPwa.core.amplitudeMatrixFileWriter()
+		if not ampFileWriter.initialize(outputFile, [eventMeta], objectBaseNames, [ waveDescription.keyFileContent() for waveDescription in waveDescriptions ],
+		                                amplitudeMatrixObjectBaseName):
+			printWarn("could not initialize amplitudeMatrixFileWriter.")
+			removeOutputFiles()
+			return False
+		ampFileWriters.append(ampFileWriter)
+	else:
+		columnarChunkSize = pyRootPwa.core.amplitudeMetadata.defaultChunkSize if columnar else 0
+		for waveDescription, objectBaseName, outputFileName in zip(waveDescriptions, objectBaseNames, outputFileNames):
+			tmpFileNames.append(outputFileName + tmpSuffix)
+			outputFile = ROOT.TFile.Open(tmpFileNames[-1], "NEW")
+			if not outputFile:
+				printWarn("could not open output file '" + tmpFileNames[-1] + "'.")
+				removeOutputFiles()
+				return False
+			outputFiles.append(outputFile)
+			ampFileWriter = pyRootPwa.core.amplitudeFileWriter()
+			if not ampFileWriter.initialize(outputFile, [eventMeta], waveDescription.keyFileContent(), objectBaseName, columnarChunkSize = columnarChunkSize):
+				printWarn("could not initialize amplitudeFileWriter for output file '" + outputFileName + "'.")
+				removeOutputFiles()
+				return False
+			ampFileWriters.append(ampFileWriter)
+
+	# the amplitudes are set up only once, the blocks of eventBlockSize
+	# events are calculated and written by the C++ code
+	if writeMatrix:
+		success = pyRootPwa.core.writeAmplitudeMatrix(eventMeta, amplitudes, ampFileWriters[0], eventBlockSize, printProgress, nmbThreads = nmbThreads)
+	else:
+		success = pyRootPwa.core.writeAmplitudes(eventMeta, amplitudes, ampFileWriters, eventBlockSize, printProgress, nmbThreads = nmbThreads)
+	if not success:
+		printWarn("could not calculate amplitudes.")
+		removeOutputFiles()
+		return False
+
+	for ampFileWriter in ampFileWriters:
+		if not ampFileWriter.finalize():
+			printWarn("could not finalize amplitude file writer.")
+			removeOutputFiles()
+			return False
+	closeOutputFiles()
+	finalFileNames = [ outputFileNames ] if writeMatrix else outputFileNames
+	for tmpFileName, outputFileName in zip(tmpFileNames, finalFileNames):
+		try:
+			_os.rename(tmpFileName, outputFileName)
+		except OSError as error:
+			printWarn("could not rename '" + tmpFileName + "' to '" + outputFileName + "': " + str(error))
+			removeOutputFiles()
+			return False
+	printSucc("successfully calculated amplitudes of " + str(len(waveNames)) + " waves for " + str(eventMeta.eventTree().GetEntries()) + " events.")
+	return True
+
+
+amplitudeMatrixObjectBaseName = "amplitudeMatrix"
+
+
+def getAmplitudeMatrixFilePath(eventFileName, directory):
+	return directory + "/" + _os.path.splitext(_os.path.basename(eventFileName))[0] + ".ampMatrix.root"
+
+
+def convertToAmplitudeMatrix(waveAmpFileDict,
+                             outputFileName,
+                             chunkSize = None):
+
+	printInfo = pyRootPwa.utils.printInfo
+	printSucc = pyRootPwa.utils.printSucc
+	printWarn = pyRootPwa.utils.printWarn
+
+	printInfo("Converting " + str(len(waveAmpFileDict)) + " amplitude files to amplitude matrix file '" + outputFileName + "'.")
+
+	if chunkSize is None:
+		chunkSize = pyRootPwa.core.amplitudeMatrixMetadata.defaultChunkSize
+	ampFiles = [ ]
+	ampMetas = [ ]
+	for waveName, ampFileName in waveAmpFileDict.items():
+		ampFile = ROOT.TFile.Open(ampFileName, "READ")
+		if not ampFile:
+			printWarn("could not open amplitude file '" + ampFileName + "'.")
+			return False
+		ampMeta = pyRootPwa.core.amplitudeMetadata.readAmplitudeFile(ampFile, waveName)
+		if not ampMeta:
+			printWarn("could not read metadata for wave '" + waveName + "' from amplitude file '" + ampFileName + "'.")
+			return False
+		ampFiles.append(ampFile)
+		ampMetas.append(ampMeta)
+	outputFile = ROOT.TFile.Open(outputFileName, "NEW")
+	if not outputFile:
+		printWarn("could not open output file '" + outputFileName + "'.")
+		return False
+	if not pyRootPwa.core.amplitudeMatrixFileWriter.convertAmplitudeFiles(outputFile, ampMetas, amplitudeMatrixObjectBaseName, chunkSize):
+		printWarn("could not convert amplitude files.")
+		outputFile.Close()
+		return False
+	outputFile.Close()
+	for ampFile in ampFiles:
+		ampFile.Close()
+	printSucc("successfully converted amplitudes of " + str(len(ampMetas)) + " waves.")
+	return True
@@ -19,7 +19,11 @@ def pwaFit(eventAndAmpFileDict,
            saveSpace=False,
            rank=1,
            verbose=False,
-           attempts=1
+           attempts=1,
+           mpi=False,
+           ampMatrixFileDict=None,
+           ampCacheDirectory="",
+           binIndexDirectory=""
           ):
 
 	waveDescThres = pyRootPwa.utils.getWaveDescThresFromWaveList(waveListFileName, waveDescriptions)
@@ -35,40 +39,54 @@ def pwaFit(eventAndAmpFileDict,
 	                                      cauchy = cauchy,
 	                                      cauchyWidth = cauchyWidth,
 	                                      rank = rank,
-	                                      verbose = verbose)
+	                                      verbose = verbose,
+	                                      mpi = mpi,
+	                                      ampMatrixFileDict = ampMatrixFileDict,
+	                                      ampCacheDirectory = ampCacheDirectory,
+	                                      binIndexDirectory = binIndexDirectory)
 	if not likelihood:
 		pyRootPwa.utils.printErr("error while initializing likelihood. Aborting...")
 		return [ ]
+	if likelihood.mpiRank() > 0:
+		# only MPI process with rank 0 runs the minimizer; all other
+		# processes contribute their events to the likelihood sums
+		likelihood.runMpiWorker()
+		return None
 
-	lowerBound = multiBin.boundaries['mass'][0]
-	upperBound = multiBin.boundaries['mass'][1]
+	# the worker processes wait for requests until rank 0 stops them,
+	# so they have to be stopped also if the fit fails
+	try:
+		lowerBound = multiBin.boundaries['mass'][0]
+		upperBound = multiBin.boundaries['mass'][1]
 
-	if attempts == 1:
-		seeds = [ seed ]
-	elif seed == 0:
-		seeds = [ 0 for _ in xrange(attempts) ]
-	else:
-		random.seed(seed)
-		seeds = [ ]
-		for _ in xrange(attempts):
-			while True:
-				randVal = random.randint(1000, 2**32-1)
-				if randVal not in seeds:
-					break
-			seeds.append(randVal)
+		if attempts == 1:
+			seeds = [ seed ]
+		elif seed == 0:
+			seeds = [ 0 for _ in xrange(attempts) ]
+		else:
+			random.seed(seed)
+			seeds = [ ]
+			for _ in xrange(attempts):
+				while True:
+					randVal = random.randint(1000, 2**32-1)
+					if randVal not in seeds:
+						break
+				seeds.append(randVal)
 
-	fitResults = [ ]
-	for fitSeed in seeds:
-		fitResult = pyRootPwa.core.pwaFit(likelihood       = likelihood,
-		                                  massBinMin       = lowerBound,
-		                                  massBinMax       = upperBound,
-		                                  seed             = fitSeed,
-		                                  startValFileName = startValFileName,
-		                                  checkHessian     = checkHessian,
-		                                  saveSpace        = saveSpace,
-		                                  verbose          = verbose)
-		fitResults.append(fitResult)
-	return fitResults
+		fitResults = [ ]
+		for fitSeed in seeds:
+			fitResult = pyRootPwa.core.pwaFit(likelihood       = likelihood,
+			                                  massBinMin       = lowerBound,
+			                                  massBinMax       = upperBound,
+			                                  seed             = fitSeed,
+			                                  startValFileName = startValFileName,
+			                                  checkHessian     = checkHessian,
+			                                  saveSpace        = saveSpace,
+			                                  verbose          = verbose)
+			fitResults.append(fitResult)
+		return fitResults
+	finally:
+		likelihood.stopMpiWorkers()
 
 
 def pwaNloptFit(eventAndAmpFileDict,
@@ -86,7 +104,13 @@ def pwaNloptFit(eventAndAmpFileDict,
                 saveSpace=False,
                 rank=1,
                 verbose=False,
-                attempts=1
+                attempts=1,
+                mpi=False,
+                nmbWorkers=0,
+                stopThreshold=0.,
+                ampMatrixFileDict=None,
+                ampCacheDirectory="",
+                binIndexDirectory=""
                ):
 
 	waveDescThres = pyRootPwa.utils.getWaveDescThresFromWaveList(waveListFileName, waveDescriptions)
@@ -102,37 +126,65 @@ def pwaNloptFit(eventAndAmpFileDict,
 	                                      cauchy = cauchy,
 	                                      cauchyWidth = cauchyWidth,
 	                                      rank = rank,
-	                                      verbose = verbose)
+	                                      verbose = verbose,
+	                                      mpi = mpi,
+	                                      ampMatrixFileDict = ampMatrixFileDict,
+	                                      ampCacheDirectory = ampCacheDirectory,
+	                                      binIndexDirectory = binIndexDirectory)
 	if not likelihood:
 		pyRootPwa.utils.printErr("error while initializing likelihood. Aborting...")
 		return [ ]
+	if likelihood.mpiRank() > 0:
+		# only MPI process with rank 0 runs the minimizer; all other
+		# processes contribute their events to the likelihood sums
+		likelihood.runMpiWorker()
+		return None
 
-	lowerBound = multiBin.boundaries['mass'][0]
-	upperBound = multiBin.boundaries['mass'][1]
+	# the worker processes wait for requests until rank 0 stops them,
+	# so they have to be stopped also if the fit fails
+	try:
+		lowerBound = multiBin.boundaries['mass'][0]
+		upperBound = multiBin.boundaries['mass'][1]
 
-	if attempts == 1:
-		seeds = [ seed ]
-	elif seed == 0:
-		seeds = [ 0 for _ in xrange(attempts) ]
-	else:
-		random.seed(seed)
-		seeds = [ ]
-		for _ in xrange(attempts):
-			while True:
-				randVal = random.randint(1000, 2**32-1)
-				if randVal not in seeds:
-					break
-			seeds.append(randVal)
+		if attempts > 1 and not mpi:
+			# run the attempts concurrently on copies of the likelihood that
+			# share the decay amplitudes
+			return pyRootPwa.core.pwaNloptMultiStartFit(likelihood    = likelihood,
+			                                            nmbAttempts   = attempts,
+			                                            massBinMin    = lowerBound,
+			                                            massBinMax    = upperBound,
+			                                            seed          = seed,
+			                                            checkHessian  = checkHessian,
+			                                            saveSpace     = saveSpace,
+			                                            nmbWorkers    = nmbWorkers,
+			                                            stopThreshold = stopThreshold,
+			                                            verbose       = verbose)
 
-	fitResults = [ ]
-	for fitSeed in seeds:
-		fitResult = pyRootPwa.core.pwaNloptFit(likelihood       = likelihood,
-		                                       massBinMin       = lowerBound,
-		                                       massBinMax       = upperBound,
-		                                       seed             = fitSeed,
-		                                       startValFileName = startValFileName,
-		                                       checkHessian     = checkHessian,
-		                                       saveSpace        = saveSpace,
-		                                       verbose          = verbose)
-		fitResults.append(fitResult)
-	return fitResults
+		if attempts == 1:
+			seeds = [ seed ]
+		elif seed == 0:
+			seeds = [ 0 for _ in xrange(attempts) ]
+		else:
+			random.seed(seed)
+			seeds = [ ]
+			for _ in xrange(attempts):
+				while True:
+					randVal = random.randint(1000, 2**32-1)
+					if randVal not in seeds:
+						break
+				seeds.append(randVal)
+
+		fitResults = [ ]
+		for fitSeed in seeds:
+			fitResult = pyRootPwa.core.pwaNloptFit(likelihood       = likelihood,
+			                                       massBinMin       = lowerBound,
+			                                       massBinMax       = upperBound,
+			                                       seed             = fitSeed,
+			                                       startValFileName = startValFileName,
+			                                       checkHessian     = checkHessian,
+			                                       saveSpace        = saveSpace,
+			                                       verbose          = verbose)
+			fitResults.append(fitResult)
+		return fitResults
+	finally:
+		likelihood.stopMpiWorkers()
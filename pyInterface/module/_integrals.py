@@ -1,8 +1,10 @@
+import os
+
 import pyRootPwa.core
 import pyRootPwa.utils
 ROOT = pyRootPwa.utils.ROOT
 
-def calcIntegrals(integralFileName, eventAndAmpFileDict, multiBin, weightFileName=""):
+def calcIntegrals(integralFileName, eventAndAmpFileDict, multiBin, weightFileName="", binIndexDirectory="", nmbThreads=0):
 	outputFile = pyRootPwa.ROOT.TFile.Open(integralFileName, "NEW")
 	if not outputFile:
 		pyRootPwa.utils.printWarn("cannot open output file '" + integralFileName + "'. Aborting...")
@@ -37,7 +39,7 @@ def calcIntegrals(integralFileName, eventAndAmpFileDict, multiBin, weightFileNam
 				# and the shape is either 0 or 1. If two such waves accidentally have the same number
 				# of events, both will also have the same hash.
 				pyRootPwa.utils.printWarn("could not add the amplitude hash.")
-		if not integrals[-1].integrate(ampMetas, -1, weightFileName, eventMeta, multiBin.boundaries):
+		if not integrals[-1].integrate(ampMetas, -1, weightFileName, eventMeta, multiBin.boundaries, binIndexDirectory, nmbThreads):
 			pyRootPwa.utils.printErr("could not run integration. Aborting...")
 			return False
 	integralMatrix = integrals[0]
@@ -52,3 +54,171 @@ def calcIntegrals(integralFileName, eventAndAmpFileDict, multiBin, weightFileNam
 		return False
 	outputFile.Close()
 	return True
+
+
+# calculates the integrals of all given bins reading each event file only
+# once; integralFileNames, eventAndAmpFileDicts and multiBins contain one
+# entry per bin. the weight file has to contain a weight for every event.
+def calcIntegralsForBins(integralFileNames, eventAndAmpFileDicts, multiBins, weightFileName="", nmbThreads=0):
+	if not len(integralFileNames) == len(eventAndAmpFileDicts) == len(multiBins):
+		pyRootPwa.utils.printErr("got different numbers of integral files, file dictionaries and bins. Aborting...")
+		return False
+	# bins using each event file
+	binsOfEventFile = {}
+	for binIndex, eventAndAmpFileDict in enumerate(eventAndAmpFileDicts):
+		for eventFileName in eventAndAmpFileDict:
+			binsOfEventFile.setdefault(eventFileName, []).append(binIndex)
+	integralMetaDatas = []
+	for multiBin in multiBins:
+		integralMetaDatas.append(pyRootPwa.core.ampIntegralMatrixMetadata())
+		integralMetaDatas[-1].setBinningMap(multiBin.boundaries)
+	integralMatrices = [ None ] * len(multiBins)
+	for eventFileName, binIndices in binsOfEventFile.iteritems():
+		ampFileDict = eventAndAmpFileDicts[binIndices[0]][eventFileName]
+		for binIndex in binIndices[1:]:
+			if eventAndAmpFileDicts[binIndex][eventFileName] != ampFileDict:
+				pyRootPwa.utils.printErr("bins use different amplitude files for event file '" + eventFileName + "'. Aborting...")
+				return False
+		(eventFile, eventMeta) = pyRootPwa.utils.openEventFile(eventFileName)
+		if not eventFile or not eventMeta:
+			pyRootPwa.utils.printErr("could not open event file '" + eventFileName + "'. Aborting...")
+			return False
+		ampMetas = []
+		for waveName, ampFileName in ampFileDict.iteritems():
+			ampFile = ROOT.TFile.Open(ampFileName, "READ")
+			if not ampFile:
+				pyRootPwa.utils.printErr("could not open amplitude file '" + ampFileName + "'. Aborting...")
+				return False
+			ampMeta = pyRootPwa.core.amplitudeMetadata.readAmplitudeFile(ampFile, waveName)
+			if not ampMeta:
+				pyRootPwa.utils.printErr("could not read metadata from amplitude file '" + ampFileName + "'. Aborting...")
+				return False
+			ampMetas.append(ampMeta)
+		for binIndex in binIndices:
+			integralMetaData = integralMetaDatas[binIndex]
+			if not integralMetaData.addEventMetadata(eventMeta):
+				pyRootPwa.utils.printErr("could not add event metadata from event file '" + eventFileName + "' to integral metadata. Aborting...")
+				return False
+			for ampMeta in ampMetas:
+				integralMetaData.addKeyFileContent(ampMeta.keyfileContent())
+				if not integralMetaData.addAmplitudeHash(ampMeta.contentHash()):
+					# not fatal, see calcIntegrals()
+					pyRootPwa.utils.printWarn("could not add the amplitude hash.")
+		integrals = pyRootPwa.core.ampIntegralMatrix.integrateBins(ampMetas, eventMeta, [ multiBins[binIndex].boundaries for binIndex in binIndices ],
+		                                                           -1, weightFileName, nmbThreads)
+		if integrals is None:
+			pyRootPwa.utils.printErr("could not run integration. Aborting...")
+			return False
+		for binIndex, integral in zip(binIndices, integrals):
+			if integralMatrices[binIndex] is None:
+				integralMatrices[binIndex] = integral
+			else:
+				integralMatrices[binIndex] += integral
+	for binIndex, integralFileName in enumerate(integralFileNames):
+		if integralMatrices[binIndex] is None:
+			pyRootPwa.utils.printErr("no event file given for bin " + str(multiBins[binIndex]) + ". Aborting...")
+			return False
+		outputFile = pyRootPwa.ROOT.TFile.Open(integralFileName, "NEW")
+		if not outputFile:
+			pyRootPwa.utils.printWarn("cannot open output file '" + integralFileName + "'. Aborting...")
+			return False
+		if not integralMetaDatas[binIndex].setAmpIntegralMatrix(integralMatrices[binIndex]):
+			pyRootPwa.utils.printErr("could not add the integral matrix to the metadata object. Aborting...")
+			return False
+		if not integralMetaDatas[binIndex].writeToFile(outputFile):
+			pyRootPwa.utils.printErr("could not write integral objects to file. Aborting...")
+			return False
+		outputFile.Close()
+	return True
+
+
+# calculates the partial integral of shard shardIndex of nmbShards shards,
+# which split the events of all event files of a bin into ranges of equal
+# size, and writes it to shardFileName. each event file of the shard is
+# checkpointed to shardFileName + ".checkpoint<index of event file>"
+# every checkpointInterval events, so that a preempted job continues
+# where it stopped. the weight file has to contain a weight for every
+# event.
+def calcIntegralShard(shardFileName, eventAndAmpFileDict, multiBin, shardIndex=0, nmbShards=1, weightFileName="", checkpointInterval=1000000, nmbThreads=0):
+	if os.path.exists(shardFileName):
+		pyRootPwa.utils.printErr("shard file '" + shardFileName + "' already exists. Aborting...")
+		return False
+	if nmbShards < 1 or shardIndex < 0 or shardIndex >= nmbShards:
+		pyRootPwa.utils.printErr("invalid shard " + str(shardIndex) + " of " + str(nmbShards) + " shards. Aborting...")
+		return False
+	eventFileNames = sorted(eventAndAmpFileDict.keys())
+	eventFiles = []
+	for eventFileName in eventFileNames:
+		(eventFile, eventMeta) = pyRootPwa.utils.openEventFile(eventFileName)
+		if not eventFile or not eventMeta:
+			pyRootPwa.utils.printErr("could not open event file '" + eventFileName + "'. Aborting...")
+			return False
+		eventFiles.append((eventFile, eventMeta))
+	nmbEventsTotal = sum(eventMeta.eventTree().GetEntries() for (_, eventMeta) in eventFiles)
+	shardFirstEvent = (shardIndex * nmbEventsTotal) // nmbShards
+	shardLastEvent  = ((shardIndex + 1) * nmbEventsTotal) // nmbShards
+	shard = None
+	checkpointFileNames = []
+	offset = 0
+	for eventFileIndex, eventFileName in enumerate(eventFileNames):
+		eventMeta = eventFiles[eventFileIndex][1]
+		nmbEvents = eventMeta.eventTree().GetEntries()
+		firstEvent = max(shardFirstEvent - offset, 0)
+		lastEvent  = min(shardLastEvent - offset, nmbEvents)
+		offset += nmbEvents
+		if firstEvent >= lastEvent:
+			continue
+		ampMetas = []
+		for waveName, ampFileName in sorted(eventAndAmpFileDict[eventFileName].iteritems()):
+			ampFile = ROOT.TFile.Open(ampFileName, "READ")
+			if not ampFile:
+				pyRootPwa.utils.printErr("could not open amplitude file '" + ampFileName + "'. Aborting...")
+				return False
+			ampMeta = pyRootPwa.core.amplitudeMetadata.readAmplitudeFile(ampFile, waveName)
+			if not ampMeta:
+				pyRootPwa.utils.printErr("could not read metadata from amplitude file '" + ampFileName + "'. Aborting...")
+				return False
+			ampMetas.append(ampMeta)
+		checkpointFileNames.append(shardFileName + ".checkpoint" + str(eventFileIndex))
+		eventFileShard = pyRootPwa.core.ampIntegralShard()
+		if not eventFileShard.integrate(ampMetas, eventMeta, firstEvent, lastEvent, weightFileName, multiBin.boundaries,
+		                                checkpointFileNames[-1], checkpointInterval, nmbThreads):
+			pyRootPwa.utils.printErr("could not run integration of event file '" + eventFileName + "'. Aborting...")
+			return False
+		# the completed integration is the checkpoint for a restarted job
+		eventFileShard.writeToFile(checkpointFileNames[-1])
+		if shard is None:
+			shard = eventFileShard
+		elif not shard.merge(eventFileShard):
+			pyRootPwa.utils.printErr("could not merge integrals of the event files. Aborting...")
+			return False
+	if shard is None:
+		pyRootPwa.utils.printErr("shard " + str(shardIndex) + " does not contain any events. Aborting...")
+		return False
+	if not shard.writeToFile(shardFileName):
+		pyRootPwa.utils.printErr("could not write shard to file '" + shardFileName + "'. Aborting...")
+		return False
+	for checkpointFileName in checkpointFileNames:
+		os.remove(checkpointFileName)
+	return True
+
+
+# merges the shards in the given files and writes the integral to
+# integralFileName
+def mergeIntegralShards(integralFileName, shardFileNames):
+	if not shardFileNames:
+		pyRootPwa.utils.printErr("did not receive any shard files. Aborting...")
+		return False
+	shard = None
+	for shardFileName in shardFileNames:
+		nextShard = pyRootPwa.core.ampIntegralShard.readShardFile(shardFileName)
+		if nextShard is None:
+			pyRootPwa.utils.printErr("could not read shard from file '" + shardFileName + "'. Aborting...")
+			return False
+		if shard is None:
+			shard = nextShard
+		elif not shard.merge(nextShard):
+			pyRootPwa.utils.printErr("could not merge shard in file '" + shardFileName + "'. Aborting...")
+			return False
+	pyRootPwa.utils.printInfo("merged " + str(len(shardFileNames)) + " shards with " + str(shard.nmbEvents()) + " events.")
+	return shard.writeIntegralFile(integralFileName)
@@ -1,6 +1,31 @@
 import pyRootPwa.utils
 ROOT = pyRootPwa.utils.ROOT
 
+
+# returns the integral matrix of an integral file together with the
+# opened ROOT file, which has to be closed once the matrix is no longer
+# used; if there is a packed integral file that was written from the
+# same content, it is mapped instead and the likelihood gathers the
+# elements directly from it
+def _readIntegralMatrix(integralFileName):
+	packedFileName = pyRootPwa.core.ampIntegralPackedMatrix.findPackedFile(integralFileName)
+	if packedFileName:
+		integralMatrix = pyRootPwa.core.ampIntegralPackedMatrix()
+		if not integralMatrix.open(packedFileName):
+			pyRootPwa.utils.printErr("could not open packed integral file '" + packedFileName + "'.")
+			return (None, None)
+		return (integralMatrix, None)
+	integralFile = ROOT.TFile.Open(integralFileName, "READ")
+	if not integralFile:
+		pyRootPwa.utils.printErr("could not open integral file '" + integralFileName + "'.")
+		return (None, None)
+	integralMeta = pyRootPwa.core.ampIntegralMatrixMetadata.readIntegralFile(integralFile)
+	if not integralMeta:
+		pyRootPwa.utils.printErr("could not read integral metadata from file '" + integralFileName + "'.")
+		integralFile.Close()
+		return (None, None)
+	return (integralMeta.getAmpIntegralMatrix(), integralFile)
+
 def initLikelihood(waveDescThres,
                    massBinCenter,
                    eventAndAmpFileDict,
@@ -11,10 +36,31 @@ def initLikelihood(waveDescThres,
                    cauchy = False,
                    cauchyWidth = 0.5,
                    rank = 1,
-                   verbose = False
+                   verbose = False,
+                   nmbThreads = 0,
+                   simd = False,
+                   floatStorage = False,
+                   cpuKernels = False,
+                   mpi = False,
+                   incremental = False,
+                   ampMatrixFileDict = None,
+                   ampCacheDirectory = "",
+                   binIndexDirectory = ""
                   ):
 	likelihood = pyRootPwa.core.pwaLikelihood()
 	likelihood.useNormalizedAmps(True)
+	likelihood.setNmbThreads(nmbThreads)
+	likelihood.enableSimd(simd)
+	likelihood.enableFloatStorage(floatStorage)
+	likelihood.enableCpuKernels(cpuKernels)
+	likelihood.enableMpi(mpi)
+	if mpi and not likelihood.mpiEnabled():
+		# otherwise each process of an MPI job would run an independent fit
+		pyRootPwa.utils.printErr("ROOTPWA was compiled without MPI support. Aborting...")
+		return None
+	likelihood.enableIncrementalUpdates(incremental)
+	likelihood.setAmplitudeCacheDirectory(ampCacheDirectory)
+	likelihood.setBinIndexDirectory(binIndexDirectory)
 	if not verbose:
 		likelihood.setQuiet()
 	if cauchy:
@@ -26,20 +72,18 @@ def initLikelihood(waveDescThres,
 		pyRootPwa.utils.printErr("could not initialize likelihood. Aborting...")
 		return None
 
-	normIntFile = ROOT.TFile.Open(normIntegralFileName, "READ")
-	normIntMeta = pyRootPwa.core.ampIntegralMatrixMetadata.readIntegralFile(normIntFile)
-	normIntMatrix = normIntMeta.getAmpIntegralMatrix()
-	if not likelihood.addNormIntegral(normIntMatrix):
+	normIntMatrix, normIntFile = _readIntegralMatrix(normIntegralFileName)
+	if normIntMatrix is None or not likelihood.addNormIntegral(normIntMatrix):
 		pyRootPwa.utils.printErr("could not add normalization integral. Aborting...")
 		return None
-	normIntFile.Close()
-	accIntFile = ROOT.TFile.Open(accIntegralFileName, "READ")
-	accIntMeta = pyRootPwa.core.ampIntegralMatrixMetadata.readIntegralFile(accIntFile)
-	accIntMatrix = accIntMeta.getAmpIntegralMatrix()
-	if not likelihood.addAccIntegral(accIntMatrix, accEventsOverride):
+	if normIntFile:
+		normIntFile.Close()
+	accIntMatrix, accIntFile = _readIntegralMatrix(accIntegralFileName)
+	if accIntMatrix is None or not likelihood.addAccIntegral(accIntMatrix, accEventsOverride):
 		pyRootPwa.utils.printErr("could not add acceptance integral. Aborting...")
 		return None
-	accIntFile.Close()
+	if accIntFile:
+		accIntFile.Close()
 
 	eventMetas = []
 	for eventFileName in eventAndAmpFileDict.keys():
@@ -49,22 +93,40 @@ def initLikelihood(waveDescThres,
 			return None
 		eventMetas.append(eventMeta)
 	likelihood.setOnTheFlyBinning(multiBin.boundaries, eventMetas)
-	for (waveName, _, _) in waveDescThres:
-		ampMetas = []
+	if ampMatrixFileDict:
+		# all waves of an event file are read from a single amplitude matrix file
+		ampMatrixMetas = []
 		for eventFileName in eventAndAmpFileDict:
-			ampFileName = eventAndAmpFileDict[eventFileName][waveName]
-			ampFile = ROOT.TFile.Open(ampFileName, "READ")
-			if not ampFile:
-				pyRootPwa.utils.printErr("could not open amplitude file '" + ampFileName + "'.")
+			ampMatrixFileName = ampMatrixFileDict[eventFileName]
+			ampMatrixFile = ROOT.TFile.Open(ampMatrixFileName, "READ")
+			if not ampMatrixFile:
+				pyRootPwa.utils.printErr("could not open amplitude matrix file '" + ampMatrixFileName + "'.")
 				return None
-			meta = pyRootPwa.core.amplitudeMetadata.readAmplitudeFile(ampFile, waveName)
+			meta = pyRootPwa.core.amplitudeMatrixMetadata.readAmplitudeMatrixFile(ampMatrixFile, pyRootPwa.amplitudeMatrixObjectBaseName)
 			if not meta:
-				pyRootPwa.utils.printErr("could not get metadata for waveName '" + waveName + "'.")
+				pyRootPwa.utils.printErr("could not get metadata from amplitude matrix file '" + ampMatrixFileName + "'.")
 				return None
-			ampMetas.append(meta)
-		if not likelihood.addAmplitude(ampMetas):
-			pyRootPwa.utils.printErr("could not add amplitude '" + waveName + "'. Aborting...")
+			ampMatrixMetas.append(meta)
+		if not likelihood.addAmplitudeMatrix(ampMatrixMetas):
+			pyRootPwa.utils.printErr("could not add amplitude matrices. Aborting...")
 			return None
+	else:
+		for (waveName, _, _) in waveDescThres:
+			ampMetas = []
+			for eventFileName in eventAndAmpFileDict:
+				ampFileName = eventAndAmpFileDict[eventFileName][waveName]
+				ampFile = ROOT.TFile.Open(ampFileName, "READ")
+				if not ampFile:
+					pyRootPwa.utils.printErr("could not open amplitude file '" + ampFileName + "'.")
+					return None
+				meta = pyRootPwa.core.amplitudeMetadata.readAmplitudeFile(ampFile, waveName)
+				if not meta:
+					pyRootPwa.utils.printErr("could not get metadata for waveName '" + waveName + "'.")
+					return None
+				ampMetas.append(meta)
+			if not likelihood.addAmplitude(ampMetas):
+				pyRootPwa.utils.printErr("could not add amplitude '" + waveName + "'. Aborting...")
+				return None
 	if not likelihood.finishInit():
 		pyRootPwa.utils.printErr("could not finish initialization of likelihood. Aborting...")
 		return None
@@ -1,6 +1,8 @@
 #!/usr/bin/env python
 
 import argparse
+import collections
+import os
 import sys
 
 import pyRootPwa
@@ -21,9 +23,17 @@ if __name__ == "__main__":
 	parser.add_argument("-b", type=int, metavar="eventFileId", default=-1, dest="eventFileId", help="event file id to be calculated (default: all)")
 	parser.add_argument("-e", type=str, metavar="eventsType", default="all", dest="eventsType", help="events type to be calculated ('real', 'generated' or 'accepted', default: all)")
 	parser.add_argument("-f", "--no-progress-bar", action="store_true", dest="noProgressBar", help="disable progress bars (decreases computing time)")
+	parser.add_argument("-j", type=int, metavar="#", dest="nmbThreads", default=1, help="number of threads (default: 1, 0 = all available)")
 	parser.add_argument("-k", "--keyfileIndex", type=int, metavar="#", default=-1,
 	                    help="keyfile index to calculate amplitude for (overrides settings from the config file, index from 0 to number of keyfiles - 1)")
 	parser.add_argument("-w", type=str, metavar="wavelistFileName", default="", dest="wavelistFileName", help="path to wavelist file (default: none)")
+	parser.add_argument("--columnar", action="store_true", help="write amplitudes in the columnar format, which is read faster (default: false)")
+	parser.add_argument("--matrix-directory", type=str, metavar="outputDirectory", default="", dest="matrixDirectory",
+	                    help="write the amplitudes of all waves of each event file into a single amplitude matrix file in this directory instead of one amplitude file per wave (default: none)")
+	parser.add_argument("--event-block-size", type=int, metavar="#", default=100000, dest="eventBlockSize",
+	                    help="number of events for which the amplitudes of all waves are kept in memory (default: 100000)")
+	parser.add_argument("--compiled-program", action="store_true", dest="compiledProgram",
+	                    help="evaluate the decay trees with compiled decay programs (default: false)")
 	args = parser.parse_args()
 
 	config = pyRootPwa.rootPwaConfig()
@@ -71,8 +81,15 @@ if __name__ == "__main__":
 		pyRootPwa.utils.printErr("Invalid events type given ('" + args.eventsType + "'). Aborting...")
 		sys.exit(1)
 
-	for waveName in waveList:
-		for eventsType in eventsTypes:
+	if args.matrixDirectory and not os.path.isdir(args.matrixDirectory):
+		pyRootPwa.utils.printErr("output directory '" + args.matrixDirectory + "' does not exist. Aborting...")
+		sys.exit(1)
+
+	# all waves of an event file are calculated in one pass over the events
+	for eventsType in eventsTypes:
+		# { "eventFileName" : { "waveName" : "amplitudeFileName" } }
+		eventAndAmpFileDict = collections.OrderedDict()
+		for waveName in waveList:
 			eventAmpFilePairs = fileManager.getEventAndAmplitudePairPathsForWave(eventsType, waveName)
 			if args.eventFileId >= 0:
 				if args.eventFileId >= len(eventAmpFilePairs):
@@ -80,6 +97,13 @@ if __name__ == "__main__":
 					sys.exit(1)
 				eventAmpFilePairs = eventAmpFilePairs[args.eventFileId:args.eventFileId+1]
 			for eventFilePath, amplitudeFilePath in eventAmpFilePairs:
-				if not pyRootPwa.calcAmplitude(eventFilePath, waveName, fileManager.getWaveDescription(waveName),
-				                               amplitudeFilePath, not args.noProgressBar):
-					pyRootPwa.utils.printWarn("could not calculate amplitude.")
+				eventAndAmpFileDict.setdefault(eventFilePath, collections.OrderedDict())[waveName] = amplitudeFilePath
+		for eventFilePath, waveAmpFileDict in eventAndAmpFileDict.items():
+			waveNames = waveAmpFileDict.keys()
+			if args.matrixDirectory:
+				outputFileNames = pyRootPwa.getAmplitudeMatrixFilePath(eventFilePath, args.matrixDirectory)
+			else:
+				outputFileNames = waveAmpFileDict.values()
+			if not pyRootPwa.calcAmplitudes(eventFilePath, waveNames, [ fileManager.getWaveDescription(waveName) for waveName in waveNames ],
+			                                outputFileNames, not args.noProgressBar, args.columnar, args.eventBlockSize, args.nmbThreads, args.compiledProgram):
+				pyRootPwa.utils.printWarn("could not calculate amplitudes.")
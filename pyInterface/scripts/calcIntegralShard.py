@@ -0,0 +1,62 @@
+#!/usr/bin/env python
+
+import argparse
+import sys
+
+import pyRootPwa
+import pyRootPwa.core
+
+if __name__ == "__main__":
+
+	parser = argparse.ArgumentParser(
+	                                 description="calculate the partial integral matrix of a range of events for batch jobs; "
+	                                             "the shards are combined with mergeIntegralShards"
+	                                )
+
+	parser.add_argument("shardFileName", type=str, metavar="shardFile", help="path to output shard file")
+	parser.add_argument("-c", type=str, metavar="configFileName", dest="configFileName", default="./rootpwa.config", help="path to config file (default: './rootpwa.config')")
+	parser.add_argument("-b", type=int, metavar="integralBin", dest="integralBin", required=True, help="bin to be calculated")
+	parser.add_argument("-e", type=str, metavar="eventsType", dest="eventsType", required=True, help="events type to be calculated ('generated' or 'accepted')")
+	parser.add_argument("-s", type=int, metavar="#", dest="shardIndex", default=0, help="index of the shard to be calculated (default: 0)")
+	parser.add_argument("-n", type=int, metavar="#", dest="nmbShards", default=1, help="number of shards the events of the bin are split into (default: 1)")
+	parser.add_argument("-w", type=str, metavar="weights", dest="weightsFileName", default="", help="label of the weight column of the event file or path to MC weight file with the weights of all events for de-weighting (default: none)")
+	parser.add_argument("--checkpointInterval", type=int, metavar="#", dest="checkpointInterval", default=1000000,
+	                    help="number of events after which a checkpoint is written (default: 1000000, 0 = no checkpoints)")
+	parser.add_argument("-j", type=int, metavar="#", dest="nmbThreads", default=0, help="number of threads (default: 0 = all available)")
+	args = parser.parse_args()
+
+	printErr  = pyRootPwa.utils.printErr
+	printSucc = pyRootPwa.utils.printSucc
+
+	config = pyRootPwa.rootPwaConfig()
+	if not config.initialize(args.configFileName):
+		printErr("loading config file '" + args.configFileName + "' failed. Aborting...")
+		sys.exit(1)
+	pyRootPwa.core.particleDataTable.readFile(config.pdgFileName)
+	fileManager = pyRootPwa.loadFileManager(config.fileManagerPath)
+	if not fileManager:
+		printErr("loading the file manager failed. Aborting...")
+		sys.exit(1)
+
+	if args.integralBin < 0 or args.integralBin >= len(fileManager.binList):
+		printErr("bin out of range (" + str(args.integralBin) + ">=" + str(len(fileManager.binList)) + "). Aborting...")
+		sys.exit(1)
+	multiBin = fileManager.binList[args.integralBin]
+
+	if args.eventsType == "generated":
+		eventsType = pyRootPwa.core.eventMetadata.GENERATED
+	elif args.eventsType == "accepted":
+		eventsType = pyRootPwa.core.eventMetadata.ACCEPTED
+	else:
+		printErr("Invalid events type given ('" + args.eventsType + "'). Aborting...")
+		sys.exit(1)
+
+	eventAndAmpFileDict = fileManager.getEventAndAmplitudeFilePathsInBin(multiBin, eventsType)
+	if not eventAndAmpFileDict:
+		printErr("could not retrieve valid amplitude file list. Aborting...")
+		sys.exit(1)
+	if not pyRootPwa.calcIntegralShard(args.shardFileName, eventAndAmpFileDict, multiBin, args.shardIndex, args.nmbShards,
+	                                   args.weightsFileName, args.checkpointInterval, args.nmbThreads):
+		printErr("integral calculation failed. Aborting...")
+		sys.exit(1)
+	printSucc("wrote shard " + str(args.shardIndex) + " of " + str(args.nmbShards) + " to file '" + args.shardFileName + "'")
@@ -15,7 +15,12 @@ if __name__ == "__main__":
 	parser.add_argument("-c", type=str, metavar="configFileName", dest="configFileName", default="./rootpwa.config", help="path to config file (default: './rootpwa.config')")
 	parser.add_argument("-b", type=int, metavar="integralBin", default=-1, dest="integralBin", help="bin to be calculated (default: all)")
 	parser.add_argument("-e", type=str, metavar="eventsType", default="all", dest="eventsType", help="events type to be calculated ('generated' or 'accepted', default: both)")
-	parser.add_argument("-w", type=str, metavar="path", dest="weightsFileName", default="", help="path to MC weight file for de-weighting (default: none)")
+	parser.add_argument("-w", type=str, metavar="weights", dest="weightsFileName", default="", help="label of the weight column of the event files or path to MC weight file for de-weighting (default: none)")
+	parser.add_argument("--singlePass", action="store_true",
+	                    help="calculate the integrals of all bins with a single pass over each event file; a weight text file has to contain the weights of all events (default: false)")
+	parser.add_argument("-j", type=int, metavar="#", dest="nmbThreads", default=0, help="number of threads (default: 0 = all available)")
+	parser.add_argument("--binIndexDir", type=str, metavar="path", dest="binIndexDirectory", default="",
+	                    help="select the events of each bin with the bin indices of the event files in this directory, which are created if they do not exist (default: scan the event files)")
 	args = parser.parse_args()
 
 	printErr  = pyRootPwa.utils.printErr
@@ -54,6 +59,24 @@ if __name__ == "__main__":
 		pyRootPwa.utils.printErr("Invalid events type given ('" + args.eventsType + "'). Aborting...")
 		sys.exit(1)
 
+	if args.singlePass:
+		for eventsType in eventsTypes:
+			outputFileNames = []
+			eventAndAmpFileDicts = []
+			for multiBin in binList:
+				outputFileNames.append(fileManager.getIntegralFilePath(multiBin, eventsType))
+				eventAndAmpFileDicts.append(fileManager.getEventAndAmplitudeFilePathsInBin(multiBin, eventsType))
+				if not eventAndAmpFileDicts[-1]:
+					printErr("could not retrieve valid amplitude file list. Aborting...")
+					sys.exit(1)
+			printInfo("calculating integral matrices of " + str(len(binList)) + " bins in a single pass.")
+			if not pyRootPwa.calcIntegralsForBins(outputFileNames, eventAndAmpFileDicts, binList, args.weightsFileName, args.nmbThreads):
+				printErr("integral calculation failed. Aborting...")
+				sys.exit(1)
+			printSucc("wrote integrals to TKey '" + pyRootPwa.core.ampIntegralMatrix.integralObjectName + "' "
+				        + "in files " + str(outputFileNames))
+		sys.exit(0)
+
 	for multiBin in binList:
 		for eventsType in eventsTypes:
 			outputFileName = fileManager.getIntegralFilePath(multiBin, eventsType)
@@ -62,7 +85,7 @@ if __name__ == "__main__":
 				printErr("could not retrieve valid amplitude file list. Aborting...")
 				sys.exit(1)
 			printInfo("calculating integral matrix from " + str(len(eventAndAmpFileDict)) + " amplitude files:")
-			if not pyRootPwa.calcIntegrals(outputFileName, eventAndAmpFileDict, multiBin, args.weightsFileName):
+			if not pyRootPwa.calcIntegrals(outputFileName, eventAndAmpFileDict, multiBin, args.weightsFileName, args.binIndexDirectory, args.nmbThreads):
 				printErr("integral calculation failed. Aborting...")
 				sys.exit(1)
 			printSucc("wrote integral to TKey '" + pyRootPwa.core.ampIntegralMatrix.integralObjectName + "' "
@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+
+import argparse
+import math
+import sys
+
+import pyRootPwa
+import pyRootPwa.core
+ROOT = pyRootPwa.ROOT
+
+
+if __name__ == "__main__":
+
+	parser = argparse.ArgumentParser(
+	                                 description="compares log-likelihood and gradient calculated with decay amplitudes "
+	                                             "stored in single precision to the ones calculated with double precision"
+	                                )
+
+	parser.add_argument("inputFileName", type=str, metavar="inputFile", help="path to fit result")
+	parser.add_argument("-c", type=str, metavar="configFileName", dest="configFileName", default="./rootpwa.config", help="path to config file (default: './rootpwa.config')")
+	parser.add_argument("-b", type=int, metavar="#", dest="integralBin", default=0, help="integral bin id of fit (default: 0)")
+	parser.add_argument("-n", type=int, metavar="#", dest="nmbPoints", default=10, help="number of randomly smeared parameter points in addition to the fit result (default: 10)")
+	parser.add_argument("-w", type=float, metavar="WIDTH", dest="smearWidth", default=0.1, help="relative width of Gaussian smearing of the parameters (default: 0.1)")
+	parser.add_argument("-s", type=int, metavar="#", dest="seed", default=0, help="random seed (default: 0)")
+	parser.add_argument("-t", type=int, metavar="#", dest="nmbThreads", default=0, help="number of threads used in the likelihood (default: 0 = as given by OpenMP)")
+	parser.add_argument("--simd", help="use SIMD event loops for both likelihoods (default: false)", action="store_true")
+	parser.add_argument("-C", "--cauchyPriors", help="use half-Cauchy priors (default: false)", action="store_true")
+	parser.add_argument("-P", "--cauchyPriorWidth", type=float, metavar ="WIDTH", default=0.5, help="width of half-Cauchy prior (default: 0.5)")
+	parser.add_argument("-A", type=int, metavar="#", dest="accEventsOverride", default=0,
+	                    help="number of input events to normalize acceptance to (default: use number of events from normalization integral file)")
+	parser.add_argument("--noAcceptance", help="do not take acceptance into account (default: false)", action="store_true")
+	parser.add_argument("-v", "--verbose", help="verbose; print debug output (default: false)", action="store_true")
+	args = parser.parse_args()
+
+	config = pyRootPwa.rootPwaConfig()
+	if not config.initialize(args.configFileName):
+		pyRootPwa.utils.printErr("loading config file '" + args.configFileName + "' failed. Aborting...")
+		sys.exit(1)
+	pyRootPwa.core.particleDataTable.readFile(config.pdgFileName)
+	fileManager = pyRootPwa.loadFileManager(config.fileManagerPath)
+	if not fileManager:
+		pyRootPwa.utils.printErr("loading the file manager failed. Aborting...")
+		sys.exit(1)
+
+	if args.integralBin < 0:
+		pyRootPwa.utils.printErr("bin < 0 (" + str(args.integralBin) + "). Aborting...")
+		sys.exit(1)
+	elif args.integralBin >= len(fileManager.binList):
+		pyRootPwa.utils.printErr("bin out of range (" + str(args.integralBin) + ">=" + str(len(fileManager.binList)) + "). Aborting...")
+		sys.exit(1)
+	multiBin = fileManager.binList[args.integralBin]
+	eventAndAmpFileDict = fileManager.getEventAndAmplitudeFilePathsInBin(multiBin, pyRootPwa.core.eventMetadata.REAL)
+	if not eventAndAmpFileDict:
+		pyRootPwa.utils.printErr("could not retrieve valid amplitude file list. Aborting...")
+		sys.exit(1)
+
+	psIntegralPath  = fileManager.getIntegralFilePath(multiBin, pyRootPwa.core.eventMetadata.GENERATED)
+	accIntegralPath = psIntegralPath
+	if not args.noAcceptance:
+		accIntegralPath = fileManager.getIntegralFilePath(multiBin, pyRootPwa.core.eventMetadata.ACCEPTED)
+
+	result = pyRootPwa.utils.getFitResultFromFile(fitResultFileName = args.inputFileName,
+	                                              fitResultTreeName = config.fitResultTreeName,
+	                                              fitResultBranchName = config.fitResultBranchName)
+	if not result:
+		pyRootPwa.utils.printErr("could not get fit result from file '" + args.inputFileName + "'. Aborting...")
+		sys.exit(1)
+
+	waveDescThres = pyRootPwa.utils.getWaveDescThresFromFitResult(result, fileManager.getWaveDescriptions())
+	if not waveDescThres:
+		pyRootPwa.utils.printErr("error while getting wave names, descriptions and thresholds. Aborting...")
+		sys.exit(1)
+
+	likelihoods = {}
+	for floatStorage in [False, True]:
+		likelihoods[floatStorage] = pyRootPwa.initLikelihood(waveDescThres = waveDescThres,
+		                                                     massBinCenter = result.massBinCenter(),
+		                                                     eventAndAmpFileDict = eventAndAmpFileDict,
+		                                                     normIntegralFileName = psIntegralPath,
+		                                                     accIntegralFileName = accIntegralPath,
+		                                                     multiBin = multiBin,
+		                                                     accEventsOverride = args.accEventsOverride,
+		                                                     cauchy = args.cauchyPriors,
+		                                                     cauchyWidth = args.cauchyPriorWidth,
+		                                                     rank = result.rank(),
+		                                                     verbose = args.verbose,
+		                                                     nmbThreads = args.nmbThreads,
+		                                                     simd = args.simd,
+		                                                     floatStorage = floatStorage)
+		if not likelihoods[floatStorage]:
+			pyRootPwa.utils.printErr("error while initializing likelihood. Aborting...")
+			sys.exit(1)
+
+	fitPars = []
+	for parameter in likelihoods[False].parameters():
+		fitPars.append(result.fitParameter(parameter.parName()))
+
+	random = ROOT.TRandom3(args.seed)
+	points = [ fitPars ]
+	for _ in range(args.nmbPoints):
+		points.append([ par * (1. + random.Gaus(0., args.smearWidth)) for par in fitPars ])
+
+	print("")
+	print("point  log-likelihood (double)  rel. diff. log-likelihood  max. abs. diff. gradient  rel. diff. gradient norm")
+	maxRelDiffLogLikelihood = 0.
+	maxRelDiffGradient = 0.
+	for iPoint, pars in enumerate(points):
+		logLikelihoodDouble, gradientDouble = likelihoods[False].FdF(pars)
+		logLikelihoodFloat,  gradientFloat  = likelihoods[True].FdF(pars)
+		relDiffLogLikelihood = abs(logLikelihoodFloat - logLikelihoodDouble) / abs(logLikelihoodDouble)
+		maxAbsDiffGradient = max([ abs(gradientFloat[i] - gradientDouble[i]) for i in range(len(gradientDouble)) ])
+		normDiffGradient = math.sqrt(sum([ (gradientFloat[i] - gradientDouble[i])**2 for i in range(len(gradientDouble)) ]))
+		normGradient = math.sqrt(sum([ g**2 for g in gradientDouble ]))
+		relDiffGradient = normDiffGradient / normGradient if normGradient > 0. else normDiffGradient
+		maxRelDiffLogLikelihood = max(maxRelDiffLogLikelihood, relDiffLogLikelihood)
+		maxRelDiffGradient = max(maxRelDiffGradient, relDiffGradient)
+		print("{:5d}  {: .15e}  {: .6e}              {: .6e}             {: .6e}".format(iPoint, logLikelihoodDouble, relDiffLogLikelihood, maxAbsDiffGradient, relDiffGradient))
+	print("")
+
+	pyRootPwa.utils.printInfo("number of events ............................ {:d}".format(likelihoods[False].nmbEvents()))
+	pyRootPwa.utils.printInfo("number of parameters ........................ {:d}".format(likelihoods[False].nmbPars()))
+	pyRootPwa.utils.printInfo("max. rel. difference of log-likelihood ...... {:.6e}".format(maxRelDiffLogLikelihood))
+	pyRootPwa.utils.printInfo("max. rel. difference of gradient norm ....... {:.6e}".format(maxRelDiffGradient))
@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+
+import argparse
+import collections
+import os
+import sys
+
+import pyRootPwa
+import pyRootPwa.core
+
+
+if __name__ == "__main__":
+
+	# parse command line arguments
+	parser = argparse.ArgumentParser(
+	                                 description="converts the amplitude files of all waves "
+	                                             "of each event file into a single amplitude "
+	                                             "matrix file"
+	                                )
+
+	parser.add_argument("outputDirectory", type=str, metavar="outputDirectory", help="directory to write the amplitude matrix files to")
+	parser.add_argument("-c", type=str, metavar="configFileName", default="rootpwa.config", dest="configFileName", help="path to config file (default: ./rootpwa.config)")
+	parser.add_argument("-b", type=int, metavar="eventFileId", default=-1, dest="eventFileId", help="event file id to be converted (default: all)")
+	parser.add_argument("-e", type=str, metavar="eventsType", default="real", dest="eventsType", help="events type to be converted ('real', 'generated', 'accepted' or 'all', default: real)")
+	parser.add_argument("-w", type=str, metavar="wavelistFileName", default="", dest="wavelistFileName", help="path to wavelist file (default: all waves)")
+	parser.add_argument("-n", type=int, metavar="#", default=pyRootPwa.core.amplitudeMatrixMetadata.defaultChunkSize, dest="chunkSize",
+	                    help="number of events per chunk (default: " + str(pyRootPwa.core.amplitudeMatrixMetadata.defaultChunkSize) + ")")
+	args = parser.parse_args()
+
+	config = pyRootPwa.rootPwaConfig()
+	if not config.initialize(args.configFileName):
+		pyRootPwa.utils.printErr("loading config file '" + args.configFileName + "' failed. Aborting...")
+		sys.exit(1)
+	fileManager = pyRootPwa.loadFileManager(config.fileManagerPath)
+	if not fileManager:
+		pyRootPwa.utils.printErr("loading the file manager failed. Aborting...")
+		sys.exit(1)
+	if not os.path.isdir(args.outputDirectory):
+		pyRootPwa.utils.printErr("output directory '" + args.outputDirectory + "' does not exist. Aborting...")
+		sys.exit(1)
+
+	waveList = fileManager.getWaveNameList()
+	if not args.wavelistFileName == "":
+		waveList = [ i[0] for i in pyRootPwa.utils.getWaveDescThresFromWaveList(args.wavelistFileName, fileManager.getWaveDescriptions()) ]
+
+	eventsTypes = []
+	if args.eventsType == "real":
+		eventsTypes = [ pyRootPwa.core.eventMetadata.REAL ]
+	elif args.eventsType == "generated":
+		eventsTypes = [ pyRootPwa.core.eventMetadata.GENERATED ]
+	elif args.eventsType == "accepted":
+		eventsTypes = [ pyRootPwa.core.eventMetadata.ACCEPTED ]
+	elif args.eventsType == "all":
+		eventsTypes = [ pyRootPwa.core.eventMetadata.REAL,
+		                pyRootPwa.core.eventMetadata.GENERATED,
+		                pyRootPwa.core.eventMetadata.ACCEPTED ]
+	else:
+		pyRootPwa.utils.printErr("Invalid events type given ('" + args.eventsType + "'). Aborting...")
+		sys.exit(1)
+
+	success = True
+	for eventsType in eventsTypes:
+		# { "eventFileName" : { "waveName" : "amplitudeFileName" } }
+		eventAndAmpFileDict = collections.OrderedDict()
+		for waveName in waveList:
+			for eventFilePath, amplitudeFilePath in fileManager.getEventAndAmplitudePairPathsForWave(eventsType, waveName):
+				eventAndAmpFileDict.setdefault(eventFilePath, collections.OrderedDict())[waveName] = amplitudeFilePath
+		eventFilePaths = eventAndAmpFileDict.keys()
+		if args.eventFileId >= 0:
+			if args.eventFileId >= len(eventFilePaths):
+				pyRootPwa.utils.printErr("event file id out of range (" + str(args.eventFileId) + ">=" + str(len(eventFilePaths)) + "). Aborting...")
+				sys.exit(1)
+			eventFilePaths = eventFilePaths[args.eventFileId:args.eventFileId+1]
+		for eventFilePath in eventFilePaths:
+			ampMatrixFilePath = pyRootPwa.getAmplitudeMatrixFilePath(eventFilePath, args.outputDirectory)
+			if not pyRootPwa.convertToAmplitudeMatrix(eventAndAmpFileDict[eventFilePath], ampMatrixFilePath, args.chunkSize):
+				pyRootPwa.utils.printWarn("could not convert amplitudes of event file '" + eventFilePath + "'.")
+				success = False
+	if not success:
+		sys.exit(1)
@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+
+import argparse
+import sys
+
+import pyRootPwa
+import pyRootPwa.core
+
+if __name__ == "__main__":
+
+	parser = argparse.ArgumentParser(
+	                                 description="writes the upper triangle of the integral matrices of the given integral "
+	                                             "files to packed integral files, which are memory-mapped by the fit"
+	                                )
+
+	parser.add_argument("integralFileNames", type=str, metavar="integralFile", nargs="+", help="paths to the integral files")
+	parser.add_argument("-o", type=str, metavar="path", dest="packedFileName", default="",
+	                    help="path to the packed integral file if a single integral file is given (default: path of the integral file with extension '.packed')")
+	args = parser.parse_args()
+
+	printErr  = pyRootPwa.utils.printErr
+	printSucc = pyRootPwa.utils.printSucc
+
+	if args.packedFileName and len(args.integralFileNames) > 1:
+		printErr("option -o can only be used with a single integral file. Aborting...")
+		sys.exit(1)
+
+	success = True
+	for integralFileName in args.integralFileNames:
+		integralFile = pyRootPwa.ROOT.TFile.Open(integralFileName, "READ")
+		if not integralFile:
+			printErr("could not open integral file '" + integralFileName + "'.")
+			success = False
+			continue
+		integralMeta = pyRootPwa.core.ampIntegralMatrixMetadata.readIntegralFile(integralFile)
+		if not integralMeta:
+			printErr("could not read integral metadata from file '" + integralFileName + "'.")
+			integralFile.Close()
+			success = False
+			continue
+		packedFileName = args.packedFileName
+		if not packedFileName:
+			packedFileName = pyRootPwa.core.ampIntegralPackedMatrix.packedFileName(integralFileName)
+		if pyRootPwa.core.ampIntegralPackedMatrix.write(packedFileName, integralMeta):
+			printSucc("wrote packed integral file '" + packedFileName + "'.")
+		else:
+			printErr("could not write packed integral file '" + packedFileName + "'.")
+			success = False
+		integralFile.Close()
+	if not success:
+		sys.exit(1)
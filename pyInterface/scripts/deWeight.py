@@ -17,6 +17,8 @@ if __name__ == "__main__":
 	parser.add_argument("outputFileName", type=str, metavar="<outputFile>", help="deweighted output RootPwa file")
 	parser.add_argument("-f", "--weightFactor", type=float, default=1., metavar="#", help="weight factor (default = 1)")
 	parser.add_argument("-s", "--seed", type=int, metavar="#", dest="seed", default=2451083, help="random number seed (default = 2451083)")
+	parser.add_argument("-w", "--weights", type=str, metavar="weights", dest="weightSource", default="weight",
+	                    help="label of the weight column of the input file or name of a weight file (default = 'weight')")
 
 	args = parser.parse_args()
 
@@ -34,18 +36,22 @@ if __name__ == "__main__":
 		printErr("error reading metaData. Input file is not a RootPWA root file.")
 	inputTree = metaData.eventTree()
 
-	additionalVariableLabels = metaData.additionalSavedVariableLables()
+	weights = pyRootPwa.core.eventWeights.readWeights(args.weightSource, metaData)
+	if weights is None:
+		printErr("could not read weights from '" + args.weightSource + "'. Aborting...")
+		sys.exit(1)
+	if len(weights) != inputTree.GetEntries():
+		printErr("number of weights does not match number of events (" + str(len(weights)) + " != " + str(inputTree.GetEntries()) + "). Aborting...")
+		sys.exit(1)
+
+	# the weight column is not copied to the output file
+	additionalVariableLabels = [ label for label in metaData.additionalSavedVariableLables() if label != args.weightSource ]
 	additionalVariables = [None] * len(additionalVariableLabels)
-	weightIndex = additionalVariableLabels.index("weight")
 	for i, additionalVariableLabel in enumerate(additionalVariableLabels):
 		additionalVariables[i] = numpy.array(1, dtype = float)
 		inputTree.SetBranchAddress(additionalVariableLabel, additionalVariables[i])
 
-	maxWeight = 0.
-	for i in xrange(inputTree.GetEntries()):
-		inputTree.GetEntry(i)
-		if float(additionalVariables[weightIndex]) > maxWeight:
-			maxWeight = float(additionalVariables[weightIndex])
+	maxWeight = max(weights)
 
 	printInfo("maxWeight: " + str(maxWeight))
 	maxWeight *= args.weightFactor
@@ -63,8 +69,7 @@ if __name__ == "__main__":
 	                             metaData.productionKinematicsParticleNames(),
 	                             metaData.decayKinematicsParticleNames(),
 	                             metaData.binningMap(),
-	                             [ additionalVariableLabel for i, additionalVariableLabel in enumerate(additionalVariableLabels)
-	                                                           if i != weightIndex ]):
+	                             additionalVariableLabels):
 		printErr("could not initialize fileWriter. Aborting...")
 		inputFile.Close()
 		sys.exit(1)
@@ -79,11 +84,11 @@ if __name__ == "__main__":
 
 	for eventIndex in xrange(inputTree.GetEntries()):
 		inputTree.GetEntry(eventIndex)
-		normWeight = additionalVariables[weightIndex] / maxWeight
+		normWeight = weights[eventIndex] / maxWeight
 		cut = pyRootPwa.ROOT.gRandom.Rndm()
 		if normWeight > cut:
 			fileWriter.addEvent(prodKinMomenta, decayKinMomenta,
-			                    [float(variable) for i, variable in enumerate(additionalVariables) if i != weightIndex])
+			                    [float(variable) for variable in additionalVariables])
 			acceptedEntries += 1
 		overallEntries += 1
 	fileWriter.finalize()
@@ -151,15 +151,21 @@ if __name__ == "__main__":
 		# This ideal parabola is drawn for a x between -sqrt(l) and
 		# +sqrt(l) using x = r * sqrt(l).
 
-		graphLikeli = ROOT.TGraph()
+		ratios = []
+		points = []
 		for p in xrange(-50, 51):
 			ratio = (p/50.0) * math.sqrt(eigenVectorsMinuit[par][1])
 			# TODO: Fix this once root get's their operators in working order
 			step = ROOT.TVectorD(eigenVectorsMinuit[par][0])
 			step *= ratio
 			pars = minimum + step
-			likeli = likelihood.DoEval( [ pars[i] for i in xrange(pars.GetNrows()) ] ) - minimumLikelihood
-			graphLikeli.SetPoint(p + 50, ratio, likeli)
+			ratios.append(ratio)
+			points.append( [ pars[i] for i in xrange(pars.GetNrows()) ] )
+		# evaluate all points of the slice in one pass over the events
+		likelis = likelihood.evaluateBatch(points)
+		graphLikeli = ROOT.TGraph()
+		for p in xrange(len(points)):
+			graphLikeli.SetPoint(p, ratios[p], likelis[p] - minimumLikelihood)
 
 		lowerLimit = -1.2 * math.sqrt(eigenVectorsMinuit[par][1])
 		upperLimit =  1.2 * math.sqrt(eigenVectorsMinuit[par][1])
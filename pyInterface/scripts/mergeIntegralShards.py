@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+
+import argparse
+import sys
+
+import pyRootPwa
+import pyRootPwa.core
+
+if __name__ == "__main__":
+
+	parser = argparse.ArgumentParser(
+	                                 description="merge the partial integrals calculated with calcIntegralShard into an integral file"
+	                                )
+
+	parser.add_argument("shardFileNames", type=str, metavar="shardFile", nargs="+", help="paths to the shard files")
+	parser.add_argument("-o", type=str, metavar="path", dest="integralFileName", default="", help="path to output integral file (default: the integral file of the bin given by -b and -e)")
+	parser.add_argument("-c", type=str, metavar="configFileName", dest="configFileName", default="./rootpwa.config", help="path to config file (default: './rootpwa.config')")
+	parser.add_argument("-b", type=int, metavar="integralBin", dest="integralBin", default=-1, help="bin of the shards")
+	parser.add_argument("-e", type=str, metavar="eventsType", dest="eventsType", default="", help="events type of the shards ('generated' or 'accepted')")
+	args = parser.parse_args()
+
+	printErr  = pyRootPwa.utils.printErr
+	printSucc = pyRootPwa.utils.printSucc
+
+	integralFileName = args.integralFileName
+	if not integralFileName:
+		config = pyRootPwa.rootPwaConfig()
+		if not config.initialize(args.configFileName):
+			printErr("loading config file '" + args.configFileName + "' failed. Aborting...")
+			sys.exit(1)
+		fileManager = pyRootPwa.loadFileManager(config.fileManagerPath)
+		if not fileManager:
+			printErr("loading the file manager failed. Aborting...")
+			sys.exit(1)
+		if args.integralBin < 0 or args.integralBin >= len(fileManager.binList):
+			printErr("bin out of range (" + str(args.integralBin) + ">=" + str(len(fileManager.binList)) + "). Aborting...")
+			sys.exit(1)
+		if args.eventsType == "generated":
+			eventsType = pyRootPwa.core.eventMetadata.GENERATED
+		elif args.eventsType == "accepted":
+			eventsType = pyRootPwa.core.eventMetadata.ACCEPTED
+		else:
+			printErr("Invalid events type given ('" + args.eventsType + "'). Aborting...")
+			sys.exit(1)
+		integralFileName = fileManager.getIntegralFilePath(fileManager.binList[args.integralBin], eventsType)
+
+	if not pyRootPwa.mergeIntegralShards(integralFileName, args.shardFileNames):
+		printErr("merging of shards failed. Aborting...")
+		sys.exit(1)
+	printSucc("wrote integral to TKey '" + pyRootPwa.core.ampIntegralMatrix.integralObjectName + "' "
+	          + "in file '" + integralFileName + "'")
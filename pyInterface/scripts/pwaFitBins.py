@@ -0,0 +1,156 @@
+#!/usr/bin/env python
+
+import argparse
+import random
+import sys
+
+import pyRootPwa
+import pyRootPwa.core
+
+
+if __name__ == "__main__":
+
+	parser = argparse.ArgumentParser(
+	                                 description="pwa fit executable fitting many bins in a single process"
+	                                )
+
+	parser.add_argument("outputFileName", type=str, metavar="fileName", help="path to output file")
+	parser.add_argument("-c", type=str, metavar="configFileName", dest="configFileName", default="./rootpwa.config", help="path to config file (default: './rootpwa.config')")
+	parser.add_argument("-b", type=int, metavar="#", dest="integralBins", action="append", help="integral bin id(s) to fit; can be given multiple times (default: all bins)")
+	parser.add_argument("-s", type=int, metavar="#", dest="seed", default=0, help="random seed (default: 0)")
+	parser.add_argument("-N", type=int, metavar="#", dest="nAttempts", default=1, help="number of fit attempts to perform in each bin")
+	parser.add_argument("-C", "--cauchyPriors", help="use half-Cauchy priors (default: false)", action="store_true")
+	parser.add_argument("-P", "--cauchyPriorWidth", type=float, metavar ="WIDTH", default=0.5, help="width of half-Cauchy prior (default: 0.5)")
+	parser.add_argument("-w", type=str, metavar="path", dest="waveListFileName", default="", help="path to wavelist file (default: none)")
+	parser.add_argument("-S", type=str, metavar="path", dest="startValFileName", default="", help="path to start value fit result file (default: none)")
+	parser.add_argument("-r", type=int, metavar="#", dest="rank", default=1, help="rank of spin density matrix (default: 1)")
+	parser.add_argument("-A", type=int, metavar="#", dest="accEventsOverride", default=0,
+	                    help="number of input events to normalize acceptance to (default: use number of events from normalization integral file)")
+	parser.add_argument("--noAcceptance", help="do not take acceptance into account (default: false)", action="store_true")
+	parser.add_argument("-H", "--checkHessian", help="check analytical Hessian eigenvalues (default: false)", action="store_true")
+	parser.add_argument("-z", "--saveSpace", help="save space by not saving integral and covariance matrices (default: false)", action="store_true")
+	parser.add_argument("--nlopt", help="use NLopt instead of Minuit2 as minimizer (default: false)", action="store_true")
+	parser.add_argument("-j", type=int, metavar="#", dest="nmbWorkers", default=0, help="number of bins fitted in parallel (default: 0 = number of hardware threads)")
+	parser.add_argument("-t", type=int, metavar="#", dest="nmbThreadsPerBin", default=1, help="number of threads used in the likelihood of each bin (default: 1)")
+	parser.add_argument("-m", type=float, metavar="MB", dest="memoryBudget", default=0., help="maximum memory for the decay amplitudes of all bins fitted at the same time in MB (default: 0 = unlimited)")
+	parser.add_argument("--binIndexDir", type=str, metavar="path", dest="binIndexDirectory", default="",
+	                    help="select the events of the bins with the bin indices of the event files in this directory, which are created if they do not exist (default: scan the event files for each bin)")
+	parser.add_argument("-v", "--verbose", help="verbose; print debug output (default: false)", action="store_true")
+	args = parser.parse_args()
+
+	printErr  = pyRootPwa.utils.printErr
+	printWarn = pyRootPwa.utils.printWarn
+	printSucc = pyRootPwa.utils.printSucc
+	printInfo = pyRootPwa.utils.printInfo
+	printDebug = pyRootPwa.utils.printDebug
+
+	config = pyRootPwa.rootPwaConfig()
+	if not config.initialize(args.configFileName):
+		printErr("loading config file '" + args.configFileName + "' failed. Aborting...")
+		sys.exit(1)
+	pyRootPwa.core.particleDataTable.readFile(config.pdgFileName)
+	fileManager = pyRootPwa.loadFileManager(config.fileManagerPath)
+	if not fileManager:
+		printErr("loading the file manager failed. Aborting...")
+		sys.exit(1)
+
+	integralBins = args.integralBins
+	if not integralBins:
+		integralBins = range(len(fileManager.binList))
+	for integralBin in integralBins:
+		if integralBin < 0:
+			printErr("bin < 0 (" + str(integralBin) + "). Aborting...")
+			sys.exit(1)
+		elif integralBin >= len(fileManager.binList):
+			printErr("bin out of range (" + str(integralBin) + ">=" + str(len(fileManager.binList)) + "). Aborting...")
+			sys.exit(1)
+
+	# the wave descriptions are read only once and are shared by all bins
+	waveDescThres = pyRootPwa.utils.getWaveDescThresFromWaveList(args.waveListFileName, fileManager.getWaveDescriptions())
+	if not waveDescThres:
+		printErr("error while reading wave list. Aborting...")
+		sys.exit(1)
+
+	random.seed(args.seed)
+	bins = [ ]
+	for integralBin in integralBins:
+		multiBin = fileManager.binList[integralBin]
+		eventAndAmpFileDict = fileManager.getEventAndAmplitudeFilePathsInBin(multiBin, pyRootPwa.core.eventMetadata.REAL)
+		if not eventAndAmpFileDict:
+			printErr("could not retrieve valid amplitude file list for bin " + str(integralBin) + ". Aborting...")
+			sys.exit(1)
+		psIntegralPath  = fileManager.getIntegralFilePath(multiBin, pyRootPwa.core.eventMetadata.GENERATED)
+		accIntegralPath = psIntegralPath
+		if not args.noAcceptance:
+			accIntegralPath = fileManager.getIntegralFilePath(multiBin, pyRootPwa.core.eventMetadata.ACCEPTED)
+		if args.nAttempts == 1:
+			seeds = [ args.seed ]
+		elif args.seed == 0:
+			seeds = [ 0 for _ in range(args.nAttempts) ]
+		else:
+			seeds = [ ]
+			for _ in range(args.nAttempts):
+				while True:
+					randVal = random.randint(1000, 2**32-1)
+					if randVal not in seeds:
+						break
+				seeds.append(randVal)
+		bins.append({ "binning":              multiBin.boundaries,
+		              "eventAndAmpFileDict":  eventAndAmpFileDict,
+		              "normIntegralFileName": psIntegralPath,
+		              "accIntegralFileName":  accIntegralPath,
+		              "seeds":                seeds })
+
+	fitResults = pyRootPwa.core.pwaFitBins(bins                      = bins,
+	                                       waveDescriptionThresholds = waveDescThres,
+	                                       rank                      = args.rank,
+	                                       cauchy                    = args.cauchyPriors,
+	                                       cauchyWidth               = args.cauchyPriorWidth,
+	                                       accEventsOverride         = args.accEventsOverride,
+	                                       startValFileName          = args.startValFileName,
+	                                       checkHessian              = args.checkHessian,
+	                                       saveSpace                 = args.saveSpace,
+	                                       useNlopt                  = args.nlopt,
+	                                       nmbWorkers                = args.nmbWorkers,
+	                                       nmbThreadsPerBin          = args.nmbThreadsPerBin,
+	                                       memoryBudget              = args.memoryBudget * 1024. * 1024.,
+	                                       binIndexDirectory         = args.binIndexDirectory,
+	                                       verbose                   = args.verbose)
+	failedBins = [ integralBins[i] for i in range(len(integralBins)) if not fitResults[i] ]
+	if failedBins:
+		printWarn("didn't get valid fit result(s) for bin(s) " + str(failedBins) + ".")
+	if len(failedBins) == len(integralBins):
+		printErr("didn't get valid fit result(s). Aborting...")
+		sys.exit(1)
+
+	printInfo("writing result(s) to '" + args.outputFileName + "'")
+	valTreeName   = "pwa"
+	valBranchName = "fitResult_v2"
+	outputFile = pyRootPwa.ROOT.TFile.Open(args.outputFileName, "UPDATE")
+	if (not outputFile) or outputFile.IsZombie():
+		printErr("cannot open output file '" + args.outputFileName + "'. Aborting...")
+		sys.exit(1)
+	fitResult = pyRootPwa.core.fitResult()
+	tree = outputFile.Get(valTreeName)
+	if not tree:
+		printInfo("file '" + args.outputFileName + "' is empty. "
+		        + "creating new tree '" + valTreeName + "' for PWA result.")
+		tree = pyRootPwa.ROOT.TTree(valTreeName, valTreeName)
+		if not fitResult.branch(tree, valBranchName):
+			printErr("failed to create new branch '" + valBranchName + "' in file '" + args.outputFileName + "'.")
+			sys.exit(1)
+	else:
+		fitResult.setBranchAddress(tree, valBranchName)
+	for binResults in fitResults:
+		for result in binResults:
+			fitResult.fill(result)
+			tree.Fill()
+	nmbBytes = tree.Write()
+	outputFile.Close()
+	if nmbBytes == 0:
+		printErr("problems writing fit result to TKey 'fitResult' "
+		       + "in file '" + args.outputFileName + "'")
+		sys.exit(1)
+	else:
+		printSucc("wrote fit result to TKey 'fitResult' "
+		        + "in file '" + args.outputFileName + "'")
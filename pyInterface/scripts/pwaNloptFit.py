@@ -28,6 +28,16 @@ if __name__ == "__main__":
 	parser.add_argument("--noAcceptance", help="do not take acceptance into account (default: false)", action="store_true")
 	parser.add_argument("-H", "--checkHessian", help="check analytical Hessian eigenvalues (default: false)", action="store_true")
 	parser.add_argument("-z", "--saveSpace", help="save space by not saving integral and covariance matrices (default: false)", action="store_true")
+	parser.add_argument("--mpi", help="distribute the events over the MPI processes; run with 'mpirun -np <n>' (default: false)", action="store_true")
+	parser.add_argument("--ampMatrixDir", type=str, metavar="path", dest="ampMatrixDirectory", default="",
+	                    help="read the decay amplitudes from the amplitude matrix files in this directory (default: use the amplitude files)")
+	parser.add_argument("--ampCacheDir", type=str, metavar="path", dest="ampCacheDirectory", default="",
+	                    help="read the decay amplitudes from memory-mapped cache files in this directory, which are created if they do not exist (default: no cache)")
+	parser.add_argument("--binIndexDir", type=str, metavar="path", dest="binIndexDirectory", default="",
+	                    help="select the events of the bin with the bin indices of the event files in this directory, which are created if they do not exist (default: scan the event files)")
+	parser.add_argument("-j", type=int, metavar="#", dest="nmbWorkers", default=0, help="number of fit attempts running concurrently (default: 0 = number of hardware threads)")
+	parser.add_argument("--stopThreshold", type=float, metavar="DELTA", default=0.,
+	                    help="stop fit attempts whose log-likelihood is worse than the one of the best attempt by more than DELTA (default: 0 = never stop)")
 	parser.add_argument("-v", "--verbose", help="verbose; print debug output (default: false)", action="store_true")
 	args = parser.parse_args()
 
@@ -58,6 +68,9 @@ if __name__ == "__main__":
 	if not eventAndAmpFileDict:
 		printErr("could not retrieve valid amplitude file list. Aborting...")
 		sys.exit(1)
+	ampMatrixFileDict = None
+	if args.ampMatrixDirectory:
+		ampMatrixFileDict = { eventFileName: pyRootPwa.getAmplitudeMatrixFilePath(eventFileName, args.ampMatrixDirectory) for eventFileName in eventAndAmpFileDict }
 
 	psIntegralPath  = fileManager.getIntegralFilePath(multiBin, pyRootPwa.core.eventMetadata.GENERATED)
 	accIntegralPath = psIntegralPath
@@ -91,8 +104,17 @@ if __name__ == "__main__":
 	                                   saveSpace = args.saveSpace,
 	                                   rank = args.rank,
 	                                   verbose = args.verbose,
-	                                   attempts = args.nAttempts
+	                                   attempts = args.nAttempts,
+	                                   mpi = args.mpi,
+	                                   nmbWorkers = args.nmbWorkers,
+	                                   stopThreshold = args.stopThreshold,
+	                                   ampMatrixFileDict = ampMatrixFileDict,
+	                                   ampCacheDirectory = args.ampCacheDirectory,
+	                                   binIndexDirectory = args.binIndexDirectory
 	                                  )
+	if fitResults is None:
+		# MPI worker process; the fit result is written by the process with rank 0
+		sys.exit(0)
 	if not fitResults:
 		printErr("didn't get valid fit result(s). Aborting...")
 		sys.exit(1)
@@ -0,0 +1,213 @@
+
+#include "amplitudeCacheFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <TMD5.h>
+
+#include "amplitudeMetadata.h"
+#include "eventMetadata.h"
+#include "fileUtils.hpp"
+#include "reportingUtils.hpp"
+
+using namespace rpwa;
+using namespace std;
+
+
+namespace {
+
+	// layout of the beginning of the header, the rest of the header is
+	// padding up to amplitudeCacheFile::headerSize
+	struct cacheFileHeader {
+		char     magic[8];
+		uint32_t version;
+		uint32_t amplitudeSize;
+		uint64_t headerSize;
+		int64_t  nmbAmplitudes;
+		char     key[33];
+	};
+
+	const char     cacheFileMagic[8]  = {'R', 'P', 'W', 'A', 'A', 'M', 'P', 'C'};
+	const uint32_t cacheFileVersion   = 1;
+
+}
+
+
+// multiple of the page size on all relevant platforms, so that the
+// amplitudes are page-aligned in the mapped file
+const size_t rpwa::amplitudeCacheFile::headerSize = 4096;
+
+
+rpwa::amplitudeCacheFile::amplitudeCacheFile()
+	: _mappedData(0),
+	  _mappedSize(0),
+	  _amplitudes(0),
+	  _nmbAmplitudes(0)
+{ }
+
+
+rpwa::amplitudeCacheFile::~amplitudeCacheFile()
+{
+	close();
+}
+
+
+bool rpwa::amplitudeCacheFile::open(const string&            cacheDirectory,
+                                    const amplitudeMetadata& ampMeta)
+{
+	close();
+	const string fileName = cacheFileName(cacheDirectory, ampMeta);
+	if(access(fileName.c_str(), R_OK) != 0) {
+		printInfo << "creating amplitude cache file '" << fileName << "' for wave '" << ampMeta.objectBaseName() << "'." << endl;
+		if(not write(fileName, ampMeta)) {
+			printWarn << "could not create amplitude cache file '" << fileName << "'." << endl;
+			return false;
+		}
+	}
+	return map(fileName, ampMeta);
+}
+
+
+void rpwa::amplitudeCacheFile::close()
+{
+	if(_mappedData) {
+		munmap(_mappedData, _mappedSize);
+	}
+	_mappedData = 0;
+	_mappedSize = 0;
+	_amplitudes = 0;
+	_nmbAmplitudes = 0;
+}
+
+
+string rpwa::amplitudeCacheFile::cacheKey(const amplitudeMetadata& ampMeta)
+{
+	TMD5 md5;
+	const string& ampHash = ampMeta.contentHash();
+	md5.Update((const UChar_t*)ampHash.c_str(), ampHash.size());
+	const vector<eventMetadata>& evtMetas = ampMeta.eventMetadata();
+	for(size_t i = 0; i < evtMetas.size(); ++i) {
+		const string& evtHash = evtMetas[i].contentHash();
+		md5.Update((const UChar_t*)evtHash.c_str(), evtHash.size());
+	}
+	md5.Final();
+	return md5.AsString();
+}
+
+
+string rpwa::amplitudeCacheFile::cacheFileName(const string&            cacheDirectory,
+                                               const amplitudeMetadata& ampMeta)
+{
+	stringstream sstr;
+	sstr << cacheDirectory << "/" << ampMeta.objectBaseName() << "." << cacheKey(ampMeta) << ".ampCache";
+	return sstr.str();
+}
+
+
+bool rpwa::amplitudeCacheFile::write(const string&            fileName,
+                                     const amplitudeMetadata& ampMeta)
+{
+	const string tmpName = temporaryFileName(fileName);
+	FILE* outFile = fopen(tmpName.c_str(), "wb");
+	if(not outFile) {
+		printWarn << "could not open '" << tmpName << "' for writing: " << strerror(errno) << endl;
+		return false;
+	}
+
+	vector<char> headerBuffer(headerSize, 0);
+	cacheFileHeader* header = (cacheFileHeader*)headerBuffer.data();
+	memcpy(header->magic, cacheFileMagic, sizeof(cacheFileMagic));
+	header->version       = cacheFileVersion;
+	header->amplitudeSize = sizeof(complex<double>);
+	header->headerSize    = headerSize;
+	header->nmbAmplitudes = ampMeta.nmbAmplitudes();
+	const string key = cacheKey(ampMeta);
+	strncpy(header->key, key.c_str(), sizeof(header->key) - 1);
+	bool success = (fwrite(headerBuffer.data(), 1, headerSize, outFile) == headerSize);
+
+	const long nmbAmps = ampMeta.nmbAmplitudes();
+	vector<complex<double> > buffer(amplitudeMetadata::defaultChunkSize);
+	for(long firstAmp = 0; success and firstAmp < nmbAmps; firstAmp += buffer.size()) {
+		const long nmbInBlock = min((long)buffer.size(), nmbAmps - firstAmp);
+		if(not ampMeta.readAmplitudes(firstAmp, nmbInBlock, buffer.data())) {
+			printWarn << "could not read amplitudes of wave '" << ampMeta.objectBaseName() << "'." << endl;
+			success = false;
+			break;
+		}
+		success = (fwrite(buffer.data(), sizeof(complex<double>), nmbInBlock, outFile) == (size_t)nmbInBlock);
+	}
+	if(fclose(outFile) != 0) {
+		success = false;
+	}
+	if(not success) {
+		printWarn << "could not write amplitude cache file '" << tmpName << "'." << endl;
+		remove(tmpName.c_str());
+		return false;
+	}
+	if(rename(tmpName.c_str(), fileName.c_str()) != 0) {
+		printWarn << "could not rename '" << tmpName << "' to '" << fileName << "': " << strerror(errno) << endl;
+		remove(tmpName.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+bool rpwa::amplitudeCacheFile::map(const string&            fileName,
+                                   const amplitudeMetadata& ampMeta)
+{
+	const int fd = ::open(fileName.c_str(), O_RDONLY);
+	if(fd < 0) {
+		printWarn << "could not open amplitude cache file '" << fileName << "': " << strerror(errno) << endl;
+		return false;
+	}
+	struct stat fileStat;
+	if(fstat(fd, &fileStat) != 0 or (size_t)fileStat.st_size < headerSize) {
+		printWarn << "amplitude cache file '" << fileName << "' is too small." << endl;
+		::close(fd);
+		return false;
+	}
+	const size_t mappedSize = fileStat.st_size;
+	void* mappedData = mmap(0, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+	// the mapping stays valid after the file descriptor is closed
+	::close(fd);
+	if(mappedData == MAP_FAILED) {
+		printWarn << "could not map amplitude cache file '" << fileName << "': " << strerror(errno) << endl;
+		return false;
+	}
+
+	const cacheFileHeader* header = (const cacheFileHeader*)mappedData;
+	const long nmbAmps = ampMeta.nmbAmplitudes();
+	string errorMessage = "";
+	if(memcmp(header->magic, cacheFileMagic, sizeof(cacheFileMagic)) != 0) {
+		errorMessage = "is not an amplitude cache file";
+	} else if(header->version != cacheFileVersion or header->amplitudeSize != sizeof(complex<double>) or header->headerSize != headerSize) {
+		errorMessage = "has an unsupported format";
+	} else if(string(header->key, strnlen(header->key, sizeof(header->key))) != cacheKey(ampMeta)) {
+		errorMessage = "belongs to different amplitudes";
+	} else if(header->nmbAmplitudes != nmbAmps or mappedSize != headerSize + nmbAmps * sizeof(complex<double>)) {
+		errorMessage = "contains the wrong number of amplitudes";
+	}
+	if(errorMessage != "") {
+		printWarn << "amplitude cache file '" << fileName << "' " << errorMessage << "." << endl;
+		munmap(mappedData, mappedSize);
+		return false;
+	}
+
+	_mappedData = mappedData;
+	_mappedSize = mappedSize;
+	_amplitudes = (const complex<double>*)((const char*)mappedData + headerSize);
+	_nmbAmplitudes = nmbAmps;
+	return true;
+}
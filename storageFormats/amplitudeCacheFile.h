@@ -0,0 +1,69 @@
+#ifndef AMPLITUDECACHEFILE_H
+#define AMPLITUDECACHEFILE_H
+
+#include <complex>
+#include <string>
+
+
+namespace rpwa {
+
+	class amplitudeMetadata;
+
+	// uncompressed binary copy of the amplitudes of an amplitude file
+	//
+	// the file consists of a header of headerSize bytes followed by the
+	// amplitudes as plain complex<double>, so that the amplitudes start
+	// at a page boundary when the file is mapped into memory. the file
+	// is mapped read-only and shared, so concurrent processes on one
+	// node read the amplitudes from the same pages of the page cache.
+	// the cache file of an amplitude file is identified by a key built
+	// from the content hashes of the amplitudes and of the events they
+	// belong to.
+	class amplitudeCacheFile {
+
+	  public:
+
+		amplitudeCacheFile();
+		~amplitudeCacheFile();
+
+		// opens the cache file of the given amplitude file in
+		// cacheDirectory; if it does not exist yet, it is created first
+		bool open(const std::string&             cacheDirectory,
+		          const rpwa::amplitudeMetadata& ampMeta);
+		void close();
+
+		bool isOpen() const { return _amplitudes != 0; }
+		long nmbAmplitudes() const { return _nmbAmplitudes; }
+		const std::complex<double>* amplitudes() const { return _amplitudes; }
+
+		static std::string cacheKey(const rpwa::amplitudeMetadata& ampMeta);
+		static std::string cacheFileName(const std::string&             cacheDirectory,
+		                                 const rpwa::amplitudeMetadata& ampMeta);
+
+		// writes the cache file; the file is written under a temporary
+		// name first and then renamed, so that other processes never
+		// see a partially written file
+		static bool write(const std::string&             fileName,
+		                  const rpwa::amplitudeMetadata& ampMeta);
+
+		static const std::size_t headerSize;
+
+	  private:
+
+		bool map(const std::string&             fileName,
+		         const rpwa::amplitudeMetadata& ampMeta);
+
+		amplitudeCacheFile(const amplitudeCacheFile&);
+		amplitudeCacheFile& operator =(const amplitudeCacheFile&);
+
+		void*                       _mappedData;
+		std::size_t                 _mappedSize;
+		const std::complex<double>* _amplitudes;
+		long                        _nmbAmplitudes;
+
+	};
+
+}
+
+
+#endif
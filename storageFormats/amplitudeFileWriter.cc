@@ -18,7 +18,10 @@ rpwa::amplitudeFileWriter::amplitudeFileWriter()
 	  _outputFile(0),
 	  _metadata(),
 	  _ampTreeLeaf(0),
-	  _hashCalculator()
+	  _hashCalculator(),
+	  _nmbAmpsInChunk(0),
+	  _chunkReal(),
+	  _chunkImag()
 {
 
 }
@@ -35,7 +38,8 @@ bool rpwa::amplitudeFileWriter::initialize(TFile&                             ou
                                            const string&                      keyfileContent,
                                            const string&                      objectBaseName,
                                            const int&                         splitlevel,
-                                           const int&                         buffsize)
+                                           const int&                         buffsize,
+                                           const unsigned int                 columnarChunkSize)
 {
 	if(_initialized) {
 		printWarn << "trying to initialized when already initialized." << endl;
@@ -53,12 +57,28 @@ bool rpwa::amplitudeFileWriter::initialize(TFile&                             ou
 	_metadata.setKeyfileContent(keyfileContent);
 	_metadata.setRootpwaGitHash(gitHash());
 	_metadata.setObjectBaseName(objectBaseName);
+	_metadata.setChunkSize(columnarChunkSize);
+	_metadata.setNmbAmplitudes(0);
 
 	const string treeName = amplitudeMetadata::getObjectNames(objectBaseName).first;
 
 	_metadata._amplitudeTree = new TTree(treeName.c_str(), treeName.c_str());
-	_ampTreeLeaf = new rpwa::amplitudeTreeLeaf();
-	_metadata._amplitudeTree->Branch(rpwa::amplitudeMetadata::amplitudeLeafName.c_str(), &_ampTreeLeaf, buffsize, splitlevel);
+	if(_metadata.columnar()) {
+		// each entry holds the real and imaginary parts of a chunk of
+		// consecutive amplitudes as plain arrays, which are read in bulk
+		_nmbAmpsInChunk = 0;
+		_chunkReal.assign(columnarChunkSize, 0.);
+		_chunkImag.assign(columnarChunkSize, 0.);
+		const string& nmbLeafName = rpwa::amplitudeMetadata::nmbAmplitudesLeafName;
+		const string& realLeafName = rpwa::amplitudeMetadata::amplitudeRealLeafName;
+		const string& imagLeafName = rpwa::amplitudeMetadata::amplitudeImagLeafName;
+		_metadata._amplitudeTree->Branch(nmbLeafName.c_str(), &_nmbAmpsInChunk, (nmbLeafName + "/I").c_str(), buffsize);
+		_metadata._amplitudeTree->Branch(realLeafName.c_str(), _chunkReal.data(), (realLeafName + "[" + nmbLeafName + "]/D").c_str(), buffsize);
+		_metadata._amplitudeTree->Branch(imagLeafName.c_str(), _chunkImag.data(), (imagLeafName + "[" + nmbLeafName + "]/D").c_str(), buffsize);
+	} else {
+		_ampTreeLeaf = new rpwa::amplitudeTreeLeaf();
+		_metadata._amplitudeTree->Branch(rpwa::amplitudeMetadata::amplitudeLeafName.c_str(), &_ampTreeLeaf, buffsize, splitlevel);
+	}
 
 	_initialized = true;
 	return _initialized;
@@ -71,8 +91,18 @@ void rpwa::amplitudeFileWriter::addAmplitude(const complex<double>& amplitude)
 		printWarn << "trying to add amplitude when not initialized." << endl;
 		return;
 	}
-	_ampTreeLeaf->setAmp(amplitude);
 	_hashCalculator.Update(amplitude);
+	++_metadata._nmbAmplitudes;
+	if(_metadata.columnar()) {
+		_chunkReal[_nmbAmpsInChunk] = amplitude.real();
+		_chunkImag[_nmbAmpsInChunk] = amplitude.imag();
+		++_nmbAmpsInChunk;
+		if((unsigned int)_nmbAmpsInChunk == _metadata.chunkSize()) {
+			fillChunk();
+		}
+		return;
+	}
+	_ampTreeLeaf->setAmp(amplitude);
 	_metadata._amplitudeTree->Fill();
 }
 
@@ -93,6 +123,9 @@ void rpwa::amplitudeFileWriter::reset()
 	}
 	_outputFile = 0;
 	_hashCalculator = hashCalculator();
+	_nmbAmpsInChunk = 0;
+	_chunkReal.clear();
+	_chunkImag.clear();
 	_initialized = false;
 }
 
@@ -103,9 +136,19 @@ bool rpwa::amplitudeFileWriter::finalize()
 		printWarn << "trying to finalize when not initialized." << endl;
 		return false;
 	}
+	if(_metadata.columnar() and _nmbAmpsInChunk > 0) {
+		fillChunk();
+	}
 	_metadata.setContentHash(_hashCalculator.hash());
 	_outputFile->cd();
 	_metadata.Write(_metadata.getObjectNames().second.c_str());
 	reset();
 	return true;
 }
+
+
+void rpwa::amplitudeFileWriter::fillChunk()
+{
+	_metadata._amplitudeTree->Fill();
+	_nmbAmpsInChunk = 0;
+}
@@ -2,6 +2,7 @@
 #define AMPLITUDEFILEWRITER_H
 
 #include <complex>
+#include <vector>
 
 #include "amplitudeMetadata.h"
 #include "hashCalculator.h"
@@ -25,7 +26,8 @@ namespace rpwa {
 		                const std::string&                            keyfileContent,
 		                const std::string&                            objectBasename,
 		                const int&                                    splitlevel = 99,
-		                const int&                                    buffsize = 256000);
+		                const int&                                    buffsize = 256000,
+		                const unsigned int                            columnarChunkSize = 0);  // > 0 selects the columnar format with this many amplitudes per tree entry
 
 		void addAmplitude(const std::complex<double>& amplitude);
 		void addAmplitudes(const std::vector<std::complex<double> >& amplitudes);
@@ -38,11 +40,16 @@ namespace rpwa {
 
 	  private:
 
+		void fillChunk();
+
 		bool _initialized;
 		TFile* _outputFile;
 		rpwa::amplitudeMetadata _metadata;
 		rpwa::amplitudeTreeLeaf* _ampTreeLeaf;
 		hashCalculator _hashCalculator;
+		Int_t _nmbAmpsInChunk;
+		std::vector<double> _chunkReal;
+		std::vector<double> _chunkImag;
 
 	};
 
@@ -0,0 +1,318 @@
+
+#include "amplitudeMatrixFileWriter.h"
+
+#include <algorithm>
+#include <set>
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include "amplitudeMetadata.h"
+#include "eventMetadata.h"
+#include "reportingUtils.hpp"
+#include "reportingUtilsEnvironment.h"
+
+using namespace rpwa;
+using namespace std;
+
+
+rpwa::amplitudeMatrixFileWriter::amplitudeMatrixFileWriter()
+	: _initialized(false),
+	  _outputFile(0),
+	  _metadata(),
+	  _hashCalculators(),
+	  _chunkHashCalculators(),
+	  _nmbEventsInChunk(0),
+	  _nmbAmpsInChunk(0),
+	  _chunkReal(),
+	  _chunkImag(),
+	  _chunkWaveHashes(0)
+{
+
+}
+
+
+rpwa::amplitudeMatrixFileWriter::~amplitudeMatrixFileWriter()
+{
+	reset();
+}
+
+
+bool rpwa::amplitudeMatrixFileWriter::initialize(TFile&                             outputFile,
+                                                 const vector<const eventMetadata*> eventMeta,
+                                                 const vector<string>&              waveNames,
+                                                 const vector<string>&              keyfileContents,
+                                                 const string&                      objectBaseName,
+                                                 const unsigned int                 chunkSize,
+                                                 const int&                         buffsize)
+{
+	if(_initialized) {
+		printWarn << "trying to initialized when already initialized." << endl;
+		return false;
+	}
+	if(waveNames.empty()) {
+		printWarn << "no waves given." << endl;
+		return false;
+	}
+	if(keyfileContents.size() != waveNames.size()) {
+		printWarn << "number of keyfile contents (" << keyfileContents.size() << ") "
+		          << "does not match number of waves (" << waveNames.size() << ")." << endl;
+		return false;
+	}
+	if(set<string>(waveNames.begin(), waveNames.end()).size() != waveNames.size()) {
+		printWarn << "wave names are not unique." << endl;
+		return false;
+	}
+	if(chunkSize == 0) {
+		printWarn << "chunk size has to be larger than zero." << endl;
+		return false;
+	}
+
+	_outputFile = &outputFile;
+	_outputFile->cd();
+
+	vector<eventMetadata> eventMetaObjects;
+	for(unsigned int i = 0; i < eventMeta.size(); ++i) {
+		eventMetaObjects.push_back(*(eventMeta[i]));
+	}
+	_metadata.setEventMetadata(eventMetaObjects);
+	_metadata.setWaveNames(waveNames);
+	_metadata.setKeyfileContents(keyfileContents);
+	_metadata.setRootpwaGitHash(gitHash());
+	_metadata.setObjectBaseName(objectBaseName);
+	_metadata.setChunkSize(chunkSize);
+	_metadata._nmbEvents = 0;
+
+	const size_t nmbWaves = waveNames.size();
+	_hashCalculators.assign(nmbWaves, hashCalculator());
+	_chunkHashCalculators.assign(nmbWaves, hashCalculator());
+	_nmbEventsInChunk = 0;
+	_nmbAmpsInChunk = 0;
+	_chunkReal.assign((size_t)chunkSize * nmbWaves, 0.);
+	_chunkImag.assign((size_t)chunkSize * nmbWaves, 0.);
+	_chunkWaveHashes = new vector<string>(nmbWaves);
+
+	const string treeName = amplitudeMatrixMetadata::getObjectNames(objectBaseName).first;
+
+	_metadata._amplitudeTree = new TTree(treeName.c_str(), treeName.c_str());
+	const string& nmbEventsLeafName = amplitudeMatrixMetadata::nmbEventsLeafName;
+	const string& nmbAmpsLeafName = amplitudeMatrixMetadata::nmbAmplitudesLeafName;
+	const string& realLeafName = amplitudeMatrixMetadata::amplitudeRealLeafName;
+	const string& imagLeafName = amplitudeMatrixMetadata::amplitudeImagLeafName;
+	_metadata._amplitudeTree->Branch(nmbEventsLeafName.c_str(), &_nmbEventsInChunk, (nmbEventsLeafName + "/I").c_str(), buffsize);
+	_metadata._amplitudeTree->Branch(nmbAmpsLeafName.c_str(), &_nmbAmpsInChunk, (nmbAmpsLeafName + "/I").c_str(), buffsize);
+	_metadata._amplitudeTree->Branch(realLeafName.c_str(), _chunkReal.data(), (realLeafName + "[" + nmbAmpsLeafName + "]/D").c_str(), buffsize);
+	_metadata._amplitudeTree->Branch(imagLeafName.c_str(), _chunkImag.data(), (imagLeafName + "[" + nmbAmpsLeafName + "]/D").c_str(), buffsize);
+	_metadata._amplitudeTree->Branch(amplitudeMatrixMetadata::waveHashesLeafName.c_str(), &_chunkWaveHashes);
+
+	_initialized = true;
+	return _initialized;
+}
+
+
+bool rpwa::amplitudeMatrixFileWriter::addEvent(const vector<complex<double> >& amplitudes)
+{
+	if(not _initialized) {
+		printWarn << "trying to add event when not initialized." << endl;
+		return false;
+	}
+	const size_t nmbWaves = _metadata.nmbWaves();
+	if(amplitudes.size() != nmbWaves) {
+		printWarn << "got " << amplitudes.size() << " amplitudes for " << nmbWaves << " waves." << endl;
+		return false;
+	}
+	const size_t offset = (size_t)_nmbEventsInChunk * nmbWaves;
+	for(size_t iWave = 0; iWave < nmbWaves; ++iWave) {
+		_chunkReal[offset + iWave] = amplitudes[iWave].real();
+		_chunkImag[offset + iWave] = amplitudes[iWave].imag();
+		_hashCalculators[iWave].Update(amplitudes[iWave]);
+		_chunkHashCalculators[iWave].Update(amplitudes[iWave]);
+	}
+	++_nmbEventsInChunk;
+	++_metadata._nmbEvents;
+	if((unsigned int)_nmbEventsInChunk == _metadata.chunkSize()) {
+		fillChunk();
+	}
+	return true;
+}
+
+
+bool rpwa::amplitudeMatrixFileWriter::addEvents(const vector<vector<complex<double> > >& waveAmplitudes)
+{
+	if(not _initialized) {
+		printWarn << "trying to add events when not initialized." << endl;
+		return false;
+	}
+	const size_t nmbWaves = _metadata.nmbWaves();
+	if(waveAmplitudes.size() != nmbWaves) {
+		printWarn << "got amplitudes of " << waveAmplitudes.size() << " waves instead of " << nmbWaves << "." << endl;
+		return false;
+	}
+	if(nmbWaves == 0) {
+		return true;
+	}
+	const size_t nmbEvents = waveAmplitudes[0].size();
+	for(size_t iWave = 1; iWave < nmbWaves; ++iWave) {
+		if(waveAmplitudes[iWave].size() != nmbEvents) {
+			printWarn << "got " << waveAmplitudes[iWave].size() << " amplitudes for wave " << iWave << " "
+			          << "but " << nmbEvents << " amplitudes for wave 0." << endl;
+			return false;
+		}
+	}
+	// the events are written chunk by chunk, the amplitudes of one wave
+	// are hashed in event order as in addEvent()
+	size_t firstEvent = 0;
+	while(firstEvent < nmbEvents) {
+		const size_t nmbEventsCopy = min(nmbEvents - firstEvent, (size_t)(_metadata.chunkSize() - _nmbEventsInChunk));
+		for(size_t iWave = 0; iWave < nmbWaves; ++iWave) {
+			const complex<double>* amplitudes = &waveAmplitudes[iWave][firstEvent];
+			size_t                 offset     = (size_t)_nmbEventsInChunk * nmbWaves + iWave;
+			for(size_t iEvent = 0; iEvent < nmbEventsCopy; ++iEvent, offset += nmbWaves) {
+				_chunkReal[offset] = amplitudes[iEvent].real();
+				_chunkImag[offset] = amplitudes[iEvent].imag();
+				_hashCalculators[iWave].Update(amplitudes[iEvent]);
+				_chunkHashCalculators[iWave].Update(amplitudes[iEvent]);
+			}
+		}
+		_nmbEventsInChunk += nmbEventsCopy;
+		_metadata._nmbEvents += nmbEventsCopy;
+		firstEvent += nmbEventsCopy;
+		if((unsigned int)_nmbEventsInChunk == _metadata.chunkSize()) {
+			fillChunk();
+		}
+	}
+	return true;
+}
+
+
+void rpwa::amplitudeMatrixFileWriter::reset()
+{
+	if(_chunkWaveHashes) {
+		delete _chunkWaveHashes;
+		_chunkWaveHashes = 0;
+	}
+	_outputFile = 0;
+	_hashCalculators.clear();
+	_chunkHashCalculators.clear();
+	_nmbEventsInChunk = 0;
+	_nmbAmpsInChunk = 0;
+	_chunkReal.clear();
+	_chunkImag.clear();
+	_initialized = false;
+}
+
+
+bool rpwa::amplitudeMatrixFileWriter::finalize()
+{
+	if(not _initialized) {
+		printWarn << "trying to finalize when not initialized." << endl;
+		return false;
+	}
+	if(_nmbEventsInChunk > 0) {
+		fillChunk();
+	}
+	vector<string> contentHashes(_hashCalculators.size());
+	for(size_t iWave = 0; iWave < _hashCalculators.size(); ++iWave) {
+		contentHashes[iWave] = _hashCalculators[iWave].hash();
+	}
+	_metadata.setContentHashes(contentHashes);
+	_outputFile->cd();
+	_metadata.Write(_metadata.getObjectNames().second.c_str());
+	reset();
+	return true;
+}
+
+
+void rpwa::amplitudeMatrixFileWriter::fillChunk()
+{
+	_nmbAmpsInChunk = _nmbEventsInChunk * _metadata.nmbWaves();
+	for(size_t iWave = 0; iWave < _chunkHashCalculators.size(); ++iWave) {
+		(*_chunkWaveHashes)[iWave] = _chunkHashCalculators[iWave].hash();
+		_chunkHashCalculators[iWave] = hashCalculator();
+	}
+	_metadata._amplitudeTree->Fill();
+	_nmbEventsInChunk = 0;
+}
+
+
+bool rpwa::amplitudeMatrixFileWriter::convertAmplitudeFiles(TFile&                                   outputFile,
+                                                            const vector<const amplitudeMetadata*>& ampMetas,
+                                                            const string&                           objectBaseName,
+                                                            const unsigned int                      chunkSize)
+{
+	if(ampMetas.empty()) {
+		printErr << "no amplitude files given." << endl;
+		return false;
+	}
+	for(size_t iWave = 0; iWave < ampMetas.size(); ++iWave) {
+		if(not ampMetas[iWave]) {
+			printErr << "amplitude metadata " << iWave << " not valid." << endl;
+			return false;
+		}
+	}
+	const long nmbEvents = ampMetas[0]->nmbAmplitudes();
+	const vector<eventMetadata>& eventMetas = ampMetas[0]->eventMetadata();
+	vector<string> waveNames(ampMetas.size());
+	vector<string> keyfileContents(ampMetas.size());
+	for(size_t iWave = 0; iWave < ampMetas.size(); ++iWave) {
+		waveNames[iWave] = ampMetas[iWave]->objectBaseName();
+		keyfileContents[iWave] = ampMetas[iWave]->keyfileContent();
+		if(ampMetas[iWave]->nmbAmplitudes() != nmbEvents) {
+			printErr << "amplitude file of wave '" << waveNames[iWave] << "' contains " << ampMetas[iWave]->nmbAmplitudes()
+			         << " amplitudes, but the one of wave '" << waveNames[0] << "' contains " << nmbEvents << "." << endl;
+			return false;
+		}
+		const vector<eventMetadata>& waveEventMetas = ampMetas[iWave]->eventMetadata();
+		bool sameEvents = (waveEventMetas.size() == eventMetas.size());
+		for(size_t iEvtMeta = 0; sameEvents and iEvtMeta < eventMetas.size(); ++iEvtMeta) {
+			sameEvents = (waveEventMetas[iEvtMeta].contentHash() == eventMetas[iEvtMeta].contentHash());
+		}
+		if(not sameEvents) {
+			printErr << "amplitude file of wave '" << waveNames[iWave] << "' belongs to different events "
+			         << "than the one of wave '" << waveNames[0] << "'." << endl;
+			return false;
+		}
+	}
+
+	vector<const eventMetadata*> eventMetaPointers(eventMetas.size());
+	for(size_t iEvtMeta = 0; iEvtMeta < eventMetas.size(); ++iEvtMeta) {
+		eventMetaPointers[iEvtMeta] = &eventMetas[iEvtMeta];
+	}
+	amplitudeMatrixFileWriter writer;
+	if(not writer.initialize(outputFile, eventMetaPointers, waveNames, keyfileContents, objectBaseName, chunkSize)) {
+		printErr << "could not initialize amplitude matrix file writer." << endl;
+		return false;
+	}
+
+	// read the waves in blocks of one chunk to keep the memory footprint small
+	vector<vector<complex<double> > > waveBlocks(ampMetas.size(), vector<complex<double> >(chunkSize));
+	vector<complex<double> > eventAmps(ampMetas.size());
+	for(long firstEvent = 0; firstEvent < nmbEvents; firstEvent += chunkSize) {
+		const long nmbInBlock = min((long)chunkSize, nmbEvents - firstEvent);
+		for(size_t iWave = 0; iWave < ampMetas.size(); ++iWave) {
+			if(not ampMetas[iWave]->readAmplitudes(firstEvent, nmbInBlock, waveBlocks[iWave].data())) {
+				printErr << "could not read amplitudes of wave '" << waveNames[iWave] << "'." << endl;
+				return false;
+			}
+		}
+		for(long iEvent = 0; iEvent < nmbInBlock; ++iEvent) {
+			for(size_t iWave = 0; iWave < ampMetas.size(); ++iWave) {
+				eventAmps[iWave] = waveBlocks[iWave][iEvent];
+			}
+			writer.addEvent(eventAmps);
+		}
+	}
+	const amplitudeMatrixMetadata& matrixMeta = writer._metadata;
+	if(not writer.finalize()) {
+		printErr << "could not finalize amplitude matrix file writer." << endl;
+		return false;
+	}
+	for(size_t iWave = 0; iWave < ampMetas.size(); ++iWave) {
+		if(matrixMeta.contentHashes()[iWave] != ampMetas[iWave]->contentHash()) {
+			printErr << "content hash of wave '" << waveNames[iWave] << "' does not match the one "
+			         << "stored in its amplitude file." << endl;
+			return false;
+		}
+	}
+	return true;
+}
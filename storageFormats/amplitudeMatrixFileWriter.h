@@ -0,0 +1,71 @@
+#ifndef AMPLITUDEMATRIXFILEWRITER_H
+#define AMPLITUDEMATRIXFILEWRITER_H
+
+#include <complex>
+#include <vector>
+
+#include "amplitudeMatrixMetadata.h"
+#include "hashCalculator.h"
+
+
+class TFile;
+
+namespace rpwa {
+
+	class amplitudeMetadata;
+
+	class amplitudeMatrixFileWriter {
+
+	  public:
+
+		amplitudeMatrixFileWriter();
+		~amplitudeMatrixFileWriter();
+
+		bool initialize(TFile&                                        outputFile,
+		                const std::vector<const rpwa::eventMetadata*> eventMetadata,
+		                const std::vector<std::string>&               waveNames,
+		                const std::vector<std::string>&               keyfileContents,
+		                const std::string&                            objectBasename,
+		                const unsigned int                            chunkSize = rpwa::amplitudeMatrixMetadata::defaultChunkSize,
+		                const int&                                    buffsize = 256000);
+
+		// adds the amplitudes of all waves for the next event
+		bool addEvent(const std::vector<std::complex<double> >& amplitudes);
+		// adds the amplitudes of the next events, given as [wave][event]
+		bool addEvents(const std::vector<std::vector<std::complex<double> > >& waveAmplitudes);
+
+		void reset();
+
+		bool finalize();
+
+		const bool& initialized() { return _initialized; }
+
+		// writes the amplitudes of the given per-wave amplitude files,
+		// which all have to belong to the same events, into a single
+		// amplitude matrix in outputFile
+		static bool convertAmplitudeFiles(TFile&                                            outputFile,
+		                                  const std::vector<const rpwa::amplitudeMetadata*>& ampMetas,
+		                                  const std::string&                                objectBaseName,
+		                                  const unsigned int                                chunkSize = rpwa::amplitudeMatrixMetadata::defaultChunkSize);
+
+	  private:
+
+		void fillChunk();
+
+		bool _initialized;
+		TFile* _outputFile;
+		rpwa::amplitudeMatrixMetadata _metadata;
+		std::vector<hashCalculator> _hashCalculators;
+		std::vector<hashCalculator> _chunkHashCalculators;
+		Int_t _nmbEventsInChunk;
+		Int_t _nmbAmpsInChunk;
+		std::vector<double> _chunkReal;
+		std::vector<double> _chunkImag;
+		std::vector<std::string>* _chunkWaveHashes;
+
+	};
+
+}
+
+
+#endif
@@ -0,0 +1,313 @@
+
+#include "amplitudeMatrixMetadata.h"
+
+#include <algorithm>
+
+#include <boost/progress.hpp>
+
+#include <TBranch.h>
+#include <TFile.h>
+#include <TTree.h>
+
+#include "hashCalculator.h"
+#include "reportingUtils.hpp"
+
+using namespace rpwa;
+using namespace std;
+
+
+namespace {
+
+	bool branchAddressIs(TTree* tree, const string& branchName, const void* address)
+	{
+		const TBranch* branch = tree->GetBranch(branchName.c_str());
+		return branch and branch->GetAddress() == (const char*)address;
+	}
+
+}
+
+
+const std::string rpwa::amplitudeMatrixMetadata::nmbEventsLeafName = "nmbEvents";
+const std::string rpwa::amplitudeMatrixMetadata::nmbAmplitudesLeafName = "nmbAmplitudes";
+const std::string rpwa::amplitudeMatrixMetadata::amplitudeRealLeafName = "ampReal";
+const std::string rpwa::amplitudeMatrixMetadata::amplitudeImagLeafName = "ampImag";
+const std::string rpwa::amplitudeMatrixMetadata::waveHashesLeafName = "waveHashes";
+const unsigned int rpwa::amplitudeMatrixMetadata::defaultChunkSize = 1024;
+
+rpwa::amplitudeMatrixMetadata::amplitudeMatrixMetadata()
+	: _contentHashes(),
+	  _eventMetadata(),
+	  _waveNames(),
+	  _keyfileContents(),
+	  _rootpwaGitHash(""),
+	  _objectBaseName(""),
+	  _chunkSize(0),
+	  _nmbEvents(0),
+	  _amplitudeTree(0),
+	  _nmbEventsInChunk(0),
+	  _nmbAmpsInChunk(0),
+	  _chunkReal(),
+	  _chunkImag(),
+	  _chunkWaveHashes(0),
+	  _bufferedChunk(-1) { }
+
+
+rpwa::amplitudeMatrixMetadata::~amplitudeMatrixMetadata() { }
+
+
+int rpwa::amplitudeMatrixMetadata::waveIndex(const string& waveName) const
+{
+	const vector<string>::const_iterator it = find(_waveNames.begin(), _waveNames.end(), waveName);
+	if(it == _waveNames.end()) {
+		return -1;
+	}
+	return it - _waveNames.begin();
+}
+
+
+bool rpwa::amplitudeMatrixMetadata::connectBranches() const
+{
+	if(not _amplitudeTree) {
+		printWarn << "input tree not found in metadata." << endl;
+		return false;
+	}
+	const size_t bufferSize = (size_t)_chunkSize * nmbWaves();
+	if(_chunkReal.size() != bufferSize) {
+		_chunkReal.resize(bufferSize);
+		_chunkImag.resize(bufferSize);
+		_bufferedChunk = -1;
+	}
+	// the branch addresses are set on the first read only, unless
+	// someone else changed them on the tree in between
+	if(branchAddressIs(_amplitudeTree, nmbEventsLeafName, &_nmbEventsInChunk)
+	   and branchAddressIs(_amplitudeTree, nmbAmplitudesLeafName, &_nmbAmpsInChunk)
+	   and branchAddressIs(_amplitudeTree, amplitudeRealLeafName, _chunkReal.data())
+	   and branchAddressIs(_amplitudeTree, amplitudeImagLeafName, _chunkImag.data())
+	   and branchAddressIs(_amplitudeTree, waveHashesLeafName, &_chunkWaveHashes))
+	{
+		return true;
+	}
+	_bufferedChunk = -1;
+	if(_amplitudeTree->SetBranchAddress(nmbEventsLeafName.c_str(), &_nmbEventsInChunk) < 0
+	   or _amplitudeTree->SetBranchAddress(nmbAmplitudesLeafName.c_str(), &_nmbAmpsInChunk) < 0
+	   or _amplitudeTree->SetBranchAddress(amplitudeRealLeafName.c_str(), _chunkReal.data()) < 0
+	   or _amplitudeTree->SetBranchAddress(amplitudeImagLeafName.c_str(), _chunkImag.data()) < 0
+	   or _amplitudeTree->SetBranchAddress(waveHashesLeafName.c_str(), &_chunkWaveHashes) < 0)
+	{
+		printWarn << "could not set addresses for branches of amplitude matrix tree." << endl;
+		return false;
+	}
+	return true;
+}
+
+
+bool rpwa::amplitudeMatrixMetadata::readChunk(const Long64_t chunk) const
+{
+	if(chunk == _bufferedChunk) {
+		return true;
+	}
+	if(_amplitudeTree->GetEntry(chunk) <= 0) {
+		printWarn << "could not read chunk " << chunk << " of amplitude matrix tree." << endl;
+		_bufferedChunk = -1;
+		return false;
+	}
+	if(_nmbAmpsInChunk != _nmbEventsInChunk * (Int_t)nmbWaves()) {
+		printWarn << "chunk " << chunk << " of amplitude matrix tree contains " << _nmbAmpsInChunk
+		          << " amplitudes for " << _nmbEventsInChunk << " events and " << nmbWaves() << " waves." << endl;
+		_bufferedChunk = -1;
+		return false;
+	}
+	_bufferedChunk = chunk;
+	return true;
+}
+
+
+bool rpwa::amplitudeMatrixMetadata::readAmplitudes(const long       firstEvent,
+                                                   const long       nmbEvts,
+                                                   complex<double>* amplitudes) const
+{
+	if(firstEvent < 0 or nmbEvts < 0 or firstEvent + nmbEvts > _nmbEvents) {
+		printWarn << "requested events [" << firstEvent << ", " << firstEvent + nmbEvts << ") "
+		          << "are out of range (" << _nmbEvents << " events)." << endl;
+		return false;
+	}
+	if(not connectBranches()) {
+		return false;
+	}
+	const size_t nmbWvs = nmbWaves();
+	long eventIndex = firstEvent;
+	const long endIndex = firstEvent + nmbEvts;
+	while(eventIndex < endIndex) {
+		const Long64_t chunk = eventIndex / _chunkSize;
+		if(not readChunk(chunk)) {
+			return false;
+		}
+		const long indexInChunk = eventIndex - chunk * _chunkSize;
+		const long nmbToCopy = min(endIndex - eventIndex, (long)_nmbEventsInChunk - indexInChunk);
+		if(nmbToCopy <= 0) {
+			printWarn << "event " << eventIndex << " not found in chunk " << chunk << "." << endl;
+			return false;
+		}
+		// the layout in the file is the same as the output layout
+		complex<double>* out = amplitudes + (eventIndex - firstEvent) * nmbWvs;
+		const size_t first = indexInChunk * nmbWvs;
+		const size_t nmbAmps = nmbToCopy * nmbWvs;
+		for(size_t i = 0; i < nmbAmps; ++i) {
+			out[i] = complex<double>(_chunkReal[first + i], _chunkImag[first + i]);
+		}
+		eventIndex += nmbToCopy;
+	}
+	return true;
+}
+
+
+bool rpwa::amplitudeMatrixMetadata::readAmplitudes(const vector<size_t>& indices,
+                                                   const size_t          indexOffset,
+                                                   complex<double>*      amplitudes) const
+{
+	if(not connectBranches()) {
+		return false;
+	}
+	const size_t nmbWvs = nmbWaves();
+	for(size_t i = 0; i < indices.size(); ++i) {
+		const long eventIndex = indexOffset + indices[i];
+		if(eventIndex >= _nmbEvents) {
+			printWarn << "requested event " << eventIndex << " is out of range (" << _nmbEvents << " events)." << endl;
+			return false;
+		}
+		const Long64_t chunk = eventIndex / _chunkSize;
+		if(not readChunk(chunk)) {
+			return false;
+		}
+		const long indexInChunk = eventIndex - chunk * _chunkSize;
+		if(indexInChunk >= _nmbEventsInChunk) {
+			printWarn << "event " << eventIndex << " not found in chunk " << chunk << "." << endl;
+			return false;
+		}
+		for(size_t iWave = 0; iWave < nmbWvs; ++iWave) {
+			amplitudes[i * nmbWvs + iWave] = complex<double>(_chunkReal[indexInChunk * nmbWvs + iWave],
+			                                                 _chunkImag[indexInChunk * nmbWvs + iWave]);
+		}
+	}
+	return true;
+}
+
+
+bool rpwa::amplitudeMatrixMetadata::checkHashes(const bool& printProgress) const
+{
+	if(not connectBranches()) {
+		return false;
+	}
+	const size_t nmbWvs = nmbWaves();
+	if(_contentHashes.size() != nmbWvs) {
+		printWarn << "number of content hashes (" << _contentHashes.size() << ") "
+		          << "does not match number of waves (" << nmbWvs << ")." << endl;
+		return false;
+	}
+	bool success = true;
+	vector<hashCalculator> waveHashors(nmbWvs);
+	boost::progress_display* progressIndicator = printProgress ? new boost::progress_display(_amplitudeTree->GetEntries(), cout, "") : 0;
+	for(Long64_t chunk = 0; chunk < _amplitudeTree->GetEntries(); ++chunk) {
+		if(not readChunk(chunk)) {
+			delete progressIndicator;
+			return false;
+		}
+		if(progressIndicator) {
+			++(*progressIndicator);
+		}
+		if(not _chunkWaveHashes or _chunkWaveHashes->size() != nmbWvs) {
+			printWarn << "chunk " << chunk << " does not contain a hash for each wave." << endl;
+			success = false;
+			continue;
+		}
+		for(size_t iWave = 0; iWave < nmbWvs; ++iWave) {
+			hashCalculator chunkHashor;
+			for(Int_t iEvent = 0; iEvent < _nmbEventsInChunk; ++iEvent) {
+				const complex<double> amp(_chunkReal[iEvent * nmbWvs + iWave], _chunkImag[iEvent * nmbWvs + iWave]);
+				chunkHashor.Update(amp);
+				waveHashors[iWave].Update(amp);
+			}
+			if(chunkHashor.hash() != (*_chunkWaveHashes)[iWave]) {
+				printWarn << "hash mismatch for wave '" << _waveNames[iWave] << "' in chunk " << chunk << "." << endl;
+				success = false;
+			}
+		}
+	}
+	delete progressIndicator;
+	for(size_t iWave = 0; iWave < nmbWvs; ++iWave) {
+		if(waveHashors[iWave].hash() != _contentHashes[iWave]) {
+			printWarn << "content hash mismatch for wave '" << _waveNames[iWave] << "'." << endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+
+ostream& rpwa::amplitudeMatrixMetadata::print(ostream& out) const
+{
+	out << "amplitudeMatrixMetadata:" << endl
+	    << "    object base name .... '" << _objectBaseName << "'"     << endl
+	    << "    rootpwa git hash .... '" << _rootpwaGitHash << "'"     << endl
+	    << "    events .............. "  << _nmbEvents                 << endl
+	    << "    events per chunk .... "  << _chunkSize                 << endl
+	    << "    waves ............... "  << nmbWaves()                 << endl;
+	for(unsigned int i = 0; i < _waveNames.size(); ++i) {
+		out << "        '" << _waveNames[i] << "'";
+		if(i < _contentHashes.size()) {
+			out << ", contentHash '" << _contentHashes[i] << "'";
+		}
+		out << endl;
+	}
+	out << endl;
+	out << "connected event metadata information:" << endl;
+	for(unsigned int i = 0; i < _eventMetadata.size(); ++i) {
+		out << _eventMetadata[i];
+		out << endl;
+	}
+	return out;
+}
+
+
+const amplitudeMatrixMetadata* rpwa::amplitudeMatrixMetadata::readAmplitudeMatrixFile(TFile* inputFile, const string& objectBaseName, const bool& quiet)
+{
+	const pair<string, string> objectNames = amplitudeMatrixMetadata::getObjectNames(objectBaseName);
+	amplitudeMatrixMetadata* amplitudeMatrixMeta = (amplitudeMatrixMetadata*)inputFile->Get(objectNames.second.c_str());
+	if(not amplitudeMatrixMeta) {
+		if(not quiet) {
+			printWarn << "could not find amplitude matrix metadata." << endl;
+		}
+		return 0;
+	}
+	amplitudeMatrixMeta->_amplitudeTree = (TTree*)inputFile->Get(objectNames.first.c_str());
+	if(not amplitudeMatrixMeta->_amplitudeTree) {
+		if(not quiet) {
+			printWarn << "could not find amplitude matrix tree." << endl;
+		}
+		return 0;
+	}
+	return amplitudeMatrixMeta;
+}
+
+
+pair<string, string> rpwa::amplitudeMatrixMetadata::getObjectNames(const string& objectBaseName)
+{
+	std::stringstream sstr;
+	sstr << objectBaseName << ".ampMatrix";
+	pair<string, string> retval = pair<string, string>();
+	retval.first = sstr.str();
+	sstr.str("");
+	sstr << objectBaseName << ".ampMatrixMeta";
+	retval.second = sstr.str();
+	return retval;
+}
+
+
+Int_t rpwa::amplitudeMatrixMetadata::Write(const char* name, Int_t option, Int_t bufsize) const
+{
+	Int_t retval = 0;
+	if(_amplitudeTree) {
+		retval = _amplitudeTree->Write();
+	}
+	return retval + TObject::Write(name, option, bufsize);
+}
@@ -0,0 +1,136 @@
+#ifndef AMPLITUDEMATRIXMETADATA_H
+#define AMPLITUDEMATRIXMETADATA_H
+
+#include <complex>
+
+#include <TObject.h>
+
+#include "eventMetadata.h"
+
+class TFile;
+class TTree;
+
+
+namespace rpwa {
+
+	// metadata of an amplitude matrix file, which holds the decay
+	// amplitudes of many waves for the same events
+	//
+	// the amplitudes are stored event-major in chunks of up to
+	// chunkSize() events: each tree entry holds the real and imaginary
+	// parts of the amplitudes of all waves for the events of this chunk
+	// (index = event in chunk * nmbWaves() + wave index) and one hash
+	// per wave over the amplitudes of this chunk, so that single waves
+	// can be verified. the content hash of each wave is the same as the
+	// one of the amplitude file of this wave.
+	class amplitudeMatrixMetadata : public TObject {
+		friend class amplitudeMatrixFileWriter;
+
+	  public:
+
+		~amplitudeMatrixMetadata();
+
+		const std::vector<std::string>& contentHashes() const { return _contentHashes; }
+		const std::vector<rpwa::eventMetadata>& eventMetadata() const { return _eventMetadata; }
+		const std::vector<std::string>& waveNames() const { return _waveNames; }
+		const std::vector<std::string>& keyfileContents() const { return _keyfileContents; }
+		const std::string& rootpwaGitHash() const { return _rootpwaGitHash; }
+		const std::string& objectBaseName() const { return _objectBaseName; }
+		unsigned int chunkSize() const { return _chunkSize; }
+
+		unsigned int nmbWaves() const { return _waveNames.size(); }
+		long nmbEvents() const { return _nmbEvents; }
+		int waveIndex(const std::string& waveName) const;  ///< returns -1 if the wave is not in this matrix
+
+		// fills amplitudes[event * nmbWaves() + wave] with the amplitudes
+		// of all waves for the nmbEvts events starting at firstEvent
+		bool readAmplitudes(const long            firstEvent,
+		                    const long            nmbEvts,
+		                    std::complex<double>* amplitudes) const;
+		// same for the events at indexOffset + indices[i]
+		bool readAmplitudes(const std::vector<std::size_t>& indices,
+		                    const std::size_t               indexOffset,
+		                    std::complex<double>*           amplitudes) const;
+
+		// recalculates the chunk hashes and the content hash of each
+		// wave and compares them with the stored ones
+		bool checkHashes(const bool& printProgress = false) const;
+
+		std::ostream& print(std::ostream& out) const;
+
+		static const amplitudeMatrixMetadata* readAmplitudeMatrixFile(TFile* inputFile,
+		                                                              const std::string& objectBaseName,
+		                                                              const bool& quiet = false);
+
+		TTree* amplitudeTree() const { return _amplitudeTree; } // changing this tree is not allowed (it should be const, but then you can't read it...)
+
+		Int_t Write(const char* name = 0, Int_t option = 0, Int_t bufsize = 0) { return ((const amplitudeMatrixMetadata*)this)->Write(name, option, bufsize); }
+		Int_t Write(const char* name = 0, Int_t option = 0, Int_t bufsize = 0) const;
+
+		static const std::string nmbEventsLeafName;
+		static const std::string nmbAmplitudesLeafName;
+		static const std::string amplitudeRealLeafName;
+		static const std::string amplitudeImagLeafName;
+		static const std::string waveHashesLeafName;
+		static const unsigned int defaultChunkSize;
+
+#if defined(__CINT__) || defined(__CLING__) || defined(G__DICTIONARY)
+	// root needs a public default constructor
+	  public:
+#else
+	  private:
+#endif
+
+		amplitudeMatrixMetadata();
+
+	  private:
+
+		void setContentHashes(const std::vector<std::string>& contentHashes) { _contentHashes = contentHashes; }
+		void setEventMetadata(const std::vector<rpwa::eventMetadata>& eventMetadata) { _eventMetadata = eventMetadata; }
+		void setWaveNames(const std::vector<std::string>& waveNames) { _waveNames = waveNames; }
+		void setKeyfileContents(const std::vector<std::string>& keyfileContents) { _keyfileContents = keyfileContents; }
+		void setRootpwaGitHash(const std::string& rootpwaGitHash) { _rootpwaGitHash = rootpwaGitHash; }
+		void setObjectBaseName(const std::string& objectBaseName) { _objectBaseName = objectBaseName; }
+		void setChunkSize(const unsigned int chunkSize) { _chunkSize = chunkSize; }
+
+		static std::pair<std::string, std::string> getObjectNames(const std::string& objectBaseName);
+		std::pair<std::string, std::string> getObjectNames() const { return amplitudeMatrixMetadata::getObjectNames(objectBaseName()); }
+
+		bool connectBranches() const;  // sets the branch addresses of the amplitude tree, unless they are already set to the read buffers
+		bool readChunk(const Long64_t chunk) const;
+
+		std::vector<std::string> _contentHashes;
+		std::vector<rpwa::eventMetadata> _eventMetadata;
+		std::vector<std::string> _waveNames;
+		std::vector<std::string> _keyfileContents;
+		std::string _rootpwaGitHash;
+		std::string _objectBaseName;
+		UInt_t _chunkSize;
+		Long64_t _nmbEvents;
+
+		mutable TTree* _amplitudeTree; //!
+
+		// read buffers, they hold the tree entry _bufferedChunk
+		mutable Int_t _nmbEventsInChunk; //!
+		mutable Int_t _nmbAmpsInChunk; //!
+		mutable std::vector<double> _chunkReal; //!
+		mutable std::vector<double> _chunkImag; //!
+		mutable std::vector<std::string>* _chunkWaveHashes; //!
+		mutable Long64_t _bufferedChunk; //!
+
+		ClassDef(amplitudeMatrixMetadata, 1);
+
+	}; // class amplitudeMatrixMetadata
+
+
+	inline
+	std::ostream&
+	operator <<(std::ostream&                  out,
+	            const amplitudeMatrixMetadata& metadata)
+	{
+		return metadata.print(out);
+	}
+
+} // namespace rpwa
+
+#endif
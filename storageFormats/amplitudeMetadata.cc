@@ -5,6 +5,7 @@
 
 #include <boost/progress.hpp>
 
+#include <TBranch.h>
 #include <TFile.h>
 #include <TTree.h>
 
@@ -15,7 +16,23 @@
 using namespace rpwa;
 using namespace std;
 
+
+namespace {
+
+	bool branchAddressIs(TTree* tree, const string& branchName, const void* address)
+	{
+		const TBranch* branch = tree->GetBranch(branchName.c_str());
+		return branch and branch->GetAddress() == (const char*)address;
+	}
+
+}
+
+
 const std::string rpwa::amplitudeMetadata::amplitudeLeafName = "amplitude";
+const std::string rpwa::amplitudeMetadata::nmbAmplitudesLeafName = "nmbAmplitudes";
+const std::string rpwa::amplitudeMetadata::amplitudeRealLeafName = "ampReal";
+const std::string rpwa::amplitudeMetadata::amplitudeImagLeafName = "ampImag";
+const unsigned int rpwa::amplitudeMetadata::defaultChunkSize = 8192;
 
 rpwa::amplitudeMetadata::amplitudeMetadata()
 	: _contentHash(""),
@@ -23,33 +40,203 @@ rpwa::amplitudeMetadata::amplitudeMetadata()
 	  _keyfileContent(""),
 	  _rootpwaGitHash(""),
 	  _objectBaseName(""),
-	  _amplitudeTree(0) { }
+	  _chunkSize(0),
+	  _nmbAmplitudes(0),
+	  _amplitudeTree(0),
+	  _ampTreeLeaf(0),
+	  _nmbAmpsInChunk(0),
+	  _chunkReal(),
+	  _chunkImag(),
+	  _bufferedChunk(-1) { }
 
 
 rpwa::amplitudeMetadata::~amplitudeMetadata() { }
 
 
-string rpwa::amplitudeMetadata::recalculateHash(const bool& printProgress) const
+long rpwa::amplitudeMetadata::nmbAmplitudes() const
+{
+	if(columnar()) {
+		return _nmbAmplitudes;
+	}
+	if(not _amplitudeTree) {
+		return 0;
+	}
+	return _amplitudeTree->GetEntries();
+}
+
+
+bool rpwa::amplitudeMetadata::connectBranches() const
 {
-	amplitudeTreeLeaf* ampTreeLeaf = 0;
-	hashCalculator hashor;
 	if(not _amplitudeTree) {
 		printWarn << "input tree not found in metadata." << endl;
-		return "";
+		return false;
+	}
+	// the branch addresses are set on the first read only, unless
+	// someone else changed them on the tree in between
+	if(not columnar()) {
+		if(branchAddressIs(_amplitudeTree, rpwa::amplitudeMetadata::amplitudeLeafName, &_ampTreeLeaf)) {
+			return true;
+		}
+		if(_amplitudeTree->SetBranchAddress(rpwa::amplitudeMetadata::amplitudeLeafName.c_str(), &_ampTreeLeaf) < 0) {
+			printWarn << "could not set address for branch '" << rpwa::amplitudeMetadata::amplitudeLeafName << "'." << endl;
+			return false;
+		}
+		return true;
 	}
-	if(_amplitudeTree->SetBranchAddress(rpwa::amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeaf) < 0)
+	if(_chunkReal.size() != _chunkSize) {
+		_chunkReal.resize(_chunkSize);
+		_chunkImag.resize(_chunkSize);
+		_bufferedChunk = -1;
+	}
+	if(branchAddressIs(_amplitudeTree, rpwa::amplitudeMetadata::nmbAmplitudesLeafName, &_nmbAmpsInChunk)
+	   and branchAddressIs(_amplitudeTree, rpwa::amplitudeMetadata::amplitudeRealLeafName, _chunkReal.data())
+	   and branchAddressIs(_amplitudeTree, rpwa::amplitudeMetadata::amplitudeImagLeafName, _chunkImag.data()))
+	{
+		return true;
+	}
+	_bufferedChunk = -1;
+	if(_amplitudeTree->SetBranchAddress(rpwa::amplitudeMetadata::nmbAmplitudesLeafName.c_str(), &_nmbAmpsInChunk) < 0
+	   or _amplitudeTree->SetBranchAddress(rpwa::amplitudeMetadata::amplitudeRealLeafName.c_str(), _chunkReal.data()) < 0
+	   or _amplitudeTree->SetBranchAddress(rpwa::amplitudeMetadata::amplitudeImagLeafName.c_str(), _chunkImag.data()) < 0)
 	{
-		printWarn << "could not set address for branch '" << rpwa::amplitudeMetadata::amplitudeLeafName << "'." << endl;
+		printWarn << "could not set addresses for branches of columnar amplitude tree." << endl;
+		return false;
+	}
+	return true;
+}
+
+
+bool rpwa::amplitudeMetadata::readAmplitude(const long amplitudeIndex, complex<double>& amplitude) const
+{
+	if(not columnar()) {
+		if(_amplitudeTree->GetEntry(amplitudeIndex) <= 0) {
+			printWarn << "could not read entry " << amplitudeIndex << " of amplitude tree." << endl;
+			return false;
+		}
+		if(_ampTreeLeaf->nmbIncohSubAmps() != 1) {
+			printWarn << "amplitude " << amplitudeIndex << " has " << _ampTreeLeaf->nmbIncohSubAmps()
+			          << " incoherent sub-amplitudes instead of one." << endl;
+			return false;
+		}
+		amplitude = _ampTreeLeaf->amp();
+		return true;
+	}
+	const Long64_t chunk = amplitudeIndex / _chunkSize;
+	if(chunk != _bufferedChunk) {
+		if(_amplitudeTree->GetEntry(chunk) <= 0) {
+			printWarn << "could not read chunk " << chunk << " of columnar amplitude tree." << endl;
+			_bufferedChunk = -1;
+			return false;
+		}
+		_bufferedChunk = chunk;
+	}
+	const long indexInChunk = amplitudeIndex - chunk * _chunkSize;
+	if(indexInChunk >= _nmbAmpsInChunk) {
+		printWarn << "amplitude " << amplitudeIndex << " not found in chunk " << chunk << "." << endl;
+		return false;
+	}
+	amplitude = complex<double>(_chunkReal[indexInChunk], _chunkImag[indexInChunk]);
+	return true;
+}
+
+
+bool rpwa::amplitudeMetadata::readAmplitudes(const long            firstAmplitude,
+                                             const long            nmbAmps,
+                                             complex<double>*      amplitudes) const
+{
+	if(firstAmplitude < 0 or nmbAmps < 0 or firstAmplitude + nmbAmps > nmbAmplitudes()) {
+		printWarn << "requested amplitudes [" << firstAmplitude << ", " << firstAmplitude + nmbAmps << ") "
+		          << "are out of range (" << nmbAmplitudes() << " amplitudes)." << endl;
+		return false;
+	}
+	if(not connectBranches()) {
+		return false;
+	}
+	if(not columnar()) {
+		for(long i = 0; i < nmbAmps; ++i) {
+			if(not readAmplitude(firstAmplitude + i, amplitudes[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+	// copy whole chunks at once
+	long amplitudeIndex = firstAmplitude;
+	const long endIndex = firstAmplitude + nmbAmps;
+	while(amplitudeIndex < endIndex) {
+		const Long64_t chunk = amplitudeIndex / _chunkSize;
+		if(chunk != _bufferedChunk) {
+			if(_amplitudeTree->GetEntry(chunk) <= 0) {
+				printWarn << "could not read chunk " << chunk << " of columnar amplitude tree." << endl;
+				_bufferedChunk = -1;
+				return false;
+			}
+			_bufferedChunk = chunk;
+		}
+		const long indexInChunk = amplitudeIndex - chunk * _chunkSize;
+		const long nmbToCopy = min(endIndex - amplitudeIndex, (long)_nmbAmpsInChunk - indexInChunk);
+		if(nmbToCopy <= 0) {
+			printWarn << "amplitude " << amplitudeIndex << " not found in chunk " << chunk << "." << endl;
+			return false;
+		}
+		complex<double>* out = amplitudes + (amplitudeIndex - firstAmplitude);
+		for(long i = 0; i < nmbToCopy; ++i) {
+			out[i] = complex<double>(_chunkReal[indexInChunk + i], _chunkImag[indexInChunk + i]);
+		}
+		amplitudeIndex += nmbToCopy;
+	}
+	return true;
+}
+
+
+bool rpwa::amplitudeMetadata::readAmplitudes(const vector<size_t>& indices,
+                                             const size_t          indexOffset,
+                                             complex<double>*      amplitudes) const
+{
+	if(not connectBranches()) {
+		return false;
+	}
+	const long nmbAmps = nmbAmplitudes();
+	for(size_t i = 0; i < indices.size(); ++i) {
+		const long amplitudeIndex = indexOffset + indices[i];
+		if(amplitudeIndex >= nmbAmps) {
+			printWarn << "requested amplitude " << amplitudeIndex << " is out of range (" << nmbAmps << " amplitudes)." << endl;
+			return false;
+		}
+		if(not readAmplitude(amplitudeIndex, amplitudes[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+string rpwa::amplitudeMetadata::recalculateHash(const bool& printProgress) const
+{
+	hashCalculator hashor;
+	if(not _amplitudeTree) {
+		printWarn << "input tree not found in metadata." << endl;
 		return "";
 	}
-	boost::progress_display* progressIndicator = printProgress ? new boost::progress_display(_amplitudeTree->GetEntries(), cout, "") : 0;
-	for(long eventNumber = 0; eventNumber < _amplitudeTree->GetEntries(); ++eventNumber) {
-		_amplitudeTree->GetEntry(eventNumber);
+	const long nmbAmps = nmbAmplitudes();
+	const long blockSize = columnar() ? _chunkSize : defaultChunkSize;
+	vector<complex<double> > amplitudes(blockSize);
+	boost::progress_display* progressIndicator = printProgress ? new boost::progress_display(nmbAmps, cout, "") : 0;
+	for(long firstAmplitude = 0; firstAmplitude < nmbAmps; firstAmplitude += blockSize) {
+		const long nmbInBlock = min(blockSize, nmbAmps - firstAmplitude);
+		if(not readAmplitudes(firstAmplitude, nmbInBlock, amplitudes.data())) {
+			printWarn << "could not read amplitudes." << endl;
+			delete progressIndicator;
+			return "";
+		}
+		for(long i = 0; i < nmbInBlock; ++i) {
+			hashor.Update(amplitudes[i]);
+		}
 		if(progressIndicator) {
-			++(*progressIndicator);
+			(*progressIndicator) += nmbInBlock;
 		}
-		hashor.Update(ampTreeLeaf->amp());
 	}
+	delete progressIndicator;
 	return hashor.hash();
 }
 
@@ -60,8 +247,11 @@ ostream& rpwa::amplitudeMetadata::print(ostream& out) const
 	    << "    contentHash ......... '" << _contentHash << "'"        << endl
 	    << "    object base name .... '" << _objectBaseName << "'"     << endl
 	    << "    rootpwa git hash .... '" << _rootpwaGitHash << "'"     << endl;
+	if(columnar()) {
+		out << "    storage format ...... columnar, " << _chunkSize << " amplitudes per chunk" << endl;
+	}
 	if(_amplitudeTree) {
-		out << "    amplitude entries ... "  << _amplitudeTree->GetEntries() << endl;
+		out << "    amplitude entries ... "  << nmbAmplitudes() << endl;
 	}
 	out << endl;
 	out << "connected event metadata information:" << endl;
@@ -2,6 +2,8 @@
 #ifndef AMPLITUDEMETADATA_H
 #define AMPLITUDEMETADATA_H
 
+#include <complex>
+
 #include <TObject.h>
 
 #include "eventMetadata.h"
@@ -12,6 +14,8 @@ class TTree;
 
 namespace rpwa {
 
+	class amplitudeTreeLeaf;
+
 	class amplitudeMetadata : public TObject {
 		friend class amplitudeFileWriter;
 
@@ -25,6 +29,25 @@ namespace rpwa {
 		const std::string& rootpwaGitHash() const { return _rootpwaGitHash; }
 		const std::string& objectBaseName() const { return _objectBaseName; }
 
+		// the amplitudes are either stored as one amplitudeTreeLeaf per
+		// tree entry, or in the columnar format, where each tree entry
+		// holds the real and imaginary parts of up to chunkSize()
+		// consecutive amplitudes as plain double arrays
+		bool columnar() const { return _chunkSize > 0; }
+		unsigned int chunkSize() const { return _chunkSize; }
+		long nmbAmplitudes() const;
+
+		// fills amplitudes with the nmbAmps amplitudes starting
+		// at firstAmplitude; independent of the storage format, but
+		// only works for amplitudes without incoherent sub-amplitudes
+		bool readAmplitudes(const long            firstAmplitude,
+		                    const long            nmbAmps,
+		                    std::complex<double>* amplitudes) const;
+		// fills amplitudes with the amplitudes at indexOffset + indices[i]
+		bool readAmplitudes(const std::vector<std::size_t>& indices,
+		                    const std::size_t               indexOffset,
+		                    std::complex<double>*           amplitudes) const;
+
 		std::string recalculateHash(const bool& printProgress = false) const;
 
 		std::ostream& print(std::ostream& out) const;
@@ -39,6 +62,10 @@ namespace rpwa {
 		Int_t Write(const char* name = 0, Int_t option = 0, Int_t bufsize = 0) const;
 
 		static const std::string amplitudeLeafName;
+		static const std::string nmbAmplitudesLeafName;
+		static const std::string amplitudeRealLeafName;
+		static const std::string amplitudeImagLeafName;
+		static const unsigned int defaultChunkSize;
 
 #if defined(__CINT__) || defined(__CLING__) || defined(G__DICTIONARY)
 	// root needs a public default constructor
@@ -56,6 +83,11 @@ namespace rpwa {
 		void setKeyfileContent(const std::string& keyfileContent) { _keyfileContent = keyfileContent; }
 		void setRootpwaGitHash(const std::string& rootpwaGitHash) { _rootpwaGitHash = rootpwaGitHash; }
 		void setObjectBaseName(const std::string& objectBaseName) { _objectBaseName = objectBaseName; }
+		void setChunkSize(const unsigned int chunkSize) { _chunkSize = chunkSize; }
+		void setNmbAmplitudes(const long nmbAmplitudes) { _nmbAmplitudes = nmbAmplitudes; }
+
+		bool readAmplitude(const long amplitudeIndex, std::complex<double>& amplitude) const;
+		bool connectBranches() const;  // sets the branch addresses of the amplitude tree, unless they are already set to the read buffers
 
 		static std::pair<std::string, std::string> getObjectNames(const std::string& objectBaseName);
 		std::pair<std::string, std::string> getObjectNames() const { return amplitudeMetadata::getObjectNames(objectBaseName()); }
@@ -65,10 +97,19 @@ namespace rpwa {
 		std::string _keyfileContent;
 		std::string _rootpwaGitHash;
 		std::string _objectBaseName;
+		UInt_t _chunkSize;
+		Long64_t _nmbAmplitudes;
 
 		mutable TTree* _amplitudeTree; //!
 
-		ClassDef(amplitudeMetadata, 1);
+		// read buffers, the chunk buffers hold the tree entry _bufferedChunk
+		mutable rpwa::amplitudeTreeLeaf* _ampTreeLeaf; //!
+		mutable Int_t _nmbAmpsInChunk; //!
+		mutable std::vector<double> _chunkReal; //!
+		mutable std::vector<double> _chunkImag; //!
+		mutable Long64_t _bufferedChunk; //!
+
+		ClassDef(amplitudeMetadata, 2);
 
 	}; // class amplitudeMetadata
 
@@ -0,0 +1,367 @@
+
+#include "eventBinIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+#include <unistd.h>
+
+#include <boost/progress.hpp>
+
+#include <TBranch.h>
+#include <TFile.h>
+#include <TTree.h>
+
+#include "eventMetadata.h"
+#include "fileUtils.hpp"
+#include "reportingUtils.hpp"
+
+using namespace rpwa;
+using namespace std;
+
+
+const std::string rpwa::eventBinIndex::objectNameInFile = "binIndex";
+
+
+namespace {
+
+	// indices that were read or created in this process, by content hash
+	// of the event file; indices that were replaced by an index with more
+	// variables are kept, because they might still be in use
+	mutex                             binIndexCacheMutex;
+	map<string, const eventBinIndex*> binIndexCache;
+	vector<const eventBinIndex*>      replacedBinIndices;
+
+
+	bool hasVariables(const eventBinIndex* binIndex, const vector<string>& variables)
+	{
+		if(not binIndex) {
+			return false;
+		}
+		for(size_t i = 0; i < variables.size(); ++i) {
+			if(not binIndex->hasVariable(variables[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	void restoreBranchAddresses(const vector<TBranch*>& branches, const vector<char*>& addresses)
+	{
+		for(size_t i = 0; i < branches.size(); ++i) {
+			if(not branches[i]) {
+				continue;
+			}
+			if(addresses[i]) {
+				branches[i]->SetAddress(addresses[i]);
+			} else {
+				branches[i]->ResetAddress();
+			}
+		}
+	}
+
+}
+
+
+rpwa::eventBinIndex::eventBinIndex()
+	: _contentHash(""),
+	  _nmbEvents(0),
+	  _variables(),
+	  _sortedValues(),
+	  _sortedEntries(),
+	  _nanEntries() { }
+
+
+rpwa::eventBinIndex::~eventBinIndex() { }
+
+
+bool rpwa::eventBinIndex::hasVariable(const string& variable) const
+{
+	return find(_variables.begin(), _variables.end(), variable) != _variables.end();
+}
+
+
+bool rpwa::eventBinIndex::entriesInBin(const map<string, pair<double, double> >& bin,
+                                       vector<size_t>&                           entries) const
+{
+	entries.clear();
+	// range [first, second) in the sorted arrays of each variable of the
+	// bin; the events with NaN value of the variable are always added
+	vector<pair<size_t, pair<size_t, size_t> > > ranges;
+	for(map<string, pair<double, double> >::const_iterator elem = bin.begin(); elem != bin.end(); ++elem) {
+		const size_t variableIndex = find(_variables.begin(), _variables.end(), elem->first) - _variables.begin();
+		if(variableIndex == _variables.size()) {
+			printWarn << "variable '" << elem->first << "' is not in the bin index." << endl;
+			return false;
+		}
+		const vector<double>& values = _sortedValues[variableIndex];
+		const size_t first = lower_bound(values.begin(), values.end(), elem->second.first) - values.begin();
+		const size_t last  = max(first, (size_t)(lower_bound(values.begin(), values.end(), elem->second.second) - values.begin()));
+		ranges.push_back(make_pair(variableIndex, make_pair(first, last)));
+	}
+	if(ranges.empty()) {
+		// a bin without variables contains all events
+		entries.resize(_nmbEvents);
+		for(size_t i = 0; i < entries.size(); ++i) {
+			entries[i] = i;
+		}
+		return true;
+	}
+
+	// start with the smallest range and intersect it with the others
+	size_t smallest = 0;
+	for(size_t i = 1; i < ranges.size(); ++i) {
+		if(ranges[i].second.second - ranges[i].second.first + _nanEntries[ranges[i].first].size()
+		   < ranges[smallest].second.second - ranges[smallest].second.first + _nanEntries[ranges[smallest].first].size()) {
+			smallest = i;
+		}
+	}
+	{
+		const vector<Long64_t>& sortedEntries = _sortedEntries[ranges[smallest].first];
+		const vector<Long64_t>& nanEntries    = _nanEntries   [ranges[smallest].first];
+		entries.assign(sortedEntries.begin() + ranges[smallest].second.first, sortedEntries.begin() + ranges[smallest].second.second);
+		entries.insert(entries.end(), nanEntries.begin(), nanEntries.end());
+		sort(entries.begin(), entries.end());
+	}
+	vector<size_t> rangeEntries;
+	vector<size_t> intersection;
+	for(size_t i = 0; i < ranges.size() and not entries.empty(); ++i) {
+		const size_t first = ranges[i].second.first;
+		const size_t last  = ranges[i].second.second;
+		if(i == smallest or (first == 0 and last == _sortedValues[ranges[i].first].size())) {
+			continue;
+		}
+		const vector<Long64_t>& sortedEntries = _sortedEntries[ranges[i].first];
+		const vector<Long64_t>& nanEntries    = _nanEntries   [ranges[i].first];
+		rangeEntries.assign(sortedEntries.begin() + first, sortedEntries.begin() + last);
+		rangeEntries.insert(rangeEntries.end(), nanEntries.begin(), nanEntries.end());
+		sort(rangeEntries.begin(), rangeEntries.end());
+		intersection.clear();
+		set_intersection(entries.begin(), entries.end(), rangeEntries.begin(), rangeEntries.end(), back_inserter(intersection));
+		entries.swap(intersection);
+	}
+	return true;
+}
+
+
+ostream& rpwa::eventBinIndex::print(ostream& out) const
+{
+	out << "eventBinIndex:" << endl
+	    << "    contentHash ......... '" << _contentHash << "'" << endl
+	    << "    number of events .... "  << _nmbEvents          << endl
+	    << "    variables:" << endl;
+	for(size_t i = 0; i < _variables.size(); ++i) {
+		out << "        '" << _variables[i] << "'";
+		if(not _sortedValues[i].empty()) {
+			out << " in [" << _sortedValues[i].front() << ", " << _sortedValues[i].back() << "]";
+		}
+		if(not _nanEntries[i].empty()) {
+			out << ", NaN for " << _nanEntries[i].size() << " events";
+		}
+		out << endl;
+	}
+	return out;
+}
+
+
+eventBinIndex* rpwa::eventBinIndex::create(const eventMetadata&  eventMeta,
+                                           const vector<string>& variables)
+{
+	TTree* eventTree = eventMeta.eventTree();
+	if(not eventTree) {
+		printWarn << "event tree not found in metadata." << endl;
+		return 0;
+	}
+	if(variables.empty()) {
+		printWarn << "no variables to index given." << endl;
+		return 0;
+	}
+	// only the baskets of the indexed variables are read; the branch
+	// statuses of the event tree are left untouched and the addresses of
+	// the branches are restored afterwards
+	vector<TBranch*> branches(variables.size(), 0);
+	vector<char*>    oldAddresses(variables.size(), 0);
+	for(size_t i = 0; i < variables.size(); ++i) {
+		branches[i] = eventTree->GetBranch(variables[i].c_str());
+		if(not branches[i]) {
+			printWarn << "could not find branch '" << variables[i] << "' in event tree." << endl;
+			return 0;
+		}
+		oldAddresses[i] = branches[i]->GetAddress();
+	}
+
+	const Long64_t nmbEvents = eventTree->GetEntries();
+	printInfo << "creating bin index of " << variables.size() << " variable(s) for " << nmbEvents << " events." << endl;
+	eventBinIndex* binIndex = new eventBinIndex();
+	binIndex->_contentHash = eventMeta.contentHash();
+	binIndex->_nmbEvents = nmbEvents;
+	binIndex->_variables = variables;
+	binIndex->_sortedValues.resize(variables.size());
+	binIndex->_sortedEntries.resize(variables.size());
+	binIndex->_nanEntries.resize(variables.size());
+	bool success = true;
+	boost::progress_display progressIndicator(nmbEvents * variables.size(), cout, "");
+	vector<pair<double, Long64_t> > valueEntries;
+	double value = 0;
+	for(size_t i = 0; success and i < variables.size(); ++i) {
+		branches[i]->SetAddress(&value);
+		valueEntries.clear();
+		valueEntries.reserve(nmbEvents);
+		for(Long64_t eventIndex = 0; eventIndex < nmbEvents; ++eventIndex) {
+			++progressIndicator;
+			if(branches[i]->GetEntry(eventIndex) <= 0) {
+				printWarn << "could not read variable '" << variables[i] << "' of event " << eventIndex << " from event tree." << endl;
+				success = false;
+				break;
+			}
+			if(std::isnan(value)) {
+				binIndex->_nanEntries[i].push_back(eventIndex);
+			} else {
+				valueEntries.push_back(make_pair(value, eventIndex));
+			}
+		}
+		sort(valueEntries.begin(), valueEntries.end());
+		binIndex->_sortedValues[i].resize(valueEntries.size());
+		binIndex->_sortedEntries[i].resize(valueEntries.size());
+		for(size_t j = 0; j < valueEntries.size(); ++j) {
+			binIndex->_sortedValues[i][j] = valueEntries[j].first;
+			binIndex->_sortedEntries[i][j] = valueEntries[j].second;
+		}
+	}
+	restoreBranchAddresses(branches, oldAddresses);
+	if(not success) {
+		delete binIndex;
+		return 0;
+	}
+	return binIndex;
+}
+
+
+const eventBinIndex* rpwa::eventBinIndex::getBinIndex(const eventMetadata&  eventMeta,
+                                                      const string&         indexDirectory,
+                                                      const vector<string>& variables)
+{
+	const string& contentHash = eventMeta.contentHash();
+	const eventBinIndex* binIndex = 0;
+	{
+		lock_guard<mutex> lock(binIndexCacheMutex);
+		map<string, const eventBinIndex*>::const_iterator cached = binIndexCache.find(contentHash);
+		if(cached != binIndexCache.end()) {
+			binIndex = cached->second;
+		} else {
+			const string fileName = binIndexFileName(indexDirectory, contentHash);
+			if(access(fileName.c_str(), R_OK) == 0) {
+				TFile* indexFile = TFile::Open(fileName.c_str(), "READ");
+				if(indexFile and not indexFile->IsZombie()) {
+					binIndex = readBinIndexFile(indexFile);
+				}
+				if(indexFile) {
+					indexFile->Close();
+					delete indexFile;
+				}
+				if(binIndex and binIndex->contentHash() != contentHash) {
+					printWarn << "bin index in file '" << fileName << "' belongs to a different event file. ignoring it." << endl;
+					delete binIndex;
+					binIndex = 0;
+				}
+			}
+			if(binIndex) {
+				binIndexCache[contentHash] = binIndex;
+			}
+		}
+	}
+	if(hasVariables(binIndex, variables)) {
+		return binIndex;
+	}
+
+	// index the requested variables and those that were already indexed;
+	// the event tree is scanned without holding the lock, so that other
+	// threads can use the indices of other event files in the meantime
+	set<string> variableSet(variables.begin(), variables.end());
+	if(binIndex) {
+		variableSet.insert(binIndex->variables().begin(), binIndex->variables().end());
+	}
+	eventBinIndex* newBinIndex = create(eventMeta, vector<string>(variableSet.begin(), variableSet.end()));
+	if(not newBinIndex) {
+		printWarn << "could not create bin index." << endl;
+		return 0;
+	}
+	{
+		lock_guard<mutex> lock(binIndexCacheMutex);
+		// another thread might have created an index of the same event file
+		// in the meantime
+		map<string, const eventBinIndex*>::iterator cached = binIndexCache.find(contentHash);
+		if(cached != binIndexCache.end()) {
+			if(hasVariables(cached->second, newBinIndex->variables())) {
+				delete newBinIndex;
+				return cached->second;
+			}
+			replacedBinIndices.push_back(cached->second);
+		}
+		binIndexCache[contentHash] = newBinIndex;
+	}
+	const string fileName = binIndexFileName(indexDirectory, contentHash);
+	if(not newBinIndex->writeToFile(fileName)) {
+		printWarn << "could not write bin index to file '" << fileName << "'. "
+		          << "the index is used only in this process." << endl;
+	}
+	return newBinIndex;
+}
+
+
+string rpwa::eventBinIndex::binIndexFileName(const string& indexDirectory,
+                                             const string& contentHash)
+{
+	stringstream sstr;
+	sstr << indexDirectory << "/" << contentHash << ".binIndex.root";
+	return sstr.str();
+}
+
+
+const eventBinIndex* rpwa::eventBinIndex::readBinIndexFile(TFile* inputFile, const bool& quiet)
+{
+	eventBinIndex* binIndex = (eventBinIndex*)inputFile->Get(objectNameInFile.c_str());
+	if(not binIndex) {
+		if(not quiet) {
+			printWarn << "could not find bin index." << endl;
+		}
+		return 0;
+	}
+	if(binIndex->_sortedValues.size() != binIndex->_variables.size()
+	   or binIndex->_sortedEntries.size() != binIndex->_variables.size()
+	   or binIndex->_nanEntries.size() != binIndex->_variables.size())
+	{
+		if(not quiet) {
+			printWarn << "bin index is inconsistent." << endl;
+		}
+		delete binIndex;
+		return 0;
+	}
+	return binIndex;
+}
+
+
+bool rpwa::eventBinIndex::writeToFile(const string& fileName) const
+{
+	// other processes must never see a partially written index
+	const string tmpName = temporaryFileName(fileName);
+	TFile* outputFile = TFile::Open(tmpName.c_str(), "RECREATE");
+	if(not outputFile or outputFile->IsZombie()) {
+		printWarn << "could not open '" << tmpName << "' for writing." << endl;
+		delete outputFile;
+		return false;
+	}
+	const bool success = (Write(objectNameInFile.c_str()) > 0);
+	outputFile->Close();
+	delete outputFile;
+	if(not success or rename(tmpName.c_str(), fileName.c_str()) != 0) {
+		remove(tmpName.c_str());
+		return false;
+	}
+	return true;
+}
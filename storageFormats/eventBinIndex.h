@@ -0,0 +1,110 @@
+#ifndef EVENTBININDEX_H
+#define EVENTBININDEX_H
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <TObject.h>
+
+class TFile;
+
+
+namespace rpwa {
+
+	class eventMetadata;
+
+	// sorted index over the binning variables of an event file
+	//
+	// for each indexed variable the values of all events are stored in
+	// ascending order together with the entry numbers of the events, so
+	// that the events in any hyper-rectangular bin are found by binary
+	// searches instead of a scan over the event tree. the index is
+	// identified by the content hash of the event file and is stored in
+	// a separate file, which is created the first time the index of an
+	// event file is requested.
+	//
+	// events with a NaN value of a variable are in every bin with respect
+	// to this variable, which is what the bin selection by a scan over
+	// the event tree does, because comparisons with NaN are false.
+	class eventBinIndex : public TObject {
+
+	  public:
+
+		~eventBinIndex();
+
+		const std::string& contentHash() const { return _contentHash; }
+		Long64_t nmbEvents() const { return _nmbEvents; }
+		const std::vector<std::string>& variables() const { return _variables; }
+		bool hasVariable(const std::string& variable) const;
+
+		// fills entries with the ascending entry numbers of all events
+		// with lower bound <= value < upper bound for each variable of the
+		// bin; an empty bin contains all events
+		bool entriesInBin(const std::map<std::string, std::pair<double, double> >& bin,
+		                  std::vector<std::size_t>&                                entries) const;
+
+		std::ostream& print(std::ostream& out) const;
+
+		// builds the index of the given variables with a single scan over
+		// the event tree; only the branches of the variables are read and
+		// their addresses are restored afterwards; the caller takes
+		// ownership
+		static eventBinIndex* create(const rpwa::eventMetadata&      eventMeta,
+		                             const std::vector<std::string>& variables);
+
+		// returns the index of the event file, which contains at least the
+		// given variables. the index is read from the index file in
+		// indexDirectory or created and written to it if it does not exist
+		// or lacks a variable; a new index contains the given variables and
+		// those of the previous index. indices are kept in memory for the
+		// lifetime of the process, so the returned index must not be
+		// deleted.
+		static const eventBinIndex* getBinIndex(const rpwa::eventMetadata&      eventMeta,
+		                                        const std::string&              indexDirectory,
+		                                        const std::vector<std::string>& variables);
+
+		static std::string binIndexFileName(const std::string& indexDirectory,
+		                                    const std::string& contentHash);
+		static const eventBinIndex* readBinIndexFile(TFile* inputFile, const bool& quiet = false);
+		bool writeToFile(const std::string& fileName) const;
+
+		static const std::string objectNameInFile;
+
+#if defined(__CINT__) || defined(__CLING__) || defined(G__DICTIONARY)
+	// root needs a public default constructor
+	  public:
+#else
+	  private:
+#endif
+
+		eventBinIndex();
+
+	  private:
+
+		std::string _contentHash;
+		Long64_t _nmbEvents;
+		std::vector<std::string> _variables;
+		std::vector<std::vector<double> > _sortedValues;     // [variable index][i] values in ascending order
+		std::vector<std::vector<Long64_t> > _sortedEntries;  // [variable index][i] entry number of the event with value _sortedValues[variable index][i]
+		std::vector<std::vector<Long64_t> > _nanEntries;     // [variable index][i] ascending entry numbers of the events with NaN value
+
+		ClassDef(eventBinIndex, 1);
+
+	}; // class eventBinIndex
+
+
+	inline
+	std::ostream&
+	operator <<(std::ostream&        out,
+	            const eventBinIndex& binIndex)
+	{
+		return binIndex.print(out);
+	}
+
+} // namespace rpwa
+
+#endif
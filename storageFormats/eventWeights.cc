@@ -0,0 +1,213 @@
+
+#include "eventWeights.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <TBranch.h>
+#include <TTree.h>
+
+#include "eventMetadata.h"
+#include "fileUtils.hpp"
+#include "reportingUtils.hpp"
+
+using namespace rpwa;
+using namespace std;
+
+
+namespace {
+
+	// layout of the beginning of the header, the rest of the header is
+	// padding up to weightFileHeaderSize
+	struct weightFileHeader {
+		char     magic[8];
+		uint32_t version;
+		uint32_t weightSize;
+		int64_t  nmbEvents;
+		char     contentHash[33];
+	};
+
+	const char     weightFileMagic[8]   = {'R', 'P', 'W', 'A', 'W', 'G', 'H', 'T'};
+	const uint32_t weightFileVersion    = 1;
+	const size_t   weightFileHeaderSize = 64;
+
+}
+
+
+const string rpwa::eventWeights::weightVariableLabel = "weight";
+
+
+eventWeights::sourceTypeEnum rpwa::eventWeights::sourceType(const string&        weightSource,
+                                                            const eventMetadata& eventMeta)
+{
+	const vector<string>& labels = eventMeta.additionalSavedVariableLables();
+	if(find(labels.begin(), labels.end(), weightSource) != labels.end()) {
+		return COLUMN;
+	}
+	FILE* weightFile = fopen(weightSource.c_str(), "rb");
+	if(weightFile) {
+		char magic[sizeof(weightFileMagic)];
+		const bool isBinary = (fread(magic, 1, sizeof(magic), weightFile) == sizeof(magic)
+		                       and memcmp(magic, weightFileMagic, sizeof(weightFileMagic)) == 0);
+		fclose(weightFile);
+		if(isBinary) {
+			return BINARY_FILE;
+		}
+	}
+	return TEXT_FILE;
+}
+
+
+bool rpwa::eventWeights::readWeights(const string&        weightSource,
+                                     const eventMetadata& eventMeta,
+                                     vector<double>&      weights)
+{
+	weights.clear();
+	switch(sourceType(weightSource, eventMeta)) {
+		case COLUMN:
+			return readColumn(weightSource, eventMeta, weights);
+		case BINARY_FILE:
+			return readBinaryFile(weightSource, eventMeta, weights);
+		case TEXT_FILE:
+			printWarn << "reading weights from text file '" << weightSource << "'. "
+			          << "consider storing the weights in the event file or in a binary weight file." << endl;
+			return readTextFile(weightSource, weights);
+	}
+	return false;
+}
+
+
+bool rpwa::eventWeights::writeWeightFile(const string&         fileName,
+                                         const string&         eventContentHash,
+                                         const vector<double>& weights)
+{
+	const string tmpName = temporaryFileName(fileName);
+	FILE* outFile = fopen(tmpName.c_str(), "wb");
+	if(not outFile) {
+		printErr << "could not open '" << tmpName << "' for writing: " << strerror(errno) << endl;
+		return false;
+	}
+
+	vector<char> headerBuffer(weightFileHeaderSize, 0);
+	weightFileHeader* header = (weightFileHeader*)headerBuffer.data();
+	memcpy(header->magic, weightFileMagic, sizeof(weightFileMagic));
+	header->version    = weightFileVersion;
+	header->weightSize = sizeof(double);
+	header->nmbEvents  = weights.size();
+	strncpy(header->contentHash, eventContentHash.c_str(), sizeof(header->contentHash) - 1);
+	bool success = (fwrite(headerBuffer.data(), 1, weightFileHeaderSize, outFile) == weightFileHeaderSize);
+	if(success and not weights.empty()) {
+		success = (fwrite(weights.data(), sizeof(double), weights.size(), outFile) == weights.size());
+	}
+	if(fclose(outFile) != 0) {
+		success = false;
+	}
+	if(not success) {
+		printErr << "could not write weight file '" << tmpName << "'." << endl;
+		remove(tmpName.c_str());
+		return false;
+	}
+	if(rename(tmpName.c_str(), fileName.c_str()) != 0) {
+		printErr << "could not rename '" << tmpName << "' to '" << fileName << "': " << strerror(errno) << endl;
+		remove(tmpName.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+bool rpwa::eventWeights::readColumn(const string&        label,
+                                    const eventMetadata& eventMeta,
+                                    vector<double>&      weights)
+{
+	TTree* eventTree = eventMeta.eventTree();
+	if(not eventTree) {
+		printErr << "event tree not found in metadata. cannot read weights from column '" << label << "'." << endl;
+		return false;
+	}
+	TBranch* branch = eventTree->GetBranch(label.c_str());
+	if(not branch) {
+		printErr << "could not find branch '" << label << "' in event tree." << endl;
+		return false;
+	}
+	// only the baskets of the weight branch are read; the addresses of
+	// the other branches are left untouched
+	const Long64_t nmbEvents = eventTree->GetEntries();
+	weights.resize(nmbEvents);
+	double weight = 0;
+	branch->SetAddress(&weight);
+	for(Long64_t iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		if(branch->GetEntry(iEvent) <= 0) {
+			printErr << "could not read weight of event " << iEvent << " from branch '" << label << "'." << endl;
+			branch->ResetAddress();
+			weights.clear();
+			return false;
+		}
+		weights[iEvent] = weight;
+	}
+	branch->ResetAddress();
+	return true;
+}
+
+
+bool rpwa::eventWeights::readBinaryFile(const string&        fileName,
+                                        const eventMetadata& eventMeta,
+                                        vector<double>&      weights)
+{
+	FILE* inFile = fopen(fileName.c_str(), "rb");
+	if(not inFile) {
+		printErr << "could not open weight file '" << fileName << "': " << strerror(errno) << endl;
+		return false;
+	}
+	vector<char> headerBuffer(weightFileHeaderSize, 0);
+	const weightFileHeader* header = (const weightFileHeader*)headerBuffer.data();
+	string errorMessage = "";
+	if(fread(headerBuffer.data(), 1, weightFileHeaderSize, inFile) != weightFileHeaderSize
+	   or memcmp(header->magic, weightFileMagic, sizeof(weightFileMagic)) != 0)
+	{
+		errorMessage = "is not a weight file";
+	} else if(header->version != weightFileVersion or header->weightSize != sizeof(double)) {
+		errorMessage = "has an unsupported format";
+	} else if(string(header->contentHash, strnlen(header->contentHash, sizeof(header->contentHash))) != eventMeta.contentHash()) {
+		errorMessage = "belongs to a different event file";
+	} else if(eventMeta.eventTree() and header->nmbEvents != eventMeta.eventTree()->GetEntries()) {
+		errorMessage = "contains the wrong number of weights";
+	} else {
+		weights.resize(header->nmbEvents);
+		if(header->nmbEvents > 0 and fread(weights.data(), sizeof(double), weights.size(), inFile) != weights.size()) {
+			errorMessage = "is truncated";
+		}
+	}
+	fclose(inFile);
+	if(errorMessage != "") {
+		printErr << "weight file '" << fileName << "' " << errorMessage << "." << endl;
+		weights.clear();
+		return false;
+	}
+	return true;
+}
+
+
+bool rpwa::eventWeights::readTextFile(const string&   fileName,
+                                      vector<double>& weights)
+{
+	ifstream weightFile(fileName.c_str());
+	if(not weightFile) {
+		printErr << "could not open weight file '" << fileName << "'." << endl;
+		return false;
+	}
+	double weight;
+	while(weightFile >> weight) {
+		weights.push_back(weight);
+	}
+	if(not weightFile.eof()) {
+		printErr << "error reading weight file '" << fileName << "' after " << weights.size() << " weights." << endl;
+		weights.clear();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,76 @@
+#ifndef EVENTWEIGHTS_H
+#define EVENTWEIGHTS_H
+
+#include <string>
+#include <vector>
+
+
+namespace rpwa {
+
+	class eventMetadata;
+
+	// bulk access to the importance sampling weights of the events of an
+	// event file
+	//
+	// the weights are taken from one of three sources:
+	//   - a column of the event file, i.e. an additional variable
+	//     written by eventFileWriter (by convention labeled
+	//     weightVariableLabel); the source is given by its label
+	//   - a binary weight file, which consists of a small header with the
+	//     number of events and the content hash of the event file
+	//     followed by the weights as plain doubles; the weight file is
+	//     only accepted for the event file it was written for
+	//   - a text file with one weight per line (deprecated)
+	// all weights are read at once into a vector indexed by the event
+	// number, except for text files, which contain the weights in the
+	// order in which the consumer visits the events.
+	class eventWeights {
+
+	  public:
+
+		enum sourceTypeEnum {
+			COLUMN,
+			BINARY_FILE,
+			TEXT_FILE
+		};
+
+		static sourceTypeEnum sourceType(const std::string&         weightSource,
+		                                 const rpwa::eventMetadata& eventMeta);
+
+		// reads all weights of weightSource; for COLUMN the event tree of
+		// eventMeta has to be available, for BINARY_FILE the content hash
+		// of the weight file has to match the one of eventMeta
+		static bool readWeights(const std::string&         weightSource,
+		                        const rpwa::eventMetadata& eventMeta,
+		                        std::vector<double>&       weights);
+
+		// reads all weights of a text file, which needs no event file
+		static bool readTextFile(const std::string&   fileName,
+		                         std::vector<double>& weights);
+
+		// writes a binary weight file for the event file with the given
+		// content hash; the file is written under a temporary name first
+		// and then renamed
+		static bool writeWeightFile(const std::string&         fileName,
+		                            const std::string&         eventContentHash,
+		                            const std::vector<double>& weights);
+
+		static const std::string weightVariableLabel;
+
+	  private:
+
+		static bool readColumn    (const std::string&         label,
+		                           const rpwa::eventMetadata& eventMeta,
+		                           std::vector<double>&       weights);
+		static bool readBinaryFile(const std::string&         fileName,
+		                           const rpwa::eventMetadata& eventMeta,
+		                           std::vector<double>&       weights);
+
+		eventWeights();
+
+	};
+
+}
+
+
+#endif
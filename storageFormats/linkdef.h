@@ -41,10 +41,14 @@
 
 #pragma link C++ class rpwa::eventMetadata+;
 #pragma link C++ class rpwa::amplitudeMetadata+;
+#pragma link C++ class rpwa::amplitudeMatrixMetadata+;
+#pragma link C++ class rpwa::eventBinIndex+;
 
 
 #pragma link C++ class std::vector<std::complex<double> >+;
 #pragma link C++ class std::vector<std::string>+;
+#pragma link C++ class std::vector<std::vector<double> >+;
+#pragma link C++ class std::vector<std::vector<Long64_t> >+;
 #pragma link C++ class rpwa::amplitudeTreeLeaf+;
 #pragma read sourceClass="rpwa::amplitudeTreeLeaf" version="[1-]" \
 	targetClass="rpwa::amplitudeTreeLeaf" \
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      compares the amplitudes calculated for blocks of events by
+//      isobarAmplitude::amplitude(const kinematicsBlock&, ...) and by
+//      clones of the amplitude to the ones calculated event by event;
+//      amplitude files are identified by the content hash of their
+//      values, so the amplitudes and their hashes have to be identical
+//      bit by bit
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <cstring>
+#include <sstream>
+
+#include "TClonesArray.h"
+#include "TObjString.h"
+#include "TRandom3.h"
+#include "TVector3.h"
+
+#include "reportingUtils.hpp"
+#include "reportingUtilsEnvironment.h"
+#include "particleDataTable.h"
+#include "diffractiveDissVertex.h"
+#include "massDependence.h"
+#include "isobarHelicityAmplitude.h"
+#include "isobarCanonicalAmplitude.h"
+#include "kinematicsBlock.h"
+#include "hashCalculator.h"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+// pi- p -> X- p with X- -> pi- f1(1285), f1(1285) -> pi- a1(1260)+,
+// a1(1260)+ -> pi+ sigma, sigma -> pi- pi+; has Bose symmetrization
+// terms and isobars with spin
+isobarDecayTopologyPtr
+createTestTopology()
+{
+	particlePtr pi0   = createParticle("pi-", 0);
+	particlePtr pi1   = createParticle("pi+", 0);
+	particlePtr pi2   = createParticle("pi-", 1);
+	particlePtr pi3   = createParticle("pi+", 1);
+	particlePtr pi4   = createParticle("pi-", 2);
+	particlePtr sigma = createParticle("sigma");
+	particlePtr a1    = createParticle("a1(1260)+");
+	particlePtr f1    = createParticle("f1(1285)");
+	//                                   2I  G  2J  P  C  2M  refl
+	particlePtr X = createParticle("X-", 2, -1, 4, +1, 0, 2, +1);
+	particlePtr              beam     = createParticle("pi-");
+	particlePtr              target   = createParticle("p+");
+	diffractiveDissVertexPtr prodVert = createDiffractiveDissVertex(beam, target, X);
+	vector<isobarDecayVertexPtr> decayVertices;
+	decayVertices.push_back(createIsobarDecayVertex(X,     pi4, f1,    2, 2));
+	decayVertices.push_back(createIsobarDecayVertex(f1,    pi2, a1,    2, 2, createRelativisticBreitWigner()));
+	decayVertices.push_back(createIsobarDecayVertex(a1,    pi3, sigma, 2, 0, createRelativisticBreitWigner()));
+	decayVertices.push_back(createIsobarDecayVertex(sigma, pi0, pi1,   0, 0, createPiPiSWaveAuMorganPenningtonM()));
+	vector<particlePtr> fsParticles;
+	fsParticles.push_back(pi0);
+	fsParticles.push_back(pi1);
+	fsParticles.push_back(pi2);
+	fsParticles.push_back(pi3);
+	fsParticles.push_back(pi4);
+	return createIsobarDecayTopology(prodVert, decayVertices, fsParticles);
+}
+
+
+bool
+compareAmplitudes(const string&                   label,
+                  const vector<complex<double> >& eventAmps,
+                  const vector<complex<double> >& blockAmps)
+{
+	hashCalculator eventHasher;
+	hashCalculator blockHasher;
+	unsigned int   nmbDifferent = 0;
+	for (unsigned int i = 0; i < eventAmps.size(); ++i) {
+		eventHasher.Update(eventAmps[i]);
+		blockHasher.Update(blockAmps[i]);
+		if (memcmp(&eventAmps[i], &blockAmps[i], sizeof(complex<double>)) != 0) {
+			if (nmbDifferent < 5)
+				printErr << label << ": amplitude of event " << i << " differs: "
+				         << maxPrecisionDouble(eventAmps[i]) << " (event by event) vs. "
+				         << maxPrecisionDouble(blockAmps[i]) << " (block)" << endl;
+			++nmbDifferent;
+		}
+	}
+	const string eventHash = eventHasher.hash();
+	const string blockHash = blockHasher.hash();
+	if (nmbDifferent > 0 or eventHash != blockHash) {
+		printErr << label << ": " << nmbDifferent << " of " << eventAmps.size() << " amplitudes differ; "
+		         << "hash " << eventHash << " (event by event) vs. " << blockHash << " (block)" << endl;
+		return false;
+	}
+	printSucc << label << ": " << eventAmps.size() << " amplitudes and their hash " << eventHash << " are identical" << endl;
+	return true;
+}
+
+
+int
+main()
+{
+	printCompilerInfo();
+	printGitHash();
+
+	particleDataTable::instance().readFile();
+
+	// the number of events is not a multiple of the block capacity, so
+	// that the last block is only partially filled
+	const unsigned int nmbEvents     = 1000;
+	const unsigned int blockCapacity = 256;
+	TRandom3 random(123456789);
+
+	TClonesArray prodKinNames   ("TObjString", 1);
+	TClonesArray decayKinNames  ("TObjString", 5);
+	const char*  decayKinLabels[5] = {"pi-", "pi+", "pi-", "pi+", "pi-"};
+	new (prodKinNames[0]) TObjString("pi-");
+	for (unsigned int i = 0; i < 5; ++i)
+		new (decayKinNames[i]) TObjString(decayKinLabels[i]);
+
+	// random momenta of beam and final-state particles; the amplitudes
+	// do not have to be physical to be compared
+	vector<kinematicsBlockPtr> blocks;
+	TClonesArray               prodKinMomenta ("TVector3", 1);
+	TClonesArray               decayKinMomenta("TVector3", 5);
+	for (unsigned int iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		new (prodKinMomenta[0]) TVector3(random.Gaus(0, 0.1), random.Gaus(0, 0.1), 190);
+		for (unsigned int i = 0; i < 5; ++i)
+			new (decayKinMomenta[i]) TVector3(random.Gaus(0, 0.3), random.Gaus(0, 0.3), random.Uniform(2, 60));
+		if (blocks.empty() or blocks.back()->full())
+			blocks.push_back(createKinematicsBlock(blockCapacity));
+		blocks.back()->addEvent(prodKinMomenta, decayKinMomenta);
+	}
+
+	bool success = true;
+	for (unsigned int iFormalism = 0; iFormalism < 2; ++iFormalism)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iProgram = 0; iProgram < 2; ++iProgram) {
+				const isobarDecayTopologyPtr topo = createTestTopology();
+				if (not topo->checkTopology() or not topo->checkConsistency()) {
+					printErr << "test decay topology is inconsistent. Aborting..." << endl;
+					return 1;
+				}
+				const isobarAmplitudePtr amp = (iFormalism == 0) ? isobarAmplitudePtr(createIsobarHelicityAmplitude (topo))
+				                                                 : isobarAmplitudePtr(createIsobarCanonicalAmplitude(topo));
+				amp->enableReflectivityBasis(iRefl == 1);
+				amp->enableCompiledProgram  (iProgram == 1);
+				amp->init();
+				if (not topo->initKinematicsData(prodKinNames, decayKinNames)) {
+					printErr << "problems initializing kinematics data. Aborting..." << endl;
+					return 1;
+				}
+				const isobarAmplitudePtr ampClone = amp->clone();
+				stringstream label;
+				label << ((iFormalism == 0) ? "helicity" : "canonical") << " formalism, "
+				      << ((iRefl    == 1) ? "with" : "without") << " reflectivity basis, "
+				      << ((iProgram == 1) ? "with" : "without") << " compiled program";
+
+				// event by event
+				vector<complex<double> > eventAmps;
+				for (unsigned int iBlock = 0; iBlock < blocks.size(); ++iBlock)
+					for (unsigned int i = 0; i < blocks[iBlock]->nmbEvents(); ++i) {
+						if (not topo->readKinematicsData(blocks[iBlock]->prodKinMomenta(i), blocks[iBlock]->decayKinMomenta(i))) {
+							printErr << "problems reading event. Aborting..." << endl;
+							return 1;
+						}
+						eventAmps.push_back(amp->amplitude());
+					}
+
+				// in blocks by the amplitude and by its clone
+				vector<complex<double> > blockAmps     (nmbEvents);
+				vector<complex<double> > cloneBlockAmps(nmbEvents);
+				for (unsigned int iBlock = 0; iBlock < blocks.size(); ++iBlock)
+					if (   not amp->amplitude     (*blocks[iBlock], &blockAmps     [iBlock * blockCapacity])
+					    or not ampClone->amplitude(*blocks[iBlock], &cloneBlockAmps[iBlock * blockCapacity])) {
+						printErr << "problems calculating amplitudes of block " << iBlock << ". Aborting..." << endl;
+						return 1;
+					}
+
+				success &= compareAmplitudes(label.str(),              eventAmps, blockAmps     );
+				success &= compareAmplitudes(label.str() + ", clone", eventAmps, cloneBlockAmps);
+			}
+
+	if (not success) {
+		printErr << "block amplitudes differ from the amplitudes calculated event by event." << endl;
+		return 1;
+	}
+	printSucc << "block amplitudes are identical to the amplitudes calculated event by event." << endl;
+	return 0;
+}
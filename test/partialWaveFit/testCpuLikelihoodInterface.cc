@@ -0,0 +1,284 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2016
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      compares log likelihood and its derivatives calculated by the
+//      CPU likelihood interface to a straightforward calculation (and
+//      to the CUDA likelihood interface, if available)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#include "boost/multi_array.hpp"
+
+#include "TRandom3.h"
+
+#include "reportingUtils.hpp"
+#include "sumAccumulators.hpp"
+
+#include "cpuLikelihoodInterface.h"
+#ifdef USE_CUDA
+#include "complex.cuh"
+#include "likelihoodInterface.cuh"
+#endif
+
+
+using namespace std;
+using namespace boost;
+using namespace boost::accumulators;
+using namespace rpwa;
+
+
+template<typename complexT>
+void
+generateData(const unsigned int             nmbEvents,
+             const unsigned int             rank,
+             const unsigned int             nmbWavesRefl[2],
+             multi_array<complexT, 3>&      decayAmps,
+             multi_array<complexT, 3>&      prodAmps,
+             typename complexT::value_type& prodAmpFlat,
+             const unsigned int             seed = 123456789)
+{
+	TRandom3 random(seed);
+	const unsigned int nmbWavesMax = max(nmbWavesRefl[0], nmbWavesRefl[1]);
+
+	// set decay amplitudes; [iEvt][iRefl][iWave]
+	decayAmps.resize(extents[nmbEvents][2][nmbWavesMax]);
+	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+		for (unsigned int iWave = 0; iWave < nmbWavesRefl[iRefl]; ++iWave)
+			for (unsigned int iEvt = 0; iEvt < nmbEvents; ++iEvt)
+				decayAmps[iEvt][iRefl][iWave] = complexT(random.Uniform(0, 1), random.Uniform(0, 1));
+
+	// set production amplitudes; [iRank][iRefl][iWave]
+	prodAmps.resize(extents[rank][2][nmbWavesMax]);
+	for (unsigned int iRank = 0; iRank < rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < nmbWavesRefl[iRefl]; ++iWave)
+				prodAmps[iRank][iRefl][iWave] = complexT(random.Uniform(0, 1), random.Uniform(0, 1));
+	prodAmpFlat = random.Uniform(0, 1);
+}
+
+
+// straightforward calculation of log likelihood and its derivatives
+template<typename complexT>
+typename complexT::value_type
+logLikelihoodDerivMultiArray(const multi_array<complexT, 3>&      decayAmps,
+                             const multi_array<complexT, 3>&      prodAmps,
+                             const typename complexT::value_type& prodAmpFlat,
+                             const unsigned int                   nmbEvents,
+                             const unsigned int                   rank,
+                             const unsigned int                   nmbWavesRefl[2],
+                             multi_array<complexT, 3>&            derivatives,
+                             typename complexT::value_type&       derivativeFlat)
+{
+	typedef typename complexT::value_type T;
+	const unsigned int nmbWavesMax  = max(nmbWavesRefl[0], nmbWavesRefl[1]);
+	const T            prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	derivatives.resize(extents[rank][2][nmbWavesMax]);
+	fill(derivatives.data(), derivatives.data() + derivatives.num_elements(), complexT(0));
+
+	accumulator_set<T, stats<tag::sum(compensated)> > logLikelihoodAcc;
+	accumulator_set<T, stats<tag::sum(compensated)> > derivativeFlatAcc;
+	multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3> derivativesAcc(extents[rank][2][nmbWavesMax]);
+	multi_array<complexT, 2> ampProdSums(extents[rank][2]);
+	for (unsigned int iEvt = 0; iEvt < nmbEvents; ++iEvt) {
+		T likelihood = prodAmpFlat2;
+		for (unsigned int iRank = 0; iRank < rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+				complexT ampProdSum = 0;
+				for (unsigned int iWave = 0; iWave < nmbWavesRefl[iRefl]; ++iWave)
+					ampProdSum += prodAmps[iRank][iRefl][iWave] * decayAmps[iEvt][iRefl][iWave];
+				ampProdSums[iRank][iRefl] = ampProdSum;
+				likelihood += norm(ampProdSum);
+			}
+		logLikelihoodAcc(-log(likelihood));
+		const T factor = 2. / likelihood;
+		for (unsigned int iRank = 0; iRank < rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < nmbWavesRefl[iRefl]; ++iWave)
+					derivativesAcc[iRank][iRefl][iWave](-factor * ampProdSums[iRank][iRefl] * conj(decayAmps[iEvt][iRefl][iWave]));
+		derivativeFlatAcc(-factor * prodAmpFlat);
+	}
+	for (unsigned int iRank = 0; iRank < rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < nmbWavesRefl[iRefl]; ++iWave)
+				derivatives[iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
+	derivativeFlat = sum(derivativeFlatAcc);
+	return sum(logLikelihoodAcc);
+}
+
+
+// returns maximum relative deviation of the derivatives
+template<typename complexT>
+double
+maxRelDiff(const multi_array<complexT, 3>& derivatives,
+           const multi_array<complexT, 3>& derivativesRef)
+{
+	double maxDiff = 0;
+	for (size_t i = 0; i < derivativesRef.num_elements(); ++i) {
+		const double normRef = abs(derivativesRef.data()[i]);
+		if (normRef > 0)
+			maxDiff = max(maxDiff, (double)abs(derivatives.data()[i] - derivativesRef.data()[i]) / normRef);
+	}
+	return maxDiff;
+}
+
+
+template<typename complexT>
+bool
+testCpuLikelihoodInterface(const unsigned int nmbEvents,
+                           const unsigned int rank,
+                           const unsigned int nmbWavesRefl[2],
+                           const double       tolerance)
+{
+	typedef typename complexT::value_type T;
+
+	multi_array<complexT, 3> decayAmps;
+	multi_array<complexT, 3> prodAmps;
+	T                        prodAmpFlat;
+	generateData(nmbEvents, rank, nmbWavesRefl, decayAmps, prodAmps, prodAmpFlat);
+
+	// reference values
+	multi_array<complexT, 3> derivativesRef;
+	T                        derivativeFlatRef;
+	const T                  logLikelihoodRef = logLikelihoodDerivMultiArray(decayAmps, prodAmps, prodAmpFlat,
+	                                                                         nmbEvents, rank, nmbWavesRefl,
+	                                                                         derivativesRef, derivativeFlatRef);
+
+	// CPU interface
+	cpu::likelihoodInterface<complexT> interface;
+	interface.setNmbThreads();
+	if (not interface.init(decayAmps.data(), decayAmps.num_elements(), nmbEvents, nmbWavesRefl, true)) {
+		printErr << "could not initialize CPU likelihood interface." << endl;
+		return false;
+	}
+	interface.print(cout);
+	const T logLikelihood = interface.logLikelihood(prodAmps.data(), prodAmps.num_elements(), prodAmpFlat, rank);
+	multi_array<complexT, 3> derivatives(extents[rank][2][max(nmbWavesRefl[0], nmbWavesRefl[1])]);
+	T                        derivativeFlat;
+	T                        logLikelihoodDeriv;
+	interface.logLikelihoodDeriv(prodAmps.data(), prodAmps.num_elements(), prodAmpFlat, rank,
+	                              derivatives.data(), derivativeFlat, &logLikelihoodDeriv);
+
+	const double relDiffLogLikelihood      = abs((logLikelihood      - logLikelihoodRef) / logLikelihoodRef);
+	const double relDiffLogLikelihoodDeriv = abs((logLikelihoodDeriv - logLikelihoodRef) / logLikelihoodRef);
+	const double relDiffDerivativeFlat     = abs((derivativeFlat     - derivativeFlatRef) / derivativeFlatRef);
+	const double relDiffDerivatives        = maxRelDiff(derivatives, derivativesRef);
+	printInfo << "CPU interface (" << sizeof(T) << "-byte floats, " << interface.nmbThreads() << " threads, "
+	          << "kernel time " << interface.kernelTime() << " sec) vs. reference:" << endl
+	          << "    log likelihood ....................... " << maxPrecision(logLikelihood) << " vs. "
+	          << maxPrecision(logLikelihoodRef) << "; rel. diff. = " << relDiffLogLikelihood << endl
+	          << "    log likelihood from derivative call .. rel. diff. = " << relDiffLogLikelihoodDeriv << endl
+	          << "    derivative of flat wave .............. rel. diff. = " << relDiffDerivativeFlat << endl
+	          << "    derivatives .......................... max. rel. diff. = " << relDiffDerivatives << endl;
+	bool success = (relDiffLogLikelihood      < tolerance) and (relDiffLogLikelihoodDeriv < tolerance)
+	           and (relDiffDerivativeFlat     < tolerance) and (relDiffDerivatives        < tolerance);
+
+	// the result must not depend on the number of threads; a copy
+	// shares the decay amplitudes, but has its own number of threads
+	const unsigned int                 nmbThreads = interface.nmbThreads();
+	cpu::likelihoodInterface<complexT> interfaceSingleThread(interface);
+	interfaceSingleThread.setNmbThreads(1);
+	const T logLikelihoodSingleThread = interfaceSingleThread.logLikelihood(prodAmps.data(), prodAmps.num_elements(), prodAmpFlat, rank);
+	if (logLikelihoodSingleThread != logLikelihood) {
+		printWarn << "log likelihood calculated with 1 thread differs: " << maxPrecision(logLikelihoodSingleThread)
+		          << " vs. " << maxPrecision(logLikelihood) << endl;
+		success = false;
+	}
+	if (interface.nmbThreads() != nmbThreads) {
+		printWarn << "number of threads of copy of CPU likelihood interface changed number of threads of original" << endl;
+		success = false;
+	}
+
+	// a second, independent instance with other decay amplitudes can be
+	// used at the same time
+	{
+		multi_array<complexT, 3> decayAmps2;
+		multi_array<complexT, 3> prodAmps2;
+		T                        prodAmpFlat2;
+		generateData(nmbEvents / 2, rank, nmbWavesRefl, decayAmps2, prodAmps2, prodAmpFlat2);
+		cpu::likelihoodInterface<complexT> interface2;
+		if (not interface2.init(decayAmps2.data(), decayAmps2.num_elements(), nmbEvents / 2, nmbWavesRefl, true)) {
+			printErr << "could not initialize second CPU likelihood interface." << endl;
+			return false;
+		}
+		const T logLikelihoodAgain = interface.logLikelihood(prodAmps.data(), prodAmps.num_elements(), prodAmpFlat, rank);
+		if (logLikelihoodAgain != logLikelihood or interface2.nmbEvents() != nmbEvents / 2) {
+			printWarn << "second instance of CPU likelihood interface changed the first one" << endl;
+			success = false;
+		}
+	}
+
+#ifdef USE_CUDA
+	// compare to CUDA interface
+	{
+		typedef cuda::complex<T> cudaComplexT;
+		cuda::likelihoodInterface<cudaComplexT>::init(reinterpret_cast<cudaComplexT*>(decayAmps.data()),
+		                                              decayAmps.num_elements(), nmbEvents, nmbWavesRefl, true);
+		const T logLikelihoodCuda = cuda::likelihoodInterface<cudaComplexT>::logLikelihood
+			(reinterpret_cast<cudaComplexT*>(prodAmps.data()), prodAmps.num_elements(), prodAmpFlat, rank);
+		multi_array<complexT, 3> derivativesCuda(extents[rank][2][max(nmbWavesRefl[0], nmbWavesRefl[1])]);
+		T                        derivativeFlatCuda;
+		cuda::likelihoodInterface<cudaComplexT>::logLikelihoodDeriv
+			(reinterpret_cast<cudaComplexT*>(prodAmps.data()), prodAmps.num_elements(), prodAmpFlat, rank,
+			 reinterpret_cast<cudaComplexT*>(derivativesCuda.data()), derivativeFlatCuda);
+		const double relDiffLogLikelihoodCuda  = abs((logLikelihood  - logLikelihoodCuda)  / logLikelihoodCuda);
+		const double relDiffDerivativeFlatCuda = abs((derivativeFlat - derivativeFlatCuda) / derivativeFlatCuda);
+		const double relDiffDerivativesCuda    = maxRelDiff(derivatives, derivativesCuda);
+		printInfo << "CPU interface vs. CUDA interface:" << endl
+		          << "    log likelihood ............. rel. diff. = "      << relDiffLogLikelihoodCuda  << endl
+		          << "    derivative of flat wave .... rel. diff. = "      << relDiffDerivativeFlatCuda << endl
+		          << "    derivatives ................ max. rel. diff. = " << relDiffDerivativesCuda    << endl;
+		success = success and (relDiffLogLikelihoodCuda  < tolerance)
+		                  and (relDiffDerivativeFlatCuda < tolerance)
+		                  and (relDiffDerivativesCuda    < tolerance);
+		cuda::likelihoodInterface<cudaComplexT>::closeCudaDevice();
+	}
+#endif
+
+	interface.close();
+	return success;
+}
+
+
+int
+main()
+{
+	const unsigned int nmbEvents       = 100000;
+	const unsigned int rank            = 2;
+	const unsigned int nmbWavesRefl[2] = {2, 16};
+
+	bool success = true;
+	success = testCpuLikelihoodInterface<complex<double> >(nmbEvents, rank, nmbWavesRefl, 1e-12) and success;
+	success = testCpuLikelihoodInterface<complex<float > >(nmbEvents, rank, nmbWavesRefl, 1e-4 ) and success;
+
+	if (success)
+		printSucc << "CPU likelihood interface agrees with reference calculation" << endl;
+	else
+		printErr << "CPU likelihood interface deviates from reference calculation" << endl;
+	return (success) ? 0 : 1;
+}
@@ -76,6 +76,26 @@ function testStep {
 		fi
 }
 
+# compares the fit results in two files, which have to agree up to the
+# different order of the sums over the events
+function compareFitResults {
+		python - "${1}" "${2}" <<'EOF'
+import sys
+import pyRootPwa
+result1 = pyRootPwa.utils.getFitResultFromFile(sys.argv[1])
+result2 = pyRootPwa.utils.getFitResultFromFile(sys.argv[2])
+if (not result1) or (not result2) or result1.nmbProdAmps() != result2.nmbProdAmps():
+	sys.exit(1)
+if abs(result1.logLikelihood() - result2.logLikelihood()) > 1e-6 * abs(result1.logLikelihood()):
+	pyRootPwa.utils.printErr("log likelihoods differ: " + str(result1.logLikelihood()) + " vs. " + str(result2.logLikelihood()))
+	sys.exit(1)
+for i in range(result1.nmbProdAmps()):
+	if abs(result1.prodAmp(i) - result2.prodAmp(i)) > 1e-3 * max(abs(result1.prodAmp(i)), 1.):
+		pyRootPwa.utils.printErr("production amplitudes " + str(i) + " differ: " + str(result1.prodAmp(i)) + " vs. " + str(result2.prodAmp(i)))
+		sys.exit(1)
+EOF
+}
+
 
 ### BEGIN PREPARATION ###
 
@@ -219,6 +239,24 @@ then
 	-s ${SEED_FIT}"
 fi
 
+# without MPI support each process would run an independent fit and
+# write its result into the same output file
+if which mpirun && python -c "import sys, pyRootPwa; likelihood = pyRootPwa.core.pwaLikelihood(); likelihood.enableMpi(True); sys.exit(0 if likelihood.mpiEnabled() else 1)"
+then
+	testStep "pwaFit with events distributed over 4 MPI processes" \
+	"mpirun -np 4 ${ROOTPWA}/build/bin/pwaFit \
+	\"./fits/pwaTest_NONLOPT_NOPRIOR_MPI.root\" \
+	--noAcceptance \
+	-w wavelist.compass.2008.88waves \
+	-s ${SEED_FIT} \
+	--mpi"
+
+	testStep "comparison of MPI fit with serial fit" \
+	"compareFitResults \"./fits/pwaTest_NONLOPT_NOPRIOR.root\" \"./fits/pwaTest_NONLOPT_NOPRIOR_MPI.root\""
+else
+	printInfo "ROOTPWA was compiled without MPI support or mpirun was not found. skipping MPI fit test."
+fi
+
 #-- END FIT TEST --#
 
 exit 0
@@ -42,6 +42,7 @@
 #define DFUNCTION_HPP
 
 
+#include <atomic>
 #include <cmath>
 #include <algorithm>
 #include <vector>
@@ -109,18 +110,21 @@ namespace rpwa {
 			const T cosThetaHalf = cos(thetaHalf);
 			const T sinThetaHalf = sin(thetaHalf);
 
-			T                dFuncVal   = 0;
-			cacheEntryType*& cacheEntry = _cache[j][(j + _m) / 2][(j + _n) / 2];
-			if (_useCache and cacheEntry) {
+			T                             dFuncVal    = 0;
+			std::atomic<cacheEntryType*>& cacheSlot   = _cache[j][(j + _m) / 2][(j + _n) / 2];
+			const cacheEntryType*         cachedEntry = cacheSlot.load(std::memory_order_acquire);
+			if (_useCache and cachedEntry) {
 				// calculate function value using cache
 				T sumTerm = 0;
-				for (unsigned int i = 0; i < cacheEntry->factor.size(); ++i) {
-					sumTerm +=   rpwa::pow(cosThetaHalf, cacheEntry->kmn1[i])
-						         * rpwa::pow(sinThetaHalf, cacheEntry->jmnk[i]) / cacheEntry->factor[i];
+				for (unsigned int i = 0; i < cachedEntry->factor.size(); ++i) {
+					sumTerm +=   rpwa::pow(cosThetaHalf, cachedEntry->kmn1[i])
+						         * rpwa::pow(sinThetaHalf, cachedEntry->jmnk[i]) / cachedEntry->factor[i];
 				}
-				dFuncVal = cacheEntry->constTerm * sumTerm;
+				dFuncVal = cachedEntry->constTerm * sumTerm;
 			} else {
-				// calculate function value and put intermediate values into cache
+				// calculate function value and put intermediate values into
+				// cache; the entry is published only when it is complete
+				cacheEntryType* cacheEntry = 0;
 				if (_useCache)
 					cacheEntry = new cacheEntryType();
 				const int jpm       = (j + _m) / 2;
@@ -158,6 +162,12 @@ namespace rpwa {
 					sumTerm += rpwa::pow(cosThetaHalf, kmn1) * rpwa::pow(sinThetaHalf, jmnk) / factor;
 				}
 				dFuncVal = constTerm * sumTerm;
+				if (cacheEntry) {
+					// another thread may have filled the entry in the meantime
+					cacheEntryType* noEntry = 0;
+					if (not cacheSlot.compare_exchange_strong(noEntry, cacheEntry, std::memory_order_acq_rel))
+						delete cacheEntry;
+				}
 			}
 
 			return dFuncVal;
@@ -171,7 +181,7 @@ namespace rpwa {
 			for (int j = 0; j < (int)_maxJ; ++j)
 				for (int m = -j; m <= j; m += 2)
 					for (int n = -j; n <= j; n += 2) {
-						cacheEntryType*& cacheEntry = _cache[j][(j + m) / 2][(j + n) / 2];
+						const cacheEntryType* cacheEntry = _cache[j][(j + m) / 2][(j + n) / 2].load();
 						if (cacheEntry) {
 							size += sizeof(*cacheEntry);
 							size += cacheEntry->kmn1.capacity  () * sizeof(int);
@@ -191,7 +201,7 @@ namespace rpwa {
 			for (int j = 0; j < (int)_maxJ; ++j)
 				for (int m = -j; m <= j; m += 2)
 					for (int n = -j; n <= j; n += 2)
-						delete _cache[j][(j + m) / 2][(j + n) / 2];
+						delete _cache[j][(j + m) / 2][(j + n) / 2].load();
 		}
 		dFunctionCached (const dFunctionCached&);
 		dFunctionCached& operator =(const dFunctionCached&);
@@ -200,14 +210,14 @@ namespace rpwa {
 		static bool            _useCache;  ///< if set to true, cache is used
 
 		static const unsigned int _maxJ = 41;                           ///< maximum allowed angular momentum * 2 + 1
-		static cacheEntryType*    _cache[_maxJ][_maxJ + 1][_maxJ + 1];  ///< cache for intermediate terms [j][m][n]
+		static std::atomic<cacheEntryType*> _cache[_maxJ][_maxJ + 1][_maxJ + 1];  ///< cache for intermediate terms [j][m][n]; entries are published only when complete
 	};
 
 
 	template<typename T> dFunctionCached<T> dFunctionCached<T>::_instance;
 	template<typename T> bool               dFunctionCached<T>::_useCache = true;
 
-	template<typename T> typename dFunctionCached<T>::cacheEntryType*
+	template<typename T> std::atomic<typename dFunctionCached<T>::cacheEntryType*>
 	  dFunctionCached<T>::_cache[_maxJ][_maxJ + 1][_maxJ + 1];
 
 
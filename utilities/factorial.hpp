@@ -22,7 +22,7 @@
 //
 // Description:
 //      simple n! singleton functor with caching for small n
-//      checks for overflows
+//      checks for overflows; the cache may be used by several threads
 //
 //
 // Author List:
@@ -38,6 +38,7 @@
 
 #include <vector>
 #include <limits>
+#include <mutex>
 
 #include "reportingUtils.hpp"
 
@@ -52,6 +53,8 @@ namespace rpwa {
 		static factorialCached& instance() { return _instance; }  ///< get singleton instance
 		T operator ()(const unsigned int n)                       ///< returns n!
 		{
+			// the cache may grow while another thread reads it
+			std::lock_guard<std::mutex> lock(_mutex);
 			const unsigned int cacheSize = _cache.size();
 			if (n >= cacheSize) {
 				_cache.resize(n + 1);
@@ -79,12 +82,14 @@ namespace rpwa {
 
 		static factorialCached _instance;  ///< singleton instance
 		static std::vector<T>  _cache;     ///< cache for already calculated values
+		static std::mutex      _mutex;     ///< guards the cache
 
 	};
 
 
 	template<typename T> factorialCached<T> factorialCached<T>::_instance;
 	template<typename T> std::vector<T>     factorialCached<T>::_cache(1, 1);
+	template<typename T> std::mutex         factorialCached<T>::_mutex;
 
 
 	template<typename T>
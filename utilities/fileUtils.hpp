@@ -37,9 +37,12 @@
 
 #include <string>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #ifndef __CINT__
+#include <atomic>
 #include <glob.h>
+#include <unistd.h>
 #else
 //  dummies for CINT
 struct glob_t;
@@ -102,6 +105,21 @@ namespace rpwa {
 	}
 
 
+#ifndef __CINT__
+	inline
+	std::string
+	temporaryFileName(const std::string& path)  ///< returns name of a temporary file next to the given path that is unique across hosts, processes, and threads; to be renamed to path once it is complete
+	{
+		static std::atomic<unsigned long> counter(0);
+		char hostName[256] = "";
+		gethostname(hostName, sizeof(hostName) - 1);
+		std::ostringstream tmpName;
+		tmpName << path << ".tmp." << hostName << "." << getpid() << "." << counter++;
+		return tmpName.str();
+	}
+#endif
+
+
 	inline
 	std::streampos
 	fileSize(std::istream& file)  ///< returns number of bytes in istream
@@ -50,6 +50,9 @@ void rpwa::printLibraryInfo()
 #endif
 #ifdef USE_MPI
 	std::cout << "    MPI libraries; using Boost.MPI" << std::endl;
+#endif
+#ifdef _OPENMP
+	std::cout << "    OpenMP version " << _OPENMP << std::endl;
 #endif
 	std::cout << "    Python version " << PYTHONLIBS_VERSION_STRING << " in '" << PYTHON_INCLUDE_DIRS << "'; using Boost.Python" << std::endl;
 }
@@ -38,6 +38,7 @@
 #define CLEBSCHGORDANCOEFF_HPP
 
 
+#include <atomic>
 #include <vector>
 #include <limits>
 
@@ -279,11 +280,12 @@ namespace rpwa {
 				return 0;
 			}
 
-			T        clebschVal = 0;
-			double*& cacheEntry = _cache[j1][m1][j2][m2][J];
-			if (_useCache and cacheEntry) {
+			T                clebschVal = 0;
+			std::atomic<T*>& cacheEntry = _cache[j1][m1][j2][m2][J];
+			const T*         cachedVal  = cacheEntry.load(std::memory_order_acquire);
+			if (_useCache and cachedVal) {
 				// calculate function value using cache
-				clebschVal = *cacheEntry;
+				clebschVal = *cachedVal;
 			} else {
 				// calculate function value and put intermediate values into cache
 				int nu = 0;
@@ -323,8 +325,11 @@ namespace rpwa {
 
 				clebschVal = rpwa::sqrt(A) * sum;
 				if (_useCache) {
-					cacheEntry  = new double;
-					*cacheEntry = clebschVal;
+					// another thread may have filled the entry in the meantime
+					T* newEntry = new T(clebschVal);
+					T* noEntry  = 0;
+					if (not cacheEntry.compare_exchange_strong(noEntry, newEntry, std::memory_order_acq_rel))
+						delete newEntry;
 				}
 			}
 
@@ -341,7 +346,7 @@ namespace rpwa {
 					for (int j2 = 0; j2 < _maxJ; ++j2)
 						for (int m2 = -j2; m2 <= j2; ++m2)
 							for (int J = 0; J < 2 * _maxJ; ++J)
-								if (_cache[j1][m1][j2][m2][J])
+								if (_cache[j1][m1][j2][m2][J].load())
 									size += sizeof(T);
 			return size;
 		}
@@ -361,7 +366,7 @@ namespace rpwa {
 		static bool                     _debug;     ///< if set to true, debug messages are printed
 
 		static const int _maxJ = 18;  ///< maximum allowed angular momentum * 2 + 1
-		static T*        _cache[_maxJ][2 * _maxJ - 1][_maxJ][2 * _maxJ - 1][2 * _maxJ];  ///< cache for intermediate terms [j1][m1][j2][m2][J]
+		static std::atomic<T*> _cache[_maxJ][2 * _maxJ - 1][_maxJ][2 * _maxJ - 1][2 * _maxJ];  ///< cache for intermediate terms [j1][m1][j2][m2][J]; every entry is set at most once
 	};
 
 
@@ -369,7 +374,7 @@ namespace rpwa {
 	template<typename T> bool                        clebschGordanCoeffCached<T>::_useCache = true;
 	template<typename T> bool                        clebschGordanCoeffCached<T>::_debug    = false;
 
-	template<typename T> T*
+	template<typename T> std::atomic<T*>
 	clebschGordanCoeffCached<T>::_cache[_maxJ][2 * _maxJ - 1][_maxJ][2 * _maxJ - 1][2 * _maxJ];
 
 